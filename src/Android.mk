@@ -40,7 +40,8 @@ COMMON_SRC_FILES := \
 	Common/Resource.cpp \
 	Common/Socket.cpp \
 	Common/Thread.cpp \
-	Common/Timer.cpp
+	Common/Timer.cpp \
+	Common/Tracer.cpp
 
 COMMON_SRC_FILES += \
 	Main/Config.cpp \
@@ -52,13 +53,15 @@ ifdef use_subzero
 COMMON_SRC_FILES += \
 	Reactor/SubzeroReactor.cpp \
 	Reactor/Routine.cpp \
-	Reactor/Optimizer.cpp
+	Reactor/Optimizer.cpp \
+	Reactor/Profiler.cpp
 else
 COMMON_SRC_FILES += \
 	Reactor/LLVMReactor.cpp \
 	Reactor/Routine.cpp \
 	Reactor/LLVMRoutine.cpp \
-	Reactor/LLVMRoutineManager.cpp
+	Reactor/LLVMRoutineManager.cpp \
+	Reactor/Profiler.cpp
 endif
 
 COMMON_SRC_FILES += \
@@ -73,6 +76,7 @@ COMMON_SRC_FILES += \
 	Renderer/Point.cpp \
 	Renderer/QuadRasterizer.cpp \
 	Renderer/Renderer.cpp \
+	Renderer/RoutineOptimizer.cpp \
 	Renderer/Sampler.cpp \
 	Renderer/SetupProcessor.cpp \
 	Renderer/Surface.cpp \
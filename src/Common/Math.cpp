@@ -23,8 +23,11 @@ namespace sw
 
 	uint64_t FNV_1a(const unsigned char *data, int size)
 	{
-		int64_t hash = 0xCBF29CE484222325;
+		return FNV_1a(data, size, 0xCBF29CE484222325);
+	}
 
+	uint64_t FNV_1a(const unsigned char *data, int size, uint64_t hash)
+	{
 		for(int i = 0; i < size; i++)
 		{
 			hash = FNV_1a(hash, data[i]);
@@ -362,6 +362,7 @@ namespace sw
 	unsigned char sRGB8toLinear8(unsigned char value);
 
 	uint64_t FNV_1a(const unsigned char *data, int size);   // Fowler-Noll-Vo hash function
+	uint64_t FNV_1a(const unsigned char *data, int size, uint64_t hash);   // Continues a previous hash
 
 	// Round up to the next multiple of alignment
 	template<typename T>
@@ -16,6 +16,7 @@
 
 #include "Types.hpp"
 #include "Debug.hpp"
+#include "MutexLock.hpp"
 
 #if defined(_WIN32)
 	#ifndef WIN32_LEAN_AND_MEAN
@@ -30,6 +31,7 @@
 	#include <unistd.h>
 #endif
 
+#include <map>
 #include <memory.h>
 
 #undef allocate
@@ -79,7 +81,7 @@ void *allocateRaw(size_t bytes, size_t alignment)
 	#endif
 }
 
-#if defined(LINUX_ENABLE_NAMED_MMAP)
+#if defined(__linux__)
 // Create a file descriptor for anonymous memory with the given
 // name. Returns -1 on failure.
 // TODO: remove once libc wrapper exists.
@@ -104,7 +106,9 @@ int memfd_create(const char* name, unsigned int flags)
 		return -1;
 	#endif
 }
+#endif  // defined(__linux__)
 
+#if defined(LINUX_ENABLE_NAMED_MMAP)
 // Returns a file descriptor for use with an anonymous mmap, if
 // memfd_create fails, -1 is returned. Note, the mappings should be
 // MAP_PRIVATE so that underlying pages aren't shared.
@@ -126,6 +130,377 @@ void ensureAnonFileSize(int anonFd, size_t length)
 }
 #endif  // defined(LINUX_ENABLE_NAMED_MMAP)
 
+
+size_t roundToPageSize(size_t bytes)
+{
+	size_t pageSize = memoryPageSize();
+	return (bytes + pageSize - 1) & ~(pageSize - 1);
+}
+
+// Maps a block of read-write memory which can later be made executable.
+unsigned char *mapExecutable(size_t length)
+{
+	void *mapping;
+
+	#if defined(LINUX_ENABLE_NAMED_MMAP)
+		// Try to name the memory region for the executable code,
+		// to aid profilers.
+		int anonFd = anonymousFd();
+		if(anonFd == -1)
+		{
+			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		}
+		else
+		{
+			ensureAnonFileSize(anonFd, length);
+			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE, anonFd, 0);
+		}
+
+		if(mapping == MAP_FAILED)
+		{
+			mapping = nullptr;
+		}
+	#else
+		mapping = allocate(length, memoryPageSize());
+	#endif
+
+	return (unsigned char*)mapping;
+}
+
+void unmapExecutable(void *memory, size_t length)
+{
+	#if defined(LINUX_ENABLE_NAMED_MMAP)
+		munmap(memory, length);
+	#else
+		deallocate(memory);
+	#endif
+}
+
+void markWritable(void *memory, size_t bytes)
+{
+	#if defined(_WIN32)
+		unsigned long oldProtection;
+		VirtualProtect(memory, bytes, PAGE_READWRITE, &oldProtection);
+	#else
+		mprotect(memory, bytes, PROT_READ | PROT_WRITE);
+	#endif
+}
+
+void protectExecutable(void *memory, size_t bytes)
+{
+	#if defined(_WIN32)
+		unsigned long oldProtection;
+		VirtualProtect(memory, bytes, PAGE_EXECUTE_READ, &oldProtection);
+	#else
+		mprotect(memory, bytes, PROT_READ | PROT_EXEC);
+	#endif
+}
+
+// Only x86-64 JIT code is position independent, so it can run from a different
+// address than it was written to (see createExecutionEngine in LLVMReactor.cpp).
+#if defined(__linux__) && defined(__x86_64__)
+	#define DUAL_MAPPED_CODE
+#endif
+
+// Maps the same memory twice: a read-write view to emit code into, and a
+// read-execute view to run it from. Returns false if it's not supported.
+bool mapDual(size_t length, unsigned char *&writable, unsigned char *&executable)
+{
+	#if defined(DUAL_MAPPED_CODE)
+		int fd = memfd_create("SwiftShader JIT", 0);
+		if(fd == -1)
+		{
+			return false;
+		}
+
+		void *rw = MAP_FAILED;
+		void *rx = MAP_FAILED;
+
+		if(ftruncate(fd, length) == 0)
+		{
+			rw = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			rx = mmap(nullptr, length, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+		}
+
+		close(fd);   // The mappings keep the memory alive
+
+		if(rw == MAP_FAILED || rx == MAP_FAILED)
+		{
+			if(rw != MAP_FAILED) munmap(rw, length);
+			if(rx != MAP_FAILED) munmap(rx, length);
+			return false;
+		}
+
+		writable = (unsigned char*)rw;
+		executable = (unsigned char*)rx;
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+void unmapDual(unsigned char *writable, unsigned char *executable, size_t length)
+{
+	#if defined(DUAL_MAPPED_CODE)
+		munmap(writable, length);
+		munmap(executable, length);
+	#endif
+}
+
+// Packs routines into large slabs instead of giving each one its own mapping.
+// When slabs can be dual mapped, routines are written through the read-write
+// view and run from the read-execute view, so they can share pages and nothing
+// needs to be reprotected. Allocations are cache line granular, to keep stores
+// of a routine being emitted from evicting instructions of one being executed.
+// Otherwise pages are never writable and executable at the same time, so
+// allocations are page granular. Free ranges are coalesced within their slab,
+// and a slab is unmapped once all of its routines have been released.
+class CodeHeap
+{
+public:
+	CodeHeap() : dualMapped(false), granularity(memoryPageSize())
+	{
+		unsigned char *writable = nullptr;
+		unsigned char *executable = nullptr;
+
+		// Map the first slab up front to find out which scheme is available
+		if(mapDual(slabSize, writable, executable))
+		{
+			dualMapped = true;
+			granularity = cacheLineSize;
+			addSlab(writable, Slab(slabSize, executable - writable));
+		}
+	}
+
+	void *allocate(size_t length)
+	{
+		length = round(length);
+
+		LockGuard lock(mutex);
+
+		FreeRanges::iterator best = freeRanges.end();
+
+		for(FreeRanges::iterator range = freeRanges.begin(); range != freeRanges.end(); range++)
+		{
+			if(range->second >= length && (best == freeRanges.end() || range->second < best->second))
+			{
+				best = range;
+			}
+		}
+
+		if(best == freeRanges.end())
+		{
+			size_t slabLength = length > slabSize ? roundToPageSize(length) : slabSize;
+			unsigned char *slab = nullptr;
+			unsigned char *executable = nullptr;
+
+			if(dualMapped ? !mapDual(slabLength, slab, executable) : !(slab = mapExecutable(slabLength)))
+			{
+				return nullptr;
+			}
+
+			best = addSlab(slab, Slab(slabLength, dualMapped ? executable - slab : 0));
+		}
+
+		unsigned char *memory = best->first;
+		size_t remainder = best->second - length;
+		freeRanges.erase(best);
+
+		if(remainder > 0)
+		{
+			freeRanges[memory + length] = remainder;
+		}
+
+		Slabs::iterator slab = findSlab(memory);
+		slab->second.allocated += length;
+		slab->second.allocations++;
+
+		return memory;
+	}
+
+	void shrink(void *memory, size_t length, size_t newLength)
+	{
+		length = round(length);
+		newLength = round(newLength);
+
+		if(newLength < length)
+		{
+			LockGuard lock(mutex);
+
+			Slabs::iterator slab = findSlab((unsigned char*)memory);
+			slab->second.allocated -= length - newLength;
+
+			addFreeRange(slab, (unsigned char*)memory + newLength, length - newLength);
+		}
+	}
+
+	void protect(void *memory, size_t length)
+	{
+		if(!dualMapped)
+		{
+			protectExecutable(memory, length);
+		}
+	}
+
+	void *alias(void *memory)
+	{
+		if(!dualMapped)
+		{
+			return memory;
+		}
+
+		LockGuard lock(mutex);
+
+		return (unsigned char*)memory + findSlab((unsigned char*)memory)->second.alias;
+	}
+
+	void release(void *memory, size_t length)
+	{
+		length = round(length);
+
+		if(!dualMapped)
+		{
+			markWritable(memory, length);
+		}
+
+		LockGuard lock(mutex);
+
+		Slabs::iterator slab = findSlab((unsigned char*)memory);
+		slab->second.allocated -= length;
+		slab->second.allocations--;
+
+		addFreeRange(slab, (unsigned char*)memory, length);
+
+		// Keep one slab around to avoid remapping when routines are recreated
+		if(slab->second.allocations == 0 && slabs.size() > 1)
+		{
+			freeRanges.erase(slab->first);
+
+			if(dualMapped)
+			{
+				unmapDual(slab->first, slab->first + slab->second.alias, slab->second.length);
+			}
+			else
+			{
+				unmapExecutable(slab->first, slab->second.length);
+			}
+
+			slabs.erase(slab);
+		}
+	}
+
+	ExecutableMemoryStatistics statistics()
+	{
+		LockGuard lock(mutex);
+
+		ExecutableMemoryStatistics statistics = {};
+
+		for(Slabs::iterator slab = slabs.begin(); slab != slabs.end(); slab++)
+		{
+			statistics.slabCount++;
+			statistics.reservedBytes += slab->second.length;
+			statistics.allocatedBytes += slab->second.allocated;
+			statistics.allocationCount += slab->second.allocations;
+		}
+
+		for(FreeRanges::iterator range = freeRanges.begin(); range != freeRanges.end(); range++)
+		{
+			statistics.freeRangeCount++;
+			statistics.freeBytes += range->second;
+
+			if(range->second > statistics.largestFreeRange)
+			{
+				statistics.largestFreeRange = range->second;
+			}
+		}
+
+		return statistics;
+	}
+
+private:
+	struct Slab
+	{
+		Slab(size_t length = 0, ptrdiff_t alias = 0) : length(length), alias(alias), allocated(0), allocations(0) {}
+
+		size_t length;
+		ptrdiff_t alias;   // Offset from the writable to the executable view
+		size_t allocated;
+		int allocations;
+	};
+
+	typedef std::map<unsigned char*, Slab> Slabs;
+	typedef std::map<unsigned char*, size_t> FreeRanges;   // Start address -> length
+
+	size_t round(size_t length) const
+	{
+		return (length + granularity - 1) & ~(granularity - 1);
+	}
+
+	FreeRanges::iterator addSlab(unsigned char *memory, const Slab &slab)
+	{
+		slabs[memory] = slab;
+		return freeRanges.insert(FreeRanges::value_type(memory, slab.length)).first;
+	}
+
+	Slabs::iterator findSlab(unsigned char *memory)
+	{
+		Slabs::iterator slab = slabs.upper_bound(memory);
+		ASSERT(slab != slabs.begin());
+		slab--;
+		ASSERT(memory < slab->first + slab->second.length);
+
+		return slab;
+	}
+
+	void addFreeRange(Slabs::iterator slab, unsigned char *memory, size_t length)
+	{
+		unsigned char *slabEnd = slab->first + slab->second.length;
+
+		// Merge with the following range, unless it's in another slab
+		FreeRanges::iterator next = freeRanges.find(memory + length);
+		if(next != freeRanges.end() && next->first < slabEnd)
+		{
+			length += next->second;
+			freeRanges.erase(next);
+		}
+
+		// Merge with the preceding range
+		FreeRanges::iterator range = freeRanges.lower_bound(memory);
+		if(range != freeRanges.begin())
+		{
+			FreeRanges::iterator previous = range;
+			previous--;
+
+			if(previous->first >= slab->first && previous->first + previous->second == memory)
+			{
+				previous->second += length;
+				return;
+			}
+		}
+
+		freeRanges[memory] = length;
+	}
+
+	static const size_t slabSize = 1024 * 1024;
+	static const size_t cacheLineSize = 64;
+
+	bool dualMapped;
+	size_t granularity;
+
+	Slabs slabs;
+	FreeRanges freeRanges;
+	MutexLock mutex;
+};
+
+CodeHeap &codeHeap()
+{
+	// Never destroyed, so routines held in static caches can be released at exit
+	static CodeHeap *heap = new CodeHeap();
+	return *heap;
+}
+
 }  // anonymous namespace
 
 size_t memoryPageSize()
@@ -175,61 +550,35 @@ void deallocate(void *memory)
 
 void *allocateExecutable(size_t bytes)
 {
-	size_t pageSize = memoryPageSize();
-	size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
-	void *mapping;
-
-	#if defined(LINUX_ENABLE_NAMED_MMAP)
-		// Try to name the memory region for the executable code,
-		// to aid profilers.
-		int anonFd = anonymousFd();
-		if(anonFd == -1)
-		{
-			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
-			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-		}
-		else
-		{
-			ensureAnonFileSize(anonFd, length);
-			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
-			               MAP_PRIVATE, anonFd, 0);
-		}
+	return codeHeap().allocate(bytes);
+}
 
-		if(mapping == MAP_FAILED)
-		{
-			mapping = nullptr;
-		}
-	#else
-		mapping = allocate(length, pageSize);
-	#endif
+void shrinkExecutable(void *memory, size_t bytes, size_t newBytes)
+{
+	codeHeap().shrink(memory, bytes, newBytes);
+}
 
-	return mapping;
+void *executableAlias(void *memory)
+{
+	return codeHeap().alias(memory);
 }
 
 void markExecutable(void *memory, size_t bytes)
 {
-	#if defined(_WIN32)
-		unsigned long oldProtection;
-		VirtualProtect(memory, bytes, PAGE_EXECUTE_READ, &oldProtection);
-	#else
-		mprotect(memory, bytes, PROT_READ | PROT_EXEC);
-	#endif
+	codeHeap().protect(memory, bytes);
 }
 
 void deallocateExecutable(void *memory, size_t bytes)
 {
-	#if defined(_WIN32)
-		unsigned long oldProtection;
-		VirtualProtect(memory, bytes, PAGE_READWRITE, &oldProtection);
-		deallocate(memory);
-	#elif defined(LINUX_ENABLE_NAMED_MMAP)
-		size_t pageSize = memoryPageSize();
-		size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
-		munmap(memory, length);
-	#else
-		mprotect(memory, bytes, PROT_READ | PROT_WRITE);
-		deallocate(memory);
-	#endif
+	if(memory)
+	{
+		codeHeap().release(memory, bytes);
+	}
+}
+
+ExecutableMemoryStatistics executableMemoryStatistics()
+{
+	return codeHeap().statistics();
 }
 
 void clear(uint16_t *memory, uint16_t element, size_t count)
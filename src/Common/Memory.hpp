@@ -26,9 +26,24 @@ void *allocate(size_t bytes, size_t alignment = 16);
 void deallocate(void *memory);
 
 void *allocateExecutable(size_t bytes);   // Allocates memory that can be made executable using markExecutable()
+void shrinkExecutable(void *memory, size_t bytes, size_t newBytes);   // Returns the unused tail to the code heap
+void *executableAlias(void *memory);   // Address the code written to memory runs from, which differs when the heap is dual mapped
 void markExecutable(void *memory, size_t bytes);
 void deallocateExecutable(void *memory, size_t bytes);
 
+struct ExecutableMemoryStatistics
+{
+	size_t reservedBytes;      // Total size of all code slabs
+	size_t allocatedBytes;     // Held by routines, in cache lines or whole pages
+	size_t freeBytes;
+	size_t largestFreeRange;   // Fragmentation is 1 - largestFreeRange / freeBytes
+	int slabCount;
+	int allocationCount;
+	int freeRangeCount;
+};
+
+ExecutableMemoryStatistics executableMemoryStatistics();
+
 void clear(uint16_t *memory, uint16_t element, size_t count);
 void clear(uint32_t *memory, uint32_t element, size_t count);
 }
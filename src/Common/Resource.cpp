@@ -15,6 +15,7 @@
 #include "Resource.hpp"
 
 #include "Memory.hpp"
+#include "Tracer.hpp"
 
 namespace sw
 {
@@ -43,7 +44,10 @@ namespace sw
 			blocked++;
 			criticalSection.unlock();
 
-			unblock.wait();
+			{
+				TraceScope trace("Resource wait");
+				unblock.wait();
+			}
 
 			criticalSection.lock();
 			blocked--;
@@ -89,7 +93,10 @@ namespace sw
 			blocked++;
 			criticalSection.unlock();
 
-			unblock.wait();
+			{
+				TraceScope trace("Resource wait");
+				unblock.wait();
+			}
 
 			criticalSection.lock();
 			blocked--;
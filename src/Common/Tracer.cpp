@@ -0,0 +1,293 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Tracer.hpp"
+
+#include "Thread.hpp"
+#include "MutexLock.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char *name;
+		int64_t time;
+		char phase;
+	};
+
+	// Only the owning thread writes events, so recording needs no locking. Readers copy the ring
+	// and then discard whatever the owner may have overwritten in the meantime.
+	struct ThreadBuffer
+	{
+		enum {SIZE = 1 << 16};   // Older events are overwritten
+
+		ThreadBuffer(int id) : id(id), name(nullptr), count(0), exited(false)
+		{
+			events = new TraceEvent[SIZE];
+		}
+
+		void add(const char *eventName, char phase)
+		{
+			unsigned int index = count.load(std::memory_order_relaxed);
+			TraceEvent &event = events[index & (SIZE - 1)];
+			event.name = eventName;
+			event.time = sw::Timer::counter();
+			event.phase = phase;
+
+			count.store(index + 1, std::memory_order_release);
+		}
+
+		int id;
+		const char *name;
+		std::atomic<unsigned int> count;
+		TraceEvent *events;
+		bool exited;   // The buffer can be reused by another thread
+	};
+
+	sw::MutexLock &mutex()
+	{
+		static sw::MutexLock *mutex = new sw::MutexLock();   // Never destroyed, so it can be used at exit
+		return *mutex;
+	}
+
+	std::vector<ThreadBuffer*> &threadBuffers()
+	{
+		static std::vector<ThreadBuffer*> *buffers = new std::vector<ThreadBuffer*>();
+		return *buffers;
+	}
+
+	int threadCount = 0;
+
+	void releaseThreadBuffer(void *storage)
+	{
+		LockGuard lock(mutex());
+		(*(ThreadBuffer**)storage)->exited = true;   // Its events stay in the trace until the buffer is reused
+		free(storage);
+	}
+
+	sw::Thread::LocalStorageKey threadBufferKey = sw::Thread::allocateLocalStorageKey(releaseThreadBuffer);
+
+	ThreadBuffer *threadBuffer()
+	{
+		ThreadBuffer **buffer = (ThreadBuffer**)sw::Thread::getLocalStorage(threadBufferKey);
+
+		if(!buffer)
+		{
+			buffer = (ThreadBuffer**)sw::Thread::allocateLocalStorage(threadBufferKey, sizeof(ThreadBuffer*));
+
+			LockGuard lock(mutex());
+			*buffer = nullptr;
+
+			for(ThreadBuffer *exited : threadBuffers())
+			{
+				if(exited->exited)
+				{
+					*buffer = exited;
+					break;
+				}
+			}
+
+			if(*buffer)
+			{
+				(*buffer)->id = ++threadCount;
+				(*buffer)->name = nullptr;
+				(*buffer)->count.store(0, std::memory_order_relaxed);
+				(*buffer)->exited = false;
+			}
+			else
+			{
+				*buffer = new ThreadBuffer(++threadCount);
+				threadBuffers().push_back(*buffer);
+			}
+		}
+
+		return *buffer;
+	}
+
+	// Copies the events which are still intact, leaving out begin and end events whose counterpart is missing
+	std::vector<TraceEvent> snapshot(const ThreadBuffer &buffer)
+	{
+		unsigned int count = buffer.count.load(std::memory_order_acquire);
+		unsigned int start = count > ThreadBuffer::SIZE ? count - ThreadBuffer::SIZE : 0;
+
+		std::vector<TraceEvent> events;
+		events.reserve(count - start);
+
+		for(unsigned int i = start; i < count; i++)
+		{
+			events.push_back(buffer.events[i & (ThreadBuffer::SIZE - 1)]);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		unsigned int written = buffer.count.load(std::memory_order_relaxed);
+
+		// Events up to the one being written now may have been overwritten while copying
+		if(written - start >= ThreadBuffer::SIZE)
+		{
+			unsigned int torn = written - start - ThreadBuffer::SIZE + 1;
+			events.erase(events.begin(), events.begin() + std::min<size_t>(torn, events.size()));
+		}
+
+		std::vector<bool> matched(events.size(), false);
+		std::vector<size_t> open;
+
+		for(size_t i = 0; i < events.size(); i++)
+		{
+			if(events[i].phase == 'B')
+			{
+				open.push_back(i);
+			}
+			else if(!open.empty())
+			{
+				matched[open.back()] = true;
+				matched[i] = true;
+				open.pop_back();
+			}
+		}
+
+		size_t kept = 0;
+
+		for(size_t i = 0; i < events.size(); i++)
+		{
+			if(matched[i])
+			{
+				events[kept++] = events[i];
+			}
+		}
+
+		events.resize(kept);
+
+		return events;
+	}
+
+	std::string escape(const char *string)
+	{
+		std::string escaped;
+
+		for(const char *c = string; *c; c++)
+		{
+			if(*c == '"' || *c == '\\')
+			{
+				escaped += '\\';
+			}
+
+			escaped += *c;
+		}
+
+		return escaped;
+	}
+
+	void writeAtExit()
+	{
+		sw::Tracer::write(getenv("SWIFTSHADER_TRACE"));
+	}
+}
+
+namespace sw
+{
+	bool Tracer::enabled = Tracer::initialize();
+
+	bool Tracer::initialize()
+	{
+		const char *fileName = getenv("SWIFTSHADER_TRACE");
+
+		if(!fileName || !*fileName)
+		{
+			return false;
+		}
+
+		atexit(writeAtExit);
+
+		return true;
+	}
+
+	void Tracer::begin(const char *name)
+	{
+		threadBuffer()->add(name, 'B');
+	}
+
+	void Tracer::end(const char *name)
+	{
+		threadBuffer()->add(name, 'E');
+	}
+
+	void Tracer::setThreadName(const char *name)
+	{
+		if(enabled)
+		{
+			threadBuffer()->name = name;
+		}
+	}
+
+	const char *Tracer::internName(const std::string &name)
+	{
+		static std::set<std::string> *names = new std::set<std::string>();
+
+		LockGuard lock(mutex());
+		return names->insert(name).first->c_str();
+	}
+
+	std::string Tracer::json()
+	{
+		LockGuard lock(mutex());
+
+		double microseconds = 1.0e6 / Timer::frequency();
+		std::string json = "{\"traceEvents\":[\n";
+		bool first = true;
+		char line[64];
+
+		for(ThreadBuffer *buffer : threadBuffers())
+		{
+			std::string tid = std::to_string(buffer->id);
+			std::string name = buffer->name ? escape(buffer->name) : "Thread " + tid;
+
+			json += std::string(first ? "" : ",\n") + "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"" + name + "\"}}";
+			first = false;
+
+			for(const TraceEvent &event : snapshot(*buffer))
+			{
+				snprintf(line, sizeof(line), "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":", event.phase, event.time * microseconds);
+				json += ",\n{\"name\":\"" + escape(event.name) + line + tid + "}";
+			}
+		}
+
+		json += "\n]}\n";
+
+		return json;
+	}
+
+	bool Tracer::write(const char *fileName)
+	{
+		FILE *file = fileName ? fopen(fileName, "w") : nullptr;
+
+		if(!file)
+		{
+			return false;
+		}
+
+		std::string trace = json();
+		fwrite(trace.c_str(), 1, trace.size(), file);
+		fclose(file);
+
+		return true;
+	}
+}
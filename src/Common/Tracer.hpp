@@ -0,0 +1,68 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Tracer_hpp
+#define sw_Tracer_hpp
+
+#include <string>
+
+namespace sw
+{
+	// Records begin/end events in per-thread ring buffers, written out in the Chrome trace event format
+	// (chrome://tracing, Perfetto). Enabled by setting SWIFTSHADER_TRACE to the file to write at exit.
+	class Tracer
+	{
+	public:
+		static bool isEnabled() { return enabled; }
+
+		// Names must outlive the trace. Use internName() for ones built at run time.
+		static void begin(const char *name);
+		static void end(const char *name);
+		static void setThreadName(const char *name);
+		static const char *internName(const std::string &name);
+
+		static std::string json();
+		static bool write(const char *fileName);
+
+	private:
+		static bool initialize();
+
+		static bool enabled;
+	};
+
+	class TraceScope
+	{
+	public:
+		explicit TraceScope(const char *name) : name(Tracer::isEnabled() ? name : nullptr)
+		{
+			if(this->name)
+			{
+				Tracer::begin(this->name);
+			}
+		}
+
+		~TraceScope()
+		{
+			if(name)
+			{
+				Tracer::end(name);
+			}
+		}
+
+	private:
+		const char *const name;
+	};
+}
+
+#endif   // sw_Tracer_hpp
@@ -20,6 +20,7 @@
 namespace sw
 {
 	Profiler profiler;
+	bool pipelineCounters = false;
 
 	Profiler::Profiler()
 	{
@@ -32,6 +33,13 @@ namespace sw
 		framesTotal = 0;
 		FPS = 0;
 
+		for(int i = 0; i < PIPELINE_COUNTERS; i++)
+		{
+			counters[i] = 0;
+			countersFrame[i] = 0;
+			countersTotal[i] = 0;
+		}
+
 		#if PERF_PROFILE
 			for(int i = 0; i < PERF_TIMERS; i++)
 			{
@@ -54,6 +62,12 @@ namespace sw
 
 	void Profiler::nextFrame()
 	{
+		for(int i = 0; i < PIPELINE_COUNTERS; i++)
+		{
+			countersFrame[i] = sw::atomicExchange(&counters[i], 0);
+			countersTotal[i] += countersFrame[i];
+		}
+
 		#if PERF_PROFILE
 			ropOperationsFrame = sw::atomicExchange(&ropOperations, 0);
 			texOperationsFrame = sw::atomicExchange(&texOperations, 0);
@@ -79,4 +93,18 @@ namespace sw
 			framesSec = 0;
 		}
 	}
-}
\ No newline at end of file
+
+	void Profiler::count(PipelineCounter counter, int value)
+	{
+		if(value != 0)
+		{
+			sw::atomicAdd(&counters[counter], value);
+		}
+	}
+
+	void Profiler::countCompile(double seconds)
+	{
+		count(COUNTER_ROUTINE_CACHE_MISSES, 1);
+		count(COUNTER_COMPILE_MICROSECONDS, (int)(seconds * 1.0e6));
+	}
+}
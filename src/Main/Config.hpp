@@ -43,6 +43,26 @@ namespace sw
 		PERF_TIMERS
 	};
 
+	// Runtime pipeline statistics, collected when the PipelineCounters setting is enabled
+	enum PipelineCounter
+	{
+		COUNTER_VERTICES_SHADED,        // Vertex shader invocations, in groups of four
+		COUNTER_VERTEX_CACHE_LOOKUPS,
+		COUNTER_VERTEX_CACHE_HITS,
+		COUNTER_PRIMITIVES,
+		COUNTER_PRIMITIVES_CULLED,
+		COUNTER_TRIANGLES_CLIPPED,
+		COUNTER_QUADS_SHADED,
+		COUNTER_QUADS_DEPTH_KILLED,
+		COUNTER_TEXTURE_SAMPLES,        // Per pixel
+		COUNTER_ROUTINE_CACHE_HITS,
+		COUNTER_ROUTINE_CACHE_MISSES,   // Each miss compiles a routine
+		COUNTER_COMPILE_MICROSECONDS,
+		COUNTER_ROUTINES_OPTIMIZED,     // Baseline routines replaced by tiered compilation
+
+		PIPELINE_COUNTERS
+	};
+
 	struct Profiler
 	{
 		Profiler();
@@ -50,10 +70,17 @@ namespace sw
 		void reset();
 		void nextFrame();
 
+		void count(PipelineCounter counter, int value);
+		void countCompile(double seconds);   // Routine cache miss
+
 		int framesSec;
 		int framesTotal;
 		double FPS;
 
+		volatile int counters[PIPELINE_COUNTERS];   // Current frame, still accumulating
+		int countersFrame[PIPELINE_COUNTERS];       // Last completed frame
+		int64_t countersTotal[PIPELINE_COUNTERS];
+
 		#if PERF_PROFILE
 		double cycles[PERF_TIMERS];
 
@@ -72,6 +99,7 @@ namespace sw
 	};
 
 	extern Profiler profiler;
+	extern bool pipelineCounters;
 
 	enum
 	{
@@ -96,6 +124,9 @@ namespace sw
 		MAX_PROGRAM_TEXEL_OFFSET = 7,
 		MAX_TEXTURE_LOD = MIPMAP_LEVELS - 2,   // Trilinear accesses lod+1
 		RENDERTARGETS = 8,
+		MAX_UNIFORM_CONDITIONS = 8,         // Uniforms deciding control flow which routines can be specialized on
+		MAX_UNIFORM_SPECIALIZATIONS = 16,   // Per shader, after which its routines stop being specialized
+		MAX_SAMPLER_SPECIALIZATIONS = 16,   // Per shader, after which its routines stop being specialized on texture traits
 		NUM_TEMPORARY_REGISTERS = 4096,
 	};
 }
@@ -16,6 +16,8 @@
 
 #include "Config.hpp"
 #include "Common/Configurator.hpp"
+#include "Common/Memory.hpp"
+#include "Common/Tracer.hpp"
 #include "Common/Debug.hpp"
 #include "Common/Version.h"
 
@@ -178,6 +180,18 @@ namespace sw
 				{
 					return send(clientSocket, OK, page());
 				}
+				else if(match(&request, "/counters "))
+				{
+					return send(clientSocket, OK, counters(), "application/json");
+				}
+				else if(match(&request, "/trace "))
+				{
+					return send(clientSocket, OK, Tracer::json(), "application/json");
+				}
+			}
+			else if(match(&request, "metrics "))
+			{
+				return send(clientSocket, OK, metrics(), "text/plain; version=0.0.4");
 			}
 		}
 		else if(match(&request, "POST /"))
@@ -338,6 +352,7 @@ namespace sw
 		html += "<option value='64'"   + (config.vertexCacheSize == 64   ? selected : empty) + ">64 (default)</option>\n";
 		html += "</select></td>\n";
 		html += "</tr>\n";
+		html += "<tr><td>Shade unique vertices:</td><td><input name = 'shadeUniqueVertices' type='checkbox'" + (config.shadeUniqueVertices ? checked : empty) + " title='If checked indexed draws with a compact index range shade each vertex once, instead of relying on the vertex cache.'></td></tr>";
 		html += "</table>\n";
 		html += "<h2><em>Quality</em></h2>\n";
 		html += "<table>\n";
@@ -417,6 +432,9 @@ namespace sw
 			html += "</select></td></tr>\n";
 		}
 
+		html += "<tr><td>Tiered compilation:</td><td><input name = 'tieredCompilation' type='checkbox'" + (config.tieredCompilation == true ? checked : empty) + " title='If checked vertex and pixel routines are first compiled with minimal optimization, and recompiled in the background with the optimization passes above once they are used frequently. Only the LLVM backend has a baseline tier.'></td></tr>";
+		html += "<tr><td>Specialize on uniforms:</td><td><input name = 'specializeUniforms' type='checkbox'" + (config.specializeUniforms == true ? checked : empty) + " title='If checked vertex and pixel routines are compiled for the current values of the uniforms which decide their branches and loop counts, up to 16 variants per shader.'></td></tr>";
+		html += "<tr><td>Specialize on textures:</td><td><input name = 'specializeSamplers' type='checkbox'" + (config.specializeSamplers == true ? checked : empty) + " title='If checked vertex and pixel routines sampling single level 2D textures with power-of-two dimensions are compiled for their sizes, up to 16 variants per shader.'></td></tr>";
 		html += "</table>\n";
 		html += "<h2><em>Testing & Experimental</em></h2>\n";
 		html += "<table>\n";
@@ -439,6 +457,9 @@ namespace sw
 		html += "<option value='3'" + (config.shadowMapping == 3 ? selected : empty) + ">Fetch4 & DST (default)</option>\n";
 		html += "</select></td>\n";
 		html += "<tr><td>Force clearing registers that have no default value:</td><td><input name = 'forceClearRegisters' type='checkbox'" + (config.forceClearRegisters == true ? checked : empty) + " title='Initializes shader register values to 0 even if they have no default.'></td></tr>";
+		html += "<tr><td>Compressed texture sampling:</td><td><input name = 'compressedTextureSampling' type='checkbox'" + (config.compressedTextureSampling == true ? checked : empty) + " title='If checked DXT, ATI and ETC2 compressed textures are sampled directly instead of being decompressed.'></td></tr>";
+		html += "<tr><td>Tiled texture layout:</td><td><input name = 'tiledTextureLayout' type='checkbox'" + (config.tiledTextureLayout == true ? checked : empty) + " title='If checked 2D textures are sampled from a copy stored in Morton ordered 64x64 texel tiles, which improves locality for rotated geometry.'></td></tr>";
+		html += "<tr><td>Pipeline counters:</td><td><input name = 'pipelineCounters' type='checkbox'" + (config.pipelineCounters == true ? checked : empty) + " title='If checked vertex, primitive, pixel and routine cache statistics are collected, and served at /swiftshader/counters (JSON) and /metrics (Prometheus).'></td></tr>";
 		html += "</table>\n";
 	#ifndef NDEBUG
 		html += "<h2><em>Debugging</em></h2>\n";
@@ -511,7 +532,98 @@ namespace sw
 		return html;
 	}
 
-	void SwiftConfig::send(Socket *clientSocket, Status code, std::string body)
+	struct CounterInfo
+	{
+		const char *name;
+		const char *help;
+	};
+
+	static const CounterInfo counterInfo[PIPELINE_COUNTERS] =
+	{
+		{"vertices_shaded",        "Vertices processed by the vertex shader, in groups of four"},
+		{"vertex_cache_lookups",   "Vertices referenced by primitives"},
+		{"vertex_cache_hits",      "Vertex references served from the vertex cache"},
+		{"primitives",             "Primitives submitted to setup"},
+		{"primitives_culled",      "Primitives rejected by culling, clipping or setup"},
+		{"triangles_clipped",      "Triangles crossing a clip plane outside the guard band"},
+		{"quads_shaded",           "2x2 pixel quads processed by the pixel shader"},
+		{"quads_depth_killed",     "2x2 pixel quads rejected by the depth test"},
+		{"texture_samples",        "Texture samples taken by pixel shaders, per pixel"},
+		{"routine_cache_hits",     "Routine lookups served from the cache"},
+		{"routine_cache_misses",   "Routine lookups that required compilation"},
+		{"compile_microseconds",   "Time spent generating routines"},
+		{"routines_optimized",     "Frequently used baseline routines replaced by optimized ones"},
+	};
+
+	std::string SwiftConfig::counters()
+	{
+		std::string json;
+
+		json += "{\n";
+		json += "\"enabled\": " + std::string(pipelineCounters ? "true" : "false") + ",\n";
+		json += "\"fps\": " + ftoa(profiler.FPS) + ",\n";
+		json += "\"frame\": {";
+
+		for(int i = 0; i < PIPELINE_COUNTERS; i++)
+		{
+			json += std::string(i ? ", " : "") + "\"" + counterInfo[i].name + "\": " + itoa(profiler.countersFrame[i]);
+		}
+
+		json += "},\n";
+		json += "\"total\": {";
+
+		for(int i = 0; i < PIPELINE_COUNTERS; i++)
+		{
+			std::stringstream total;
+			total << profiler.countersTotal[i] + profiler.counters[i];
+
+			json += std::string(i ? ", " : "") + "\"" + counterInfo[i].name + "\": " + total.str();
+		}
+
+		json += "},\n";
+
+		int lookups = profiler.countersFrame[COUNTER_VERTEX_CACHE_LOOKUPS];
+		double hitRate = lookups ? (double)profiler.countersFrame[COUNTER_VERTEX_CACHE_HITS] / lookups : 0.0;
+		json += "\"vertex_cache_hit_rate\": " + ftoa(hitRate) + "\n";
+		json += "}\n";
+
+		return json;
+	}
+
+	std::string SwiftConfig::metrics()
+	{
+		std::string text;
+
+		for(int i = 0; i < PIPELINE_COUNTERS; i++)
+		{
+			std::string name = std::string("swiftshader_") + counterInfo[i].name + "_total";
+			std::stringstream total;
+			total << profiler.countersTotal[i] + profiler.counters[i];
+
+			text += "# HELP " + name + " " + counterInfo[i].help + "\n";
+			text += "# TYPE " + name + " counter\n";
+			text += name + " " + total.str() + "\n";
+		}
+
+		ExecutableMemoryStatistics code = executableMemoryStatistics();
+		std::stringstream codeBytes;
+		codeBytes << "swiftshader_code_heap_bytes{kind=\"reserved\"} " << code.reservedBytes << "\n";
+		codeBytes << "swiftshader_code_heap_bytes{kind=\"allocated\"} " << code.allocatedBytes << "\n";
+		codeBytes << "swiftshader_code_heap_bytes{kind=\"free\"} " << code.freeBytes << "\n";
+		codeBytes << "swiftshader_code_heap_bytes{kind=\"largest_free_range\"} " << code.largestFreeRange << "\n";
+
+		text += "# HELP swiftshader_code_heap_bytes Executable memory used by generated routines\n";
+		text += "# TYPE swiftshader_code_heap_bytes gauge\n";
+		text += codeBytes.str();
+
+		text += "# HELP swiftshader_fps Frames per second\n";
+		text += "# TYPE swiftshader_fps gauge\n";
+		text += "swiftshader_fps " + ftoa(profiler.FPS) + "\n";
+
+		return text;
+	}
+
+	void SwiftConfig::send(Socket *clientSocket, Status code, std::string body, const char *contentType)
 	{
 		std::string status;
 		char header[1024];
@@ -522,10 +634,10 @@ namespace sw
 		case NotFound: status += "HTTP/1.1 404 Not Found\r\n"; break;
 		}
 
-		sprintf(header, "Content-Type: text/html; charset=UTF-8\r\n"
+		sprintf(header, "Content-Type: %s\r\n"
 						"Content-Length: %zd\r\n"
 						"Host: localhost\r\n"
-						"\r\n", body.size());
+						"\r\n", contentType, body.size());
 
 		std::string message = status + header + body;
 		clientSocket->send(message.c_str(), (int)message.length());
@@ -548,6 +660,13 @@ namespace sw
 		config.disable10BitMode = false;
 		config.precache = false;
 		config.forceClearRegisters = false;
+		config.compressedTextureSampling = false;
+		config.tiledTextureLayout = false;
+		config.tieredCompilation = false;
+		config.specializeUniforms = false;
+		config.specializeSamplers = false;
+		config.pipelineCounters = false;
+		config.shadeUniqueVertices = false;
 
 		while(*post != 0)
 		{
@@ -586,6 +705,10 @@ namespace sw
 			{
 				config.vertexCacheSize = integer;
 			}
+			else if(strstr(post, "shadeUniqueVertices=on"))
+			{
+				config.shadeUniqueVertices = true;
+			}
 			else if(sscanf(post, "textureSampleQuality=%d", &integer))
 			{
 				config.textureSampleQuality = integer;
@@ -654,6 +777,18 @@ namespace sw
 			{
 				config.optimization[index - 1] = (Optimization)integer;
 			}
+			else if(strstr(post, "tieredCompilation=on"))
+			{
+				config.tieredCompilation = true;
+			}
+			else if(strstr(post, "specializeUniforms=on"))
+			{
+				config.specializeUniforms = true;
+			}
+			else if(strstr(post, "specializeSamplers=on"))
+			{
+				config.specializeSamplers = true;
+			}
 			else if(strstr(post, "disableServer=on"))
 			{
 				config.disableServer = true;
@@ -690,6 +825,18 @@ namespace sw
 			{
 				config.forceClearRegisters = true;
 			}
+			else if(strstr(post, "compressedTextureSampling=on"))
+			{
+				config.compressedTextureSampling = true;
+			}
+			else if(strstr(post, "tiledTextureLayout=on"))
+			{
+				config.tiledTextureLayout = true;
+			}
+			else if(strstr(post, "pipelineCounters=on"))
+			{
+				config.pipelineCounters = true;
+			}
 		#ifndef NDEBUG
 			else if(sscanf(post, "minPrimitives=%d", &integer))
 			{
@@ -725,6 +872,7 @@ namespace sw
 		config.pixelRoutineCacheSize = ini.getInteger("Caches", "PixelRoutineCacheSize", 1024);
 		config.setupRoutineCacheSize = ini.getInteger("Caches", "SetupRoutineCacheSize", 1024);
 		config.vertexCacheSize = ini.getInteger("Caches", "VertexCacheSize", 64);
+		config.shadeUniqueVertices = ini.getBoolean("Caches", "ShadeUniqueVertices", false);
 		config.textureSampleQuality = ini.getInteger("Quality", "TextureSampleQuality", 2);
 		config.mipmapQuality = ini.getInteger("Quality", "MipmapQuality", 1);
 		config.perspectiveCorrection = ini.getBoolean("Quality", "PerspectiveCorrection", true);
@@ -742,6 +890,10 @@ namespace sw
 			config.optimization[pass] = (Optimization)ini.getInteger("Optimization", "OptimizationPass" + itoa(pass + 1), pass == 0 ? InstructionCombining : Disabled);
 		}
 
+		config.tieredCompilation = ini.getBoolean("Optimization", "TieredCompilation", false);
+		config.specializeUniforms = ini.getBoolean("Optimization", "SpecializeUniforms", false);
+		config.specializeSamplers = ini.getBoolean("Optimization", "SpecializeSamplers", false);
+
 		config.disableServer = ini.getBoolean("Testing", "DisableServer", false);
 		config.forceWindowed = ini.getBoolean("Testing", "ForceWindowed", false);
 		config.complementaryDepthBuffer = ini.getBoolean("Testing", "ComplementaryDepthBuffer", false);
@@ -753,6 +905,9 @@ namespace sw
 		config.precache = ini.getBoolean("Testing", "Precache", false);
 		config.shadowMapping = ini.getInteger("Testing", "ShadowMapping", 3);
 		config.forceClearRegisters = ini.getBoolean("Testing", "ForceClearRegisters", false);
+		config.compressedTextureSampling = ini.getBoolean("Testing", "CompressedTextureSampling", false);
+		config.tiledTextureLayout = ini.getBoolean("Testing", "TiledTextureLayout", false);
+		config.pipelineCounters = ini.getBoolean("Testing", "PipelineCounters", false);
 
 	#ifndef NDEBUG
 		config.minPrimitives = 1;
@@ -765,7 +920,8 @@ namespace sw
 		bool noConfig = stat("SwiftShader.ini", &status) != 0;
 		newConfig = !noConfig && abs((int)status.st_mtime - lastModified) > 1;
 
-		if(disableServerOverride)
+		// Collected counters and traces are only reachable through the server
+		if(disableServerOverride && !config.pipelineCounters && !Tracer::isEnabled())
 		{
 			config.disableServer = true;
 		}
@@ -783,6 +939,7 @@ namespace sw
 		ini.addValue("Caches", "PixelRoutineCacheSize", itoa(config.pixelRoutineCacheSize));
 		ini.addValue("Caches", "SetupRoutineCacheSize", itoa(config.setupRoutineCacheSize));
 		ini.addValue("Caches", "VertexCacheSize", itoa(config.vertexCacheSize));
+		ini.addValue("Caches", "ShadeUniqueVertices", itoa(config.shadeUniqueVertices));
 		ini.addValue("Quality", "TextureSampleQuality", itoa(config.textureSampleQuality));
 		ini.addValue("Quality", "MipmapQuality", itoa(config.mipmapQuality));
 		ini.addValue("Quality", "PerspectiveCorrection", itoa(config.perspectiveCorrection));
@@ -800,6 +957,10 @@ namespace sw
 			ini.addValue("Optimization", "OptimizationPass" + itoa(pass + 1), itoa(config.optimization[pass]));
 		}
 
+		ini.addValue("Optimization", "TieredCompilation", itoa(config.tieredCompilation));
+		ini.addValue("Optimization", "SpecializeUniforms", itoa(config.specializeUniforms));
+		ini.addValue("Optimization", "SpecializeSamplers", itoa(config.specializeSamplers));
+
 		ini.addValue("Testing", "DisableServer", itoa(config.disableServer));
 		ini.addValue("Testing", "ForceWindowed", itoa(config.forceWindowed));
 		ini.addValue("Testing", "ComplementaryDepthBuffer", itoa(config.complementaryDepthBuffer));
@@ -811,6 +972,9 @@ namespace sw
 		ini.addValue("Testing", "Precache", itoa(config.precache));
 		ini.addValue("Testing", "ShadowMapping", itoa(config.shadowMapping));
 		ini.addValue("Testing", "ForceClearRegisters", itoa(config.forceClearRegisters));
+		ini.addValue("Testing", "CompressedTextureSampling", itoa(config.compressedTextureSampling));
+		ini.addValue("Testing", "TiledTextureLayout", itoa(config.tiledTextureLayout));
+		ini.addValue("Testing", "PipelineCounters", itoa(config.pipelineCounters));
 		ini.addValue("LastModified", "Time", itoa((int)time(0)));
 
 		ini.writeFile("SwiftShader Configuration File\n"
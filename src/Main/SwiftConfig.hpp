@@ -38,6 +38,7 @@ namespace sw
 			int pixelRoutineCacheSize;
 			int setupRoutineCacheSize;
 			int vertexCacheSize;
+			bool shadeUniqueVertices;
 			int textureSampleQuality;
 			int mipmapQuality;
 			bool perspectiveCorrection;
@@ -49,6 +50,9 @@ namespace sw
 			bool enableSSSE3;
 			bool enableSSE4_1;
 			Optimization optimization[10];
+			bool tieredCompilation;
+			bool specializeUniforms;
+			bool specializeSamplers;
 			bool disableServer;
 			bool keepSystemCursor;
 			bool forceWindowed;
@@ -62,6 +66,9 @@ namespace sw
 			bool precache;
 			int shadowMapping;
 			bool forceClearRegisters;
+			bool compressedTextureSampling;
+			bool tiledTextureLayout;
+			bool pipelineCounters;
 		#ifndef NDEBUG
 			unsigned int minPrimitives;
 			unsigned int maxPrimitives;
@@ -91,7 +98,9 @@ namespace sw
 		void respond(Socket *clientSocket, const char *request);
 		std::string page();
 		std::string profile();
-		void send(Socket *clientSocket, Status code, std::string body = "");
+		std::string counters();
+		std::string metrics();
+		void send(Socket *clientSocket, Status code, std::string body = "", const char *contentType = "text/html; charset=UTF-8");
 		void parsePost(const char *post);
 
 		void readConfiguration(bool disableServerOverride = false);
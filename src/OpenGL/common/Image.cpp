@@ -1422,6 +1422,16 @@ namespace egl
 			return clientBuffer.lock(x, y, z);
 		}
 
+		bool isTileable() const override
+		{
+			return false;   // The client buffer is sampled directly
+		}
+
+		void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock) override
+		{
+			return this->lock(x, y, z, lock);   // Writes go to the client buffer, which is tracked as a whole
+		}
+
 		void unlock() override
 		{
 			LOGLOCK("image=%p op=%s.ani", this, __FUNCTION__);
@@ -1861,7 +1871,7 @@ namespace egl
 		GLsizei inputHeight = (unpackParameters.imageHeight == 0) ? height : unpackParameters.imageHeight;
 		char *input = ((char*)pixels) + gl::ComputePackingOffset(format, type, inputWidth, inputHeight, unpackParameters);
 
-		void *buffer = lock(xoffset, yoffset, zoffset, sw::LOCK_WRITEONLY);
+		void *buffer = lock(xoffset, yoffset, zoffset, width, height, depth, sw::LOCK_WRITEONLY);
 
 		if(buffer)
 		{
@@ -1889,7 +1899,7 @@ namespace egl
 		int inputSlice = imageSize / depth;
 		int rows = inputSlice / inputPitch;
 
-		void *buffer = lock(xoffset, yoffset, zoffset, sw::LOCK_WRITEONLY);
+		void *buffer = lock(xoffset, yoffset, zoffset, width, height, depth, sw::LOCK_WRITEONLY);
 
 		if(buffer)
 		{
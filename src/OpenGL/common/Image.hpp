@@ -185,6 +185,11 @@ public:
 		return lockExternal(x, y, z, lock, sw::PUBLIC);
 	}
 
+	virtual void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock)
+	{
+		return lockExternal(x, y, z, width, height, depth, lock, sw::PUBLIC);
+	}
+
 	unsigned int getPitch() const
 	{
 		return getExternalPitchB();
@@ -332,6 +337,16 @@ private:
 		return lockNativeBuffer(GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN);
 	}
 
+	bool isTileable() const override
+	{
+		return false;   // The native buffer is sampled directly
+	}
+
+	void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock) override
+	{
+		return this->lock(x, y, z, lock);   // Writes go to the native buffer, which is tracked as a whole
+	}
+
 	void unlock() override
 	{
 		LOGLOCK("image=%p op=%s.ani", this, __FUNCTION__);
@@ -21,16 +21,21 @@
 #include "Object.hpp"
 #include "debug.h"
 
-#include <map>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace gl
 {
 
+// Names below the dense table's size are looked up by direct indexing. Names
+// far beyond it, which can only be chosen by the application, are kept in a
+// hash map so that they don't inflate the table.
 template<class ObjectType, GLuint baseName = 1>
 class NameSpace
 {
 public:
-	NameSpace() : freeName(baseName)
+	NameSpace() : reservedCount(0), lowestReserved(0)
 	{
 	}
 
@@ -41,74 +46,160 @@ public:
 
 	bool empty()
 	{
-		return map.empty();
+		return reservedCount == 0 && sparse.empty();
 	}
 
-	GLuint firstName()
+	GLuint firstName()   // Lowest name in the dense table, if any
 	{
-		return map.begin()->first;
+		if(reservedCount > 0)
+		{
+			while(!table[lowestReserved].reserved)
+			{
+				lowestReserved++;
+			}
+
+			return lowestReserved;
+		}
+
+		return sparse.begin()->first;
 	}
 
 	GLuint lastName()
 	{
-		return map.rbegin()->first;
+		if(!sparse.empty())   // Sparse names all lie beyond the table
+		{
+			GLuint name = 0;
+
+			for(auto &element : sparse)
+			{
+				name = std::max(name, element.first);
+			}
+
+			return name;
+		}
+
+		GLuint name = static_cast<GLuint>(table.size()) - 1;
+
+		while(!table[name].reserved)
+		{
+			name--;
+		}
+
+		return name;
 	}
 
 	GLuint allocate(ObjectType *object = nullptr)
 	{
-		GLuint name = freeName;
-
-		while(isReserved(name))
+		while(true)
 		{
-			name++;
-		}
+			if(freeNames.empty())
+			{
+				grow(std::max<size_t>(table.size() * 2, minimumTableSize));
+			}
 
-		map.insert({name, object});
-		freeName = name + 1;
+			GLuint name = freeNames.back();
+			freeNames.pop_back();
 
-		return name;
+			if(!table[name].reserved)   // Names reserved through insert() aren't removed from the free list
+			{
+				reserve(name, object);
+
+				return name;
+			}
+		}
 	}
 
 	bool isReserved(GLuint name) const
 	{
-		return map.find(name) != map.end();
+		if(name < table.size())
+		{
+			return table[name].reserved;
+		}
+
+		return !sparse.empty() && sparse.find(name) != sparse.end();
 	}
 
 	void insert(GLuint name, ObjectType *object)
 	{
-		map[name] = object;
+		if(name >= table.size() && name < std::max<size_t>(table.size() * 2, minimumTableSize))
+		{
+			grow(std::max<size_t>(table.size() * 2, minimumTableSize));
+		}
 
-		if(name == freeName)
+		if(name < table.size())
+		{
+			if(table[name].reserved)
+			{
+				table[name].object = object;
+			}
+			else
+			{
+				reserve(name, object);
+			}
+		}
+		else
 		{
-			freeName++;
+			sparse[name] = object;
 		}
 	}
 
 	ObjectType *remove(GLuint name)
 	{
-		auto element = map.find(name);
-
-		if(element != map.end())
+		if(name < table.size())
 		{
-			ObjectType *object = element->second;
-			map.erase(element);
+			Entry &entry = table[name];
 
-			if(name < freeName)
+			if(!entry.reserved)
 			{
-				freeName = name;
+				return nullptr;
+			}
+
+			ObjectType *object = entry.object;
+			entry.object = nullptr;
+			entry.reserved = false;
+			reservedCount--;
+
+			if(name >= baseName)
+			{
+				freeNames.push_back(name);
+
+				if(freeNames.size() > table.size())
+				{
+					collectFreeNames();
+				}
 			}
 
 			return object;
 		}
 
+		auto element = sparse.find(name);
+
+		if(element != sparse.end())
+		{
+			ObjectType *object = element->second;
+			sparse.erase(element);
+
+			return object;
+		}
+
 		return nullptr;
 	}
 
 	ObjectType *find(GLuint name) const
 	{
-		auto element = map.find(name);
+		if(name < table.size())
+		{
+			return table[name].object;
+		}
 
-		if(element == map.end())
+		if(sparse.empty())
+		{
+			return nullptr;
+		}
+
+		auto element = sparse.find(name);
+
+		if(element == sparse.end())
 		{
 			return nullptr;
 		}
@@ -117,10 +208,78 @@ public:
 	}
 
 private:
-	typedef std::map<GLuint, ObjectType*> Map;
-	Map map;
+	enum {minimumTableSize = 64};
+
+	struct Entry
+	{
+		ObjectType *object;
+		bool reserved;
+	};
+
+	void reserve(GLuint name, ObjectType *object)
+	{
+		table[name].object = object;
+		table[name].reserved = true;
+		reservedCount++;
+
+		if(name < lowestReserved)
+		{
+			lowestReserved = name;
+		}
+	}
+
+	// Extends the dense table, moving sparse names which now fall within it,
+	// and queues the new free names so that the lowest ones get handed out first.
+	void grow(size_t size)
+	{
+		size_t oldSize = table.size();
+		table.resize(size, Entry{nullptr, false});
+
+		for(size_t i = size; i > oldSize; i--)
+		{
+			GLuint name = static_cast<GLuint>(i - 1);
+
+			if(!sparse.empty())
+			{
+				auto element = sparse.find(name);
+
+				if(element != sparse.end())
+				{
+					reserve(name, element->second);
+					sparse.erase(element);
+					continue;
+				}
+			}
+
+			if(name >= baseName)
+			{
+				freeNames.push_back(name);
+			}
+		}
+	}
+
+	// Rebuilds the free list without the stale entries left by insert()
+	void collectFreeNames()
+	{
+		freeNames.clear();
+
+		for(size_t i = table.size(); i > baseName; i--)
+		{
+			GLuint name = static_cast<GLuint>(i - 1);
+
+			if(!table[name].reserved)
+			{
+				freeNames.push_back(name);
+			}
+		}
+	}
+
+	std::vector<Entry> table;                          // Indexed by name
+	std::unordered_map<GLuint, ObjectType*> sparse;   // Names beyond the table
+	std::vector<GLuint> freeNames;                     // Names for allocate() to hand out, from the back
 
-	GLuint freeName;   // Lowest known potentially free name
+	size_t reservedCount;     // Reserved names in the table
+	GLuint lowestReserved;    // No name below this one is reserved in the table
 };
 
 }
@@ -22,6 +22,8 @@
 
 namespace gl
 {
+static sw::AtomicInt generation(0);
+
 #ifndef NDEBUG
 sw::MutexLock Object::instances_mutex;
 std::set<Object*> Object::instances;
@@ -87,6 +89,11 @@ NamedObject::~NamedObject()
 {
 }
 
+unsigned int NewGeneration()
+{
+	return generation++;   // Returns the incremented value
+}
+
 #ifndef NDEBUG
 struct ObjectLeakCheck
 {
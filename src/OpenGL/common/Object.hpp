@@ -106,6 +106,10 @@ private:
 	ObjectType *object;
 };
 
+// Returns a process-wide unique value for tagging object state changes, so that
+// cached state can't be mistaken for that of a new object at a reused address.
+unsigned int NewGeneration();
+
 }
 
 #endif   // gl_Object_hpp
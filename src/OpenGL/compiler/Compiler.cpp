@@ -21,6 +21,11 @@
 #include "ParseHelper.h"
 #include "ValidateLimitations.h"
 
+#include "Common/MutexLock.hpp"
+
+#include <string.h>
+#include <vector>
+
 namespace
 {
 class TScopedPoolAllocator {
@@ -41,6 +46,19 @@ private:
 	TPoolAllocator* mAllocator;
 	bool mPushPopAllocator;
 };
+
+// Built-in symbols only depend on the shader type and resources. They are
+// built once for each configuration, then shared read-only by all compilers.
+struct TBuiltInSymbols
+{
+	GLenum shaderType;
+	ShBuiltInResources resources;
+	TSymbolTable symbolTable;
+};
+
+sw::MutexLock builtInMutex;
+TPoolAllocator *builtInAllocator = nullptr;   // Never popped
+std::vector<TBuiltInSymbols*> builtInSymbols;
 }  // namespace
 
 //
@@ -164,6 +182,51 @@ bool TCompiler::compile(const char* const shaderStrings[],
 bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
 	assert(symbolTable.isEmpty());
+
+	builtInMutex.lock();
+
+	TBuiltInSymbols *builtIns = nullptr;
+
+	for(TBuiltInSymbols *candidate : builtInSymbols)
+	{
+		if(candidate->shaderType == shaderType && memcmp(&candidate->resources, &resources, sizeof(ShBuiltInResources)) == 0)
+		{
+			builtIns = candidate;
+			break;
+		}
+	}
+
+	if(!builtIns)
+	{
+		if(!builtInAllocator)
+		{
+			builtInAllocator = new TPoolAllocator();
+			builtInAllocator->push();
+		}
+
+		TPoolAllocator *allocator = GetGlobalPoolAllocator();
+		SetGlobalPoolAllocator(builtInAllocator);
+
+		builtIns = new TBuiltInSymbols;
+		builtIns->shaderType = shaderType;
+		builtIns->resources = resources;
+		InsertBuiltInSymbols(shaderType, resources, builtIns->symbolTable);
+		builtIns->symbolTable.finalizeBuiltIns();
+		builtInSymbols.push_back(builtIns);
+
+		SetGlobalPoolAllocator(allocator);
+	}
+
+	builtInMutex.unlock();
+
+	// User-defined symbols are pushed on top of the shared built-in levels
+	symbolTable.shareBuiltIns(builtIns->symbolTable);
+
+	return true;
+}
+
+void TCompiler::InsertBuiltInSymbols(GLenum shaderType, const ShBuiltInResources &resources, TSymbolTable &symbolTable)
+{
 	symbolTable.push();   // COMMON_BUILTINS
 	symbolTable.push();   // ESSL1_BUILTINS
 	symbolTable.push();   // ESSL3_BUILTINS
@@ -195,8 +258,6 @@ bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 	InsertBuiltInFunctions(shaderType, resources, symbolTable);
 
 	IdentifyBuiltIns(shaderType, resources, symbolTable);
-
-	return true;
 }
 
 void TCompiler::clearResults()
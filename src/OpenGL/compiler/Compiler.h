@@ -91,6 +91,7 @@ protected:
 	GLenum getShaderType() const { return shaderType; }
 	// Initialize symbol-table with built-in symbols.
 	bool InitBuiltInSymbolTable(const ShBuiltInResources& resources);
+	static void InsertBuiltInSymbols(GLenum shaderType, const ShBuiltInResources& resources, TSymbolTable& symbolTable);
 	// Clears the results from the previous compilation.
 	void clearResults();
 	// Return true if function recursion is detected or call depth exceeded.
@@ -109,7 +110,7 @@ private:
 	unsigned int maxCallStackDepth;
 
 	// Built-in symbol table for the given language, spec, and resources.
-	// It is preserved from compile-to-compile.
+	// The built-in levels are shared between compilers and preserved from compile-to-compile.
 	TSymbolTable symbolTable;
 	// Built-in extensions with default behavior.
 	TExtensionBehavior extensionBehavior;
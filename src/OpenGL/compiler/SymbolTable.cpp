@@ -227,6 +227,19 @@ TSymbol *TSymbolTableLevel::find(const TString &name) const
 		return (*it).second;
 }
 
+void TSymbolTableLevel::finalize()
+{
+	for(tLevel::iterator it = level.begin(); it != level.end(); ++it)
+	{
+		if(it->second->isVariable())
+		{
+			TType &type = static_cast<TVariable*>(it->second)->getType();
+			type.getMangledName();
+			type.getObjectSize();
+		}
+	}
+}
+
 TSymbol *TSymbolTable::find(const TString &name, int shaderVersion, bool *builtIn, bool *sameScope) const
 {
 	int level = currentLevel();
@@ -213,6 +213,9 @@ public:
 
 	TSymbol *find(const TString &name) const;
 
+	// Evaluates lazily computed type information, so the level can be shared read-only.
+	void finalize();
+
 	static int nextUniqueId()
 	{
 		return ++uniqueId;
@@ -300,7 +303,7 @@ class TSymbolTable
 {
 public:
 	TSymbolTable()
-		: mGlobalInvariant(false)
+		: mSharedBuiltIns(nullptr), mGlobalInvariant(false)
 	{
 		//
 		// The symbol table cannot be used until push() is called, but
@@ -318,6 +321,29 @@ public:
 	}
 
 	bool isEmpty() { return table.empty(); }
+
+	// Uses the built-in levels of another table, which must outlive this one and no longer change.
+	void shareBuiltIns(const TSymbolTable &builtIns)
+	{
+		assert(isEmpty() && builtIns.currentLevel() == LAST_BUILTIN_LEVEL);
+
+		for(int level = COMMON_BUILTINS; level <= LAST_BUILTIN_LEVEL; level++)
+		{
+			table.push_back(builtIns.table[level]);
+			precisionStack.push_back(builtIns.precisionStack[level]);
+		}
+
+		mSharedBuiltIns = &builtIns;
+	}
+
+	void finalizeBuiltIns()
+	{
+		for(int level = COMMON_BUILTINS; level <= LAST_BUILTIN_LEVEL; level++)
+		{
+			table[level]->finalize();
+		}
+	}
+
 	bool atBuiltInLevel() { return currentLevel() <= LAST_BUILTIN_LEVEL; }
 	bool atGlobalLevel() { return currentLevel() <= GLOBAL_LEVEL; }
 	void push()
@@ -512,7 +538,15 @@ public:
 	void setGlobalInvariant() { mGlobalInvariant = true; }
 	bool getGlobalInvariant() const { return mGlobalInvariant; }
 
-	bool hasUnmangledBuiltIn(const char *name) { return mUnmangledBuiltinNames.count(std::string(name)) > 0; }
+	bool hasUnmangledBuiltIn(const char *name) const
+	{
+		if(mSharedBuiltIns)
+		{
+			return mSharedBuiltIns->hasUnmangledBuiltIn(name);
+		}
+
+		return mUnmangledBuiltinNames.count(std::string(name)) > 0;
+	}
 
 private:
 	// Used to insert unmangled functions to check redeclaration of built-ins in ESSL 3.00.
@@ -526,6 +560,7 @@ protected:
 	std::vector< PrecisionStackLevel > precisionStack;
 
 	std::set<std::string> mUnmangledBuiltinNames;
+	const TSymbolTable *mSharedBuiltIns;
 
 	std::set<std::string> mInvariantVaryings;
 	bool mGlobalInvariant;
@@ -19,6 +19,7 @@
 #include "Config.h"
 
 #include "common/debug.h"
+#include "Main/Config.hpp"
 
 #include <EGL/eglext.h>
 #ifdef __ANDROID__
@@ -44,6 +45,8 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 	// Initialize to a high value to lower the preference of formats for which there's no native support
 	mNativeVisualID = 0x7FFFFFFF;
 
+	mMatchFormatKHR = EGL_NONE;
+
 	switch(renderTargetFormat)
 	{
 	case sw::FORMAT_A1R5G5B5:
@@ -64,6 +67,7 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 		mBlueSize = 8;
 		mAlphaSize = 8;
 		mBindToTextureRGBA = EGL_TRUE;
+		mMatchFormatKHR = EGL_FORMAT_RGBA_8888_KHR;
 		#ifdef __ANDROID__
 			mNativeVisualID = HAL_PIXEL_FORMAT_BGRA_8888;
 		#else
@@ -76,6 +80,7 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 		mBlueSize = 8;
 		mAlphaSize = 8;
 		mBindToTextureRGBA = EGL_TRUE;
+		mMatchFormatKHR = EGL_FORMAT_RGBA_8888_KHR;
 		#ifdef __ANDROID__
 			mNativeVisualID = HAL_PIXEL_FORMAT_RGBA_8888;
 		#endif
@@ -85,6 +90,7 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 		mGreenSize = 6;
 		mBlueSize = 5;
 		mAlphaSize = 0;
+		mMatchFormatKHR = EGL_FORMAT_RGB_565_KHR;
 		#ifdef __ANDROID__
 			mNativeVisualID = HAL_PIXEL_FORMAT_RGB_565;
 		#endif
@@ -95,6 +101,7 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 		mBlueSize = 8;
 		mAlphaSize = 0;
 		mBindToTextureRGB = EGL_TRUE;
+		mMatchFormatKHR = EGL_FORMAT_RGBA_8888_KHR;
 		#ifdef __ANDROID__
 			mNativeVisualID = 0x1FF;   // HAL_PIXEL_FORMAT_BGRX_8888
 		#else
@@ -107,6 +114,7 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 		mBlueSize = 8;
 		mAlphaSize = 0;
 		mBindToTextureRGB = EGL_TRUE;
+		mMatchFormatKHR = EGL_FORMAT_RGBA_8888_KHR;
 		#ifdef __ANDROID__
 			mNativeVisualID = HAL_PIXEL_FORMAT_RGBX_8888;
 		#endif
@@ -171,8 +179,8 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 
 	mLevel = 0;
 	mMatchNativePixmap = EGL_NONE;
-	mMaxPBufferWidth = 4096;
-	mMaxPBufferHeight = 4096;
+	mMaxPBufferWidth = sw::OUTLINE_RESOLUTION;
+	mMaxPBufferHeight = sw::OUTLINE_RESOLUTION;
 	mMaxPBufferPixels = mMaxPBufferWidth * mMaxPBufferHeight;
 	mMaxSwapInterval = maxInterval;
 	mMinSwapInterval = minInterval;
@@ -182,6 +190,12 @@ Config::Config(sw::Format displayFormat, EGLint minInterval, EGLint maxInterval,
 	mSampleBuffers = (multiSample > 0) ? 1 : 0;
 	mSamples = multiSample;
 	mSurfaceType = EGL_PBUFFER_BIT | EGL_WINDOW_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT | EGL_MULTISAMPLE_RESOLVE_BOX_BIT;
+
+	// Single-sampled surfaces of a supported format can be mapped directly, without any copies
+	if(multiSample <= 1 && mMatchFormatKHR != EGL_NONE)
+	{
+		mSurfaceType |= EGL_LOCK_SURFACE_BIT_KHR;
+	}
 	mTransparentType = EGL_NONE;
 	mTransparentRedValue = 0;
 	mTransparentGreenValue = 0;
@@ -387,6 +401,7 @@ bool ConfigSet::getConfigs(EGLConfig *configs, const EGLint *attribList, EGLint
 				case EGL_CONFORMANT:                 match = (config->mConformant & attribute[1]) == attribute[1];          break;
 				case EGL_RECORDABLE_ANDROID:         match = config->mRecordableAndroid == (EGLBoolean)attribute[1];        break;
 				case EGL_FRAMEBUFFER_TARGET_ANDROID: match = config->mFramebufferTargetAndroid == (EGLBoolean)attribute[1]; break;
+				case EGL_MATCH_FORMAT_KHR:           match = config->mMatchFormatKHR == (EGLenum)attribute[1];              break;
 
 				// Ignored attributes
 				case EGL_MAX_PBUFFER_WIDTH:
@@ -76,6 +76,7 @@ public:
 
 	EGLBoolean mRecordableAndroid;          // EGL_ANDROID_recordable
 	EGLBoolean mFramebufferTargetAndroid;   // EGL_ANDROID_framebuffer_target
+	EGLenum mMatchFormatKHR;                // EGL_KHR_lock_surface
 };
 
 struct CompareConfig
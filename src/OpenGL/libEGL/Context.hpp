@@ -32,6 +32,7 @@ class [[clang::lto_visibility_public]] Context : public gl::Object
 {
 public:
 	virtual void makeCurrent(gl::Surface *surface) = 0;
+	virtual void setThreadCurrent(bool current) = 0;   // Starts or stops being the calling thread's current context
 	virtual void bindTexImage(gl::Surface *surface) = 0;
 	virtual EGLenum validateSharedImage(EGLenum target, GLuint name, GLuint textureLevel) = 0;
 	virtual Image *createSharedImage(EGLenum target, GLuint name, GLuint textureLevel) = 0;
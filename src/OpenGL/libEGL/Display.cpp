@@ -277,6 +277,7 @@ bool Display::getConfigAttrib(EGLConfig config, EGLint attribute, EGLint *value)
 	case EGL_MAX_PBUFFER_PIXELS:         *value = configuration->mMaxPBufferPixels;         break;
 	case EGL_RECORDABLE_ANDROID:         *value = configuration->mRecordableAndroid;        break;
 	case EGL_FRAMEBUFFER_TARGET_ANDROID: *value = configuration->mFramebufferTargetAndroid; break;
+	case EGL_MATCH_FORMAT_KHR:           *value = configuration->mMatchFormatKHR;           break;
 	default:
 		return false;
 	}
@@ -448,6 +449,17 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 		return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
 	}
 
+	if(width > configuration->mMaxPBufferWidth || height > configuration->mMaxPBufferHeight)
+	{
+		if(!largestPBuffer)
+		{
+			return error(EGL_BAD_ALLOC, EGL_NO_SURFACE);
+		}
+
+		width = std::min(width, configuration->mMaxPBufferWidth);
+		height = std::min(height, configuration->mMaxPBufferHeight);
+	}
+
 	if((textureFormat != EGL_NO_TEXTURE && textureTarget == EGL_NO_TEXTURE) ||
 	   (textureFormat == EGL_NO_TEXTURE && textureTarget != EGL_NO_TEXTURE))
 	{
@@ -559,7 +571,7 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 	return success(surface);
 }
 
-EGLContext Display::createContext(EGLConfig configHandle, const egl::Context *shareContext, EGLint clientVersion)
+EGLContext Display::createContext(EGLConfig configHandle, const egl::Context *shareContext, EGLint clientVersion, bool noError)
 {
 	const egl::Config *config = mConfigSet.get(configHandle);
 	egl::Context *context = nullptr;
@@ -576,7 +588,7 @@ EGLContext Display::createContext(EGLConfig configHandle, const egl::Context *sh
 	{
 		if(libGLESv2)
 		{
-			context = libGLESv2->es2CreateContext(this, shareContext, config);
+			context = libGLESv2->es2CreateContext(this, shareContext, config, noError);
 		}
 	}
 	else
@@ -110,6 +110,8 @@ bool Surface::initialize()
 
 void Surface::deleteResources()
 {
+	unlockSurface();
+
 	if(depthStencil)
 	{
 		depthStencil->release();
@@ -292,6 +294,98 @@ egl::Texture *Surface::getBoundTexture() const
 	return texture;
 }
 
+bool Surface::isLockable() const
+{
+	return (config->mSurfaceType & EGL_LOCK_SURFACE_BIT_KHR) && backBuffer && !clientBuffer;
+}
+
+bool Surface::lockSurface(EGLint usageHint, EGLBoolean preservePixels)
+{
+	if(!isLockable() || isLocked())
+	{
+		return false;
+	}
+
+	sw::Lock lock = sw::LOCK_READWRITE;
+
+	if(usageHint == EGL_READ_SURFACE_BIT_KHR)
+	{
+		lock = sw::LOCK_READONLY;
+	}
+	else if(!(usageHint & EGL_READ_SURFACE_BIT_KHR) && !preservePixels)
+	{
+		lock = sw::LOCK_DISCARD;
+	}
+
+	// The back buffer's external memory aliases its internal one for lockable
+	// configs, so this waits for pending rendering but does not copy anything.
+	lockedBuffer = backBuffer->lock(0, 0, 0, lock);
+
+	return lockedBuffer != nullptr;
+}
+
+void Surface::unlockSurface()
+{
+	if(lockedBuffer)
+	{
+		backBuffer->unlock();
+		lockedBuffer = nullptr;
+	}
+}
+
+EGLAttribKHR Surface::getBitmapAttribute(EGLint attribute) const
+{
+	ASSERT(isLocked());
+
+	sw::Format format = backBuffer->getExternalFormat();
+
+	switch(attribute)
+	{
+	case EGL_BITMAP_POINTER_KHR:
+		return reinterpret_cast<EGLAttribKHR>(lockedBuffer);
+	case EGL_BITMAP_PITCH_KHR:
+		return backBuffer->getPitch();
+	case EGL_BITMAP_ORIGIN_KHR:
+		return EGL_LOWER_LEFT_KHR;
+	case EGL_BITMAP_PIXEL_SIZE_KHR:
+		return (config->mMatchFormatKHR == EGL_FORMAT_RGB_565_KHR) ? 16 : 32;
+	case EGL_BITMAP_PIXEL_RED_OFFSET_KHR:
+		switch(format)
+		{
+		case sw::FORMAT_A8R8G8B8:
+		case sw::FORMAT_X8R8G8B8: return 16;
+		case sw::FORMAT_R5G6B5:   return 11;
+		default:                  return 0;
+		}
+	case EGL_BITMAP_PIXEL_GREEN_OFFSET_KHR:
+		switch(format)
+		{
+		case sw::FORMAT_R5G6B5: return 5;
+		default:                return 8;
+		}
+	case EGL_BITMAP_PIXEL_BLUE_OFFSET_KHR:
+		switch(format)
+		{
+		case sw::FORMAT_A8B8G8R8:
+		case sw::FORMAT_X8B8G8R8: return 16;
+		default:                  return 0;
+		}
+	case EGL_BITMAP_PIXEL_ALPHA_OFFSET_KHR:
+		switch(format)
+		{
+		case sw::FORMAT_A8R8G8B8:
+		case sw::FORMAT_A8B8G8R8: return 24;
+		default:                  return 0;
+		}
+	case EGL_BITMAP_PIXEL_LUMINANCE_OFFSET_KHR:
+		return 0;
+	default:
+		UNREACHABLE(attribute);
+	}
+
+	return 0;
+}
+
 WindowSurface::WindowSurface(Display *display, const Config *config, EGLNativeWindowType window)
 	: Surface(display, config), window(window)
 {
@@ -25,6 +25,7 @@
 #include "Main/FrameBuffer.hpp"
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 
 namespace egl
 {
@@ -67,6 +68,13 @@ public:
 	virtual bool isPBufferSurface() const { return false; }
 	bool hasClientBuffer() const { return clientBuffer != nullptr; }
 
+	// EGL_KHR_lock_surface3
+	bool isLockable() const;
+	bool lockSurface(EGLint usageHint, EGLBoolean preservePixels);
+	void unlockSurface();
+	bool isLocked() const { return lockedBuffer != nullptr; }
+	EGLAttribKHR getBitmapAttribute(EGLint attribute) const;
+
 protected:
 	Surface(const Display *display, const Config *config);
 
@@ -82,6 +90,7 @@ protected:
 	Image *depthStencil = nullptr;
 	Image *backBuffer = nullptr;
 	Texture *texture = nullptr;
+	void *lockedBuffer = nullptr;   // Mapped back buffer memory, while locked
 
 	bool reset(int backbufferWidth, int backbufferHeight);
 
@@ -30,6 +30,7 @@
 #endif
 
 #include <algorithm>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace egl;
@@ -121,7 +122,8 @@ EGLDisplay GetDisplay(EGLNativeDisplayType display_id)
 
 	#if defined(__linux__) && !defined(__ANDROID__)
 		#if defined(USE_X11)
-		if(!libX11)
+		// Without an X server to connect to, don't load libX11 at all.
+		if(!getenv("DISPLAY") || !libX11)
 		#endif  // Non X11 linux is headless only
 		{
 			return success(HEADLESS_DISPLAY);
@@ -180,6 +182,7 @@ const char *QueryString(EGLDisplay dpy, EGLint name)
 			"EGL_KHR_client_get_all_proc_addresses "
 #if defined(__linux__) && !defined(__ANDROID__)
 			"EGL_KHR_platform_gbm "
+			"EGL_MESA_platform_surfaceless "
 #endif
 #if defined(USE_X11)
 			"EGL_KHR_platform_x11 "
@@ -201,12 +204,14 @@ const char *QueryString(EGLDisplay dpy, EGLint name)
 		return success("OpenGL_ES");
 	case EGL_EXTENSIONS:
 		return success("EGL_KHR_create_context "
+		               "EGL_KHR_create_context_no_error "
 		               "EGL_KHR_get_all_proc_addresses "
 		               "EGL_KHR_gl_texture_2D_image "
 		               "EGL_KHR_gl_texture_cubemap_image "
 		               "EGL_KHR_gl_renderbuffer_image "
 		               "EGL_KHR_fence_sync "
 		               "EGL_KHR_image_base "
+		               "EGL_KHR_lock_surface3 "
 		               "EGL_KHR_surfaceless_context "
 		               "EGL_ANGLE_iosurface_client_buffer "
 		               "EGL_ANDROID_framebuffer_target "
@@ -458,6 +463,31 @@ EGLBoolean QuerySurface(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EG
 	case EGL_WIDTH:
 		*value = eglSurface->getWidth();
 		break;
+	case EGL_BITMAP_POINTER_KHR:
+	case EGL_BITMAP_PITCH_KHR:
+	case EGL_BITMAP_ORIGIN_KHR:
+	case EGL_BITMAP_PIXEL_RED_OFFSET_KHR:
+	case EGL_BITMAP_PIXEL_GREEN_OFFSET_KHR:
+	case EGL_BITMAP_PIXEL_BLUE_OFFSET_KHR:
+	case EGL_BITMAP_PIXEL_ALPHA_OFFSET_KHR:
+	case EGL_BITMAP_PIXEL_LUMINANCE_OFFSET_KHR:
+	case EGL_BITMAP_PIXEL_SIZE_KHR:
+		{
+			if(!eglSurface->isLocked())
+			{
+				return error(EGL_BAD_ACCESS, EGL_FALSE);
+			}
+
+			EGLAttribKHR bitmapValue = eglSurface->getBitmapAttribute(attribute);
+
+			if(bitmapValue != static_cast<EGLint>(bitmapValue))
+			{
+				return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);   // Use eglQuerySurface64KHR
+			}
+
+			*value = static_cast<EGLint>(bitmapValue);
+		}
+		break;
 	default:
 		return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
 	}
@@ -712,6 +742,8 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 
 	EGLint majorVersion = 1;
 	EGLint minorVersion = 0;
+	bool debugContext = false;
+	bool noErrorContext = false;
 
 	if(attrib_list)
 	{
@@ -734,6 +766,7 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 					//  implementations are currently free to implement "debug contexts" with little or no debug
 					//  functionality. However, OpenGL and OpenGL ES implementations supporting the GL_KHR_debug
 					//  extension should enable it when this bit is set."
+					debugContext = true;
 					break;
 				case EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR:
 				case EGL_CONTEXT_OPENGL_ROBUST_ACCESS_BIT_KHR:
@@ -765,12 +798,30 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 					return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
 				}
 				break;
+			case EGL_CONTEXT_OPENGL_NO_ERROR_KHR:
+				switch(attribute[1])
+				{
+				case EGL_TRUE:
+				case EGL_FALSE:
+					noErrorContext = (attribute[1] == EGL_TRUE);
+					break;
+				default:
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
+				}
+				break;
 			default:
 				return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
 			}
 		}
 	}
 
+	if(debugContext && noErrorContext)
+	{
+		// "If <attrib_list> specifies both EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR and
+		//  EGL_CONTEXT_OPENGL_NO_ERROR_KHR as EGL_TRUE, an EGL_BAD_MATCH error is generated."
+		return error(EGL_BAD_MATCH, EGL_NO_CONTEXT);
+	}
+
 	switch(majorVersion)
 	{
 	case 1:
@@ -805,7 +856,7 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 		return error(EGL_BAD_CONTEXT, EGL_NO_CONTEXT);
 	}
 
-	return display->createContext(config, shareContext, majorVersion);
+	return display->createContext(config, shareContext, majorVersion, noErrorContext);
 }
 
 EGLBoolean DestroyContext(EGLDisplay dpy, EGLContext ctx)
@@ -876,6 +927,12 @@ EGLBoolean MakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLCont
 		return error(EGL_BAD_MATCH, EGL_FALSE);
 	}
 
+	if((draw != EGL_NO_SURFACE && drawSurface->isLocked()) ||
+	   (read != EGL_NO_SURFACE && readSurface->isLocked()))
+	{
+		return error(EGL_BAD_ACCESS, EGL_FALSE);
+	}
+
 	if(draw != read)
 	{
 		UNIMPLEMENTED();   // FIXME
@@ -1014,7 +1071,10 @@ EGLBoolean WaitNative(EGLint engine)
 				return error(EGL_BAD_DISPLAY, EGL_FALSE);
 			}
 
-			libX11->XSync((::Display*)display->getNativeDisplay(), False);
+			if(display->getNativeDisplay())   // Nothing to wait for on headless displays
+			{
+				libX11->XSync((::Display*)display->getNativeDisplay(), False);
+			}
 		#else
 			UNIMPLEMENTED();
 		#endif
@@ -1040,6 +1100,11 @@ EGLBoolean SwapBuffers(EGLDisplay dpy, EGLSurface surface)
 		return error(EGL_BAD_SURFACE, EGL_FALSE);
 	}
 
+	if(eglSurface->isLocked())
+	{
+		return error(EGL_BAD_ACCESS, EGL_FALSE);
+	}
+
 	eglSurface->swap();
 
 	return success(EGL_TRUE);
@@ -1179,11 +1244,12 @@ EGLDisplay GetPlatformDisplayEXT(EGLenum platform, void *native_display, const E
 		case EGL_PLATFORM_X11_EXT: break;
 		#endif
 		case EGL_PLATFORM_GBM_KHR: break;
+		case EGL_PLATFORM_SURFACELESS_MESA: break;
 		default:
 			return error(EGL_BAD_PARAMETER, EGL_NO_DISPLAY);
 		}
 
-		if(platform == EGL_PLATFORM_GBM_KHR)
+		if(platform == EGL_PLATFORM_GBM_KHR || platform == EGL_PLATFORM_SURFACELESS_MESA)
 		{
 			if(native_display != (void*)EGL_DEFAULT_DISPLAY || attrib_list != NULL)
 			{
@@ -1340,6 +1406,132 @@ EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, E
 	}
 }
 
+EGLBoolean LockSurfaceKHR(EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list)
+{
+	TRACE("(EGLDisplay dpy = %p, EGLSurface surface = %p, const EGLint *attrib_list = %p)", dpy, surface, attrib_list);
+
+	egl::Display *display = egl::Display::get(dpy);
+	egl::Surface *eglSurface = static_cast<egl::Surface*>(surface);
+
+	if(!validateSurface(display, eglSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	if(surface == EGL_NO_SURFACE)
+	{
+		return error(EGL_BAD_SURFACE, EGL_FALSE);
+	}
+
+	EGLBoolean preservePixels = EGL_FALSE;
+	EGLint usageHint = EGL_READ_SURFACE_BIT_KHR | EGL_WRITE_SURFACE_BIT_KHR;
+
+	if(attrib_list)
+	{
+		for(const EGLint *attribute = attrib_list; attribute[0] != EGL_NONE; attribute += 2)
+		{
+			switch(attribute[0])
+			{
+			case EGL_MAP_PRESERVE_PIXELS_KHR:
+				preservePixels = (attribute[1] != EGL_FALSE) ? EGL_TRUE : EGL_FALSE;
+				break;
+			case EGL_LOCK_USAGE_HINT_KHR:
+				if(attribute[1] & ~(EGL_READ_SURFACE_BIT_KHR | EGL_WRITE_SURFACE_BIT_KHR))
+				{
+					return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
+				}
+				usageHint = attribute[1];
+				break;
+			default:
+				return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
+			}
+		}
+	}
+
+	if(!eglSurface->isLockable() || eglSurface->isLocked() ||
+	   egl::getCurrentDrawSurface() == eglSurface || egl::getCurrentReadSurface() == eglSurface)
+	{
+		return error(EGL_BAD_ACCESS, EGL_FALSE);
+	}
+
+	if(!eglSurface->lockSurface(usageHint, preservePixels))
+	{
+		return error(EGL_BAD_ACCESS, EGL_FALSE);
+	}
+
+	return success(EGL_TRUE);
+}
+
+EGLBoolean UnlockSurfaceKHR(EGLDisplay dpy, EGLSurface surface)
+{
+	TRACE("(EGLDisplay dpy = %p, EGLSurface surface = %p)", dpy, surface);
+
+	egl::Display *display = egl::Display::get(dpy);
+	egl::Surface *eglSurface = static_cast<egl::Surface*>(surface);
+
+	if(!validateSurface(display, eglSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	if(surface == EGL_NO_SURFACE)
+	{
+		return error(EGL_BAD_SURFACE, EGL_FALSE);
+	}
+
+	if(!eglSurface->isLocked())
+	{
+		return error(EGL_BAD_PARAMETER, EGL_FALSE);
+	}
+
+	eglSurface->unlockSurface();
+
+	return success(EGL_TRUE);
+}
+
+EGLBoolean QuerySurface64KHR(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value)
+{
+	TRACE("(EGLDisplay dpy = %p, EGLSurface surface = %p, EGLint attribute = %d, EGLAttribKHR *value = %p)",
+	      dpy, surface, attribute, value);
+
+	if(attribute == EGL_BITMAP_POINTER_KHR)
+	{
+		egl::Display *display = egl::Display::get(dpy);
+		egl::Surface *eglSurface = static_cast<egl::Surface*>(surface);
+
+		if(!validateSurface(display, eglSurface))
+		{
+			return EGL_FALSE;
+		}
+
+		if(surface == EGL_NO_SURFACE)
+		{
+			return error(EGL_BAD_SURFACE, EGL_FALSE);
+		}
+
+		if(!eglSurface->isLocked())
+		{
+			return error(EGL_BAD_ACCESS, EGL_FALSE);
+		}
+
+		*value = eglSurface->getBitmapAttribute(attribute);
+
+		return success(EGL_TRUE);
+	}
+
+	// All other attributes fit in an EGLint. Some leave the value unmodified, so pass in the current one.
+	EGLint value32 = static_cast<EGLint>(*value);
+
+	if(!QuerySurface(dpy, surface, attribute, &value32))
+	{
+		return EGL_FALSE;
+	}
+
+	*value = value32;
+
+	return EGL_TRUE;
+}
+
 __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname)
 {
 	TRACE("(const char *procname = \"%s\")", procname);
@@ -1393,17 +1585,20 @@ __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname)
 		FUNCTION(eglGetProcAddress),
 		FUNCTION(eglGetSyncAttribKHR),
 		FUNCTION(eglInitialize),
+		FUNCTION(eglLockSurfaceKHR),
 		FUNCTION(eglMakeCurrent),
 		FUNCTION(eglQueryAPI),
 		FUNCTION(eglQueryContext),
 		FUNCTION(eglQueryString),
 		FUNCTION(eglQuerySurface),
+		FUNCTION(eglQuerySurface64KHR),
 		FUNCTION(eglReleaseTexImage),
 		FUNCTION(eglReleaseThread),
 		FUNCTION(eglSurfaceAttrib),
 		FUNCTION(eglSwapBuffers),
 		FUNCTION(eglSwapInterval),
 		FUNCTION(eglTerminate),
+		FUNCTION(eglUnlockSurfaceKHR),
 		FUNCTION(eglWaitClient),
 		FUNCTION(eglWaitGL),
 		FUNCTION(eglWaitNative),
@@ -243,10 +243,16 @@ void setCurrentContext(egl::Context *ctx)
 
 	if(current->context)
 	{
+		current->context->setThreadCurrent(false);
 		current->context->release();
 	}
 
 	current->context = ctx;
+
+	if(ctx)
+	{
+		ctx->setThreadCurrent(true);
+	}
 }
 
 NO_SANITIZE_FUNCTION egl::Context *getCurrentContext()
@@ -376,6 +382,9 @@ EGLSyncKHR CreateSyncKHR(EGLDisplay dpy, EGLenum type, const EGLint *attrib_list
 EGLBoolean DestroySyncKHR(EGLDisplay dpy, EGLSyncKHR sync);
 EGLint ClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
 EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value);
+EGLBoolean LockSurfaceKHR(EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list);
+EGLBoolean UnlockSurfaceKHR(EGLDisplay dpy, EGLSurface surface);
+EGLBoolean QuerySurface64KHR(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value);
 __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname);
 }
 
@@ -591,6 +600,21 @@ EGLAPI EGLBoolean EGLAPIENTRY eglGetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR syn
 	return egl::GetSyncAttribKHR(dpy, sync, attribute, value);
 }
 
+EGLAPI EGLBoolean EGLAPIENTRY eglLockSurfaceKHR(EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list)
+{
+	return egl::LockSurfaceKHR(dpy, surface, attrib_list);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglUnlockSurfaceKHR(EGLDisplay dpy, EGLSurface surface)
+{
+	return egl::UnlockSurfaceKHR(dpy, surface);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQuerySurface64KHR(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value)
+{
+	return egl::QuerySurface64KHR(dpy, surface, attribute, value);
+}
+
 EGLAPI __eglMustCastToProperFunctionPointerType EGLAPIENTRY eglGetProcAddress(const char *procname)
 {
 	return egl::GetProcAddress(procname);
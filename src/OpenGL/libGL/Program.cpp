@@ -1207,6 +1207,9 @@ namespace gl
 			return;
 		}
 
+		// Outputs which didn't get linked to a fragment shader input are never consumed
+		vertexBinary->removeUnusedOutputs();
+
 		linked = true;   // Success
 	}
 
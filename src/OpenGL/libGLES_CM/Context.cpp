@@ -326,6 +326,11 @@ void Context::makeCurrent(gl::Surface *surface)
 	markAllStateDirty();
 }
 
+void Context::setThreadCurrent(bool current)
+{
+	es1::setCurrentContext(current ? this : nullptr);
+}
+
 EGLint Context::getClientVersion() const
 {
 	return 1;
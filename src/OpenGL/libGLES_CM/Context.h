@@ -296,6 +296,7 @@ public:
 	Context(egl::Display *display, const Context *shareContext, const egl::Config *config);
 
 	void makeCurrent(gl::Surface *surface) override;
+	void setThreadCurrent(bool current) override;
 	EGLint getClientVersion() const override;
 	EGLint getConfigID() const override;
 
@@ -84,16 +84,18 @@ extern "C" BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved
 
 namespace es1
 {
+// Mirrors libEGL's current context for this thread, as notified through
+// Context::setThreadCurrent(), so entry points don't have to call into libEGL.
+static thread_local Context *currentContext = nullptr;
+
 es1::Context *getContext()
 {
-	egl::Context *context = libEGL->clientGetCurrentContext();
-
-	if(context && context->getClientVersion() == 1)
-	{
-		return static_cast<es1::Context*>(context);
-	}
+	return currentContext;
+}
 
-	return nullptr;
+void setCurrentContext(Context *context)
+{
+	currentContext = context;
 }
 
 Device *getDevice()
@@ -29,6 +29,7 @@
 namespace es1
 {
 	Context *getContext();
+	void setCurrentContext(Context *context);
 	Device *getDevice();
 
 	void error(GLenum errorCode);
@@ -45,8 +45,8 @@
 
 namespace es2
 {
-Context::Context(egl::Display *display, const Context *shareContext, const egl::Config *config)
-	: egl::Context(display), config(config)
+Context::Context(egl::Display *display, const Context *shareContext, const egl::Config *config, bool noError)
+	: egl::Context(display), config(config), noError(noError)
 {
 	sw::Context *context = new sw::Context();
 	device = new es2::Device(context);
@@ -179,6 +179,9 @@ Context::Context(egl::Display *display, const Context *shareContext, const egl::
 
 Context::~Context()
 {
+	device->synchronizeReadbacks();
+	releaseReadbackSources();
+
 	if(mState.currentProgram != 0)
 	{
 		Program *programObject = mResourceManager->getProgram(mState.currentProgram);
@@ -314,6 +317,11 @@ void Context::makeCurrent(gl::Surface *surface)
 	markAllStateDirty();
 }
 
+void Context::setThreadCurrent(bool current)
+{
+	es2::setCurrentContext(current ? this : nullptr);
+}
+
 EGLint Context::getClientVersion() const
 {
 	return 3;
@@ -329,6 +337,11 @@ void Context::markAllStateDirty()
 {
 	mAppliedProgramSerial = 0;
 
+	for(int i = 0; i < sw::TOTAL_IMAGE_UNITS; i++)
+	{
+		mAppliedSamplers[i].shaderSerial = -1;
+	}
+
 	mDepthStateDirty = true;
 	mMaskStateDirty = true;
 	mBlendStateDirty = true;
@@ -959,6 +972,13 @@ GLsync Context::createFenceSync(GLenum condition, GLbitfield flags)
 {
 	GLuint handle = mResourceManager->createFenceSync(condition, flags);
 
+	releaseReadbackSources();
+
+	if(!mReadbackSources.empty())
+	{
+		device->fence(mResourceManager->getFenceSync(handle)->getPending());
+	}
+
 	return reinterpret_cast<GLsync>(static_cast<uintptr_t>(handle));
 }
 
@@ -1586,6 +1606,15 @@ GLenum Context::getPixels(const GLvoid **pixels, GLenum type, GLsizei imageSize)
 			return GL_INVALID_OPERATION;
 		}
 
+		// Wait for pending readbacks into the buffer
+		sw::Resource *resource = mState.pixelUnpackBuffer->getResource();
+
+		if(resource)
+		{
+			resource->lock(sw::PUBLIC);
+			resource->unlock();
+		}
+
 		*pixels = static_cast<const unsigned char*>(mState.pixelUnpackBuffer->data()) + offset;
 	}
 
@@ -3073,6 +3102,7 @@ void Context::applyTextures()
 void Context::applyTextures(sw::SamplerType samplerType)
 {
 	Program *programObject = getCurrentProgram();
+	sw::Shader *shader = (samplerType == sw::SAMPLER_PIXEL) ? static_cast<sw::Shader*>(programObject->getPixelShader()) : static_cast<sw::Shader*>(programObject->getVertexShader());
 
 	int samplerCount = (samplerType == sw::SAMPLER_PIXEL) ? MAX_TEXTURE_IMAGE_UNITS : MAX_VERTEX_TEXTURE_IMAGE_UNITS;   // Range of samplers of given sampler type
 
@@ -3080,76 +3110,97 @@ void Context::applyTextures(sw::SamplerType samplerType)
 	{
 		int textureUnit = programObject->getSamplerMapping(samplerType, samplerIndex);   // OpenGL texture image unit index
 
+		Texture *texture = nullptr;
+		Sampler *samplerObject = nullptr;
+
 		if(textureUnit != -1)
 		{
 			TextureType textureType = programObject->getSamplerTextureType(samplerType, samplerIndex);
 
-			Texture *texture = getSamplerTexture(textureUnit, textureType);
+			texture = getSamplerTexture(textureUnit, textureType);
+			samplerObject = mState.sampler[textureUnit];
+		}
 
-			if(texture->isSamplerComplete())
-			{
-				GLenum wrapS, wrapT, wrapR, minFilter, magFilter, compFunc, compMode;
-				GLfloat minLOD, maxLOD, maxAnisotropy;
+		// Parameter and image changes produce a new generation, so an unchanged
+		// binding only needs reapplying when image contents need synchronizing.
+		AppliedSampler &applied = mAppliedSamplers[(samplerType == sw::SAMPLER_PIXEL) ? samplerIndex : sw::TEXTURE_IMAGE_UNITS + samplerIndex];
+		unsigned int textureGeneration = texture ? texture->getGeneration() : 0;
+		unsigned int samplerGeneration = samplerObject ? samplerObject->getGeneration() : 0;
+
+		if(applied.shaderSerial == shader->getSerialID() &&
+		   applied.textureGeneration == textureGeneration &&
+		   applied.samplerGeneration == samplerGeneration &&
+		   applied.textureFilteringHint == mState.textureFilteringHint &&
+		   !(applied.texture && applied.texture->hasDirtyImages()))
+		{
+			continue;
+		}
 
-				Sampler *samplerObject = mState.sampler[textureUnit];
-				if(samplerObject)
-				{
-					wrapS = samplerObject->getWrapS();
-					wrapT = samplerObject->getWrapT();
-					wrapR = samplerObject->getWrapR();
-					minFilter = samplerObject->getMinFilter();
-					magFilter = samplerObject->getMagFilter();
-					minLOD = samplerObject->getMinLod();
-					maxLOD = samplerObject->getMaxLod();
-					compFunc = samplerObject->getCompareFunc();
-					compMode = samplerObject->getCompareMode();
-					maxAnisotropy = samplerObject->getMaxAnisotropy();
-				}
-				else
-				{
-					wrapS = texture->getWrapS();
-					wrapT = texture->getWrapT();
-					wrapR = texture->getWrapR();
-					minFilter = texture->getMinFilter();
-					magFilter = texture->getMagFilter();
-					minLOD = texture->getMinLOD();
-					maxLOD = texture->getMaxLOD();
-					compFunc = texture->getCompareFunc();
-					compMode = texture->getCompareMode();
-					maxAnisotropy = texture->getMaxAnisotropy();
-				}
+		applied.shaderSerial = shader->getSerialID();
+		applied.texture = nullptr;
+		applied.textureGeneration = textureGeneration;
+		applied.samplerGeneration = samplerGeneration;
+		applied.textureFilteringHint = mState.textureFilteringHint;
 
-				GLint baseLevel = texture->getBaseLevel();
-				GLint maxLevel = texture->getMaxLevel();
-				GLenum swizzleR = texture->getSwizzleR();
-				GLenum swizzleG = texture->getSwizzleG();
-				GLenum swizzleB = texture->getSwizzleB();
-				GLenum swizzleA = texture->getSwizzleA();
-
-				device->setAddressingModeU(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapS));
-				device->setAddressingModeV(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapT));
-				device->setAddressingModeW(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapR));
-				device->setCompareFunc(samplerType, samplerIndex, es2sw::ConvertCompareFunc(compFunc, compMode));
-				device->setSwizzleR(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleR));
-				device->setSwizzleG(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleG));
-				device->setSwizzleB(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleB));
-				device->setSwizzleA(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleA));
-				device->setMinLod(samplerType, samplerIndex, minLOD);
-				device->setMaxLod(samplerType, samplerIndex, maxLOD);
-				device->setBaseLevel(samplerType, samplerIndex, baseLevel);
-				device->setMaxLevel(samplerType, samplerIndex, maxLevel);
-				device->setTextureFilter(samplerType, samplerIndex, es2sw::ConvertTextureFilter(minFilter, magFilter, maxAnisotropy));
-				device->setMipmapFilter(samplerType, samplerIndex, es2sw::ConvertMipMapFilter(minFilter));
-				device->setMaxAnisotropy(samplerType, samplerIndex, maxAnisotropy);
-				device->setHighPrecisionFiltering(samplerType, samplerIndex, mState.textureFilteringHint == GL_NICEST);
-				device->setSyncRequired(samplerType, samplerIndex, texture->requiresSync());
-
-				applyTexture(samplerType, samplerIndex, texture);
+		if(texture && texture->isSamplerComplete())
+		{
+			GLenum wrapS, wrapT, wrapR, minFilter, magFilter, compFunc, compMode;
+			GLfloat minLOD, maxLOD, maxAnisotropy;
+
+			if(samplerObject)
+			{
+				wrapS = samplerObject->getWrapS();
+				wrapT = samplerObject->getWrapT();
+				wrapR = samplerObject->getWrapR();
+				minFilter = samplerObject->getMinFilter();
+				magFilter = samplerObject->getMagFilter();
+				minLOD = samplerObject->getMinLod();
+				maxLOD = samplerObject->getMaxLod();
+				compFunc = samplerObject->getCompareFunc();
+				compMode = samplerObject->getCompareMode();
+				maxAnisotropy = samplerObject->getMaxAnisotropy();
 			}
 			else
 			{
-				applyTexture(samplerType, samplerIndex, nullptr);
+				wrapS = texture->getWrapS();
+				wrapT = texture->getWrapT();
+				wrapR = texture->getWrapR();
+				minFilter = texture->getMinFilter();
+				magFilter = texture->getMagFilter();
+				minLOD = texture->getMinLOD();
+				maxLOD = texture->getMaxLOD();
+				compFunc = texture->getCompareFunc();
+				compMode = texture->getCompareMode();
+				maxAnisotropy = texture->getMaxAnisotropy();
 			}
+
+			GLint baseLevel = texture->getBaseLevel();
+			GLint maxLevel = texture->getMaxLevel();
+			GLenum swizzleR = texture->getSwizzleR();
+			GLenum swizzleG = texture->getSwizzleG();
+			GLenum swizzleB = texture->getSwizzleB();
+			GLenum swizzleA = texture->getSwizzleA();
+
+			device->setAddressingModeU(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapS));
+			device->setAddressingModeV(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapT));
+			device->setAddressingModeW(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapR));
+			device->setCompareFunc(samplerType, samplerIndex, es2sw::ConvertCompareFunc(compFunc, compMode));
+			device->setSwizzleR(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleR));
+			device->setSwizzleG(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleG));
+			device->setSwizzleB(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleB));
+			device->setSwizzleA(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleA));
+			device->setMinLod(samplerType, samplerIndex, minLOD);
+			device->setMaxLod(samplerType, samplerIndex, maxLOD);
+			device->setBaseLevel(samplerType, samplerIndex, baseLevel);
+			device->setMaxLevel(samplerType, samplerIndex, maxLevel);
+			device->setTextureFilter(samplerType, samplerIndex, es2sw::ConvertTextureFilter(minFilter, magFilter, maxAnisotropy));
+			device->setMipmapFilter(samplerType, samplerIndex, es2sw::ConvertMipMapFilter(minFilter));
+			device->setMaxAnisotropy(samplerType, samplerIndex, maxAnisotropy);
+			device->setHighPrecisionFiltering(samplerType, samplerIndex, mState.textureFilteringHint == GL_NICEST);
+			device->setSyncRequired(samplerType, samplerIndex, texture->requiresSync());
+
+			applyTexture(samplerType, samplerIndex, texture);
+			applied.texture = texture;
 		}
 		else
 		{
@@ -3305,7 +3356,14 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 	GLsizei outputWidth = (mState.packParameters.rowLength > 0) ? mState.packParameters.rowLength : width;
 	GLsizei outputPitch = gl::ComputePitch(outputWidth, format, type, mState.packParameters.alignment);
 	GLsizei outputHeight = (mState.packParameters.imageHeight == 0) ? height : mState.packParameters.imageHeight;
-	pixels = getPixelPackBuffer() ? (unsigned char*)getPixelPackBuffer()->data() + (ptrdiff_t)pixels : (unsigned char*)pixels;
+	Buffer *packBuffer = getPixelPackBuffer();
+
+	if(packBuffer && packBuffer->isMapped())
+	{
+		return error(GL_INVALID_OPERATION);
+	}
+
+	pixels = packBuffer ? (unsigned char*)packBuffer->data() + (ptrdiff_t)pixels : (unsigned char*)pixels;
 	pixels = ((char*)pixels) + gl::ComputePackingOffset(format, type, outputWidth, outputHeight, mState.packParameters);
 
 	// Sized query sanity check
@@ -3341,6 +3399,23 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 	sw::Surface *externalSurface = sw::Surface::create(width, height, 1, gl::ConvertReadFormatType(format, type), pixels, outputPitch, outputPitch * outputHeight);
 	sw::SliceRectF sliceRect(rect);
 	sw::SliceRect dstSliceRect(dstRect);
+
+	if(packBuffer && packBuffer->getResource())
+	{
+		// Copy into the pixel pack buffer asynchronously. Mapping or otherwise accessing the
+		// buffer blocks until the copy has completed, and fences signal its completion.
+		releaseReadbackSources();
+
+		packBuffer->getResource()->lock(sw::EXCLUSIVE);   // Unlocked by the renderer
+		mReadbackSources.emplace_back();
+		ReadbackSource &source = mReadbackSources.back();
+		source.image = renderTarget;   // Released once the readback has completed
+		source.pending = 0;
+		device->readback(renderTarget, sliceRect, externalSurface, dstSliceRect, packBuffer->getResource(), &source.pending);
+
+		return;
+	}
+
 	device->blit(renderTarget, sliceRect, externalSurface, dstSliceRect, false, false, false);
 	externalSurface->lockExternal(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC);
 	externalSurface->unlockExternal();
@@ -3349,6 +3424,22 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 	renderTarget->release();
 }
 
+void Context::releaseReadbackSources()
+{
+	for(auto source = mReadbackSources.begin(); source != mReadbackSources.end();)
+	{
+		if(source->pending == 0)
+		{
+			source->image->release();
+			source = mReadbackSources.erase(source);
+		}
+		else
+		{
+			++source;
+		}
+	}
+}
+
 void Context::clear(GLbitfield mask)
 {
 	if(mState.rasterizerDiscardEnabled)
@@ -3532,7 +3623,7 @@ void Context::drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instan
 		applyShaders();
 		applyTextures();
 
-		if(!getCurrentProgram()->validateSamplers(false))
+		if(!noError && !getCurrentProgram()->validateSamplers(false))
 		{
 			return error(GL_INVALID_OPERATION);
 		}
@@ -3621,7 +3712,7 @@ void Context::drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count,
 		applyShaders();
 		applyTextures();
 
-		if(!getCurrentProgram()->validateSamplers(false))
+		if(!noError && !getCurrentProgram()->validateSamplers(false))
 		{
 			return error(GL_INVALID_OPERATION);
 		}
@@ -3652,6 +3743,7 @@ void Context::blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface
 void Context::finish()
 {
 	device->finish();
+	releaseReadbackSources();
 }
 
 void Context::flush()
@@ -4480,7 +4572,7 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 
 }
 
-NO_SANITIZE_FUNCTION egl::Context *es2CreateContext(egl::Display *display, const egl::Context *shareContext, const egl::Config *config)
+NO_SANITIZE_FUNCTION egl::Context *es2CreateContext(egl::Display *display, const egl::Context *shareContext, const egl::Config *config, bool noError)
 {
-	return new es2::Context(display, static_cast<const es2::Context*>(shareContext), config);
+	return new es2::Context(display, static_cast<const es2::Context*>(shareContext), config, noError);
 }
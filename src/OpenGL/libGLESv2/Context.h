@@ -31,8 +31,10 @@
 #include <GLES3/gl3.h>
 #include <EGL/egl.h>
 
+#include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace egl
 {
@@ -430,12 +432,15 @@ struct State
 class [[clang::lto_visibility_public]] Context : public egl::Context
 {
 public:
-	Context(egl::Display *display, const Context *shareContext, const egl::Config *config);
+	Context(egl::Display *display, const Context *shareContext, const egl::Config *config, bool noError);
 
 	void makeCurrent(gl::Surface *surface) override;
+	void setThreadCurrent(bool current) override;
 	EGLint getClientVersion() const override;
 	EGLint getConfigID() const override;
 
+	bool isNoErrorContext() const { return noError; }   // Errors lead to undefined behavior, so validation may be skipped
+
 	void markAllStateDirty();
 
 	// State manipulation
@@ -714,6 +719,8 @@ private:
 	void applyTexture(sw::SamplerType type, int sampler, Texture *texture);
 	void clearColorBuffer(GLint drawbuffer, void *value, sw::Format format);
 
+	void releaseReadbackSources();
+
 	void detachBuffer(GLuint buffer);
 	void detachTexture(GLuint texture);
 	void detachFramebuffer(GLuint framebuffer);
@@ -726,6 +733,7 @@ private:
 	Query *createQuery(GLuint handle, GLenum type);
 
 	const egl::Config *const config;
+	const bool noError;
 
 	State mState;
 
@@ -745,6 +753,15 @@ private:
 	VertexDataManager *mVertexDataManager;
 	IndexDataManager *mIndexDataManager;
 
+	// Asynchronous readbacks into pixel pack buffers
+	struct ReadbackSource
+	{
+		egl::Image *image;
+		sw::AtomicInt pending;
+	};
+
+	std::list<ReadbackSource> mReadbackSources;   // Each source is kept alive until its own readback completes
+
 	// Recorded errors
 	bool mInvalidEnum;
 	bool mInvalidValue;
@@ -756,6 +773,19 @@ private:
 
 	unsigned int mAppliedProgramSerial;
 
+	// Texture and sampler state last applied to each device sampler, so that
+	// unchanged bindings can skip rederiving and reapplying it on every draw.
+	struct AppliedSampler
+	{
+		int shaderSerial;
+		Texture *texture;   // Null when no complete texture was applied
+		unsigned int textureGeneration;
+		unsigned int samplerGeneration;
+		GLenum textureFilteringHint;
+	};
+
+	AppliedSampler mAppliedSamplers[sw::TOTAL_IMAGE_UNITS];
+
 	// state caching flags
 	bool mDepthStateDirty;
 	bool mMaskStateDirty;
@@ -18,6 +18,7 @@
 
 #include "main.h"
 #include "Common/Thread.hpp"
+#include "Common/Timer.hpp"
 
 namespace es2
 {
@@ -115,20 +116,41 @@ void Fence::getFenceiv(GLenum pname, GLint *params)
 	}
 }
 
-FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags) : NamedObject(name), mCondition(condition), mFlags(flags)
+FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags) : NamedObject(name), mCondition(condition), mFlags(flags), mPending(0)
 {
 }
 
 FenceSync::~FenceSync()
 {
+	// The renderer still holds a pointer to the pending count
+	while(!isSignaled())
+	{
+		sw::Thread::yield();
+	}
 }
 
 GLenum FenceSync::clientWait(GLbitfield flags, GLuint64 timeout)
 {
-	// The current assumtion is that no matter where the fence is placed, it is
-	// done by the time it is tested, which is similar to Context::flush(), since
-	// we don't queue anything without processing it as fast as possible.
-	return GL_ALREADY_SIGNALED;
+	// Draw calls are completed before anything can observe their results, so the
+	// fence only has to wait for preceding asynchronous pixel pack buffer readbacks.
+	if(isSignaled())
+	{
+		return GL_ALREADY_SIGNALED;
+	}
+
+	double deadline = sw::Timer::seconds() + timeout * 1.0e-9;
+
+	while(!isSignaled())
+	{
+		if(sw::Timer::seconds() >= deadline)
+		{
+			return GL_TIMEOUT_EXPIRED;
+		}
+
+		sw::Thread::yield();
+	}
+
+	return GL_CONDITION_SATISFIED;
 }
 
 void FenceSync::serverWait(GLbitfield flags, GLuint64 timeout)
@@ -146,10 +168,7 @@ void FenceSync::getSynciv(GLenum pname, GLsizei *length, GLint *values)
 		}
 		break;
 	case GL_SYNC_STATUS:
-		// The current assumtion is that no matter where the fence is placed, it is
-		// done by the time it is tested, which is similar to Context::flush(), since
-		// we don't queue anything without processing it as fast as possible.
-		values[0] = GL_SIGNALED;
+		values[0] = isSignaled() ? GL_SIGNALED : GL_UNSIGNALED;
 		if(length) {
 			*length = 1;
 		}
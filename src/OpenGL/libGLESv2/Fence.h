@@ -18,6 +18,7 @@
 #define LIBGLESV2_FENCE_H_
 
 #include "common/Object.hpp"
+#include "Common/Thread.hpp"
 #include <GLES2/gl2.h>
 
 namespace es2
@@ -53,10 +54,14 @@ public:
 
 	GLenum getCondition() const { return mCondition; }
 	GLbitfield getFlags() const { return mFlags; }
+	sw::AtomicInt *getPending() { return &mPending; }
 
 private:
+	bool isSignaled() const { return mPending == 0; }
+
 	GLenum mCondition;
 	GLbitfield mFlags;
+	sw::AtomicInt mPending;   // Number of preceding asynchronous operations still in flight
 };
 
 }
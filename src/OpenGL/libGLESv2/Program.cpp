@@ -1598,6 +1598,9 @@ namespace es2
 			return;
 		}
 
+		// Outputs which didn't get linked to a fragment shader input are never consumed
+		vertexBinary->removeUnusedOutputs();
+
 		linked = true;   // Success
 	}
 
@@ -42,18 +42,20 @@ public:
 		mCompareMode = GL_NONE;
 		mCompareFunc = GL_LEQUAL;
 		mMaxAnisotropy = 1.0f;
+
+		mGeneration = gl::NewGeneration();
 	}
 
-	void setMinFilter(GLenum minFilter) { mMinFilter = minFilter; }
-	void setMagFilter(GLenum magFilter) { mMagFilter = magFilter; }
-	void setWrapS(GLenum wrapS) { mWrapModeS = wrapS; }
-	void setWrapT(GLenum wrapT) { mWrapModeT = wrapT; }
-	void setWrapR(GLenum wrapR) { mWrapModeR = wrapR; }
-	void setMinLod(GLfloat minLod) { mMinLod = minLod; }
-	void setMaxLod(GLfloat maxLod) { mMaxLod = maxLod; }
-	void setCompareMode(GLenum compareMode) { mCompareMode = compareMode; }
-	void setCompareFunc(GLenum compareFunc) { mCompareFunc = compareFunc; }
-	void setMaxAnisotropy(GLfloat maxAnisotropy) { mMaxAnisotropy = maxAnisotropy; }
+	void setMinFilter(GLenum minFilter) { mMinFilter = minFilter; mGeneration = gl::NewGeneration(); }
+	void setMagFilter(GLenum magFilter) { mMagFilter = magFilter; mGeneration = gl::NewGeneration(); }
+	void setWrapS(GLenum wrapS) { mWrapModeS = wrapS; mGeneration = gl::NewGeneration(); }
+	void setWrapT(GLenum wrapT) { mWrapModeT = wrapT; mGeneration = gl::NewGeneration(); }
+	void setWrapR(GLenum wrapR) { mWrapModeR = wrapR; mGeneration = gl::NewGeneration(); }
+	void setMinLod(GLfloat minLod) { mMinLod = minLod; mGeneration = gl::NewGeneration(); }
+	void setMaxLod(GLfloat maxLod) { mMaxLod = maxLod; mGeneration = gl::NewGeneration(); }
+	void setCompareMode(GLenum compareMode) { mCompareMode = compareMode; mGeneration = gl::NewGeneration(); }
+	void setCompareFunc(GLenum compareFunc) { mCompareFunc = compareFunc; mGeneration = gl::NewGeneration(); }
+	void setMaxAnisotropy(GLfloat maxAnisotropy) { mMaxAnisotropy = maxAnisotropy; mGeneration = gl::NewGeneration(); }
 
 	GLenum getMinFilter() const { return mMinFilter; }
 	GLenum getMagFilter() const { return mMagFilter; }
@@ -65,6 +67,7 @@ public:
 	GLenum getCompareMode() const { return mCompareMode; }
 	GLenum getCompareFunc() const { return mCompareFunc; }
 	GLfloat getMaxAnisotropy() const { return mMaxAnisotropy; }
+	unsigned int getGeneration() const { return mGeneration; }
 
 private:
 	GLenum mMinFilter;
@@ -79,6 +82,8 @@ private:
 	GLenum mCompareMode;
 	GLenum mCompareFunc;
 	GLfloat mMaxAnisotropy;
+
+	unsigned int mGeneration;
 };
 
 }
@@ -52,6 +52,7 @@ Texture::Texture(GLuint name) : egl::Texture(name)
 	mSwizzleG = GL_GREEN;
 	mSwizzleB = GL_BLUE;
 	mSwizzleA = GL_ALPHA;
+	mGeneration = gl::NewGeneration();
 
 	resource = new sw::Resource(0);
 }
@@ -83,6 +84,7 @@ bool Texture::setMinFilter(GLenum filter)
 	case GL_NEAREST:
 	case GL_LINEAR:
 		mMinFilter = filter;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -97,6 +99,7 @@ bool Texture::setMagFilter(GLenum filter)
 	case GL_NEAREST:
 	case GL_LINEAR:
 		mMagFilter = filter;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -117,6 +120,7 @@ bool Texture::setWrapS(GLenum wrap)
 		// Fall through
 	case GL_CLAMP_TO_EDGE:
 		mWrapS = wrap;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -137,6 +141,7 @@ bool Texture::setWrapT(GLenum wrap)
 		// Fall through
 	case GL_CLAMP_TO_EDGE:
 		mWrapT = wrap;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -157,6 +162,7 @@ bool Texture::setWrapR(GLenum wrap)
 		// Fall through
 	case GL_CLAMP_TO_EDGE:
 		mWrapR = wrap;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -176,6 +182,7 @@ bool Texture::setMaxAnisotropy(float textureMaxAnisotropy)
 	if(mMaxAnisotropy != textureMaxAnisotropy)
 	{
 		mMaxAnisotropy = textureMaxAnisotropy;
+		markChanged();
 	}
 
 	return true;
@@ -189,6 +196,7 @@ bool Texture::setBaseLevel(GLint baseLevel)
 	}
 
 	mBaseLevel = baseLevel;
+	markChanged();
 	return true;
 }
 
@@ -205,6 +213,7 @@ bool Texture::setCompareFunc(GLenum compareFunc)
 	case GL_ALWAYS:
 	case GL_NEVER:
 		mCompareFunc = compareFunc;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -218,6 +227,7 @@ bool Texture::setCompareMode(GLenum compareMode)
 	case GL_COMPARE_REF_TO_TEXTURE:
 	case GL_NONE:
 		mCompareMode = compareMode;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -228,23 +238,27 @@ void Texture::makeImmutable(GLsizei levels)
 {
 	mImmutableFormat = GL_TRUE;
 	mImmutableLevels = levels;
+	markChanged();
 }
 
 bool Texture::setMaxLevel(GLint maxLevel)
 {
 	mMaxLevel = maxLevel;
+	markChanged();
 	return true;
 }
 
 bool Texture::setMaxLOD(GLfloat maxLOD)
 {
 	mMaxLOD = maxLOD;
+	markChanged();
 	return true;
 }
 
 bool Texture::setMinLOD(GLfloat minLOD)
 {
 	mMinLOD = minLOD;
+	markChanged();
 	return true;
 }
 
@@ -259,6 +273,7 @@ bool Texture::setSwizzleR(GLenum swizzleR)
 	case GL_ZERO:
 	case GL_ONE:
 		mSwizzleR = swizzleR;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -276,6 +291,7 @@ bool Texture::setSwizzleG(GLenum swizzleG)
 	case GL_ZERO:
 	case GL_ONE:
 		mSwizzleG = swizzleG;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -293,6 +309,7 @@ bool Texture::setSwizzleB(GLenum swizzleB)
 	case GL_ZERO:
 	case GL_ONE:
 		mSwizzleB = swizzleB;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -310,6 +327,7 @@ bool Texture::setSwizzleA(GLenum swizzleA)
 	case GL_ZERO:
 	case GL_ONE:
 		mSwizzleA = swizzleA;
+		markChanged();
 		return true;
 	default:
 		return false;
@@ -360,6 +378,7 @@ void Texture::subImage(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei widt
 
 	if(pixels && width > 0 && height > 0 && depth > 0)
 	{
+		getDevice()->synchronizeReadbacks(image);   // Pending readbacks of this image must see its old contents
 		image->loadImageData(xoffset, yoffset, zoffset, width, height, depth, format, type, unpackParameters, pixels);
 	}
 }
@@ -373,6 +392,7 @@ void Texture::subImageCompressed(GLint xoffset, GLint yoffset, GLint zoffset, GL
 
 	if(pixels && (imageSize > 0)) // imageSize's correlation to width and height is already validated with gl::ComputeCompressedSize() at the API level
 	{
+		getDevice()->synchronizeReadbacks(image);
 		image->loadCompressedData(xoffset, yoffset, zoffset, width, height, depth, imageSize, pixels);
 	}
 }
@@ -541,6 +561,19 @@ bool Texture2D::requiresSync() const
 	return false;
 }
 
+bool Texture2D::hasDirtyImages() const
+{
+	for(int level = 0; level < IMPLEMENTATION_MAX_TEXTURE_LEVELS; level++)
+	{
+		if(image[level] && (image[level]->requiresSync() || image[level]->isExternalDirty() || image[level]->isTiledDirty()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels)
 {
 	if(image[level])
@@ -549,6 +582,7 @@ void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLint inter
 	}
 
 	image[level] = egl::Image::create(this, width, height, internalformat);
+	markChanged();
 
 	if(!image[level])
 	{
@@ -570,6 +604,7 @@ void Texture2D::bindTexImage(gl::Surface *surface)
 	}
 
 	image[0] = surface->getRenderTarget();
+	markChanged();
 
 	mSurface = surface;
 	mSurface->setBoundTexture(this);
@@ -586,6 +621,8 @@ void Texture2D::releaseTexImage()
 		}
 	}
 
+	markChanged();
+
 	if(mSurface)
 	{
 		mSurface->setBoundTexture(nullptr);
@@ -601,6 +638,7 @@ void Texture2D::setCompressedImage(GLint level, GLenum format, GLsizei width, GL
 	}
 
 	image[level] = egl::Image::create(this, width, height, format);
+	markChanged();
 
 	if(!image[level])
 	{
@@ -628,6 +666,7 @@ void Texture2D::copyImage(GLint level, GLenum internalformat, GLint x, GLint y,
 	}
 
 	image[level] = egl::Image::create(this, width, height, internalformat);
+	markChanged();
 
 	if(!image[level])
 	{
@@ -699,6 +738,7 @@ void Texture2D::setSharedImage(egl::Image *sharedImage)
 	}
 
 	image[0] = sharedImage;
+	markChanged();
 }
 
 // Tests for 2D texture sampling completeness. [OpenGL ES 3.0.5] section 3.8.13 page 160.
@@ -804,6 +844,7 @@ void Texture2D::generateMipmaps()
 		}
 
 		image[i] = egl::Image::create(this, std::max(image[mBaseLevel]->getWidth() >> i, 1), std::max(image[mBaseLevel]->getHeight() >> i, 1), image[mBaseLevel]->getFormat());
+		markChanged();
 
 		if(!image[i])
 		{
@@ -1048,6 +1089,25 @@ bool TextureCubeMap::requiresSync() const
 	return false;
 }
 
+bool TextureCubeMap::hasDirtyImages() const
+{
+	for(int level = 0; level < IMPLEMENTATION_MAX_TEXTURE_LEVELS; level++)
+	{
+		for(int face = 0; face < 6; face++)
+		{
+			egl::Image *faceImage = image[face][level];
+
+			if(faceImage && (faceImage->requiresSync() || faceImage->isExternalDirty() ||
+			                 (faceImage->getBorder() != 0 && faceImage->hasDirtyContents())))   // Seamless borders need updating
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void TextureCubeMap::setCompressedImage(GLenum target, GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei imageSize, const void *pixels)
 {
 	int face = CubeFaceIndex(target);
@@ -1058,6 +1118,7 @@ void TextureCubeMap::setCompressedImage(GLenum target, GLint level, GLenum forma
 	}
 
 	image[face][level] = egl::Image::create(this, width, height, 1, 1, format);
+	markChanged();
 
 	if(!image[face][level])
 	{
@@ -1264,6 +1325,7 @@ void TextureCubeMap::setImage(GLenum target, GLint level, GLsizei width, GLsizei
 	}
 
 	image[face][level] = egl::Image::create(this, width, height, 1, 1, internalformat);
+	markChanged();
 
 	if(!image[face][level])
 	{
@@ -1283,6 +1345,7 @@ void TextureCubeMap::copyImage(GLenum target, GLint level, GLenum internalformat
 	}
 
 	image[face][level] = egl::Image::create(this, width, height, 1, 1, internalformat);
+	markChanged();
 
 	if(!image[face][level])
 	{
@@ -1375,6 +1438,7 @@ void TextureCubeMap::generateMipmaps()
 			}
 
 			image[f][i] = egl::Image::create(this, std::max(image[f][mBaseLevel]->getWidth() >> i, 1), std::max(image[f][mBaseLevel]->getHeight() >> i, 1), 1, 1, image[f][mBaseLevel]->getFormat());
+			markChanged();
 
 			if(!image[f][i])
 			{
@@ -1569,6 +1633,19 @@ bool Texture3D::requiresSync() const
 	return false;
 }
 
+bool Texture3D::hasDirtyImages() const
+{
+	for(int level = 0; level < IMPLEMENTATION_MAX_TEXTURE_LEVELS; level++)
+	{
+		if(image[level] && (image[level]->requiresSync() || image[level]->isExternalDirty()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei depth, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels)
 {
 	if(image[level])
@@ -1577,6 +1654,7 @@ void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei dep
 	}
 
 	image[level] = egl::Image::create(this, width, height, depth, 0, internalformat);
+	markChanged();
 
 	if(!image[level])
 	{
@@ -1599,6 +1677,7 @@ void Texture3D::setCompressedImage(GLint level, GLenum format, GLsizei width, GL
 	}
 
 	image[level] = egl::Image::create(this, width, height, depth, 0, format);
+	markChanged();
 
 	if(!image[level])
 	{
@@ -1626,6 +1705,7 @@ void Texture3D::copyImage(GLint level, GLenum internalformat, GLint x, GLint y,
 	}
 
 	image[level] = egl::Image::create(this, width, height, depth, 0, internalformat);
+	markChanged();
 
 	if(!image[level])
 	{
@@ -1695,6 +1775,7 @@ void Texture3D::setSharedImage(egl::Image *sharedImage)
 	}
 
 	image[0] = sharedImage;
+	markChanged();
 }
 
 // Tests for 3D texture sampling completeness. [OpenGL ES 3.0.5] section 3.8.13 page 160.
@@ -1810,6 +1891,7 @@ void Texture3D::generateMipmaps()
 		}
 
 		image[i] = egl::Image::create(this, std::max(image[mBaseLevel]->getWidth() >> i, 1), std::max(image[mBaseLevel]->getHeight() >> i, 1), std::max(image[mBaseLevel]->getDepth() >> i, 1), 0, image[mBaseLevel]->getFormat());
+		markChanged();
 
 		if(!image[i])
 		{
@@ -1915,6 +1997,7 @@ void Texture2DArray::generateMipmaps()
 		GLsizei w = std::max(image[mBaseLevel]->getWidth() >> i, 1);
 		GLsizei h = std::max(image[mBaseLevel]->getHeight() >> i, 1);
 		image[i] = egl::Image::create(this, w, h, depth, 0, image[mBaseLevel]->getFormat());
+		markChanged();
 
 		if(!image[i])
 		{
@@ -91,6 +91,7 @@ public:
 	GLenum getSwizzleG() const { return mSwizzleG; }
 	GLenum getSwizzleB() const { return mSwizzleB; }
 	GLenum getSwizzleA() const { return mSwizzleA; }
+	unsigned int getGeneration() const { return mGeneration; }   // Changes whenever parameters or images get redefined
 
 	virtual GLsizei getWidth(GLenum target, GLint level) const = 0;
 	virtual GLsizei getHeight(GLenum target, GLint level) const = 0;
@@ -98,6 +99,7 @@ public:
 	virtual GLint getFormat(GLenum target, GLint level) const = 0;
 	virtual int getTopLevel() const = 0;
 	virtual bool requiresSync() const = 0;
+	virtual bool hasDirtyImages() const = 0;   // Image contents have to be synchronized before sampling
 
 	virtual bool isSamplerComplete() const = 0;
 	virtual bool isCompressed(GLenum target, GLint level) const = 0;
@@ -122,6 +124,7 @@ protected:
 	bool copy(egl::Image *source, const sw::SliceRect &sourceRect, GLint xoffset, GLint yoffset, GLint zoffset, egl::Image *dest);
 
 	bool isMipmapFiltered() const;
+	void markChanged() { mGeneration = gl::NewGeneration(); }
 
 	GLenum mMinFilter;
 	GLenum mMagFilter;
@@ -141,6 +144,7 @@ protected:
 	GLenum mSwizzleG;
 	GLenum mSwizzleB;
 	GLenum mSwizzleA;
+	unsigned int mGeneration;
 
 	sw::Resource *resource;
 };
@@ -161,6 +165,7 @@ public:
 	GLint getFormat(GLenum target, GLint level) const override;
 	int getTopLevel() const override;
 	bool requiresSync() const override;
+	bool hasDirtyImages() const override;
 
 	void setImage(GLint level, GLsizei width, GLsizei height, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels);
 	void setCompressedImage(GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei imageSize, const void *pixels);
@@ -229,6 +234,7 @@ public:
 	GLint getFormat(GLenum target, GLint level) const override;
 	int getTopLevel() const override;
 	bool requiresSync() const override;
+	bool hasDirtyImages() const override;
 
 	void setImage(GLenum target, GLint level, GLsizei width, GLsizei height, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels);
 	void setCompressedImage(GLenum target, GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei imageSize, const void *pixels);
@@ -291,6 +297,7 @@ public:
 	GLint getFormat(GLenum target, GLint level) const override;
 	int getTopLevel() const override;
 	bool requiresSync() const override;
+	bool hasDirtyImages() const override;
 
 	void setImage(GLint level, GLsizei width, GLsizei height, GLsizei depth, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels);
 	void setCompressedImage(GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei depth, GLsizei imageSize, const void *pixels);
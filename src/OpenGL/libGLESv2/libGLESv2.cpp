@@ -1457,29 +1457,33 @@ void DrawArrays(GLenum mode, GLint first, GLsizei count)
 {
 	TRACE("(GLenum mode = 0x%X, GLint first = %d, GLsizei count = %d)", mode, first, count);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
-
-	if(count < 0 || first < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
-
 	es2::Context *context = es2::getContext();
 
 	if(context)
 	{
+		// Drawing checks the mode again, so no-error contexts skip the check here
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
+
+		if(count < 0 || first < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
+
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && (mode != transformFeedback->primitiveMode()))
 		{
@@ -1495,43 +1499,50 @@ void DrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices
 	TRACE("(GLenum mode = 0x%X, GLsizei count = %d, GLenum type = 0x%X, const GLvoid* indices = %p)",
 	      mode, count, type, indices);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
-
-	if(count < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
-
 	es2::Context *context = es2::getContext();
 
 	if(context)
 	{
+		// Drawing checks the mode and index type again, so no-error contexts skip them here
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
+
+		if(count < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
+
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && !transformFeedback->isPaused())
 		{
 			return error(GL_INVALID_OPERATION);
 		}
 
-		switch(type)
+		if(!context->isNoErrorContext())
 		{
-		case GL_UNSIGNED_BYTE:
-		case GL_UNSIGNED_SHORT:
-		case GL_UNSIGNED_INT:
-			break;
-		default:
-			return error(GL_INVALID_ENUM);
+			switch(type)
+			{
+			case GL_UNSIGNED_BYTE:
+			case GL_UNSIGNED_SHORT:
+			case GL_UNSIGNED_INT:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
 		}
 
 		context->drawElements(mode, 0, MAX_ELEMENT_INDEX, count, type, indices);
@@ -1543,29 +1554,32 @@ void DrawArraysInstancedEXT(GLenum mode, GLint first, GLsizei count, GLsizei ins
 	TRACE("(GLenum mode = 0x%X, GLint first = %d, GLsizei count = %d, GLsizei instanceCount = %d)",
 		mode, first, count, instanceCount);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
-
-	if(count < 0 || instanceCount < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
-
 	es2::Context *context = es2::getContext();
 
 	if(context)
 	{
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
+
+		if(count < 0 || instanceCount < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
+
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && (mode != transformFeedback->primitiveMode()))
 		{
@@ -1581,39 +1595,42 @@ void DrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const voi
 	TRACE("(GLenum mode = 0x%X, GLsizei count = %d, GLenum type = 0x%X, const void *indices = %p, GLsizei instanceCount = %d)",
 		mode, count, type, indices, instanceCount);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+	es2::Context *context = es2::getContext();
 
-	switch(type)
+	if(context)
 	{
-	case GL_UNSIGNED_BYTE:
-	case GL_UNSIGNED_SHORT:
-	case GL_UNSIGNED_INT:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
 
-	if(count < 0 || instanceCount < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
+			switch(type)
+			{
+			case GL_UNSIGNED_BYTE:
+			case GL_UNSIGNED_SHORT:
+			case GL_UNSIGNED_INT:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
 
-	es2::Context *context = es2::getContext();
+		if(count < 0 || instanceCount < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
 
-	if(context)
-	{
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && !transformFeedback->isPaused())
 		{
@@ -1646,30 +1663,34 @@ void DrawArraysInstancedANGLE(GLenum mode, GLint first, GLsizei count, GLsizei i
 	TRACE("(GLenum mode = 0x%X, GLint first = %d, GLsizei count = %d, GLsizei instanceCount = %d)",
 		mode, first, count, instanceCount);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
-
-	if(count < 0 || instanceCount < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
-
 	es2::Context *context = es2::getContext();
 
 	if(context)
 	{
-		if(!context->hasZeroDivisor())
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
+
+		if(count < 0 || instanceCount < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
+
+		// The zero divisor rule doesn't affect drawing, and checking it walks every attribute
+		if(!context->isNoErrorContext() && !context->hasZeroDivisor())
 		{
 			return error(GL_INVALID_OPERATION);
 		}
@@ -1689,40 +1710,43 @@ void DrawElementsInstancedANGLE(GLenum mode, GLsizei count, GLenum type, const v
 	TRACE("(GLenum mode = 0x%X, GLsizei count = %d, GLenum type = 0x%X, const void *indices = %p, GLsizei instanceCount = %d)",
 		mode, count, type, indices, instanceCount);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+	es2::Context *context = es2::getContext();
 
-	switch(type)
+	if(context)
 	{
-	case GL_UNSIGNED_BYTE:
-	case GL_UNSIGNED_SHORT:
-	case GL_UNSIGNED_INT:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
 
-	if(count < 0 || instanceCount < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
+			switch(type)
+			{
+			case GL_UNSIGNED_BYTE:
+			case GL_UNSIGNED_SHORT:
+			case GL_UNSIGNED_INT:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
 
-	es2::Context *context = es2::getContext();
+		if(count < 0 || instanceCount < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
 
-	if(context)
-	{
-		if(!context->hasZeroDivisor())
+		if(!context->isNoErrorContext() && !context->hasZeroDivisor())
 		{
 			return error(GL_INVALID_OPERATION);
 		}
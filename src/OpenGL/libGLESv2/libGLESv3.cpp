@@ -289,39 +289,42 @@ GL_APICALL void GL_APIENTRY glDrawRangeElements(GLenum mode, GLuint start, GLuin
 		  "GLsizei count = %d, GLenum type = 0x%x, const void* indices = %p)",
 		  mode, start, end, count, type, indices);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+	es2::Context *context = es2::getContext();
 
-	switch(type)
+	if(context)
 	{
-	case GL_UNSIGNED_BYTE:
-	case GL_UNSIGNED_SHORT:
-	case GL_UNSIGNED_INT:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
 
-	if((count < 0) || (end < start))
-	{
-		return error(GL_INVALID_VALUE);
-	}
+			switch(type)
+			{
+			case GL_UNSIGNED_BYTE:
+			case GL_UNSIGNED_SHORT:
+			case GL_UNSIGNED_INT:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
 
-	es2::Context *context = es2::getContext();
+		if((count < 0) || (end < start))
+		{
+			return error(GL_INVALID_VALUE);
+		}
 
-	if(context)
-	{
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && !transformFeedback->isPaused())
 		{
@@ -2474,7 +2477,14 @@ GL_APICALL void GL_APIENTRY glCopyBufferSubData(GLenum readTarget, GLenum writeT
 			return error(GL_INVALID_VALUE);
 		}
 
-		writeBuffer->bufferSubData(((char*)readBuffer->data()) + readOffset, size, writeOffset);
+		sw::Resource *readResource = readBuffer->getResource();
+
+		if(readResource)
+		{
+			const char *data = static_cast<const char*>(readResource->lock(sw::PUBLIC));   // Waits for pending readbacks
+			writeBuffer->bufferSubData(data + readOffset, size, writeOffset);
+			readResource->unlock();
+		}
 	}
 }
 
@@ -2703,29 +2713,32 @@ GL_APICALL void GL_APIENTRY glDrawArraysInstanced(GLenum mode, GLint first, GLsi
 	TRACE("(GLenum mode = 0x%X, GLint first = %d, GLsizei count = %d, GLsizei instanceCount = %d)",
 	      mode, first, count, instanceCount);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
-
-	if(count < 0 || instanceCount < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
-
 	es2::Context *context = es2::getContext();
 
 	if(context)
 	{
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
+
+		if(count < 0 || instanceCount < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
+
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && (mode != transformFeedback->primitiveMode()))
 		{
@@ -2741,39 +2754,42 @@ GL_APICALL void GL_APIENTRY glDrawElementsInstanced(GLenum mode, GLsizei count,
 	TRACE("(GLenum mode = 0x%X, GLsizei count = %d, GLenum type = 0x%X, const void *indices = %p, GLsizei instanceCount = %d)",
 	      mode, count, type, indices, instanceCount);
 
-	switch(mode)
-	{
-	case GL_POINTS:
-	case GL_LINES:
-	case GL_LINE_LOOP:
-	case GL_LINE_STRIP:
-	case GL_TRIANGLES:
-	case GL_TRIANGLE_FAN:
-	case GL_TRIANGLE_STRIP:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+	es2::Context *context = es2::getContext();
 
-	switch(type)
+	if(context)
 	{
-	case GL_UNSIGNED_BYTE:
-	case GL_UNSIGNED_SHORT:
-	case GL_UNSIGNED_INT:
-		break;
-	default:
-		return error(GL_INVALID_ENUM);
-	}
+		if(!context->isNoErrorContext())
+		{
+			switch(mode)
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_LINE_LOOP:
+			case GL_LINE_STRIP:
+			case GL_TRIANGLES:
+			case GL_TRIANGLE_FAN:
+			case GL_TRIANGLE_STRIP:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
 
-	if(count < 0 || instanceCount < 0)
-	{
-		return error(GL_INVALID_VALUE);
-	}
+			switch(type)
+			{
+			case GL_UNSIGNED_BYTE:
+			case GL_UNSIGNED_SHORT:
+			case GL_UNSIGNED_INT:
+				break;
+			default:
+				return error(GL_INVALID_ENUM);
+			}
+		}
 
-	es2::Context *context = es2::getContext();
+		if(count < 0 || instanceCount < 0)
+		{
+			return error(GL_INVALID_VALUE);
+		}
 
-	if(context)
-	{
 		es2::TransformFeedback* transformFeedback = context->getTransformFeedback();
 		if(transformFeedback && transformFeedback->isActive() && !transformFeedback->isPaused())
 		{
@@ -31,6 +31,7 @@
 namespace es2
 {
 	Context *getContext();
+	void setCurrentContext(Context *context);
 	Device *getDevice();
 
 	void error(GLenum errorCode);
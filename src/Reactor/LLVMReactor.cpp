@@ -31,6 +31,7 @@
 
 #include "LLVMRoutine.hpp"
 #include "LLVMRoutineManager.hpp"
+#include "Profiler.hpp"
 #include "x86.hpp"
 #include "Common/CPUID.hpp"
 #include "Common/Thread.hpp"
@@ -179,21 +180,8 @@ namespace sw
 		return llvm::cast<llvm::VectorType>(T(type))->getNumElements();
 	}
 
-	Nucleus::Nucleus()
+	static void createExecutionEngine(llvm::CodeGenOpt::Level optimizationLevel)
 	{
-		::codegenMutex.lock();   // Reactor and LLVM are currently not thread safe
-
-		llvm::InitializeNativeTarget();
-		llvm::JITEmitDebugInfo = false;
-
-		if(!::context)
-		{
-			::context = new llvm::LLVMContext();
-		}
-
-		::module = new llvm::Module("", *::context);
-		::routineManager = new LLVMRoutineManager();
-
 		#if defined(__x86_64__)
 			const char *architecture = "x86-64";
 		#else
@@ -209,9 +197,57 @@ namespace sw
 		MAttrs.push_back(CPUID::supportsSSSE3()  ? "+ssse3" : "-ssse3");
 		MAttrs.push_back(CPUID::supportsSSE4_1() ? "+sse41" : "-sse41");
 
+		// Position independent code has no absolute references into its own buffer (constant
+		// pools, jump tables), so it can run from the code heap's executable view of the memory.
+		#if defined(__x86_64__)
+			llvm::Reloc::Model relocationModel = llvm::Reloc::PIC_;
+			llvm::CodeModel::Model codeModel = llvm::CodeModel::Small;
+		#else
+			llvm::Reloc::Model relocationModel = llvm::Reloc::Default;
+			llvm::CodeModel::Model codeModel = llvm::CodeModel::JITDefault;
+		#endif
+
 		std::string error;
-		llvm::TargetMachine *targetMachine = llvm::EngineBuilder::selectTarget(::module, architecture, "", MAttrs, llvm::Reloc::Default, llvm::CodeModel::JITDefault, &error);
-		::executionEngine = llvm::JIT::createJIT(::module, 0, ::routineManager, llvm::CodeGenOpt::Aggressive, true, targetMachine);
+		llvm::TargetMachine *targetMachine = llvm::EngineBuilder::selectTarget(::module, architecture, "", MAttrs, relocationModel, codeModel, &error);
+		::executionEngine = llvm::JIT::createJIT(::module, 0, ::routineManager, optimizationLevel, true, targetMachine);
+	}
+
+	// Without instruction combining the emulated vector types produce many times
+	// larger code, which takes longer to generate than it saves on optimization.
+	static void optimizeBaseline()
+	{
+		static llvm::PassManager *passManager = nullptr;
+
+		if(!passManager)
+		{
+			passManager = new llvm::PassManager();
+
+			passManager->add(new llvm::TargetData(*::executionEngine->getTargetData()));
+			passManager->add(llvm::createScalarReplAggregatesPass());
+			passManager->add(llvm::createInstructionCombiningPass());
+		}
+
+		passManager->run(*::module);
+	}
+
+	Nucleus::Nucleus()
+	{
+		::codegenMutex.lock();   // Reactor and LLVM are currently not thread safe
+
+		llvm::InitializeNativeTarget();
+		llvm::JITEmitDebugInfo = false;
+
+		llvm::UnsafeFPMath = true;
+	//	llvm::NoInfsFPMath = true;
+	//	llvm::NoNaNsFPMath = true;
+
+		if(!::context)
+		{
+			::context = new llvm::LLVMContext();
+		}
+
+		::module = new llvm::Module("", *::context);
+		::routineManager = new LLVMRoutineManager();
 
 		if(!::builder)
 		{
@@ -233,8 +269,16 @@ namespace sw
 
 	Nucleus::~Nucleus()
 	{
-		delete ::executionEngine;
-		::executionEngine = nullptr;
+		if(::executionEngine)   // Owns the module and routine manager
+		{
+			delete ::executionEngine;
+			::executionEngine = nullptr;
+		}
+		else
+		{
+			delete ::module;
+			delete ::routineManager;
+		}
 
 		::routineManager = nullptr;
 		::function = nullptr;
@@ -266,10 +310,17 @@ namespace sw
 			::module->print(file, 0);
 		}
 
+		// The code generator's optimization level is fixed at JIT creation
+		createExecutionEngine(runOptimizations ? llvm::CodeGenOpt::Aggressive : llvm::CodeGenOpt::Less);
+
 		if(runOptimizations)
 		{
 			optimize();
 		}
+		else
+		{
+			optimizeBaseline();
+		}
 
 		if(false)
 		{
@@ -280,12 +331,15 @@ namespace sw
 
 		void *entry = ::executionEngine->getPointerToFunction(::function);
 		LLVMRoutine *routine = ::routineManager->acquireRoutine(entry);
+		routine->optimized = runOptimizations;
 
 		if(CodeAnalystLogJITCode)
 		{
 			CodeAnalystLogJITCode(routine->getEntry(), routine->getCodeSize(), name);
 		}
 
+		sw::profileRoutine(routine->getEntry(), routine->getCodeSize(), name);
+
 		return routine;
 	}
 
@@ -297,10 +351,6 @@ namespace sw
 		{
 			passManager = new llvm::PassManager();
 
-			llvm::UnsafeFPMath = true;
-		//	llvm::NoInfsFPMath = true;
-		//	llvm::NoNaNsFPMath = true;
-
 			passManager->add(new llvm::TargetData(*::executionEngine->getTargetData()));
 			passManager->add(llvm::createScalarReplAggregatesPass());
 
@@ -25,7 +25,8 @@ namespace sw
 		void *memory = allocateExecutable(bufferSize);
 
 		buffer = memory;
-		entry = memory;
+		executable = executableAlias(memory);
+		entry = executable;
 		functionSize = bufferSize;   // Updated by LLVMRoutineManager::endFunctionBody
 	}
 
@@ -41,6 +42,6 @@ namespace sw
 
 	int LLVMRoutine::getCodeSize()
 	{
-		return functionSize - static_cast<int>((uintptr_t)entry - (uintptr_t)buffer);
+		return functionSize - static_cast<int>((uintptr_t)entry - (uintptr_t)executable);
 	}
 }
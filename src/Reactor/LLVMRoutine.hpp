@@ -42,6 +42,7 @@ namespace sw
 
 	private:
 		void *buffer;
+		void *executable;   // Where the code written to buffer runs from
 		const void *entry;
 		int bufferSize;
 		int functionSize;
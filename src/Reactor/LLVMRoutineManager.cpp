@@ -64,7 +64,7 @@ namespace sw
 			sw::atomicIncrement(&averageInstructionSize);
 		}
 
-		// Round up to the next page size
+		// Round up to the next page size. The unused part is released by setMemoryExecutable.
 		size_t pageSize = memoryPageSize();
 		actualSize = (actualSize + pageSize - 1) & ~(pageSize - 1);
 
@@ -128,6 +128,10 @@ namespace sw
 
 	void LLVMRoutineManager::setMemoryExecutable()
 	{
+		// Emission succeeded, so release the unused part of the size estimate
+		shrinkExecutable(routine->buffer, routine->bufferSize, routine->functionSize);
+		routine->bufferSize = routine->functionSize;
+
 		markExecutable(routine->buffer, routine->bufferSize);
 	}
 
@@ -138,7 +142,8 @@ namespace sw
 
 	LLVMRoutine *LLVMRoutineManager::acquireRoutine(void *entry)
 	{
-		routine->entry = entry;
+		// The code was emitted into the writable view of the buffer
+		routine->entry = (uint8_t*)routine->executable + ((uint8_t*)entry - (uint8_t*)routine->buffer);
 
 		LLVMRoutine *result = routine;
 		routine = nullptr;
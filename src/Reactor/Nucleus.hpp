@@ -53,7 +53,7 @@ namespace sw
 
 		virtual ~Nucleus();
 
-		Routine *acquireRoutine(const wchar_t *name, bool runOptimizations = true);
+		Routine *acquireRoutine(const wchar_t *name, bool runOptimizations = true);   // Without optimizations LLVM compiles a baseline routine quickly
 
 		static Value *allocateStackVariable(Type *type, int arraySize = 0);
 		static BasicBlock *createBasicBlock();
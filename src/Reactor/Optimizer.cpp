@@ -17,6 +17,8 @@
 #include "src/IceCfg.h"
 #include "src/IceCfgNode.h"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
 namespace
@@ -28,14 +30,25 @@ namespace
 
 	private:
 		void analyzeUses(Ice::Cfg *function);
+		void analyzeControlFlow();
 		void eliminateDeadCode();
 		void eliminateUnitializedLoads();
 		void eliminateLoadsFollowingSingleStore();
 		void optimizeStoresInSingleBasicBlock();
+		void foldConstants();
+		void eliminateCommonSubexpressions();
+		void hoistLoopInvariants();
 
 		void replace(Ice::Inst *instruction, Ice::Operand *newValue);
 		void deleteInstruction(Ice::Inst *instruction);
 		bool isDead(Ice::Inst *instruction);
+		Ice::Operand *fold(Ice::InstArithmetic *arithmetic);
+		void replaceSource(Ice::Inst *instruction, Ice::SizeT i, Ice::Operand *newValue);
+		bool dominates(Ice::CfgNode *a, Ice::CfgNode *b) const;
+		bool dominates(Ice::Inst *a, Ice::Inst *b);
+		bool isArgument(Ice::Operand *value) const;
+		Ice::Operand *baseAddress(Ice::Operand *address, int64_t *offset);
+		Ice::Inst *terminator(Ice::CfgNode *node);
 
 		static const Ice::InstIntrinsicCall *asLoadSubVector(const Ice::Inst *instruction);
 		static const Ice::InstIntrinsicCall *asStoreSubVector(const Ice::Inst *instruction);
@@ -46,6 +59,9 @@ namespace
 		static Ice::Operand *storeData(const Ice::Inst *instruction);
 		static std::size_t storeSize(const Ice::Inst *instruction);
 		static bool loadTypeMatchesStore(const Ice::Inst *load, const Ice::Inst *store);
+		static bool isPure(const Ice::Inst *instruction);
+		static bool canTrap(const Ice::Inst *instruction);
+		static bool getConstantValue(const Ice::Operand *operand, int64_t *value);
 
 		Ice::Cfg *function;
 		Ice::GlobalContext *context;
@@ -74,6 +90,19 @@ namespace
 			bool isStore;
 		};
 
+		// Operation and operands of a pure instruction, used as a value numbering key
+		struct Expression
+		{
+			Expression(const Ice::Inst *instruction);
+
+			bool operator<(const Expression &other) const;
+
+			Ice::Inst::InstKind kind;
+			int op;
+			Ice::Type type;
+			Ice::Operand *src[3];
+		};
+
 		Optimizer::Uses* getUses(Ice::Operand*);
 		void setUses(Ice::Operand*, Optimizer::Uses*);
 		bool hasUses(Ice::Operand*) const;
@@ -89,6 +118,11 @@ namespace
 		bool hasLoadStoreInsts(Ice::CfgNode* node) const;
 
 		std::vector<Optimizer::Uses*> allocatedUses;
+
+		// Dominator tree, indexed by node number
+		std::vector<Ice::CfgNode*> immediateDominator;
+		std::vector<int> postOrder;
+		Ice::NodeList reversePostOrder;
 	};
 
 	void Optimizer::run(Ice::Cfg *function)
@@ -97,12 +131,18 @@ namespace
 		this->context = function->getContext();
 
 		analyzeUses(function);
+		analyzeControlFlow();
 
 		eliminateDeadCode();
 		eliminateUnitializedLoads();
 		eliminateLoadsFollowingSingleStore();
 		optimizeStoresInSingleBasicBlock();
 		eliminateDeadCode();
+		foldConstants();
+		eliminateCommonSubexpressions();
+		hoistLoopInvariants();
+		eliminateCommonSubexpressions();   // Merges the loads hoisted out of nested loops
+		eliminateDeadCode();
 
 		for(auto uses : allocatedUses)
 		{
@@ -235,14 +275,22 @@ namespace
 				Ice::Inst *store = addressUses.stores[0];
 				Ice::Operand *storeValue = storeData(store);
 
-				for(Ice::Inst *load = &*++store->getIterator(), *next = nullptr; load != next; next = load, load = &*++store->getIterator())
+				// The stored value must not be redefined between the store and the loads
+				if(Ice::Variable *variable = llvm::dyn_cast<Ice::Variable>(storeValue))
 				{
-					if(load->isDeleted() || !isLoad(*load))
+					Ice::Inst *definition = getDefinition(variable);
+
+					if(!isArgument(variable) && (!definition || getNode(definition) != getNode(store)))
 					{
 						continue;
 					}
+				}
+
+				std::vector<Ice::Inst*> loads = addressUses.loads;
 
-					if(loadAddress(load) != address)
+				for(Ice::Inst *load : loads)
+				{
+					if(!dominates(store, load))
 					{
 						continue;
 					}
@@ -253,56 +301,26 @@ namespace
 					}
 
 					replace(load, storeValue);
+				}
 
-					for(size_t i = 0; i < addressUses.loads.size(); i++)
-					{
-						if(addressUses.loads[i] == load)
-						{
-							addressUses.loads[i] = addressUses.loads.back();
-							addressUses.loads.pop_back();
-							break;
-						}
-					}
+				if(addressUses.size() == 1)
+				{
+					assert(addressUses[0] == store);
 
-					for(size_t i = 0; i < addressUses.size(); i++)
-					{
-						if(addressUses[i] == load)
-						{
-							addressUses[i] = addressUses.back();
-							addressUses.pop_back();
-							break;
-						}
-					}
+					alloca.setDeleted();
+					store->setDeleted();
+					setUses(address, nullptr);
 
-					if(addressUses.size() == 1)
+					if(hasUses(storeValue))
 					{
-						assert(addressUses[0] == store);
+						auto &valueUses = *getUses(storeValue);
 
-						alloca.setDeleted();
-						store->setDeleted();
-						setUses(address, nullptr);
+						valueUses.erase(store);
 
-						if(hasUses(storeValue))
+						if(valueUses.empty())
 						{
-							auto &valueUses = *getUses(storeValue);
-
-							for(size_t i = 0; i < valueUses.size(); i++)
-							{
-								if(valueUses[i] == store)
-								{
-									valueUses[i] = valueUses.back();
-									valueUses.pop_back();
-									break;
-								}
-							}
-
-							if(valueUses.empty())
-							{
-								setUses(storeValue, nullptr);
-							}
+							setUses(storeValue, nullptr);
 						}
-
-						break;
 					}
 				}
 			}
@@ -427,6 +445,297 @@ namespace
 		}
 	}
 
+	void Optimizer::foldConstants()
+	{
+		for(Ice::CfgNode *basicBlock : function->getNodes())
+		{
+			for(Ice::Inst &inst : basicBlock->getInsts())
+			{
+				if(inst.isDeleted())
+				{
+					continue;
+				}
+
+				if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(&inst))
+				{
+					if(Ice::Operand *value = fold(arithmetic))
+					{
+						replace(arithmetic, value);
+					}
+				}
+			}
+		}
+	}
+
+	void Optimizer::eliminateCommonSubexpressions()
+	{
+		// Dominating instructions are visited first, so the first of each expression is kept
+		std::map<Expression, std::vector<Ice::Inst*>> expressions;
+
+		for(Ice::CfgNode *basicBlock : reversePostOrder)
+		{
+			std::map<std::pair<Ice::Operand*, Ice::Type>, Ice::Inst*> loads;   // Since the last store or call
+
+			for(Ice::Inst &inst : basicBlock->getInsts())
+			{
+				if(inst.isDeleted())
+				{
+					continue;
+				}
+
+				if(auto *load = llvm::dyn_cast<Ice::InstLoad>(&inst))
+				{
+					auto key = std::make_pair(load->getSourceAddress(), load->getDest()->getType());
+					auto previous = loads.find(key);
+
+					if(previous != loads.end() && !previous->second->isDeleted())
+					{
+						replace(load, previous->second->getDest());
+					}
+					else
+					{
+						loads[key] = load;
+					}
+				}
+				else if(isStore(inst) || inst.hasSideEffects())
+				{
+					loads.clear();
+				}
+				else if(isPure(&inst))
+				{
+					std::vector<Ice::Inst*> &equivalents = expressions[Expression(&inst)];
+					Ice::Inst *dominator = nullptr;
+
+					for(Ice::Inst *equivalent : equivalents)
+					{
+						if(!equivalent->isDeleted() && dominates(getNode(equivalent), basicBlock))
+						{
+							dominator = equivalent;
+							break;
+						}
+					}
+
+					if(dominator)
+					{
+						replace(&inst, dominator->getDest());
+					}
+					else
+					{
+						equivalents.push_back(&inst);
+					}
+				}
+			}
+		}
+	}
+
+	void Optimizer::hoistLoopInvariants()
+	{
+		// Natural loops, identified by their header
+		std::map<Ice::CfgNode*, std::vector<bool>> loops;
+
+		for(Ice::CfgNode *basicBlock : reversePostOrder)
+		{
+			for(Ice::CfgNode *successor : basicBlock->getOutEdges())
+			{
+				if(!dominates(successor, basicBlock))
+				{
+					continue;
+				}
+
+				std::vector<bool> &body = loops[successor];
+				body.resize(function->getNumNodes());
+				body[successor->getIndex()] = true;
+
+				std::vector<Ice::CfgNode*> worklist(1, basicBlock);
+
+				while(!worklist.empty())
+				{
+					Ice::CfgNode *node = worklist.back();
+					worklist.pop_back();
+
+					if(!body[node->getIndex()])
+					{
+						body[node->getIndex()] = true;
+						worklist.insert(worklist.end(), node->getInEdges().begin(), node->getInEdges().end());
+					}
+				}
+			}
+		}
+
+		// Inner loops first, so their invariants can move further out afterwards
+		std::vector<std::pair<size_t, Ice::SizeT>> order;
+
+		for(auto &loop : loops)
+		{
+			order.push_back(std::make_pair(std::count(loop.second.begin(), loop.second.end(), true), loop.first->getIndex()));
+		}
+
+		std::sort(order.begin(), order.end());
+
+		for(auto &entry : order)
+		{
+			Ice::CfgNode *header = function->getNodes()[entry.second];
+			const std::vector<bool> &body = loops[header];
+
+			Ice::CfgNode *preheader = nullptr;
+
+			for(Ice::CfgNode *predecessor : header->getInEdges())
+			{
+				if(!body[predecessor->getIndex()])
+				{
+					if(preheader)
+					{
+						preheader = nullptr;
+						break;
+					}
+
+					preheader = predecessor;
+				}
+			}
+
+			if(!preheader || preheader->getOutEdges().size() != 1)
+			{
+				continue;
+			}
+
+			// Memory reached through the routine's arguments is assumed to be written only through
+			// addresses derived from those arguments. Stack variables and memory reached through
+			// loaded pointers (e.g. the render targets) don't clobber it.
+			bool argumentsWritten = false;
+
+			for(Ice::CfgNode *basicBlock : reversePostOrder)
+			{
+				if(!body[basicBlock->getIndex()])
+				{
+					continue;
+				}
+
+				for(Ice::Inst &inst : basicBlock->getInsts())
+				{
+					if(inst.isDeleted())
+					{
+						continue;
+					}
+
+					if(isStore(inst))
+					{
+						Ice::Variable *base = llvm::dyn_cast<Ice::Variable>(baseAddress(storeAddress(&inst), nullptr));
+						Ice::Inst *definition = base ? getDefinition(base) : nullptr;
+
+						if(!definition || !(llvm::isa<Ice::InstAlloca>(definition) || isLoad(*definition)))
+						{
+							argumentsWritten = true;
+						}
+					}
+					else if(inst.hasSideEffects() && !isLoad(inst))
+					{
+						argumentsWritten = true;
+					}
+				}
+			}
+
+			Ice::Inst *insertionPoint = terminator(preheader);
+			std::vector<std::pair<Ice::Inst*, Ice::CfgNode*>> invariants;
+
+			for(Ice::CfgNode *basicBlock : reversePostOrder)
+			{
+				if(!body[basicBlock->getIndex()])
+				{
+					continue;
+				}
+
+				for(Ice::Inst &inst : basicBlock->getInsts())
+				{
+					if(inst.isDeleted())
+					{
+						continue;
+					}
+
+					if(isLoad(inst))
+					{
+						// Only fixed offsets from an argument are known to be safe to load speculatively.
+						// The address gets recomputed in the preheader, so it needn't be invariant itself.
+						int64_t offset = 0;
+
+						if(!argumentsWritten && isArgument(baseAddress(loadAddress(&inst), &offset)) && offset == (int32_t)offset)
+						{
+							invariants.push_back(std::make_pair(&inst, basicBlock));
+							setNode(&inst, preheader);
+						}
+
+						continue;
+					}
+
+					if(!isPure(&inst) || canTrap(&inst))
+					{
+						continue;
+					}
+
+					// Constant offsets get folded into addressing modes, so hoisting them only adds register pressure
+					if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(&inst))
+					{
+						if((arithmetic->getOp() == Ice::InstArithmetic::Add || arithmetic->getOp() == Ice::InstArithmetic::Sub) &&
+						   llvm::isa<Ice::Constant>(arithmetic->getSrc(1)))
+						{
+							continue;
+						}
+					}
+
+					bool invariant = true;
+
+					for(Ice::SizeT i = 0; i < inst.getSrcSize(); i++)
+					{
+						if(Ice::Variable *variable = llvm::dyn_cast<Ice::Variable>(inst.getSrc(i)))
+						{
+							Ice::Inst *definition = getDefinition(variable);
+
+							if(definition && body[getNode(definition)->getIndex()])
+							{
+								invariant = false;
+								break;
+							}
+						}
+					}
+
+					if(invariant)
+					{
+						invariants.push_back(std::make_pair(&inst, basicBlock));
+						setNode(&inst, preheader);
+					}
+				}
+			}
+
+			for(auto &invariant : invariants)
+			{
+				Ice::Inst *inst = invariant.first;
+
+				invariant.second->getInsts().remove(Ice::instToIterator(inst));
+				preheader->getInsts().insert(Ice::instToIterator(insertionPoint), inst);
+
+				if(isLoad(*inst))
+				{
+					int64_t offset = 0;
+					Ice::Operand *address = loadAddress(inst);
+					Ice::Operand *base = baseAddress(address, &offset);
+
+					if(address != base)
+					{
+						Ice::Variable *hoistedAddress = function->makeVariable(base->getType());
+						auto *add = Ice::InstArithmetic::create(function, Ice::InstArithmetic::Add, hoistedAddress, base, context->getConstantInt32((int32_t)offset));
+						preheader->getInsts().insert(Ice::instToIterator(inst), add);
+
+						setNode(add, preheader);
+						setDefinition(hoistedAddress, add);
+						getUses(base)->insert(base, add);
+						getUses(add->getSrc(1))->insert(add->getSrc(1), add);
+
+						replaceSource(inst, llvm::isa<Ice::InstLoad>(inst) ? 0 : 1, hoistedAddress);
+					}
+				}
+			}
+		}
+	}
+
 	void Optimizer::analyzeUses(Ice::Cfg *function)
 	{
 		for(Ice::CfgNode *basicBlock : function->getNodes())
@@ -465,6 +774,103 @@ namespace
 		}
 	}
 
+	void Optimizer::analyzeControlFlow()
+	{
+		Ice::SizeT nodeCount = function->getNumNodes();
+
+		immediateDominator.assign(nodeCount, nullptr);
+		postOrder.assign(nodeCount, -1);
+		reversePostOrder.clear();
+
+		// Depth-first traversal, numbering the nodes in post-order
+		std::vector<std::pair<Ice::CfgNode*, size_t>> stack;
+		std::vector<bool> visited(nodeCount);
+		Ice::CfgNode *entryBlock = function->getEntryNode();
+
+		stack.push_back(std::make_pair(entryBlock, 0));
+		visited[entryBlock->getIndex()] = true;
+
+		while(!stack.empty())
+		{
+			Ice::CfgNode *node = stack.back().first;
+			size_t &next = stack.back().second;
+			const Ice::NodeList &edges = node->getOutEdges();
+
+			if(next < edges.size())
+			{
+				Ice::CfgNode *successor = edges[next++];
+
+				if(!visited[successor->getIndex()])
+				{
+					visited[successor->getIndex()] = true;
+					stack.push_back(std::make_pair(successor, 0));
+				}
+			}
+			else
+			{
+				postOrder[node->getIndex()] = (int)reversePostOrder.size();
+				reversePostOrder.push_back(node);
+				stack.pop_back();
+			}
+		}
+
+		std::reverse(reversePostOrder.begin(), reversePostOrder.end());
+
+		// Iterative dominator computation (Cooper, Harvey and Kennedy)
+		immediateDominator[entryBlock->getIndex()] = entryBlock;
+
+		bool modified;
+		do
+		{
+			modified = false;
+			for(Ice::CfgNode *basicBlock : reversePostOrder)
+			{
+				if(basicBlock == entryBlock)
+				{
+					continue;
+				}
+
+				Ice::CfgNode *dominator = nullptr;
+
+				for(Ice::CfgNode *predecessor : basicBlock->getInEdges())
+				{
+					if(!immediateDominator[predecessor->getIndex()])
+					{
+						continue;   // Not processed yet, or unreachable
+					}
+
+					if(!dominator)
+					{
+						dominator = predecessor;
+						continue;
+					}
+
+					Ice::CfgNode *other = predecessor;
+
+					while(dominator != other)
+					{
+						while(postOrder[dominator->getIndex()] < postOrder[other->getIndex()])
+						{
+							dominator = immediateDominator[dominator->getIndex()];
+						}
+
+						while(postOrder[other->getIndex()] < postOrder[dominator->getIndex()])
+						{
+							other = immediateDominator[other->getIndex()];
+						}
+					}
+				}
+
+				if(immediateDominator[basicBlock->getIndex()] != dominator)
+				{
+					immediateDominator[basicBlock->getIndex()] = dominator;
+					modified = true;
+				}
+			}
+		}
+		while(modified);
+	}
+
 	void Optimizer::replace(Ice::Inst *instruction, Ice::Operand *newValue)
 	{
 		Ice::Variable *oldValue = instruction->getDest();
@@ -561,6 +967,235 @@ namespace
 		return false;
 	}
 
+	Ice::Operand *Optimizer::fold(Ice::InstArithmetic *arithmetic)
+	{
+		Ice::Type type = arithmetic->getDest()->getType();
+
+		if(type != Ice::IceType_i32 && type != Ice::IceType_i64)
+		{
+			return nullptr;
+		}
+
+		Ice::Operand *lhs = arithmetic->getSrc(0);
+		Ice::Operand *rhs = arithmetic->getSrc(1);
+		int64_t x = 0;
+		int64_t y = 0;
+
+		if(!getConstantValue(rhs, &y))
+		{
+			return nullptr;
+		}
+
+		if(getConstantValue(lhs, &x))
+		{
+			uint64_t a = (uint64_t)x;
+			uint64_t b = (uint64_t)y;
+			int bits = (type == Ice::IceType_i32) ? 32 : 64;
+			uint64_t result = 0;
+
+			switch(arithmetic->getOp())
+			{
+			case Ice::InstArithmetic::Add:  result = a + b;   break;
+			case Ice::InstArithmetic::Sub:  result = a - b;   break;
+			case Ice::InstArithmetic::Mul:  result = a * b;   break;
+			case Ice::InstArithmetic::And:  result = a & b;   break;
+			case Ice::InstArithmetic::Or:   result = a | b;   break;
+			case Ice::InstArithmetic::Xor:  result = a ^ b;   break;
+			case Ice::InstArithmetic::Shl:
+				if(b >= (uint64_t)bits) return nullptr;
+				result = a << b;
+				break;
+			case Ice::InstArithmetic::Lshr:
+				if(b >= (uint64_t)bits) return nullptr;
+				result = (bits == 32) ? (uint32_t)a >> b : a >> b;
+				break;
+			case Ice::InstArithmetic::Ashr:
+				if(b >= (uint64_t)bits) return nullptr;
+				result = (bits == 32) ? (uint64_t)((int32_t)a >> b) : (uint64_t)((int64_t)a >> b);
+				break;
+			default:
+				return nullptr;
+			}
+
+			if(bits == 32)
+			{
+				return context->getConstantInt32((int32_t)result);
+			}
+
+			return context->getConstantInt64((int64_t)result);
+		}
+
+		if(lhs->getType() != type)
+		{
+			return nullptr;
+		}
+
+		switch(arithmetic->getOp())
+		{
+		case Ice::InstArithmetic::Add:
+		case Ice::InstArithmetic::Sub:
+		case Ice::InstArithmetic::Or:
+		case Ice::InstArithmetic::Xor:
+		case Ice::InstArithmetic::Shl:
+		case Ice::InstArithmetic::Lshr:
+		case Ice::InstArithmetic::Ashr:
+			if(y == 0)
+			{
+				return lhs;
+			}
+			break;
+		case Ice::InstArithmetic::Mul:
+			if(y == 1)
+			{
+				return lhs;
+			}
+			break;
+		default:
+			break;
+		}
+
+		// Combine the constant offsets of chained additions, as produced by pointer arithmetic
+		if(arithmetic->getOp() == Ice::InstArithmetic::Add)
+		{
+			Ice::Variable *variable = llvm::dyn_cast<Ice::Variable>(lhs);
+			auto *inner = variable ? llvm::dyn_cast_or_null<Ice::InstArithmetic>(getDefinition(variable)) : nullptr;
+			int64_t z = 0;
+
+			if(inner && !inner->isDeleted() && inner->getOp() == Ice::InstArithmetic::Add &&
+			   getConstantValue(inner->getSrc(1), &z) && inner->getSrc(0)->getType() == type)
+			{
+				int64_t sum = z + y;
+
+				if(rhs->getType() == Ice::IceType_i32 && sum != (int32_t)sum)
+				{
+					return nullptr;
+				}
+
+				Ice::Operand *offset = (rhs->getType() == Ice::IceType_i32) ?
+				                       context->getConstantInt32((int32_t)sum) :
+				                       context->getConstantInt64(sum);
+
+				replaceSource(arithmetic, 0, inner->getSrc(0));
+				replaceSource(arithmetic, 1, offset);
+			}
+		}
+
+		return nullptr;
+	}
+
+	void Optimizer::replaceSource(Ice::Inst *instruction, Ice::SizeT i, Ice::Operand *newValue)
+	{
+		Ice::Operand *oldValue = instruction->getSrc(i);
+
+		instruction->replaceSource(i, newValue);
+		getUses(newValue)->insert(newValue, instruction);
+
+		for(Ice::SizeT j = 0; j < instruction->getSrcSize(); j++)
+		{
+			if(instruction->getSrc(j) == oldValue)
+			{
+				return;   // Still used
+			}
+		}
+
+		if(hasUses(oldValue))
+		{
+			auto &oldUses = *getUses(oldValue);
+
+			oldUses.erase(instruction);
+
+			if(oldUses.empty())
+			{
+				setUses(oldValue, nullptr);
+
+				if(Ice::Variable *var = llvm::dyn_cast<Ice::Variable>(oldValue))
+				{
+					deleteInstruction(getDefinition(var));
+				}
+			}
+		}
+	}
+
+	bool Optimizer::dominates(Ice::CfgNode *a, Ice::CfgNode *b) const
+	{
+		Ice::CfgNode *entryBlock = function->getEntryNode();
+
+		while(b != a)
+		{
+			if(b == entryBlock || !immediateDominator[b->getIndex()])
+			{
+				return false;
+			}
+
+			b = immediateDominator[b->getIndex()];
+		}
+
+		return true;
+	}
+
+	bool Optimizer::dominates(Ice::Inst *a, Ice::Inst *b)
+	{
+		Ice::CfgNode *node = getNode(a);
+
+		if(node != getNode(b))
+		{
+			return dominates(node, getNode(b));
+		}
+
+		// Reactor appends instructions in creation order (except allocas), and they haven't been moved yet
+		return a->getNumber() < b->getNumber();
+	}
+
+	bool Optimizer::isArgument(Ice::Operand *value) const
+	{
+		const Ice::VarList &arguments = function->getArgs();
+
+		return std::find(arguments.begin(), arguments.end(), value) != arguments.end();
+	}
+
+	Ice::Operand *Optimizer::baseAddress(Ice::Operand *address, int64_t *offset)
+	{
+		while(Ice::Variable *variable = llvm::dyn_cast<Ice::Variable>(address))
+		{
+			auto *arithmetic = llvm::dyn_cast_or_null<Ice::InstArithmetic>(getDefinition(variable));
+
+			if(!arithmetic || arithmetic->isDeleted() ||
+			   (arithmetic->getOp() != Ice::InstArithmetic::Add && arithmetic->getOp() != Ice::InstArithmetic::Sub))
+			{
+				break;
+			}
+
+			if(offset)
+			{
+				int64_t value = 0;
+
+				if(!getConstantValue(arithmetic->getSrc(1), &value))
+				{
+					break;   // Only follow constant offsets
+				}
+
+				*offset += (arithmetic->getOp() == Ice::InstArithmetic::Add) ? value : -value;
+			}
+
+			address = arithmetic->getSrc(0);
+		}
+
+		return address;
+	}
+
+	Ice::Inst *Optimizer::terminator(Ice::CfgNode *node)
+	{
+		for(Ice::Inst &inst : Ice::reverse_range(node->getInsts()))
+		{
+			if(!inst.isDeleted())
+			{
+				return &inst;
+			}
+		}
+
+		return nullptr;
+	}
+
 	const Ice::InstIntrinsicCall *Optimizer::asLoadSubVector(const Ice::Inst *instruction)
 	{
 		if(auto *instrinsic = llvm::dyn_cast<Ice::InstIntrinsicCall>(instruction))
@@ -707,6 +1342,60 @@ namespace
 		return false;
 	}
 
+	bool Optimizer::isPure(const Ice::Inst *instruction)
+	{
+		switch(instruction->getKind())
+		{
+		case Ice::Inst::Arithmetic:
+		case Ice::Inst::Cast:
+		case Ice::Inst::ExtractElement:
+		case Ice::Inst::Fcmp:
+		case Ice::Inst::Icmp:
+		case Ice::Inst::InsertElement:
+		case Ice::Inst::Select:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool Optimizer::canTrap(const Ice::Inst *instruction)
+	{
+		if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(instruction))
+		{
+			switch(arithmetic->getOp())
+			{
+			case Ice::InstArithmetic::Udiv:
+			case Ice::InstArithmetic::Sdiv:
+			case Ice::InstArithmetic::Urem:
+			case Ice::InstArithmetic::Srem:
+			case Ice::InstArithmetic::Frem:
+				return true;
+			default:
+				break;
+			}
+		}
+
+		return false;
+	}
+
+	bool Optimizer::getConstantValue(const Ice::Operand *operand, int64_t *value)
+	{
+		if(auto *constant = llvm::dyn_cast<Ice::ConstantInteger32>(operand))
+		{
+			*value = constant->getValue();
+			return true;
+		}
+
+		if(auto *constant = llvm::dyn_cast<Ice::ConstantInteger64>(operand))
+		{
+			*value = constant->getValue();
+			return true;
+		}
+
+		return false;
+	}
+
 	Optimizer::Uses* Optimizer::getUses(Ice::Operand* operand)
 	{
 		Optimizer::Uses* uses = (Optimizer::Uses*)operand->Ice::Operand::getExternalData();
@@ -824,6 +1513,36 @@ namespace
 			}
 		}
 	}
+
+	Optimizer::Expression::Expression(const Ice::Inst *instruction)
+	{
+		kind = instruction->getKind();
+		type = instruction->getDest()->getType();
+
+		switch(kind)
+		{
+		case Ice::Inst::Arithmetic: op = llvm::cast<Ice::InstArithmetic>(instruction)->getOp();   break;
+		case Ice::Inst::Cast:       op = llvm::cast<Ice::InstCast>(instruction)->getCastKind();   break;
+		case Ice::Inst::Fcmp:       op = llvm::cast<Ice::InstFcmp>(instruction)->getCondition();  break;
+		case Ice::Inst::Icmp:       op = llvm::cast<Ice::InstIcmp>(instruction)->getCondition();  break;
+		default:                    op = 0;
+		}
+
+		for(Ice::SizeT i = 0; i < 3; i++)
+		{
+			src[i] = (i < instruction->getSrcSize()) ? instruction->getSrc(i) : nullptr;
+		}
+	}
+
+	bool Optimizer::Expression::operator<(const Expression &other) const
+	{
+		if(kind != other.kind) return kind < other.kind;
+		if(op != other.op) return op < other.op;
+		if(type != other.type) return type < other.type;
+		if(src[0] != other.src[0]) return src[0] < other.src[0];
+		if(src[1] != other.src[1]) return src[1] < other.src[1];
+		return src[2] < other.src[2];
+	}
 }
 
 namespace sw
@@ -0,0 +1,228 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Profiler.hpp"
+
+#include "../Common/MutexLock.hpp"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+#if defined(__linux__)
+	#include <elf.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <time.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	#if defined(__linux__)
+		// Record layouts of the perf jitdump format (tools/perf/util/jitdump.h)
+		struct JitDumpHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t totalSize;
+			uint32_t elfMachine;
+			uint32_t padding;
+			uint32_t pid;
+			uint64_t timestamp;
+			uint64_t flags;
+		};
+
+		struct JitDumpCodeLoad
+		{
+			uint32_t id;
+			uint32_t totalSize;
+			uint64_t timestamp;
+			uint32_t pid;
+			uint32_t tid;
+			uint64_t vma;
+			uint64_t codeAddress;
+			uint64_t codeSize;
+			uint64_t codeIndex;
+		};
+
+		const uint32_t JitDumpMagic = 0x4A695444;   // "JiTD"
+		const uint32_t JitCodeLoad = 0;
+
+		uint64_t timestamp()
+		{
+			timespec time;
+			clock_gettime(CLOCK_MONOTONIC, &time);   // Matches 'perf record -k mono'
+
+			return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+		}
+
+		uint32_t elfMachine()
+		{
+			#if defined(__x86_64__)
+				return EM_X86_64;
+			#elif defined(__i386__)
+				return EM_386;
+			#elif defined(__aarch64__)
+				return EM_AARCH64;
+			#elif defined(__arm__)
+				return EM_ARM;
+			#elif defined(__mips__)
+				return EM_MIPS;
+			#else
+				return EM_NONE;
+			#endif
+		}
+	#endif
+
+	class Profiler
+	{
+	public:
+		Profiler()
+		{
+			perfMap = nullptr;
+			jitDump = nullptr;
+			codeIndex = 0;
+
+			const char *dumpDirectory = getenv("SWIFTSHADER_DUMP_ROUTINES");
+
+			if(dumpDirectory)
+			{
+				routineDirectory = dumpDirectory;
+			}
+
+			#if defined(__linux__)
+				char fileName[64];
+
+				if(getenv("SWIFTSHADER_PERF_MAP"))
+				{
+					sprintf(fileName, "/tmp/perf-%d.map", getpid());
+					perfMap = fopen(fileName, "a");
+				}
+
+				if(getenv("SWIFTSHADER_JITDUMP"))
+				{
+					sprintf(fileName, "/tmp/jit-%d.dump", getpid());
+					jitDump = fopen(fileName, "w+");
+				}
+
+				if(jitDump)
+				{
+					// perf finds the dump through an executable mapping of the file recorded in its event stream
+					long pageSize = sysconf(_SC_PAGESIZE);
+					void *marker = mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, fileno(jitDump), 0);
+
+					if(marker == MAP_FAILED)
+					{
+						fclose(jitDump);
+						jitDump = nullptr;
+					}
+				}
+
+				if(jitDump)
+				{
+					JitDumpHeader header = {};
+					header.magic = JitDumpMagic;
+					header.version = 1;
+					header.totalSize = sizeof(JitDumpHeader);
+					header.elfMachine = elfMachine();
+					header.pid = getpid();
+					header.timestamp = timestamp();
+
+					fwrite(&header, sizeof(header), 1, jitDump);
+					fflush(jitDump);
+				}
+			#endif
+		}
+
+		bool enabled() const
+		{
+			return perfMap || jitDump || !routineDirectory.empty();
+		}
+
+		void add(const void *code, size_t size, const wchar_t *name)
+		{
+			std::string routineName;
+
+			for(const wchar_t *c = name; *c; c++)
+			{
+				routineName += (*c < 0x80) ? (char)*c : '?';
+			}
+
+			LockGuard lock(mutex);
+
+			if(perfMap)
+			{
+				fprintf(perfMap, "%lx %lx %s\n", (unsigned long)(uintptr_t)code, (unsigned long)size, routineName.c_str());
+				fflush(perfMap);
+			}
+
+			#if defined(__linux__)
+				if(jitDump)
+				{
+					JitDumpCodeLoad record = {};
+					record.id = JitCodeLoad;
+					record.totalSize = (uint32_t)(sizeof(JitDumpCodeLoad) + routineName.size() + 1 + size);
+					record.timestamp = timestamp();
+					record.pid = getpid();
+					record.tid = (uint32_t)syscall(SYS_gettid);
+					record.vma = (uintptr_t)code;
+					record.codeAddress = (uintptr_t)code;
+					record.codeSize = size;
+					record.codeIndex = codeIndex++;
+
+					fwrite(&record, sizeof(record), 1, jitDump);
+					fwrite(routineName.c_str(), routineName.size() + 1, 1, jitDump);
+					fwrite(code, size, 1, jitDump);
+					fflush(jitDump);
+				}
+			#endif
+
+			if(!routineDirectory.empty())
+			{
+				// Disassemble with: objdump -D -b binary -m i386:x86-64 <name>.bin
+				std::string fileName = routineDirectory + "/" + routineName + ".bin";
+				FILE *file = fopen(fileName.c_str(), "wb");
+
+				if(file)
+				{
+					fwrite(code, size, 1, file);
+					fclose(file);
+				}
+			}
+		}
+
+	private:
+		FILE *perfMap;
+		FILE *jitDump;
+		uint64_t codeIndex;
+		std::string routineDirectory;
+		sw::MutexLock mutex;
+	};
+}
+
+namespace sw
+{
+	void profileRoutine(const void *code, size_t size, const wchar_t *name)
+	{
+		// Never destroyed, so routines created during shutdown can still be recorded
+		static Profiler *profiler = new Profiler();
+
+		if(profiler->enabled())
+		{
+			profiler->add(code, size, name);
+		}
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Profiler_hpp
+#define sw_Profiler_hpp
+
+#include <stddef.h>
+
+namespace sw
+{
+	// Makes generated code visible to profilers and debugging tools. Controlled by environment variables:
+	//   SWIFTSHADER_PERF_MAP        Append each routine to /tmp/perf-<pid>.map, for 'perf report'
+	//   SWIFTSHADER_JITDUMP         Write /tmp/jit-<pid>.dump, for 'perf record -k mono' + 'perf inject --jit'
+	//   SWIFTSHADER_DUMP_ROUTINES   Directory in which to store the code of each routine as <name>.bin
+	void profileRoutine(const void *code, size_t size, const wchar_t *name);
+}
+
+#endif   // sw_Profiler_hpp
@@ -2248,6 +2248,7 @@ namespace sw
 		}
 
 		Routine *operator()(const wchar_t *name, ...);
+		Routine *compile(bool runOptimizations, const wchar_t *name, ...);   // Baseline routines compile faster but run slower (LLVM only)
 
 	protected:
 		Nucleus *core;
@@ -2759,6 +2760,19 @@ namespace sw
 		return core->acquireRoutine(fullName, true);
 	}
 
+	template<typename Return, typename... Arguments>
+	Routine *Function<Return(Arguments...)>::compile(bool runOptimizations, const wchar_t *name, ...)
+	{
+		wchar_t fullName[1024 + 1];
+
+		va_list vararg;
+		va_start(vararg, name);
+		vswprintf(fullName, 1024, name, vararg);
+		va_end(vararg);
+
+		return core->acquireRoutine(fullName, runOptimizations);
+	}
+
 	template<class T, class S>
 	RValue<T> ReinterpretCast(RValue<S> val)
 	{
@@ -23,6 +23,8 @@ namespace sw
 	Routine::Routine()
 	{
 		bindCount = 0;
+		optimized = true;
+		useCount = 0;
 	}
 
 	void Routine::bind()
@@ -40,6 +42,16 @@ namespace sw
 		}
 	}
 
+	bool Routine::isOptimized() const
+	{
+		return optimized;
+	}
+
+	int Routine::countUse()
+	{
+		return ++useCount;
+	}
+
 	Routine::~Routine()
 	{
 		assert(bindCount == 0);
@@ -25,13 +25,22 @@ namespace sw
 		virtual ~Routine();
 
 		virtual const void *getEntry() = 0;
+		virtual int getCodeSize() = 0;   // Executable code only
 
 		// Reference counting
 		void bind();
 		void unbind();
 
+		// Tiered compilation
+		bool isOptimized() const;
+		int countUse();   // Returns how many times the routine was selected. Not thread-safe.
+
 	private:
+		friend class Nucleus;
+
 		volatile int bindCount;
+		bool optimized;   // False for baseline routines
+		int useCount;
 	};
 }
 
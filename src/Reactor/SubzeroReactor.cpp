@@ -15,6 +15,7 @@
 #include "Reactor.hpp"
 
 #include "Optimizer.hpp"
+#include "Profiler.hpp"
 
 #include "src/IceTypes.h"
 #include "src/IceCfg.h"
@@ -446,7 +447,7 @@ namespace sw
 		ELFMemoryStreamer &operator=(const ELFMemoryStreamer &) = delete;
 
 	public:
-		ELFMemoryStreamer() : Routine(), entry(nullptr)
+		ELFMemoryStreamer() : Routine(), entry(nullptr), codeSize(0)
 		{
 			position = 0;
 			buffer.reserve(0x1000);
@@ -490,13 +491,14 @@ namespace sw
 
 		void seek(uint64_t Off) override { position = Off; }
 
+		void setName(const std::wstring &routineName) { name = routineName; }
+
 		const void *getEntry() override
 		{
 			if(!entry)
 			{
 				position = std::numeric_limits<std::size_t>::max();   // Can't stream more data after this
 
-				size_t codeSize = 0;
 				entry = loadImage(&buffer[0], codeSize);
 
 				#if defined(_WIN32)
@@ -506,15 +508,26 @@ namespace sw
 					mprotect(&buffer[0], buffer.size(), PROT_READ | PROT_EXEC);
 					__builtin___clear_cache((char*)entry, (char*)entry + codeSize);
 				#endif
+
+				sw::profileRoutine(entry, codeSize, name.c_str());
 			}
 
 			return entry;
 		}
 
+		int getCodeSize() override
+		{
+			getEntry();
+
+			return static_cast<int>(codeSize);
+		}
+
 	private:
 		void *entry;
+		std::size_t codeSize;
 		std::vector<uint8_t, ExecutableAllocator<uint8_t>> buffer;
 		std::size_t position;
+		std::wstring name;
 
 		#if defined(_WIN32)
 		DWORD oldProtection;
@@ -584,6 +597,11 @@ namespace sw
 		std::string asciiName(wideName.begin(), wideName.end());
 		::function->setFunctionName(Ice::GlobalString::createWithString(::context, asciiName));
 
+		// Liveness analysis needs the control flow edges, or values live across a loop's back edge can share a register
+		::function->computeInOutEdges();
+
+		// Subzero has no baseline tier. Opt_m1 code is over ten times larger, which makes it slower
+		// to compile than Opt_2 code, so runOptimizations is ignored and tiered compilation is LLVM only.
 		optimize();
 
 		::function->translate();
@@ -608,7 +626,10 @@ namespace sw
 		objectWriter->setUndefinedSyms(::context->getConstantExternSyms());
 		objectWriter->writeNonUserSections();
 
+		static_cast<ELFMemoryStreamer*>(::routine)->setName(wideName);
+
 		Routine *handoffRoutine = ::routine;
+		handoffRoutine->optimized = true;
 		::routine = nullptr;
 
 		return handoffRoutine;
@@ -625,7 +646,7 @@ namespace sw
 		int typeSize = Ice::typeWidthInBytes(type);
 		int totalSize = typeSize * (arraySize ? arraySize : 1);
 
-		auto bytes = Ice::ConstantInteger32::create(::context, type, totalSize);
+		auto bytes = Ice::ConstantInteger32::create(::context, Ice::IceType_i32, totalSize);
 		auto address = ::function->makeVariable(T(getPointerType(t)));
 		auto alloca = Ice::InstAlloca::create(::function, address, bytes, typeSize);
 		::function->getEntryNode()->getInsts().push_front(alloca);
@@ -17,6 +17,8 @@
 #include "Shader/ShaderCore.hpp"
 #include "Reactor/Reactor.hpp"
 #include "Common/Memory.hpp"
+#include "Common/Timer.hpp"
+#include "Common/Tracer.hpp"
 #include "Common/Debug.hpp"
 
 namespace sw
@@ -1380,26 +1382,11 @@ namespace sw
 			}
 		}
 
-		return function(L"BlitRoutine");
+		return function(L"BlitRoutine_%d_%d", state.sourceFormat, state.destFormat);
 	}
 
-	bool Blitter::blitReactor(Surface *source, const SliceRectF &sourceRect, Surface *dest, const SliceRect &destRect, const Blitter::Options &options)
+	Routine *Blitter::getRoutine(Surface *source, const SliceRectF &sourceRect, Surface *dest, const Options &options)
 	{
-		ASSERT(!options.clearOperation || ((source->getWidth() == 1) && (source->getHeight() == 1) && (source->getDepth() == 1)));
-
-		Rect dRect = destRect;
-		RectF sRect = sourceRect;
-		if(destRect.x0 > destRect.x1)
-		{
-			swap(dRect.x0, dRect.x1);
-			swap(sRect.x0, sRect.x1);
-		}
-		if(destRect.y0 > destRect.y1)
-		{
-			swap(dRect.y0, dRect.y1);
-			swap(sRect.y0, sRect.y1);
-		}
-
 		State state(options);
 		state.clampToEdge = (sourceRect.x0 < 0.0f) ||
 		                    (sourceRect.y0 < 0.0f) ||
@@ -1419,19 +1406,61 @@ namespace sw
 
 		if(!blitRoutine)
 		{
+			double compileStart = Timer::seconds();
+			TraceScope trace("Compile BlitRoutine");
 			blitRoutine = generate(state);
 
 			if(!blitRoutine)
 			{
 				criticalSection.unlock();
-				return false;
+				return nullptr;
 			}
 
 			blitCache->add(state, blitRoutine);
+
+			if(pipelineCounters)
+			{
+				profiler.countCompile(Timer::seconds() - compileStart);
+			}
+		}
+		else if(pipelineCounters)
+		{
+			profiler.count(COUNTER_ROUTINE_CACHE_HITS, 1);
 		}
 
 		criticalSection.unlock();
 
+		return blitRoutine;
+	}
+
+	bool Blitter::blitReactor(Surface *source, const SliceRectF &sourceRect, Surface *dest, const SliceRect &destRect, const Blitter::Options &options)
+	{
+		ASSERT(!options.clearOperation || ((source->getWidth() == 1) && (source->getHeight() == 1) && (source->getDepth() == 1)));
+
+		Rect dRect = destRect;
+		RectF sRect = sourceRect;
+		if(destRect.x0 > destRect.x1)
+		{
+			swap(dRect.x0, dRect.x1);
+			swap(sRect.x0, sRect.x1);
+		}
+		if(destRect.y0 > destRect.y1)
+		{
+			swap(dRect.y0, dRect.y1);
+			swap(sRect.y0, sRect.y1);
+		}
+
+		bool useSourceInternal = !source->isExternalDirty();
+		bool useDestInternal = !dest->isExternalDirty();
+		bool isStencil = options.useStencil;
+
+		Routine *blitRoutine = getRoutine(source, sourceRect, dest, options);
+
+		if(!blitRoutine)
+		{
+			return false;
+		}
+
 		void (*blitFunction)(const BlitData *data) = (void(*)(const BlitData*))blitRoutine->getEntry();
 
 		BlitData data;
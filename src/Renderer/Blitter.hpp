@@ -98,6 +98,8 @@ namespace sw
 		void blit(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, const Options &options);
 		void blit3D(Surface *source, Surface *dest);
 
+		Routine *getRoutine(Surface *source, const SliceRectF &sRect, Surface *dest, const Options &options);   // The routine blit() uses, compiled if needed
+
 	private:
 		bool fastClear(void *pixel, sw::Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask);
 
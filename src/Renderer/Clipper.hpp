@@ -38,8 +38,10 @@ namespace sw
 			CLIP_NEAR   = 1 << 5,
 
 			CLIP_FRUSTUM = 0x003F,
+			CLIP_SIDES   = CLIP_RIGHT | CLIP_TOP | CLIP_LEFT | CLIP_BOTTOM,
 
-			CLIP_FINITE = 1 << 7,   // All position coordinates are finite
+			CLIP_GUARD_BAND = 1 << 6,   // Outside the guard band; the sides have to be clipped
+			CLIP_FINITE     = 1 << 7,   // All position coordinates are finite
 
 			// User-defined clipping planes
 			CLIP_PLANE0 = 1 << 8,
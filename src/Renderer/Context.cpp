@@ -41,8 +41,13 @@ namespace sw
 	bool complementaryDepthBuffer = false;
 	bool postBlendSRGB = false;
 	bool exactColorRounding = false;
+	bool compressedTextureSampling = false; // Sample BC1-BC5 and ETC2/EAC textures without decompressing them
+	bool tiledTextureLayout = false;        // Sample 2D textures from a copy stored in Morton ordered 64x64 texel tiles
 	TransparencyAntialiasing transparencyAntialiasing = TRANSPARENCY_NONE;
 	bool forceClearRegisters = false;
+	bool tieredCompilation = false;         // Compile routines quickly first, and optimize the frequently used ones (LLVM only)
+	bool specializeUniforms = false;        // Compile routines for the values of uniforms which decide control flow
+	bool specializeSamplers = false;        // Compile routines for the sizes of single level power-of-two textures
 
 	Context::Context()
 	{
@@ -317,6 +322,9 @@ namespace sw
 
 		colorLogicOpEnabled = false;
 		logicalOperation = LOGICALOP_COPY;
+
+		dirtyState = STATE_ALL;
+		memset(&bindings, 0, sizeof(Bindings));
 	}
 
 	const float &Context::exp2Bias()
@@ -336,17 +344,29 @@ namespace sw
 
 	void Context::setLightingEnable(bool lightingEnable)
 	{
-		this->lightingEnable = lightingEnable;
+		if(this->lightingEnable != lightingEnable)
+		{
+			this->lightingEnable = lightingEnable;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setSpecularEnable(bool specularEnable)
 	{
-		Context::specularEnable = specularEnable;
+		if(Context::specularEnable != specularEnable)
+		{
+			Context::specularEnable = specularEnable;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setLightEnable(int light, bool lightEnable)
 	{
-		Context::lightEnable[light] = lightEnable;
+		if(Context::lightEnable[light] != lightEnable)
+		{
+			Context::lightEnable[light] = lightEnable;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setLightPosition(int light, Point worldLightPosition)
@@ -356,38 +376,68 @@ namespace sw
 
 	void Context::setAmbientMaterialSource(MaterialSource ambientMaterialSource)
 	{
-		Context::ambientMaterialSource = ambientMaterialSource;
+		if(Context::ambientMaterialSource != ambientMaterialSource)
+		{
+			Context::ambientMaterialSource = ambientMaterialSource;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setDiffuseMaterialSource(MaterialSource diffuseMaterialSource)
 	{
-		Context::diffuseMaterialSource = diffuseMaterialSource;
+		if(Context::diffuseMaterialSource != diffuseMaterialSource)
+		{
+			Context::diffuseMaterialSource = diffuseMaterialSource;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setSpecularMaterialSource(MaterialSource specularMaterialSource)
 	{
-		Context::specularMaterialSource = specularMaterialSource;
+		if(Context::specularMaterialSource != specularMaterialSource)
+		{
+			Context::specularMaterialSource = specularMaterialSource;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setEmissiveMaterialSource(MaterialSource emissiveMaterialSource)
 	{
-		Context::emissiveMaterialSource = emissiveMaterialSource;
+		if(Context::emissiveMaterialSource != emissiveMaterialSource)
+		{
+			Context::emissiveMaterialSource = emissiveMaterialSource;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setPointSpriteEnable(bool pointSpriteEnable)
 	{
-		Context::pointSpriteEnable = pointSpriteEnable;
+		if(Context::pointSpriteEnable != pointSpriteEnable)
+		{
+			Context::pointSpriteEnable = pointSpriteEnable;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Context::setPointScaleEnable(bool pointScaleEnable)
 	{
-		Context::pointScaleEnable = pointScaleEnable;
+		if(Context::pointScaleEnable != pointScaleEnable)
+		{
+			Context::pointScaleEnable = pointScaleEnable;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	bool Context::setDepthBufferEnable(bool depthBufferEnable)
 	{
 		bool modified = (Context::depthBufferEnable != depthBufferEnable);
 		Context::depthBufferEnable = depthBufferEnable;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -395,6 +445,12 @@ namespace sw
 	{
 		bool modified = (Context::alphaBlendEnable != alphaBlendEnable);
 		Context::alphaBlendEnable = alphaBlendEnable;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -402,6 +458,12 @@ namespace sw
 	{
 		bool modified = (Context::sourceBlendFactorState != sourceBlendFactor);
 		Context::sourceBlendFactorState = sourceBlendFactor;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -409,6 +471,12 @@ namespace sw
 	{
 		bool modified = (Context::destBlendFactorState != destBlendFactor);
 		Context::destBlendFactorState = destBlendFactor;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -416,6 +484,12 @@ namespace sw
 	{
 		bool modified = (Context::blendOperationState != blendOperation);
 		Context::blendOperationState = blendOperation;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -423,6 +497,12 @@ namespace sw
 	{
 		bool modified = (Context::separateAlphaBlendEnable != separateAlphaBlendEnable);
 		Context::separateAlphaBlendEnable = separateAlphaBlendEnable;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -430,6 +510,12 @@ namespace sw
 	{
 		bool modified = (Context::sourceBlendFactorStateAlpha != sourceBlendFactorAlpha);
 		Context::sourceBlendFactorStateAlpha = sourceBlendFactorAlpha;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -437,6 +523,12 @@ namespace sw
 	{
 		bool modified = (Context::destBlendFactorStateAlpha != destBlendFactorAlpha);
 		Context::destBlendFactorStateAlpha = destBlendFactorAlpha;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -444,6 +536,12 @@ namespace sw
 	{
 		bool modified = (Context::blendOperationStateAlpha != blendOperationAlpha);
 		Context::blendOperationStateAlpha = blendOperationAlpha;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -451,6 +549,12 @@ namespace sw
 	{
 		bool modified = (Context::colorWriteMask[index] != colorWriteMask);
 		Context::colorWriteMask[index] = colorWriteMask;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -458,6 +562,12 @@ namespace sw
 	{
 		bool modified = (Context::writeSRGB != sRGB);
 		Context::writeSRGB = sRGB;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -465,6 +575,12 @@ namespace sw
 	{
 		bool modified = (Context::colorLogicOpEnabled != enabled);
 		Context::colorLogicOpEnabled = enabled;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
@@ -472,12 +588,22 @@ namespace sw
 	{
 		bool modified = (Context::logicalOperation != logicalOperation);
 		Context::logicalOperation = logicalOperation;
+
+		if(modified)
+		{
+			dirtyState |= STATE_RENDER;
+		}
+
 		return modified;
 	}
 
 	void Context::setColorVertexEnable(bool colorVertexEnable)
 	{
-		Context::colorVertexEnable = colorVertexEnable;
+		if(Context::colorVertexEnable != colorVertexEnable)
+		{
+			Context::colorVertexEnable = colorVertexEnable;
+			dirtyState |= STATE_RENDER;
+		}
 	}
 
 	bool Context::fogActive()
@@ -1455,6 +1581,37 @@ namespace sw
 		return renderTarget[0] ? renderTarget[0]->getSuperSampleCount() : 1;
 	}
 
+	void Context::validateBindings()
+	{
+		Bindings current;
+		memset(&current, 0, sizeof(Bindings));
+
+		for(int index = 0; index < RENDERTARGETS; index++)
+		{
+			current.renderTargetFormat[index] = renderTargetInternalFormat(index);
+		}
+
+		current.renderTargetExternalFormat = renderTarget[0] ? renderTarget[0]->getExternalFormat() : FORMAT_NULL;
+		current.multiSampleCount = getMultiSampleCount();
+		current.superSampleCount = getSuperSampleCount();
+		current.depthBufferFormat = depthBuffer ? depthBuffer->getInternalFormat() : FORMAT_NULL;
+		current.stencilBuffer = (stencilBuffer != nullptr);
+		current.vertexShaderID = vertexShader ? vertexShader->getSerialID() : -1;
+		current.pixelShaderID = pixelShader ? pixelShader->getSerialID() : -1;
+
+		if(current.vertexShaderID != bindings.vertexShaderID || current.pixelShaderID != bindings.pixelShaderID)
+		{
+			dirtyState |= STATE_SHADERS;
+		}
+
+		if(memcmp(&current, &bindings, OFFSET(Bindings, vertexShaderID)) != 0)
+		{
+			dirtyState |= STATE_TARGETS;
+		}
+
+		bindings = current;
+	}
+
 	Format Context::renderTargetInternalFormat(int index)
 	{
 		if(renderTarget[index])
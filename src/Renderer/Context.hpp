@@ -277,6 +277,18 @@ namespace sw
 		TRANSPARENCY_LAST = TRANSPARENCY_ALPHA_TO_COVERAGE
 	};
 
+	enum StateGroup   // Groups of context state which the processor states are derived from
+	{
+		STATE_RENDER   = 0x01,   // Draw type, depth, stencil, blending, rasterization and fixed-function modes
+		STATE_TARGETS  = 0x02,   // Color, depth and stencil buffer formats
+		STATE_SHADERS  = 0x04,   // Vertex and pixel shaders
+		STATE_INPUT    = 0x08,   // Vertex input stream formats
+		STATE_SAMPLERS = 0x10,   // Sampler and texture stage states
+		STATE_UNIFORMS = 0x20,   // Shader constants, when routines are specialized on them
+
+		STATE_ALL      = 0x3F
+	};
+
 	class Context
 	{
 	public:
@@ -405,6 +417,10 @@ namespace sw
 		int getMultiSampleCount() const;
 		int getSuperSampleCount() const;
 
+		void validateBindings();   // Marks targets and shaders dirty when their formats or identities changed
+
+		unsigned int dirtyState;   // StateGroup flags changed since the processor states were last derived
+
 		DrawType drawType;
 
 		bool stencilEnable;
@@ -535,6 +551,23 @@ namespace sw
 
 		bool colorLogicOpEnabled;
 		LogicalOperation logicalOperation;
+
+	private:
+		// Binding properties the processor states depend on. Compared by value on each draw,
+		// since a surface or shader can be allocated at the address of a released one.
+		struct Bindings
+		{
+			Format renderTargetFormat[RENDERTARGETS];
+			Format renderTargetExternalFormat;
+			int multiSampleCount;
+			int superSampleCount;
+			Format depthBufferFormat;
+			bool stencilBuffer;
+			int vertexShaderID;
+			int pixelShaderID;
+		};
+
+		Bindings bindings;
 	};
 }
 
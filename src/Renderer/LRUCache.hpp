@@ -29,6 +29,7 @@ namespace sw
 
 		Data *query(const Key &key) const;
 		Data *add(const Key &key, Data *data);
+		Data *replace(const Key &key, Data *data);   // Adds the data if the key is not cached
 	
 		int getSize() {return size;}
 		Key &getKey(int i) {return key[i];}
@@ -140,6 +141,26 @@ namespace sw
 
 		return data;
 	}
+
+	template<class Key, class Data>
+	Data *LRUCache<Key, Data>::replace(const Key &key, Data *data)
+	{
+		for(int i = top; i > top - fill; i--)
+		{
+			int j = i & mask;
+
+			if(key == *ref[j])
+			{
+				data->bind();
+				this->data[j]->unbind();
+				this->data[j] = data;
+
+				return data;
+			}
+		}
+
+		return add(key, data);
+	}
 }
 
 #endif   // sw_LRUCache_hpp
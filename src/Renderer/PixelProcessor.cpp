@@ -20,6 +20,9 @@
 #include "Shader/PixelProgram.hpp"
 #include "Shader/PixelShader.hpp"
 #include "Shader/Constants.hpp"
+#include "Common/Math.hpp"
+#include "Common/Timer.hpp"
+#include "Common/Tracer.hpp"
 #include "Common/Debug.hpp"
 
 #include <string.h>
@@ -30,24 +33,72 @@ namespace sw
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool perspectiveCorrection;
 
+	extern bool tieredCompilation;
+	extern bool specializeUniforms;
+	extern bool specializeSamplers;
+
 	bool precachePixel = false;
 
-	unsigned int PixelProcessor::States::computeHash()
+	// The samplers section spans the sampler and texture stage arrays, the uniforms section the
+	// trailing uniform condition values, and the main section the rest
+	static const int samplersBegin = OFFSET(PixelProcessor::States, sampler);
+	static const int samplersEnd = OFFSET(PixelProcessor::States, textureStage) + sizeof(PixelProcessor::States::textureStage);
+	static const int uniformsBegin = OFFSET(PixelProcessor::States, specializedUniforms);
+
+	PixelProcessor::State::State()
+	{
+		memset(this, 0, sizeof(State));
+	}
+
+	void PixelProcessor::State::clear(StateSection section)
+	{
+		unsigned char *states = reinterpret_cast<unsigned char*>(static_cast<States*>(this));
+
+		switch(section)
+		{
+		case SECTION_MAIN:
+			memset(states, 0, samplersBegin);
+			memset(states + samplersEnd, 0, uniformsBegin - samplersEnd);
+			break;
+		case SECTION_SAMPLERS:
+			memset(states + samplersBegin, 0, samplersEnd - samplersBegin);
+			break;
+		case SECTION_UNIFORMS:
+			memset(states + uniformsBegin, 0, sizeof(States) - uniformsBegin);
+			break;
+		default:
+			ASSERT(false);
+		}
+	}
+
+	void PixelProcessor::State::computeHash(StateSection section)
 	{
-		unsigned int *state = (unsigned int*)this;
-		unsigned int hash = 0;
+		const unsigned char *states = reinterpret_cast<const unsigned char*>(static_cast<States*>(this));
 
-		for(unsigned int i = 0; i < sizeof(States) / 4; i++)
+		switch(section)
 		{
-			hash ^= state[i];
+		case SECTION_MAIN:
+			sectionHash[SECTION_MAIN] = FNV_1a(states + samplersEnd, uniformsBegin - samplersEnd, FNV_1a(states, samplersBegin));
+			break;
+		case SECTION_SAMPLERS:
+			sectionHash[SECTION_SAMPLERS] = FNV_1a(states + samplersBegin, samplersEnd - samplersBegin);
+			break;
+		case SECTION_UNIFORMS:
+			sectionHash[SECTION_UNIFORMS] = FNV_1a(states + uniformsBegin, sizeof(States) - uniformsBegin);
+			break;
+		default:
+			ASSERT(false);
 		}
 
-		return hash;
+		uint64_t combined = FNV_1a(reinterpret_cast<const unsigned char*>(sectionHash), sizeof(sectionHash));
+		hash = static_cast<unsigned int>(combined ^ (combined >> 32));
 	}
 
-	PixelProcessor::State::State()
+	void PixelProcessor::State::computeHash()
 	{
-		memset(this, 0, sizeof(State));
+		computeHash(SECTION_MAIN);
+		computeHash(SECTION_SAMPLERS);
+		computeHash(SECTION_UNIFORMS);
 	}
 
 	bool PixelProcessor::State::operator==(const State &state) const
@@ -161,18 +212,33 @@ namespace sw
 
 	void PixelProcessor::setRenderTarget(int index, Surface *renderTarget, unsigned int layer)
 	{
+		if(context->renderTarget[index] != renderTarget)
+		{
+			context->dirtyState |= STATE_TARGETS;
+		}
+
 		context->renderTarget[index] = renderTarget;
 		context->renderTargetLayer[index] = layer;
 	}
 
 	void PixelProcessor::setDepthBuffer(Surface *depthBuffer, unsigned int layer)
 	{
+		if(context->depthBuffer != depthBuffer)
+		{
+			context->dirtyState |= STATE_TARGETS;
+		}
+
 		context->depthBuffer = depthBuffer;
 		context->depthBufferLayer = layer;
 	}
 
 	void PixelProcessor::setStencilBuffer(Surface *stencilBuffer, unsigned int layer)
 	{
+		if(context->stencilBuffer != stencilBuffer)
+		{
+			context->dirtyState |= STATE_TARGETS;
+		}
+
 		context->stencilBuffer = stencilBuffer;
 		context->stencilBufferLayer = layer;
 	}
@@ -182,6 +248,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setTexCoordIndex(texCoordIndex);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -191,6 +258,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setStageOperation(stageOperation);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -200,6 +268,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setFirstArgument(firstArgument);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -209,6 +278,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setSecondArgument(secondArgument);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -218,6 +288,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setThirdArgument(thirdArgument);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -227,6 +298,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setStageOperationAlpha(stageOperationAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -236,6 +308,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setFirstArgumentAlpha(firstArgumentAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -245,6 +318,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setSecondArgumentAlpha(secondArgumentAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -254,6 +328,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setThirdArgumentAlpha(thirdArgumentAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -263,6 +338,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setFirstModifier(firstModifier);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -272,6 +348,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setSecondModifier(secondModifier);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -281,6 +358,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setThirdModifier(thirdModifier);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -290,6 +368,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setFirstModifierAlpha(firstModifierAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -299,6 +378,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setSecondModifierAlpha(secondModifierAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -308,6 +388,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setThirdModifierAlpha(thirdModifierAlpha);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -317,6 +398,7 @@ namespace sw
 		if(stage < 8)
 		{
 			context->textureStage[stage].setDestinationArgument(destinationArgument);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -362,6 +444,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setTextureFilter(textureFilter);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -371,6 +454,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setMipmapFilter(mipmapFilter);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -380,6 +464,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setGatherEnable(enable);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -389,6 +474,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setAddressingModeU(addressMode);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -398,6 +484,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setAddressingModeV(addressMode);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -407,6 +494,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setAddressingModeW(addressMode);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -416,6 +504,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setReadSRGB(sRGB);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -443,6 +532,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setMaxAnisotropy(maxAnisotropy);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -452,6 +542,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setHighPrecisionFiltering(highPrecisionFiltering);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -461,6 +552,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setSwizzleR(swizzleR);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -470,6 +562,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setSwizzleG(swizzleG);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -479,6 +572,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setSwizzleB(swizzleB);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -488,6 +582,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setSwizzleA(swizzleA);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -497,6 +592,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setCompareFunc(compFunc);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -568,27 +664,47 @@ namespace sw
 
 	void PixelProcessor::setDepthCompare(DepthCompareMode depthCompareMode)
 	{
-		context->depthCompareMode = depthCompareMode;
+		if(context->depthCompareMode != depthCompareMode)
+		{
+			context->depthCompareMode = depthCompareMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setAlphaCompare(AlphaCompareMode alphaCompareMode)
 	{
-		context->alphaCompareMode = alphaCompareMode;
+		if(context->alphaCompareMode != alphaCompareMode)
+		{
+			context->alphaCompareMode = alphaCompareMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setDepthWriteEnable(bool depthWriteEnable)
 	{
-		context->depthWriteEnable = depthWriteEnable;
+		if(context->depthWriteEnable != depthWriteEnable)
+		{
+			context->depthWriteEnable = depthWriteEnable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setAlphaTestEnable(bool alphaTestEnable)
 	{
-		context->alphaTestEnable = alphaTestEnable;
+		if(context->alphaTestEnable != alphaTestEnable)
+		{
+			context->alphaTestEnable = alphaTestEnable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setCullMode(CullMode cullMode)
 	{
-		context->cullMode = cullMode;
+		if(context->cullMode != cullMode)
+		{
+			context->cullMode = cullMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setColorWriteMask(int index, int rgbaMask)
@@ -598,12 +714,20 @@ namespace sw
 
 	void PixelProcessor::setStencilEnable(bool stencilEnable)
 	{
-		context->stencilEnable = stencilEnable;
+		if(context->stencilEnable != stencilEnable)
+		{
+			context->stencilEnable = stencilEnable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilCompare(StencilCompareMode stencilCompareMode)
 	{
-		context->stencilCompareMode = stencilCompareMode;
+		if(context->stencilCompareMode != stencilCompareMode)
+		{
+			context->stencilCompareMode = stencilCompareMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilReference(int stencilReference)
@@ -620,66 +744,114 @@ namespace sw
 
 	void PixelProcessor::setStencilMask(int stencilMask)
 	{
-		context->stencilMask = stencilMask;
+		if(context->stencilMask != stencilMask)
+		{
+			context->stencilMask = stencilMask;
+			context->dirtyState |= STATE_RENDER;
+		}
 		stencil.set(context->stencilReference, stencilMask, context->stencilWriteMask);
 	}
 
 	void PixelProcessor::setStencilMaskCCW(int stencilMaskCCW)
 	{
-		context->stencilMaskCCW = stencilMaskCCW;
+		if(context->stencilMaskCCW != stencilMaskCCW)
+		{
+			context->stencilMaskCCW = stencilMaskCCW;
+			context->dirtyState |= STATE_RENDER;
+		}
 		stencilCCW.set(context->stencilReferenceCCW, stencilMaskCCW, context->stencilWriteMaskCCW);
 	}
 
 	void PixelProcessor::setStencilFailOperation(StencilOperation stencilFailOperation)
 	{
-		context->stencilFailOperation = stencilFailOperation;
+		if(context->stencilFailOperation != stencilFailOperation)
+		{
+			context->stencilFailOperation = stencilFailOperation;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilPassOperation(StencilOperation stencilPassOperation)
 	{
-		context->stencilPassOperation = stencilPassOperation;
+		if(context->stencilPassOperation != stencilPassOperation)
+		{
+			context->stencilPassOperation = stencilPassOperation;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilZFailOperation(StencilOperation stencilZFailOperation)
 	{
-		context->stencilZFailOperation = stencilZFailOperation;
+		if(context->stencilZFailOperation != stencilZFailOperation)
+		{
+			context->stencilZFailOperation = stencilZFailOperation;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilWriteMask(int stencilWriteMask)
 	{
-		context->stencilWriteMask = stencilWriteMask;
+		if(context->stencilWriteMask != stencilWriteMask)
+		{
+			context->stencilWriteMask = stencilWriteMask;
+			context->dirtyState |= STATE_RENDER;
+		}
 		stencil.set(context->stencilReference, context->stencilMask, stencilWriteMask);
 	}
 
 	void PixelProcessor::setStencilWriteMaskCCW(int stencilWriteMaskCCW)
 	{
-		context->stencilWriteMaskCCW = stencilWriteMaskCCW;
+		if(context->stencilWriteMaskCCW != stencilWriteMaskCCW)
+		{
+			context->stencilWriteMaskCCW = stencilWriteMaskCCW;
+			context->dirtyState |= STATE_RENDER;
+		}
 		stencilCCW.set(context->stencilReferenceCCW, context->stencilMaskCCW, stencilWriteMaskCCW);
 	}
 
 	void PixelProcessor::setTwoSidedStencil(bool enable)
 	{
-		context->twoSidedStencil = enable;
+		if(context->twoSidedStencil != enable)
+		{
+			context->twoSidedStencil = enable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilCompareCCW(StencilCompareMode stencilCompareMode)
 	{
-		context->stencilCompareModeCCW = stencilCompareMode;
+		if(context->stencilCompareModeCCW != stencilCompareMode)
+		{
+			context->stencilCompareModeCCW = stencilCompareMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilFailOperationCCW(StencilOperation stencilFailOperation)
 	{
-		context->stencilFailOperationCCW = stencilFailOperation;
+		if(context->stencilFailOperationCCW != stencilFailOperation)
+		{
+			context->stencilFailOperationCCW = stencilFailOperation;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilPassOperationCCW(StencilOperation stencilPassOperation)
 	{
-		context->stencilPassOperationCCW = stencilPassOperation;
+		if(context->stencilPassOperationCCW != stencilPassOperation)
+		{
+			context->stencilPassOperationCCW = stencilPassOperation;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setStencilZFailOperationCCW(StencilOperation stencilZFailOperation)
 	{
-		context->stencilZFailOperationCCW = stencilZFailOperation;
+		if(context->stencilZFailOperationCCW != stencilZFailOperation)
+		{
+			context->stencilZFailOperationCCW = stencilZFailOperation;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setTextureFactor(const Color<float> &textureFactor)
@@ -808,12 +980,20 @@ namespace sw
 
 	void PixelProcessor::setFillMode(FillMode fillMode)
 	{
-		context->fillMode = fillMode;
+		if(context->fillMode != fillMode)
+		{
+			context->fillMode = fillMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setShadingMode(ShadingMode shadingMode)
 	{
-		context->shadingMode = shadingMode;
+		if(context->shadingMode != shadingMode)
+		{
+			context->shadingMode = shadingMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setAlphaBlendEnable(bool alphaBlendEnable)
@@ -858,7 +1038,11 @@ namespace sw
 
 	void PixelProcessor::setAlphaReference(float alphaReference)
 	{
-		context->alphaReference = alphaReference;
+		if(context->alphaReference != alphaReference)
+		{
+			context->alphaReference = alphaReference;
+			context->dirtyState |= STATE_RENDER;
+		}
 
 		factor.alphaReference4[0] = (word)iround(alphaReference * 0x1000 / 0xFF);
 		factor.alphaReference4[1] = (word)iround(alphaReference * 0x1000 / 0xFF);
@@ -916,17 +1100,29 @@ namespace sw
 
 	void PixelProcessor::setPixelFogMode(FogMode fogMode)
 	{
-		context->pixelFogMode = fogMode;
+		if(context->pixelFogMode != fogMode)
+		{
+			context->pixelFogMode = fogMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setPerspectiveCorrection(bool perspectiveEnable)
 	{
-		perspectiveCorrection = perspectiveEnable;
+		if(perspectiveCorrection != perspectiveEnable)
+		{
+			perspectiveCorrection = perspectiveEnable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setOcclusionEnabled(bool enable)
 	{
-		context->occlusionEnabled = enable;
+		if(context->occlusionEnabled != enable)
+		{
+			context->occlusionEnabled = enable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void PixelProcessor::setRoutineCacheSize(int cacheSize)
@@ -952,10 +1148,37 @@ namespace sw
 		fog.offset = replicate(fogOffset);
 	}
 
-	const PixelProcessor::State PixelProcessor::update() const
+	void PixelProcessor::update(State &state) const
 	{
-		State state;
+		// Without both shaders the fixed-function paths also depend on vertex inputs and samplers
+		const unsigned int mainGroups = (context->vertexShader && context->pixelShader) ? (STATE_RENDER | STATE_TARGETS | STATE_SHADERS) : STATE_ALL;
+		const unsigned int samplerGroups = STATE_SAMPLERS | STATE_SHADERS;
+		const unsigned int uniformGroups = STATE_UNIFORMS | STATE_SHADERS;
 
+		if(context->dirtyState & mainGroups)
+		{
+			state.clear(SECTION_MAIN);
+			updateMain(state);
+			state.computeHash(SECTION_MAIN);
+		}
+
+		if(context->dirtyState & samplerGroups)
+		{
+			state.clear(SECTION_SAMPLERS);
+			updateSamplers(state);
+			state.computeHash(SECTION_SAMPLERS);
+		}
+
+		if(context->dirtyState & uniformGroups)
+		{
+			state.clear(SECTION_UNIFORMS);
+			updateUniforms(state);
+			state.computeHash(SECTION_UNIFORMS);
+		}
+	}
+
+	void PixelProcessor::updateMain(State &state) const
+	{
 		if(context->pixelShader)
 		{
 			state.shaderID = context->pixelShader->getSerialID();
@@ -1006,6 +1229,7 @@ namespace sw
 		}
 
 		state.occlusionEnabled = context->occlusionEnabled;
+		state.pipelineCounters = pipelineCounters;
 
 		state.fogActive = context->fogActive();
 		state.pixelFogMode = context->pixelFogActive();
@@ -1043,33 +1267,9 @@ namespace sw
 
 		if(!context->pixelShader)
 		{
-			for(unsigned int i = 0; i < 8; i++)
-			{
-				state.textureStage[i] = context->textureStage[i].textureStageState();
-			}
-
 			state.specularAdd = context->specularActive() && context->specularEnable;
 		}
 
-		for(unsigned int i = 0; i < 16; i++)
-		{
-			if(context->pixelShader)
-			{
-				if(context->pixelShader->usesSampler(i))
-				{
-					state.sampler[i] = context->sampler[i].samplerState();
-				}
-			}
-			else
-			{
-				if(i < 8 && state.textureStage[i].stageOperation != TextureStage::STAGE_DISABLE)
-				{
-					state.sampler[i] = context->sampler[i].samplerState();
-				}
-				else break;
-			}
-		}
-
 		const bool point = context->isDrawPoint(true);
 		const bool sprite = context->pointSpriteActive();
 		const bool flatShading = (context->shadingMode == SHADING_FLAT) || point;
@@ -1173,35 +1373,184 @@ namespace sw
 				}
 			}
 		}
+	}
+
+	void PixelProcessor::updateSamplers(State &state) const
+	{
+		if(!context->pixelShader)
+		{
+			for(unsigned int i = 0; i < 8; i++)
+			{
+				state.textureStage[i] = context->textureStage[i].textureStageState();
+			}
+		}
+
+		const PixelShader *shader = context->pixelShader;
+		bool specialize = specializeSamplers && shader && shader->getSamplerSpecializationCount() < MAX_SAMPLER_SPECIALIZATIONS;
+
+		for(unsigned int i = 0; i < 16; i++)
+		{
+			if(shader)
+			{
+				if(shader->usesSampler(i))
+				{
+					state.sampler[i] = context->sampler[i].samplerState();
+
+					if(specialize)
+					{
+						context->sampler[i].specialize(state.sampler[i]);
+					}
+				}
+			}
+			else
+			{
+				if(i < 8 && state.textureStage[i].stageOperation != TextureStage::STAGE_DISABLE)
+				{
+					state.sampler[i] = context->sampler[i].samplerState();
+				}
+				else break;
+			}
+		}
+	}
+
+	void PixelProcessor::updateUniforms(State &state) const
+	{
+		const PixelShader *shader = context->pixelShader;
+
+		if(!specializeUniforms || !shader || shader->getSpecializationCount() >= MAX_UNIFORM_SPECIALIZATIONS)
+		{
+			return;
+		}
+
+		int count = shader->getUniformConditionCount();
+
+		for(int index = 0; index < count; index++)
+		{
+			const Shader::UniformCondition &condition = shader->getUniformCondition(index);
+			int *value = state.uniformCondition[index];
+
+			switch(condition.type)
+			{
+			case Shader::PARAMETER_CONST:
+				if(condition.index >= FRAGMENT_UNIFORM_VECTORS)
+				{
+					state.clear(SECTION_UNIFORMS);
+					return;
+				}
+
+				value[0] = ((const int&)c[condition.index][condition.component] < 0);   // Sign bit, as tested by IF
+				break;
+			case Shader::PARAMETER_CONSTINT:
+				value[0] = i[condition.index][0];
+				value[1] = i[condition.index][1];
+				value[2] = i[condition.index][2];
+				break;
+			case Shader::PARAMETER_CONSTBOOL:
+				value[0] = b[condition.index];
+				break;
+			default:
+				ASSERT(false);
+			}
+		}
 
-		state.hash = state.computeHash();
+		state.specializedUniforms = count;
+	}
 
-		return state;
+	static Routine *generateRoutine(const PixelProcessor::State &state, const PixelShader *pixelShader, bool runOptimizations)
+	{
+		const bool integerPipeline = !pixelShader || (pixelShader->getShaderModel() <= 0x0104);
+		QuadRasterizer *generator = nullptr;
+
+		if(integerPipeline)
+		{
+			generator = new PixelPipeline(state, pixelShader);
+		}
+		else
+		{
+			generator = new PixelProgram(state, pixelShader);
+		}
+
+		generator->generate();
+		Routine *routine = generator->compile(runOptimizations, L"PixelRoutine_%0.8X_%0.8X", state.shaderID, state.hash);
+		delete generator;
+
+		return routine;
 	}
 
+	class PixelRoutineOptimization : public RoutineCache<PixelProcessor::State>::Optimization
+	{
+	public:
+		PixelRoutineOptimization(const PixelProcessor::State &state, const PixelShader *pixelShader) : Optimization(state)
+		{
+			// The application may delete its shader before the optimizer gets to it
+			this->pixelShader = pixelShader ? new PixelShader(pixelShader) : nullptr;
+		}
+
+		~PixelRoutineOptimization() override
+		{
+			delete pixelShader;
+		}
+
+		Routine *generate() override
+		{
+			return generateRoutine(state, pixelShader, true);
+		}
+
+	private:
+		const PixelShader *pixelShader;
+	};
+
 	Routine *PixelProcessor::routine(const State &state)
 	{
+		routineCache->update();
+
 		Routine *routine = routineCache->query(state);
 
 		if(!routine)
 		{
-			const bool integerPipeline = (context->pixelShaderModel() <= 0x0104);
-			QuadRasterizer *generator = nullptr;
+			double compileStart = Timer::seconds();
+			TraceScope trace("Compile PixelRoutine");
+
+			routine = generateRoutine(state, context->pixelShader, !tieredCompilation);
+			routineCache->add(state, routine);
 
-			if(integerPipeline)
+			if(state.specializedUniforms)
 			{
-				generator = new PixelPipeline(state, context->pixelShader);
+				context->pixelShader->countSpecialization();
 			}
-			else
+
+			for(int i = 0; i < TEXTURE_IMAGE_UNITS; i++)
+			{
+				if(state.sampler[i].powerOfTwo)
+				{
+					context->pixelShader->countSamplerSpecialization();
+					break;
+				}
+			}
+
+			if(pipelineCounters)
 			{
-				generator = new PixelProgram(state, context->pixelShader);
+				profiler.countCompile(Timer::seconds() - compileStart);
 			}
+		}
+		else if(pipelineCounters)
+		{
+			profiler.count(COUNTER_ROUTINE_CACHE_HITS, 1);
+		}
+
+		return routine;
+	}
 
-			generator->generate();
-			routine = (*generator)(L"PixelRoutine_%0.8X", state.shaderID);
-			delete generator;
+	Routine *PixelProcessor::tierUp(const State &state, Routine *routine)
+	{
+		if(routineCache->update())
+		{
+			routine = this->routine(state);   // The bound routine may have been replaced
+		}
 
-			routineCache->add(state, routine);
+		if(routineCache->isHot(routine))
+		{
+			routineCache->optimize(new PixelRoutineOptimization(state, context->pixelShader));
 		}
 
 		return routine;
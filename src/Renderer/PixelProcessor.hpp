@@ -28,10 +28,17 @@ namespace sw
 	class PixelProcessor
 	{
 	public:
-		struct States
+		enum StateSection
 		{
-			unsigned int computeHash();
+			SECTION_MAIN,       // Everything but the sampler and texture stage states
+			SECTION_SAMPLERS,   // Sampler and texture stage states
+			SECTION_UNIFORMS,   // Values of the shader's uniform conditions
+
+			SECTION_COUNT
+		};
 
+		struct States
+		{
 			int shaderID;
 
 			bool depthOverride                        : 1;   // TODO: Eliminate by querying shader.
@@ -64,6 +71,7 @@ namespace sw
 			FogMode pixelFogMode                      : BITS(FOG_LAST);
 			bool specularAdd                          : 1;
 			bool occlusionEnabled                     : 1;
+			bool pipelineCounters                     : 1;
 			bool wBasedFog                            : 1;
 			bool perspective                          : 1;
 			bool depthClamp                           : 1;
@@ -108,6 +116,9 @@ namespace sw
 
 				Interpolant interpolant[MAX_FRAGMENT_INPUTS];
 			};
+
+			unsigned char specializedUniforms;   // Number of uniform conditions the routine assumes the values of
+			int uniformCondition[MAX_UNIFORM_CONDITIONS][3];
 		};
 
 		struct State : States
@@ -131,7 +142,12 @@ namespace sw
 				return pixelFogMode != FOG_NONE;
 			}
 
+			void clear(StateSection section);         // Resets the section's fields
+			void computeHash(StateSection section);   // Rehashes the section and recombines the hash
+			void computeHash();
+
 			unsigned int hash;
+			uint64_t sectionHash[SECTION_COUNT];
 		};
 
 		struct Stencil
@@ -304,8 +320,9 @@ namespace sw
 		void setOcclusionEnabled(bool enable);
 
 	protected:
-		const State update() const;
+		void update(State &state) const;   // Rederives the sections whose context state is dirty
 		Routine *routine(const State &state);
+		Routine *tierUp(const State &state, Routine *routine);   // Counts a draw, returns the optimized routine once available
 		void setRoutineCacheSize(int routineCacheSize);
 
 		// Shader constants
@@ -332,6 +349,10 @@ namespace sw
 
 		void setFogRanges(float start, float end);
 
+		void updateMain(State &state) const;
+		void updateSamplers(State &state) const;
+		void updateUniforms(State &state) const;
+
 		Context *const context;
 
 		RoutineCache<State> *routineCache;
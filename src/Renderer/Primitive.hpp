@@ -18,6 +18,8 @@
 #include "Vertex.hpp"
 #include "Main/Config.hpp"
 
+#include <cstddef>
+
 namespace sw
 {
 	struct Triangle
@@ -71,10 +73,16 @@ namespace sw
 
 		// The rasterizer adds a zero length span to the top and bottom of the polygon to allow
 		// for 2x2 pixel processing. We need an even number of spans to keep accesses aligned.
-		Span outlineUnderflow[2];
+		// With multisampling each row holds the left edges of all samples followed by their
+		// right edges, and the outline extends into the space of the following multiSample - 1
+		// primitives, which only serve as storage.
+		Span outlineUnderflow[4];
 		Span outline[OUTLINE_RESOLUTION];
 		Span outlineOverflow[2];
 	};
+
+	static_assert(2 * sizeof(Primitive) >= offsetof(Primitive, outline) + (OUTLINE_RESOLUTION + 2) * 2 * sizeof(Primitive::Span), "Insufficient outline storage for 2x multisampling");
+	static_assert(4 * sizeof(Primitive) >= offsetof(Primitive, outline) + (OUTLINE_RESOLUTION + 2) * 4 * sizeof(Primitive::Span), "Insufficient outline storage for 4x multisampling");
 }
 
 #endif   // sw_Primitive_hpp
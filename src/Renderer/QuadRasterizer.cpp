@@ -49,6 +49,9 @@ namespace sw
 
 		constants = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,constants));
 		occlusion = 0;
+		quadsShaded = 0;
+		quadsDepthKilled = 0;
+		textureSamples = 0;
 		int clusterCount = Renderer::getClusterCount();
 
 		Do
@@ -66,7 +69,7 @@ namespace sw
 				rasterize(yMin, yMax);
 			}
 
-			primitive += sizeof(Primitive) * state.multiSample;
+			primitive += sizeof(Primitive) * state.multiSample;   // Multisampled outlines span several primitives
 			count--;
 		}
 		Until(count == 0)
@@ -78,6 +81,13 @@ namespace sw
 			*Pointer<UInt>(data + OFFSET(DrawData,occlusion) + 4 * cluster) = clusterOcclusion;
 		}
 
+		if(state.pipelineCounters)
+		{
+			*Pointer<UInt>(data + OFFSET(DrawData,quadsShaded) + 4 * cluster) += quadsShaded;
+			*Pointer<UInt>(data + OFFSET(DrawData,quadsDepthKilled) + 4 * cluster) += quadsDepthKilled;
+			*Pointer<UInt>(data + OFFSET(DrawData,textureSamples) + 4 * cluster) += textureSamples;
+		}
+
 		#if PERF_PROFILE
 			cycles[PERF_PIXEL] = Ticks() - pixelTime;
 
@@ -118,30 +128,57 @@ namespace sw
 
 		Do
 		{
-			Int x0a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
-			Int x0b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
-			Int x0 = Min(x0a, x0b);
+			Int x0;
+			Int x1;
+
+			Short4 left[2];    // Left edges of all samples on rows y and y + 1
+			Short4 right[2];   // Right edges of all samples on rows y and y + 1
 
-			for(unsigned int q = 1; q < state.multiSample; q++)
+			if(state.multiSample == 1)
 			{
-				x0a = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
-				x0b = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
-				x0 = Min(x0, Min(x0a, x0b));
+				Int x0a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
+				Int x0b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
+				x0 = Min(x0a, x0b);
+
+				Int x1a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
+				Int x1b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
+				x1 = Max(x1a, x1b);
 			}
+			else
+			{
+				const int pitch = state.multiSample * sizeof(Primitive::Span);
 
-			x0 &= 0xFFFFFFFE;
+				for(int i = 0; i < 2; i++)
+				{
+					Pointer<Byte> row = primitive + OFFSET(Primitive,outline) + (y + i) * pitch;
 
-			Int x1a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
-			Int x1b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
-			Int x1 = Max(x1a, x1b);
+					if(state.multiSample == 4)
+					{
+						left[i] = *Pointer<Short4>(row);
+						right[i] = *Pointer<Short4>(row + 8);
+					}
+					else
+					{
+						Short4 spans = *Pointer<Short4>(row);
 
-			for(unsigned int q = 1; q < state.multiSample; q++)
-			{
-				x1a = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
-				x1b = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
-				x1 = Max(x1, Max(x1a, x1b));
+						left[i] = Swizzle(spans, 0x44);
+						right[i] = Swizzle(spans, 0xEE);
+					}
+				}
+
+				Short4 xLeft = Min(left[0], left[1]);
+				xLeft = Min(xLeft, Swizzle(xLeft, 0x4E));
+				xLeft = Min(xLeft, Swizzle(xLeft, 0xB1));
+				x0 = Int(Extract(xLeft, 0));
+
+				Short4 xRight = Max(right[0], right[1]);
+				xRight = Max(xRight, Swizzle(xRight, 0x4E));
+				xRight = Max(xRight, Swizzle(xRight, 0xB1));
+				x1 = Int(Extract(xRight, 0));
 			}
 
+			x0 &= 0xFFFFFFFE;
+
 			Float4 yyyy = Float4(Float(y)) + *Pointer<Float4>(primitive + OFFSET(Primitive,yQuad), 16);
 
 			if(interpolateZ())
@@ -267,13 +304,30 @@ namespace sw
 				Short4 xLeft[4];
 				Short4 xRight[4];
 
-				for(unsigned int q = 0; q < state.multiSample; q++)
+				if(state.multiSample == 1)
 				{
-					xLeft[q] = *Pointer<Short4>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline) + y * sizeof(Primitive::Span));
-					xRight[q] = xLeft[q];
+					xLeft[0] = *Pointer<Short4>(primitive + OFFSET(Primitive,outline) + y * sizeof(Primitive::Span));
+					xRight[0] = xLeft[0];
 
-					xLeft[q] = Swizzle(xLeft[q], 0xA0) - Short4(1, 2, 1, 2);
-					xRight[q] = Swizzle(xRight[q], 0xF5) - Short4(0, 1, 0, 1);
+					xLeft[0] = Swizzle(xLeft[0], 0xA0) - Short4(1, 2, 1, 2);
+					xRight[0] = Swizzle(xRight[0], 0xF5) - Short4(0, 1, 0, 1);
+				}
+				else
+				{
+					// Interleave the rows, then broadcast each sample's edges to its pixel pairs
+					Short4 left01 = As<Short4>(UnpackLow(left[0], left[1]));
+					Short4 left23 = As<Short4>(UnpackHigh(left[0], left[1]));
+					Short4 right01 = As<Short4>(UnpackLow(right[0], right[1]));
+					Short4 right23 = As<Short4>(UnpackHigh(right[0], right[1]));
+
+					for(unsigned int q = 0; q < state.multiSample; q++)
+					{
+						Short4 &leftq = (q < 2) ? left01 : left23;
+						Short4 &rightq = (q < 2) ? right01 : right23;
+
+						xLeft[q] = Swizzle(leftq, (q & 1) ? 0xFA : 0x50) - Short4(1, 2, 1, 2);
+						xRight[q] = Swizzle(rightq, (q & 1) ? 0xFA : 0x50) - Short4(0, 1, 0, 1);
+					}
 				}
 
 				For(Int x = x0, x < x1, x += 2)
@@ -40,6 +40,11 @@ namespace sw
 
 		UInt occlusion;
 
+		// Pipeline counters
+		UInt quadsShaded;
+		UInt quadsDepthKilled;
+		UInt textureSamples;
+
 #if PERF_PROFILE
 		Long cycles[PERF_TIMERS];
 #endif
@@ -29,8 +29,14 @@
 #include "Common/Half.hpp"
 #include "Common/Math.hpp"
 #include "Common/Timer.hpp"
+#include "Common/Tracer.hpp"
 #include "Common/Debug.hpp"
 
+#if defined(__i386__) || defined(__x86_64__)
+	#include <xmmintrin.h>
+	#include <emmintrin.h>
+#endif
+
 #undef max
 
 bool disableServer = true;
@@ -54,14 +60,21 @@ namespace sw
 	extern bool complementaryDepthBuffer;
 	extern bool postBlendSRGB;
 	extern bool exactColorRounding;
+	extern bool compressedTextureSampling;
+	extern bool tiledTextureLayout;
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool forceClearRegisters;
+	extern bool tieredCompilation;
+	extern bool specializeUniforms;
+	extern bool specializeSamplers;
 
 	extern bool precacheVertex;
+	extern bool shadeUniqueVertices;
 	extern bool precacheSetup;
 	extern bool precachePixel;
 
 	static const int batchSize = 128;
+	static const unsigned int maxUniqueVertices = 8192;   // Largest index range shaded once per draw
 	AtomicInt threadCount(1);
 	AtomicInt Renderer::unitCount(1);
 	AtomicInt Renderer::clusterCount(1);
@@ -92,6 +105,14 @@ namespace sw
 
 		references = -1;
 
+		vertexBuffer = 0;
+		vertexBufferSize = 0;
+		vertexBase = 0;
+		vertexCount = 0;
+		vertexProgress = 0;
+		vertexReferences = 0;
+		outputCount = 0;
+
 		data = (DrawData*)allocate(sizeof(DrawData));
 		data->constants = &constants;
 	}
@@ -100,9 +121,65 @@ namespace sw
 	{
 		delete queries;
 
+		deallocate(vertexBuffer);
 		deallocate(data);
 	}
 
+	// Determines the range of indices referenced by an indexed draw
+	static bool indexRange(DrawType drawType, const void *indices, unsigned int count, unsigned int &minIndex, unsigned int &maxIndex)
+	{
+		unsigned int indexCount;
+
+		switch(drawType & 0x0F)
+		{
+		case DRAW_POINTLIST:     indexCount = count;     break;
+		case DRAW_LINELIST:      indexCount = 2 * count; break;
+		case DRAW_LINESTRIP:     indexCount = count + 1; break;
+		case DRAW_LINELOOP:      indexCount = count;     break;
+		case DRAW_TRIANGLELIST:  indexCount = 3 * count; break;
+		case DRAW_TRIANGLESTRIP: indexCount = count + 2; break;
+		case DRAW_TRIANGLEFAN:   indexCount = count + 2; break;
+		default:
+			return false;
+		}
+
+		minIndex = 0xFFFFFFFF;
+		maxIndex = 0;
+
+		switch(drawType & 0xF0)
+		{
+		case DRAW_INDEXED8:
+			for(unsigned int i = 0; i < indexCount; i++)
+			{
+				unsigned int index = static_cast<const unsigned char*>(indices)[i];
+				minIndex = min(minIndex, index);
+				maxIndex = max(maxIndex, index);
+			}
+			break;
+		case DRAW_INDEXED16:
+			for(unsigned int i = 0; i < indexCount; i++)
+			{
+				unsigned int index = static_cast<const unsigned short*>(indices)[i];
+				minIndex = min(minIndex, index);
+				maxIndex = max(maxIndex, index);
+			}
+			break;
+		case DRAW_INDEXED32:
+			for(unsigned int i = 0; i < indexCount; i++)
+			{
+				unsigned int index = static_cast<const unsigned int*>(indices)[i];
+				minIndex = min(minIndex, index);
+				maxIndex = max(maxIndex, index);
+			}
+			break;
+		default:
+			return false;
+		}
+
+		// Only worthwhile when there are fewer vertices in the range than indices
+		return maxIndex - minIndex < min(indexCount, maxUniqueVertices);
+	}
+
 	Renderer::Renderer(Context *context, Conventions conventions, bool exactColorRounding) : VertexProcessor(context), PixelProcessor(context), SetupProcessor(context), context(context), viewport()
 	{
 		sw::halfIntegerCoordinates = conventions.halfIntegerCoordinates;
@@ -139,6 +216,13 @@ namespace sw
 		threadsAwake = 0;
 		resumeApp = new Event();
 
+		readbackCount = 0;
+		readbackThread = nullptr;
+		readbackQueued = new Event();
+		readbackDone = new Event();
+		readbackBlitter = nullptr;
+		exitReadbacks = false;
+
 		currentDraw = 0;
 		nextDraw = 0;
 
@@ -177,6 +261,22 @@ namespace sw
 
 	Renderer::~Renderer()
 	{
+		synchronizeReadbacks();
+
+		if(readbackThread)
+		{
+			exitReadbacks = true;
+			readbackQueued->signal();
+			readbackThread->join();
+
+			delete readbackThread;
+			readbackThread = nullptr;
+		}
+
+		delete readbackQueued;
+		delete readbackDone;
+		delete readbackBlitter;
+
 		sync->destruct();
 
 		delete clipper;
@@ -210,6 +310,8 @@ namespace sw
 
 	void Renderer::draw(DrawType drawType, unsigned int indexOffset, unsigned int count, bool update)
 	{
+		TraceScope trace("Draw");
+
 		#ifndef NDEBUG
 			if(count < minPrimitives || count > maxPrimitives)
 			{
@@ -217,10 +319,27 @@ namespace sw
 			}
 		#endif
 
-		context->drawType = drawType;
+		if(context->drawType != drawType)
+		{
+			context->drawType = drawType;
+			context->dirtyState |= STATE_RENDER;
+		}
+
+		if(readbackCount > 0)
+		{
+			// Don't overwrite surfaces which are still being read back
+			for(int index = 0; index < RENDERTARGETS; index++)
+			{
+				synchronizeReadbacks(context->renderTarget[index]);
+			}
+
+			synchronizeReadbacks(context->depthBuffer);
+			synchronizeReadbacks(context->stencilBuffer);
+		}
 
 		updateConfiguration();
 		updateClipper();
+		context->validateBindings();
 
 		int ss = context->getSuperSampleCount();
 		int ms = context->getMultiSampleCount();
@@ -238,15 +357,33 @@ namespace sw
 
 			sync->lock(sw::PRIVATE);
 
+			if(oldMultiSampleMask != context->multiSampleMask)
+			{
+				context->dirtyState |= STATE_RENDER;
+			}
+
 			if(update || oldMultiSampleMask != context->multiSampleMask)
 			{
-				vertexState = VertexProcessor::update(drawType);
-				setupState = SetupProcessor::update();
-				pixelState = PixelProcessor::update();
+				bool stateChanged = (context->dirtyState != 0);
+
+				VertexProcessor::update(vertexState, drawType);
+				SetupProcessor::update(setupState);
+				PixelProcessor::update(pixelState);
 
-				vertexRoutine = VertexProcessor::routine(vertexState);
-				setupRoutine = SetupProcessor::routine(setupState);
-				pixelRoutine = PixelProcessor::routine(pixelState);
+				if(stateChanged)   // Unchanged states keep their routines
+				{
+					vertexRoutine = VertexProcessor::routine(vertexState);
+					setupRoutine = SetupProcessor::routine(setupState);
+					pixelRoutine = PixelProcessor::routine(pixelState);
+
+					context->dirtyState = 0;
+				}
+			}
+
+			if(tieredCompilation)
+			{
+				vertexRoutine = VertexProcessor::tierUp(vertexState, vertexRoutine);
+				pixelRoutine = PixelProcessor::tierUp(pixelState, pixelRoutine);
 			}
 
 			int batch = batchSize / ms;
@@ -335,6 +472,7 @@ namespace sw
 			draw->pixelPointer = (PixelProcessor::RoutinePointer)pixelRoutine->getEntry();
 			draw->setupPrimitives = setupPrimitives;
 			draw->setupState = setupState;
+			draw->pipelineCounters = pixelState.pipelineCounters;
 
 			for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 			{
@@ -527,6 +665,16 @@ namespace sw
 				}
 			}
 
+			if(pixelState.pipelineCounters)
+			{
+				for(int cluster = 0; cluster < clusterCount; cluster++)
+				{
+					data->quadsShaded[cluster] = 0;
+					data->quadsDepthKilled[cluster] = 0;
+					data->textureSamples[cluster] = 0;
+				}
+			}
+
 			#if PERF_PROFILE
 				for(int cluster = 0; cluster < clusterCount; cluster++)
 				{
@@ -590,6 +738,19 @@ namespace sw
 				data->slopeDepthBias = context->slopeDepthBias;
 				data->depthRange = Z;
 				data->depthNear = N;
+
+				// Triangles inside the guard band are only scissored, not clipped against the sides.
+				// It's as large as possible without overflowing the fixed-point edge setup, which
+				// multiplies 28.4 x and y deltas: (width + 2 * g) * (height + 2 * g) * 16^2 < 2^31.
+				float width = abs(viewport.width) + 2;
+				float height = abs(viewport.height) + 2;
+				float maxArea = (float)(0x7FFFFFFF >> 8);
+				float g = 0.25f * (sqrt((width - height) * (width - height) + 4 * maxArea) - (width + height));
+				g = max(g, 0.0f);
+
+				data->guardBandX = replicate(1.0f + 2 * g / width);
+				data->guardBandY = replicate(1.0f + 2 * g / height);
+
 				draw->clipFlags = clipFlags;
 
 				if(clipFlags)
@@ -603,8 +764,25 @@ namespace sw
 				}
 			}
 
+			// Scissor
+			{
+				// Triangles within the guard band can extend past the viewport
+				float x0 = min(viewport.x0, viewport.x0 + viewport.width);
+				float x1 = max(viewport.x0, viewport.x0 + viewport.width);
+				float y0 = min(viewport.y0, viewport.y0 + viewport.height);
+				float y1 = max(viewport.y0, viewport.y0 + viewport.height);
+
+				data->scissorX0 = max(scissor.x0, (int)ceil(x0 - 0.5f));
+				data->scissorX1 = min(scissor.x1, (int)ceil(x1 - 0.5f));
+				data->scissorY0 = max(scissor.y0, (int)ceil(y0 - 0.5f));
+				data->scissorY1 = min(scissor.y1, (int)ceil(y1 - 0.5f));
+			}
+
 			// Target
 			{
+				// Only the scissored region gets written, so only that needs converting for readback
+				Rect written(data->scissorX0, data->scissorY0, data->scissorX1, data->scissorY1);
+
 				for(int index = 0; index < RENDERTARGETS; index++)
 				{
 					draw->renderTarget[index] = context->renderTarget[index];
@@ -613,7 +791,7 @@ namespace sw
 					{
 						unsigned int layer = context->renderTargetLayer[index];
 						requiresSync |= context->renderTarget[index]->requiresSync();
-						data->colorBuffer[index] = (unsigned int*)context->renderTarget[index]->lockInternal(0, 0, layer, LOCK_READWRITE, MANAGED);
+						data->colorBuffer[index] = (unsigned int*)context->renderTarget[index]->lockInternal(0, 0, layer, written, LOCK_READWRITE, MANAGED);
 						data->colorBuffer[index] += q * ms * context->renderTarget[index]->getSliceB(true);
 						data->colorPitchB[index] = context->renderTarget[index]->getInternalPitchB();
 						data->colorSliceB[index] = context->renderTarget[index]->getInternalSliceB();
@@ -627,7 +805,7 @@ namespace sw
 				{
 					unsigned int layer = context->depthBufferLayer;
 					requiresSync |= context->depthBuffer->requiresSync();
-					data->depthBuffer = (float*)context->depthBuffer->lockInternal(0, 0, layer, LOCK_READWRITE, MANAGED);
+					data->depthBuffer = (float*)context->depthBuffer->lockInternal(0, 0, layer, written, LOCK_READWRITE, MANAGED);
 					data->depthBuffer += q * ms * context->depthBuffer->getSliceB(true);
 					data->depthPitchB = context->depthBuffer->getInternalPitchB();
 					data->depthSliceB = context->depthBuffer->getInternalSliceB();
@@ -644,12 +822,36 @@ namespace sw
 				}
 			}
 
-			// Scissor
+			draw->vertexCount = 0;
+			draw->vertexProgress = 0;
+			draw->vertexReferences = 0;
+
+			unsigned int minIndex;
+			unsigned int maxIndex;
+
+			if(shadeUniqueVertices && !vertexState.transformFeedbackEnabled && data->indices && indexRange(drawType, data->indices, count, minIndex, maxIndex))
 			{
-				data->scissorX0 = scissor.x0;
-				data->scissorX1 = scissor.x1;
-				data->scissorY0 = scissor.y0;
-				data->scissorY1 = scissor.y1;
+				unsigned int vertexCount = maxIndex - minIndex + 1;
+
+				if(draw->vertexBufferSize < vertexCount)
+				{
+					deallocate(draw->vertexBuffer);
+					draw->vertexBuffer = (Vertex*)allocate(vertexCount * sizeof(Vertex));
+					draw->vertexBufferSize = vertexCount;
+				}
+
+				draw->vertexBase = minIndex;
+				draw->vertexCount = vertexCount;
+				draw->vertexReferences = (vertexCount + batchSize - 1) / batchSize;
+				draw->outputCount = 0;
+
+				for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+				{
+					if(vertexState.output[i].write)
+					{
+						draw->outputs[draw->outputCount++] = i;
+					}
+				}
 			}
 
 			draw->primitive = 0;
@@ -693,19 +895,189 @@ namespace sw
 
 	void Renderer::clear(void *value, Format format, Surface *dest, const Rect &clearRect, unsigned int rgbaMask)
 	{
+		synchronizeReadbacks(dest);
 		blitter->clear(value, format, dest, clearRect, rgbaMask);
 	}
 
 	void Renderer::blit(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, bool filter, bool isStencil, bool sRGBconversion)
 	{
+		synchronizeReadbacks(dest);
 		blitter->blit(source, sRect, dest, dRect, {filter, isStencil, sRGBconversion});
 	}
 
 	void Renderer::blit3D(Surface *source, Surface *dest)
 	{
+		synchronizeReadbacks(dest);
 		blitter->blit3D(source, dest);
 	}
 
+	void Renderer::readback(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, Resource *buffer, AtomicInt *pending)
+	{
+		Readback readback = {source, sRect, dest, dRect, buffer, pending};
+		queueReadback(readback);
+	}
+
+	void Renderer::fence(AtomicInt *pending)
+	{
+		Readback readback = {nullptr, SliceRectF(), nullptr, SliceRect(), nullptr, pending};
+		queueReadback(readback);
+	}
+
+	void Renderer::queueReadback(const Readback &readback)
+	{
+		if(!readbackThread)
+		{
+			readbackBlitter = new Blitter;
+			readbackThread = new Thread(readbackFunction, this);
+		}
+
+		if(readback.pending)
+		{
+			++(*readback.pending);
+		}
+
+		readbackMutex.lock();
+		readbacks.push_back(readback);
+		++readbackCount;
+		readbackMutex.unlock();
+
+		readbackQueued->signal();
+	}
+
+	void Renderer::synchronizeReadbacks(Surface *source)
+	{
+		while(readbackCount > 0)
+		{
+			bool pending = !source;   // Without a source, wait for all readbacks and fences to complete
+
+			if(source)
+			{
+				readbackMutex.lock();
+				for(const Readback &readback : readbacks)
+				{
+					if(readback.source == source)
+					{
+						pending = true;
+						break;
+					}
+				}
+				readbackMutex.unlock();
+			}
+
+			if(!pending)
+			{
+				break;
+			}
+
+			readbackDone->wait();
+		}
+	}
+
+	void Renderer::readbackFunction(void *parameters)
+	{
+		Renderer *renderer = static_cast<Renderer*>(parameters);
+		renderer->readbackLoop();
+	}
+
+	void Renderer::readbackLoop()
+	{
+		while(true)
+		{
+			readbackMutex.lock();
+
+			if(readbacks.empty())
+			{
+				readbackMutex.unlock();
+
+				if(exitReadbacks)
+				{
+					return;
+				}
+
+				readbackQueued->wait();
+				continue;
+			}
+
+			Readback readback = readbacks.front();
+			readbackMutex.unlock();
+
+			if(readback.source)
+			{
+				Surface *snapshot = snapshotReadback(readback);
+
+				if(snapshot != readback.source)
+				{
+					// Later writes to the source only have to wait for the snapshot, not for the conversion
+					readbackMutex.lock();
+					readbacks.front().source = nullptr;
+					readbackMutex.unlock();
+					readbackDone->signal();
+				}
+
+				readbackBlitter->blit(snapshot, readback.sRect, readback.dest, readback.dRect, {false, false, false});
+
+				if(snapshot != readback.source)
+				{
+					delete snapshot;
+				}
+			}
+
+			if(readback.dest)
+			{
+				readback.dest->lockExternal(0, 0, 0, LOCK_READONLY, PUBLIC);
+				readback.dest->unlockExternal();
+				delete readback.dest;
+			}
+
+			if(readback.buffer)
+			{
+				readback.buffer->unlock();
+			}
+
+			if(readback.pending)
+			{
+				--(*readback.pending);
+			}
+
+			readbackMutex.lock();
+			readbacks.pop_front();
+			--readbackCount;
+			readbackMutex.unlock();
+
+			readbackDone->signal();
+		}
+	}
+
+	Surface *Renderer::snapshotReadback(Readback &readback)
+	{
+		Surface *source = readback.source;
+		Format format = source->getInternalFormat();
+
+		if(Surface::isDepth(format) || Surface::isStencil(format))
+		{
+			return source;   // Converted in place, so writers wait for the whole readback
+		}
+
+		int x0 = (int)floor(readback.sRect.x0);
+		int y0 = (int)floor(readback.sRect.y0);
+		int x1 = (int)ceil(readback.sRect.x1);
+		int y1 = (int)ceil(readback.sRect.y1);
+
+		if(x1 <= x0 || y1 <= y0)
+		{
+			return source;
+		}
+
+		// Locking the source waits for the draws which render to it
+		Surface *snapshot = Surface::create(nullptr, x1 - x0, y1 - y0, 1, 0, 1, format, false, false);
+		const SliceRectF &sRect = readback.sRect;
+		readbackBlitter->blit(source, SliceRectF((float)x0, (float)y0, (float)x1, (float)y1, sRect.slice), snapshot, SliceRect(0, 0, x1 - x0, y1 - y0, 0), {false, false, false});
+
+		readback.sRect = SliceRectF(sRect.x0 - x0, sRect.y0 - y0, sRect.x1 - x0, sRect.y1 - y0, 0);
+
+		return snapshot;
+	}
+
 	void Renderer::threadFunction(void *parameters)
 	{
 		Renderer *renderer = static_cast<Parameters*>(parameters)->renderer;
@@ -717,6 +1089,13 @@ namespace sw
 			CPUID::setDenormalsAreZero(true);
 		}
 
+		if(Tracer::isEnabled())
+		{
+			char name[32];
+			sprintf(name, "Worker %d", threadIndex);
+			Tracer::setThreadName(Tracer::internName(name));
+		}
+
 		renderer->threadLoop(threadIndex);
 	}
 
@@ -727,6 +1106,8 @@ namespace sw
 			taskLoop(threadIndex);
 
 			suspend[threadIndex]->signal();
+
+			TraceScope trace("Suspended");
 			resume[threadIndex]->wait();
 		}
 	}
@@ -799,6 +1180,26 @@ namespace sw
 				draw = drawList[currentDraw & DRAW_COUNT_BITS];
 			}
 
+			if(draw->vertexReferences > 0)   // Primitives are assembled once all vertices have been shaded
+			{
+				// Keep room in the task queue for the pixel and primitive tasks
+				while(draw->vertexProgress < (int)draw->vertexCount && qSize < TASK_COUNT - clusterCount - unitCount)
+				{
+					Task &task = taskQueue[qHead];
+					task.type = Task::VERTICES;
+					task.drawCall = currentDraw;
+					task.firstVertex = draw->vertexProgress;
+
+					draw->vertexProgress += batchSize;
+
+					// Commit to the task queue
+					qHead = (qHead + 1) & TASK_COUNT_BITS;
+					qSize++;
+				}
+
+				return;
+			}
+
 			if(!primitiveProgress[unit].references)   // Task not already being executed and not still in use by a pixel unit
 			{
 				primitive = draw->primitive;
@@ -876,8 +1277,21 @@ namespace sw
 
 		switch(task[threadIndex].type)
 		{
+		case Task::VERTICES:
+			{
+				TraceScope trace("Vertices");
+
+				processVertices(task[threadIndex].drawCall, task[threadIndex].firstVertex, threadIndex);
+
+				#if PERF_HUD
+					vertexTime[threadIndex] += Timer::ticks() - startTick;
+				#endif
+			}
+			break;
 		case Task::PRIMITIVES:
 			{
+				TraceScope trace("Primitives");
+
 				int unit = task[threadIndex].primitiveUnit;
 
 				int input = primitiveProgress[unit].firstPrimitive;
@@ -900,6 +1314,12 @@ namespace sw
 					visible = (this->*setupPrimitives)(unit, count);
 				}
 
+				if(draw->pipelineCounters)
+				{
+					profiler.count(COUNTER_PRIMITIVES, count);
+					profiler.count(COUNTER_PRIMITIVES_CULLED, count - visible);
+				}
+
 				primitiveProgress[unit].visible = visible;
 				primitiveProgress[unit].references = clusterCount;
 
@@ -910,6 +1330,8 @@ namespace sw
 			break;
 		case Task::PIXELS:
 			{
+				TraceScope trace("Pixels");
+
 				int unit = task[threadIndex].primitiveUnit;
 				int visible = primitiveProgress[unit].visible;
 
@@ -942,6 +1364,10 @@ namespace sw
 
 	void Renderer::synchronize()
 	{
+		TraceScope trace("Synchronize");
+
+		synchronizeReadbacks();
+
 		sync->lock(sw::PUBLIC);
 		sync->unlock();
 	}
@@ -983,6 +1409,16 @@ namespace sw
 					}
 				#endif
 
+				if(draw.pipelineCounters)
+				{
+					for(int cluster = 0; cluster < clusterCount; cluster++)
+					{
+						profiler.count(COUNTER_QUADS_SHADED, data.quadsShaded[cluster]);
+						profiler.count(COUNTER_QUADS_DEPTH_KILLED, data.quadsDepthKilled[cluster]);
+						profiler.count(COUNTER_TEXTURE_SAMPLES, data.textureSamples[cluster]);
+					}
+				}
+
 				if(draw.queries)
 				{
 					for(auto &query : *(draw.queries))
@@ -1082,6 +1518,44 @@ namespace sw
 		pixelProgress[cluster].executing = false;
 	}
 
+	static void countVertices(unsigned int lookups, unsigned int misses)
+	{
+		profiler.count(COUNTER_VERTICES_SHADED, 4 * misses);   // Each miss shades a group of four vertices
+		profiler.count(COUNTER_VERTEX_CACHE_LOOKUPS, lookups);
+		profiler.count(COUNTER_VERTEX_CACHE_HITS, lookups - misses);
+	}
+
+	void Renderer::processVertices(int drawCall, unsigned int first, int thread)
+	{
+		DrawCall *draw = drawList[drawCall & DRAW_COUNT_BITS];
+		VertexTask *task = vertexTask[thread];
+
+		if(task->vertexCache.drawCall != drawCall)
+		{
+			task->vertexCache.clear();
+			task->vertexCache.drawCall = drawCall;
+		}
+
+		unsigned int count = min((unsigned int)batchSize, draw->vertexCount - first);
+		unsigned int batch[batchSize];
+
+		for(unsigned int i = 0; i < count; i++)
+		{
+			batch[i] = draw->vertexBase + first + i;
+		}
+
+		task->primitiveStart = 0;
+		task->vertexCount = count;
+		draw->vertexPointer(&draw->vertexBuffer[first], batch, task, draw->data);
+
+		if(draw->pipelineCounters)
+		{
+			countVertices(count, task->cacheMisses);
+		}
+
+		--draw->vertexReferences;   // Atomic
+	}
+
 	void Renderer::processPrimitiveVertices(int unit, unsigned int start, unsigned int triangleCount, unsigned int loop, int thread)
 	{
 		Triangle *triangle = triangleBatch[unit];
@@ -1524,14 +1998,241 @@ namespace sw
 			return;
 		}
 
+		if(draw->vertexCount)   // Already shaded
+		{
+			Vertex *vertex = &triangle->v0;
+			const unsigned int *index = &batch[0][0];
+
+			for(unsigned int i = 0; i < triangleCount * 3; i++)
+			{
+				const Vertex &shaded = draw->vertexBuffer[index[i] - draw->vertexBase];
+
+				for(int j = 0; j < draw->outputCount; j++)
+				{
+					vertex[i].v[draw->outputs[j]] = shaded.v[draw->outputs[j]];
+				}
+
+				vertex[i].X = shaded.X;
+				vertex[i].Y = shaded.Y;
+				vertex[i].Z = shaded.Z;
+				vertex[i].W = shaded.W;
+				vertex[i].clipFlags = shaded.clipFlags;
+			}
+
+			if(draw->pipelineCounters)
+			{
+				profiler.count(COUNTER_VERTEX_CACHE_LOOKUPS, triangleCount * 3);
+				profiler.count(COUNTER_VERTEX_CACHE_HITS, triangleCount * 3);
+			}
+
+			return;
+		}
+
 		task->primitiveStart = start;
 		task->vertexCount = triangleCount * 3;
 		vertexRoutine(&triangle->v0, (unsigned int*)&batch, task, data);
+
+		if(draw->pipelineCounters)
+		{
+			countVertices(task->vertexCount, task->cacheMisses);
+		}
+	}
+
+	static int clipFlagsOr(const Triangle &triangle, const DrawCall &draw)
+	{
+		int clipFlagsOr = triangle.v0.clipFlags | triangle.v1.clipFlags | triangle.v2.clipFlags | draw.clipFlags;
+
+		// Within the guard band only the near and far planes and user planes need clipping
+		if(!(clipFlagsOr & Clipper::CLIP_GUARD_BAND))
+		{
+			clipFlagsOr &= ~Clipper::CLIP_SIDES;
+		}
+
+		return clipFlagsOr & ~Clipper::CLIP_GUARD_BAND;
+	}
+
+	// Conservatively determines whether the setup routine would reject an unclipped triangle, or it
+	// would produce no fragments: back faces, degenerate triangles, and those outside the scissor.
+	static bool cullTriangle(const Triangle &triangle, const DrawCall &draw)
+	{
+		const Vertex &v0 = triangle.v0;
+		const Vertex &v1 = triangle.v1;
+		const Vertex &v2 = triangle.v2;
+		const DrawData &data = *draw.data;
+
+		if((v0.X == v1.X && v0.Y == v1.Y) || (v1.X == v2.X && v1.Y == v2.Y) || (v2.X == v0.X && v2.Y == v0.Y))
+		{
+			return true;
+		}
+
+		// Fixed-point bounds, with a margin for the half-pixel offset and multisample positions
+		int left = data.scissorX0 * 16 - 16;
+		int right = data.scissorX1 * 16 + 16;
+		int top = data.scissorY0 * 16 - 16;
+		int bottom = data.scissorY1 * 16 + 16;
+
+		if((v0.X < left && v1.X < left && v2.X < left) || (v0.X > right && v1.X > right && v2.X > right) ||
+		   (v0.Y < top && v1.Y < top && v2.Y < top) || (v0.Y > bottom && v1.Y > bottom && v2.Y > bottom))
+		{
+			return true;
+		}
+
+		CullMode cullMode = draw.setupState.cullMode;
+
+		if(cullMode != CULL_NONE)
+		{
+			int pos = draw.setupState.positionRegister;
+
+			float x0 = (float)v0.X;
+			float x1 = (float)v1.X;
+			float x2 = (float)v2.X;
+			float y0 = (float)v0.Y;
+			float y1 = (float)v1.Y;
+			float y2 = (float)v2.Y;
+
+			float t0 = (y1 - y2) * x0;
+			float t1 = (y2 - y0) * x1;
+			float t2 = (y0 - y1) * x2;
+			float A = t0 + t1 + t2;   // Same area as computed by the setup routine
+
+			if(std::signbit(v0.v[pos].w) ^ std::signbit(v1.v[pos].w) ^ std::signbit(v2.v[pos].w))
+			{
+				A = -A;
+			}
+
+			// Leave near-degenerate triangles to the setup routine, whose area may round differently
+			float margin = (abs(t0) + abs(t1) + abs(t2)) * (1.0f / (1 << 20));
+
+			if((cullMode == CULL_CLOCKWISE && A > margin) || (cullMode == CULL_COUNTERCLOCKWISE && A < -margin))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	int Renderer::cullTriangles(const Triangle *triangle, int count, const DrawCall &draw, int *survivors)
+	{
+		int visible = 0;
+		int i = 0;
+
+		#if defined(__i386__) || defined(__x86_64__)
+			if(CPUID::supportsSSE2())
+			{
+				const DrawData &data = *draw.data;
+				int pos = draw.setupState.positionRegister;
+				CullMode cullMode = draw.setupState.cullMode;
+
+				const __m128i finite = _mm_set1_epi32(Clipper::CLIP_FINITE);
+				const __m128i band = _mm_set1_epi32(Clipper::CLIP_GUARD_BAND);
+				const __m128i sides = _mm_set1_epi32(Clipper::CLIP_SIDES);
+				const __m128i drawFlags = _mm_set1_epi32(draw.clipFlags);
+				const __m128i left = _mm_set1_epi32(data.scissorX0 * 16 - 16);
+				const __m128i right = _mm_set1_epi32(data.scissorX1 * 16 + 16);
+				const __m128i top = _mm_set1_epi32(data.scissorY0 * 16 - 16);
+				const __m128i bottom = _mm_set1_epi32(data.scissorY1 * 16 + 16);
+				const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+				const __m128 epsilon = _mm_set1_ps(1.0f / (1 << 20));
+
+				for(; i + 4 <= count; i += 4)
+				{
+					const Triangle *t = triangle + i;
+
+					__m128i flags0 = _mm_setr_epi32(t[0].v0.clipFlags, t[1].v0.clipFlags, t[2].v0.clipFlags, t[3].v0.clipFlags);
+					__m128i flags1 = _mm_setr_epi32(t[0].v1.clipFlags, t[1].v1.clipFlags, t[2].v1.clipFlags, t[3].v1.clipFlags);
+					__m128i flags2 = _mm_setr_epi32(t[0].v2.clipFlags, t[1].v2.clipFlags, t[2].v2.clipFlags, t[3].v2.clipFlags);
+
+					// Trivially rejected by the frustum or non-finite
+					__m128i flagsAnd = _mm_andnot_si128(band, _mm_and_si128(_mm_and_si128(flags0, flags1), flags2));
+					__m128i reject = _mm_xor_si128(_mm_cmpeq_epi32(flagsAnd, finite), _mm_set1_epi32(-1));
+
+					// Only unclipped triangles have meaningful projected coordinates
+					__m128i flagsOr = _mm_or_si128(_mm_or_si128(_mm_or_si128(flags0, flags1), flags2), drawFlags);
+					__m128i inBand = _mm_cmpeq_epi32(_mm_and_si128(flagsOr, band), _mm_setzero_si128());
+					flagsOr = _mm_andnot_si128(_mm_or_si128(band, _mm_and_si128(inBand, sides)), flagsOr);
+					__m128i unclipped = _mm_cmpeq_epi32(flagsOr, finite);
+
+					__m128i X0 = _mm_setr_epi32(t[0].v0.X, t[1].v0.X, t[2].v0.X, t[3].v0.X);
+					__m128i X1 = _mm_setr_epi32(t[0].v1.X, t[1].v1.X, t[2].v1.X, t[3].v1.X);
+					__m128i X2 = _mm_setr_epi32(t[0].v2.X, t[1].v2.X, t[2].v2.X, t[3].v2.X);
+					__m128i Y0 = _mm_setr_epi32(t[0].v0.Y, t[1].v0.Y, t[2].v0.Y, t[3].v0.Y);
+					__m128i Y1 = _mm_setr_epi32(t[0].v1.Y, t[1].v1.Y, t[2].v1.Y, t[3].v1.Y);
+					__m128i Y2 = _mm_setr_epi32(t[0].v2.Y, t[1].v2.Y, t[2].v2.Y, t[3].v2.Y);
+
+					__m128i degenerate = _mm_or_si128(_mm_or_si128(
+						_mm_and_si128(_mm_cmpeq_epi32(X0, X1), _mm_cmpeq_epi32(Y0, Y1)),
+						_mm_and_si128(_mm_cmpeq_epi32(X1, X2), _mm_cmpeq_epi32(Y1, Y2))),
+						_mm_and_si128(_mm_cmpeq_epi32(X2, X0), _mm_cmpeq_epi32(Y2, Y0)));
+
+					__m128i outside = _mm_or_si128(_mm_or_si128(
+						_mm_and_si128(_mm_and_si128(_mm_cmplt_epi32(X0, left), _mm_cmplt_epi32(X1, left)), _mm_cmplt_epi32(X2, left)),
+						_mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(X0, right), _mm_cmpgt_epi32(X1, right)), _mm_cmpgt_epi32(X2, right))), _mm_or_si128(
+						_mm_and_si128(_mm_and_si128(_mm_cmplt_epi32(Y0, top), _mm_cmplt_epi32(Y1, top)), _mm_cmplt_epi32(Y2, top)),
+						_mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(Y0, bottom), _mm_cmpgt_epi32(Y1, bottom)), _mm_cmpgt_epi32(Y2, bottom))));
+
+					__m128i cull = _mm_or_si128(degenerate, outside);
+
+					if(cullMode != CULL_NONE)
+					{
+						__m128 x0 = _mm_cvtepi32_ps(X0);
+						__m128 x1 = _mm_cvtepi32_ps(X1);
+						__m128 x2 = _mm_cvtepi32_ps(X2);
+						__m128 y0 = _mm_cvtepi32_ps(Y0);
+						__m128 y1 = _mm_cvtepi32_ps(Y1);
+						__m128 y2 = _mm_cvtepi32_ps(Y2);
+
+						__m128 t0 = _mm_mul_ps(_mm_sub_ps(y1, y2), x0);
+						__m128 t1 = _mm_mul_ps(_mm_sub_ps(y2, y0), x1);
+						__m128 t2 = _mm_mul_ps(_mm_sub_ps(y0, y1), x2);
+						__m128 A = _mm_add_ps(_mm_add_ps(t0, t1), t2);
+
+						__m128 w0 = _mm_setr_ps(t[0].v0.v[pos].w, t[1].v0.v[pos].w, t[2].v0.v[pos].w, t[3].v0.v[pos].w);
+						__m128 w1 = _mm_setr_ps(t[0].v1.v[pos].w, t[1].v1.v[pos].w, t[2].v1.v[pos].w, t[3].v1.v[pos].w);
+						__m128 w2 = _mm_setr_ps(t[0].v2.v[pos].w, t[1].v2.v[pos].w, t[2].v2.v[pos].w, t[3].v2.v[pos].w);
+						A = _mm_xor_ps(A, _mm_and_ps(_mm_xor_ps(_mm_xor_ps(w0, w1), w2), signMask));
+
+						__m128 margin = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, t0), _mm_andnot_ps(signMask, t1)), _mm_andnot_ps(signMask, t2)), epsilon);
+						__m128 back = (cullMode == CULL_CLOCKWISE) ? _mm_cmpgt_ps(A, margin) : _mm_cmplt_ps(A, _mm_xor_ps(margin, signMask));
+
+						cull = _mm_or_si128(cull, _mm_castps_si128(back));
+					}
+
+					reject = _mm_or_si128(reject, _mm_and_si128(unclipped, cull));
+
+					int mask = _mm_movemask_ps(_mm_castsi128_ps(reject));
+
+					if(!(mask & 1)) survivors[visible++] = i + 0;
+					if(!(mask & 2)) survivors[visible++] = i + 1;
+					if(!(mask & 4)) survivors[visible++] = i + 2;
+					if(!(mask & 8)) survivors[visible++] = i + 3;
+				}
+			}
+		#endif
+
+		for(; i < count; i++)
+		{
+			const Triangle &t = triangle[i];
+
+			if((t.v0.clipFlags & t.v1.clipFlags & t.v2.clipFlags & ~Clipper::CLIP_GUARD_BAND) != Clipper::CLIP_FINITE)
+			{
+				continue;
+			}
+
+			if(clipFlagsOr(t, draw) == Clipper::CLIP_FINITE && cullTriangle(t, draw))
+			{
+				continue;
+			}
+
+			survivors[visible++] = i;
+		}
+
+		return visible;
 	}
 
 	int Renderer::setupSolidTriangles(int unit, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
+		Triangle *triangles = triangleBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
@@ -1542,33 +2243,44 @@ namespace sw
 		int pos = state.positionRegister;
 		const DrawData *data = draw.data;
 		int visible = 0;
+		int clipped = 0;
+
+		// Reject triangles in bulk, to only call the setup routine for the ones likely to be visible
+		int survivors[batchSize];
+		int survivorCount = cullTriangles(triangles, count, draw, survivors);
 
-		for(int i = 0; i < count; i++, triangle++)
+		for(int i = 0; i < survivorCount; i++)
 		{
+			Triangle *triangle = &triangles[survivors[i]];
+
 			Vertex &v0 = triangle->v0;
 			Vertex &v1 = triangle->v1;
 			Vertex &v2 = triangle->v2;
 
-			if((v0.clipFlags & v1.clipFlags & v2.clipFlags) == Clipper::CLIP_FINITE)
-			{
-				Polygon polygon(&v0.v[pos], &v1.v[pos], &v2.v[pos]);
+			Polygon polygon(&v0.v[pos], &v1.v[pos], &v2.v[pos]);
 
-				int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags | draw.clipFlags;
+			int clipFlags = clipFlagsOr(*triangle, draw);
 
-				if(clipFlagsOr != Clipper::CLIP_FINITE)
-				{
-					if(!clipper->clip(polygon, clipFlagsOr, draw))
-					{
-						continue;
-					}
-				}
+			if(clipFlags != Clipper::CLIP_FINITE)
+			{
+				clipped++;
 
-				if(setupRoutine(primitive, triangle, &polygon, data))
+				if(!clipper->clip(polygon, clipFlags, draw))
 				{
-					primitive += ms;
-					visible++;
+					continue;
 				}
 			}
+
+			if(setupRoutine(primitive, triangle, &polygon, data))
+			{
+				primitive += ms;
+				visible++;
+			}
+		}
+
+		if(draw.pipelineCounters)
+		{
+			profiler.count(COUNTER_TRIANGLES_CLIPPED, clipped);
 		}
 
 		return visible;
@@ -2169,7 +2881,11 @@ namespace sw
 
 	void Renderer::setTransparencyAntialiasing(TransparencyAntialiasing transparencyAntialiasing)
 	{
-		sw::transparencyAntialiasing = transparencyAntialiasing;
+		if(sw::transparencyAntialiasing != transparencyAntialiasing)
+		{
+			sw::transparencyAntialiasing = transparencyAntialiasing;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	bool Renderer::isReadWriteTexture(int sampler)
@@ -2231,6 +2947,7 @@ namespace sw
 		ASSERT(sampler < TOTAL_IMAGE_UNITS && face < 6 && level < MIPMAP_LEVELS);
 
 		context->sampler[sampler].setTextureLevel(face, level, surface, type);
+		context->dirtyState |= STATE_SAMPLERS;
 	}
 
 	void Renderer::setTextureFilter(SamplerType type, int sampler, FilterType textureFilter)
@@ -2502,29 +3219,49 @@ namespace sw
 
 	void Renderer::setDepthBias(float bias)
 	{
-		context->depthBias = bias;
+		if(context->depthBias != bias)
+		{
+			context->depthBias = bias;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Renderer::setSlopeDepthBias(float slopeBias)
 	{
-		context->slopeDepthBias = slopeBias;
+		if(context->slopeDepthBias != slopeBias)
+		{
+			context->slopeDepthBias = slopeBias;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Renderer::setRasterizerDiscard(bool rasterizerDiscard)
 	{
-		context->rasterizerDiscard = rasterizerDiscard;
+		if(context->rasterizerDiscard != rasterizerDiscard)
+		{
+			context->rasterizerDiscard = rasterizerDiscard;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void Renderer::setPixelShader(const PixelShader *shader)
 	{
-		context->pixelShader = shader;
+		if(context->pixelShader != shader)
+		{
+			context->pixelShader = shader;
+			context->dirtyState |= STATE_SHADERS;
+		}
 
 		loadConstants(shader);
 	}
 
 	void Renderer::setVertexShader(const VertexShader *shader)
 	{
-		context->vertexShader = shader;
+		if(context->vertexShader != shader)
+		{
+			context->vertexShader = shader;
+			context->dirtyState |= STATE_SHADERS;
+		}
 
 		loadConstants(shader);
 	}
@@ -2544,6 +3281,11 @@ namespace sw
 			PixelProcessor::setFloatConstant(index + i, value);
 			value += 4;
 		}
+
+		if(specializeUniforms && context->pixelShader && context->pixelShader->getUniformConditionCount() > 0)
+		{
+			context->dirtyState |= STATE_UNIFORMS;
+		}
 	}
 
 	void Renderer::setPixelShaderConstantI(unsigned int index, const int value[4], unsigned int count)
@@ -2561,6 +3303,11 @@ namespace sw
 			PixelProcessor::setIntegerConstant(index + i, value);
 			value += 4;
 		}
+
+		if(specializeUniforms && context->pixelShader && context->pixelShader->getUniformConditionCount() > 0)
+		{
+			context->dirtyState |= STATE_UNIFORMS;
+		}
 	}
 
 	void Renderer::setPixelShaderConstantB(unsigned int index, const int *boolean, unsigned int count)
@@ -2578,6 +3325,11 @@ namespace sw
 			PixelProcessor::setBooleanConstant(index + i, *boolean);
 			boolean++;
 		}
+
+		if(specializeUniforms && context->pixelShader && context->pixelShader->getUniformConditionCount() > 0)
+		{
+			context->dirtyState |= STATE_UNIFORMS;
+		}
 	}
 
 	void Renderer::setVertexShaderConstantF(unsigned int index, const float value[4], unsigned int count)
@@ -2595,6 +3347,11 @@ namespace sw
 			VertexProcessor::setFloatConstant(index + i, value);
 			value += 4;
 		}
+
+		if(specializeUniforms && context->vertexShader && context->vertexShader->getUniformConditionCount() > 0)
+		{
+			context->dirtyState |= STATE_UNIFORMS;
+		}
 	}
 
 	void Renderer::setVertexShaderConstantI(unsigned int index, const int value[4], unsigned int count)
@@ -2612,6 +3369,11 @@ namespace sw
 			VertexProcessor::setIntegerConstant(index + i, value);
 			value += 4;
 		}
+
+		if(specializeUniforms && context->vertexShader && context->vertexShader->getUniformConditionCount() > 0)
+		{
+			context->dirtyState |= STATE_UNIFORMS;
+		}
 	}
 
 	void Renderer::setVertexShaderConstantB(unsigned int index, const int *boolean, unsigned int count)
@@ -2629,6 +3391,11 @@ namespace sw
 			VertexProcessor::setBooleanConstant(index + i, *boolean);
 			boolean++;
 		}
+
+		if(specializeUniforms && context->vertexShader && context->vertexShader->getUniformConditionCount() > 0)
+		{
+			context->dirtyState |= STATE_UNIFORMS;
+		}
 	}
 
 	void Renderer::setModelMatrix(const Matrix &M, int i)
@@ -2730,10 +3497,13 @@ namespace sw
 		{
 			terminateThreads();
 
+			context->dirtyState = STATE_ALL;   // Routine caches and global pipeline settings get replaced
+
 			SwiftConfig::Configuration configuration = {};
 			swiftConfig->getConfiguration(configuration);
 
 			precacheVertex = !newConfiguration && configuration.precache;
+			shadeUniqueVertices = configuration.shadeUniqueVertices;
 			precacheSetup = !newConfiguration && configuration.precache;
 			precachePixel = !newConfiguration && configuration.precache;
 
@@ -2823,11 +3593,18 @@ namespace sw
 				optimization[pass] = configuration.optimization[pass];
 			}
 
+			tieredCompilation = configuration.tieredCompilation;
+			specializeUniforms = configuration.specializeUniforms;
+			specializeSamplers = configuration.specializeSamplers;
+
 			forceWindowed = configuration.forceWindowed;
 			complementaryDepthBuffer = configuration.complementaryDepthBuffer;
 			postBlendSRGB = configuration.postBlendSRGB;
 			exactColorRounding = configuration.exactColorRounding;
 			forceClearRegisters = configuration.forceClearRegisters;
+			compressedTextureSampling = configuration.compressedTextureSampling;
+			tiledTextureLayout = configuration.tiledTextureLayout;
+			pipelineCounters = configuration.pipelineCounters;
 
 		#ifndef NDEBUG
 			minPrimitives = configuration.minPrimitives;
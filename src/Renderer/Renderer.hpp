@@ -161,6 +161,11 @@ namespace sw
 		PixelProcessor::Factor factor;
 		unsigned int occlusion[16];   // Number of pixels passing depth test
 
+		// Pipeline counters, per cluster
+		unsigned int quadsShaded[16];
+		unsigned int quadsDepthKilled[16];
+		unsigned int textureSamples[16];
+
 		#if PERF_PROFILE
 			int64_t cycles[PERF_TIMERS][16];
 		#endif
@@ -175,6 +180,8 @@ namespace sw
 		float4 YYYY;
 		float4 halfPixelX;
 		float4 halfPixelY;
+		float4 guardBandX;   // Guard band extent, relative to the viewport
+		float4 guardBandY;
 		float viewportHeight;
 		float slopeDepthBias;
 		float depthRange;
@@ -218,6 +225,7 @@ namespace sw
 		{
 			enum Type
 			{
+				VERTICES,
 				PRIMITIVES,
 				PIXELS,
 
@@ -228,6 +236,8 @@ namespace sw
 			AtomicInt type;
 			AtomicInt primitiveUnit;
 			AtomicInt pixelCluster;
+			AtomicInt drawCall;
+			AtomicInt firstVertex;
 		};
 
 		struct PrimitiveProgress
@@ -262,6 +272,16 @@ namespace sw
 			AtomicInt executing;
 		};
 
+		struct Readback
+		{
+			Surface *source;   // Null for fences, and once the source has been snapshotted
+			SliceRectF sRect;
+			Surface *dest;
+			SliceRect dRect;
+			Resource *buffer;
+			AtomicInt *pending;
+		};
+
 	public:
 		Renderer(Context *context, Conventions conventions, bool exactColorRounding);
 
@@ -276,6 +296,12 @@ namespace sw
 		void blit(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, bool filter, bool isStencil = false, bool sRGBconversion = true);
 		void blit3D(Surface *source, Surface *dest);
 
+		// Asynchronous copies, performed in order on a dedicated thread after the draws which produce the source data.
+		// The destination surface is deleted and the buffer unlocked once the copy completes. Pending is decremented
+		// when the copy (or, for fences, all preceding copies) has completed.
+		void readback(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, Resource *buffer, AtomicInt *pending);
+		void fence(AtomicInt *pending);
+
 		void setIndexBuffer(Resource *indexBuffer);
 
 		void setMultiSampleMask(unsigned int mask);
@@ -343,6 +369,7 @@ namespace sw
 		void removeQuery(Query *query);
 
 		void synchronize();
+		void synchronizeReadbacks(Surface *source = nullptr);   // Waits until the source has been read, or until all readbacks have completed
 
 		#if PERF_HUD
 			// Performance timers
@@ -364,8 +391,15 @@ namespace sw
 		void executeTask(int threadIndex);
 		void finishRendering(Task &pixelTask);
 
+		static void readbackFunction(void *parameters);
+		void readbackLoop();
+		void queueReadback(const Readback &readback);
+		Surface *snapshotReadback(Readback &readback);   // Copies the source region, or returns the source if it must be converted in place
+
+		void processVertices(int drawCall, unsigned int first, int thread);
 		void processPrimitiveVertices(int unit, unsigned int start, unsigned int count, unsigned int loop, int thread);
 
+		int cullTriangles(const Triangle *triangle, int count, const DrawCall &draw, int *survivors);
 		int setupSolidTriangles(int batch, int count);
 		int setupWireframeTriangle(int batch, int count);
 		int setupVertexTriangle(int batch, int count);
@@ -421,7 +455,7 @@ namespace sw
 		AtomicInt nextDraw;
 
 		enum {
-			TASK_COUNT = 32,   // Size of the task queue (must be power of 2)
+			TASK_COUNT = 64,   // Size of the task queue (must be power of 2)
 			TASK_COUNT_BITS = TASK_COUNT - 1,
 		};
 		Task taskQueue[TASK_COUNT];
@@ -433,6 +467,15 @@ namespace sw
 
 		MutexLock schedulerMutex;
 
+		std::list<Readback> readbacks;   // In-flight readbacks stay at the front until completed
+		AtomicInt readbackCount;
+		MutexLock readbackMutex;
+		Thread *readbackThread;
+		Event *readbackQueued;
+		Event *readbackDone;
+		Blitter *readbackBlitter;   // The main blitter is not thread-safe
+		AtomicInt exitReadbacks;
+
 		#if PERF_HUD
 			int64_t vertexTime[16];
 			int64_t setupTime[16];
@@ -494,6 +537,7 @@ namespace sw
 		unsigned int psDirtyConstB;
 
 		std::list<Query*> *queries;
+		bool pipelineCounters;   // Report statistics to the profiler
 
 		AtomicInt clipFlags;
 
@@ -501,6 +545,16 @@ namespace sw
 		AtomicInt count;        // Number of primitives to render
 		AtomicInt references;   // Remaining references to this draw call, 0 when done drawing, -1 when resources unlocked and slot is free
 
+		// Vertices shaded once for the whole draw, before primitive assembly
+		Vertex *vertexBuffer;
+		unsigned int vertexBufferSize;
+		unsigned int vertexBase;         // Index of the first vertex in the buffer
+		unsigned int vertexCount;        // Number of vertices to shade, 0 when shading per primitive batch
+		AtomicInt vertexProgress;        // Next vertex to enter the pipeline
+		AtomicInt vertexReferences;      // Vertex tasks still to complete
+		int outputCount;
+		unsigned char outputs[MAX_VERTEX_OUTPUTS];   // Vertex outputs copied into primitives
+
 		DrawData *data;
 	};
 }
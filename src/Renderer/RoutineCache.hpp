@@ -16,8 +16,10 @@
 #define sw_RoutineCache_hpp
 
 #include "LRUCache.hpp"
+#include "RoutineOptimizer.hpp"
 
 #include "Reactor/Reactor.hpp"
+#include "Main/Config.hpp"
 
 namespace sw
 {
@@ -25,24 +27,86 @@ namespace sw
 	class RoutineCache : public LRUCache<State, Routine>
 	{
 	public:
+		// Generates the fully optimized replacement of a baseline routine
+		class Optimization : public RoutineOptimizer::Task
+		{
+		public:
+			explicit Optimization(const State &state) : state(state) {}
+
+			const State state;
+		};
+
 		RoutineCache(int n, const char *precache = 0);
 		~RoutineCache();
 
+		bool isHot(Routine *routine);   // Counts a use, true once a baseline routine should be optimized
+		void optimize(Optimization *optimization);
+		bool update();   // Swaps in the completed optimized routines, true if any were
+
+		enum {HOT_ROUTINE_USES = 16};
+
 	private:
 		const char *precache;
 		#if defined(_WIN32)
 		HMODULE precacheDLL;
 		#endif
+
+		RoutineOptimizer *optimizer;
 	};
 
 	template<class State>
 	RoutineCache<State>::RoutineCache(int n, const char *precache) : LRUCache<State, Routine>(n), precache(precache)
 	{
+		optimizer = nullptr;
 	}
 
 	template<class State>
 	RoutineCache<State>::~RoutineCache()
 	{
+		delete optimizer;
+	}
+
+	template<class State>
+	bool RoutineCache<State>::isHot(Routine *routine)
+	{
+		return !routine->isOptimized() && routine->countUse() == HOT_ROUTINE_USES;
+	}
+
+	template<class State>
+	void RoutineCache<State>::optimize(Optimization *optimization)
+	{
+		if(!optimizer)
+		{
+			optimizer = new RoutineOptimizer();
+		}
+
+		optimizer->queue(optimization);
+	}
+
+	template<class State>
+	bool RoutineCache<State>::update()
+	{
+		if(!optimizer || !optimizer->hasCompleted())
+		{
+			return false;
+		}
+
+		bool updated = false;
+
+		while(Optimization *optimization = static_cast<Optimization*>(optimizer->completed()))
+		{
+			this->replace(optimization->state, optimization->routine);
+			optimization->routine = nullptr;
+			delete optimization;
+			updated = true;
+
+			if(pipelineCounters)
+			{
+				profiler.count(COUNTER_ROUTINES_OPTIMIZED, 1);
+			}
+		}
+
+		return updated;
 	}
 }
 
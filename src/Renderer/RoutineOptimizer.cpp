@@ -0,0 +1,143 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "RoutineOptimizer.hpp"
+
+#include "Reactor/Routine.hpp"
+#include "Common/Tracer.hpp"
+
+namespace sw
+{
+	RoutineOptimizer::Task::Task() : routine(nullptr)
+	{
+	}
+
+	RoutineOptimizer::Task::~Task()
+	{
+		delete routine;   // Never bound
+	}
+
+	RoutineOptimizer::RoutineOptimizer()
+	{
+		completedCount = 0;
+		thread = nullptr;
+		queued = new Event();
+		exit = false;
+	}
+
+	RoutineOptimizer::~RoutineOptimizer()
+	{
+		if(thread)
+		{
+			mutex.lock();
+			exit = true;
+			mutex.unlock();
+
+			queued->signal();
+			thread->join();
+
+			delete thread;
+			thread = nullptr;
+		}
+
+		for(Task *task : pendingTasks)
+		{
+			delete task;
+		}
+
+		for(Task *task : completedTasks)
+		{
+			delete task;
+		}
+
+		delete queued;
+	}
+
+	void RoutineOptimizer::queue(Task *task)
+	{
+		if(!thread)
+		{
+			thread = new Thread(threadFunction, this);
+		}
+
+		mutex.lock();
+		pendingTasks.push_back(task);
+		mutex.unlock();
+
+		queued->signal();
+	}
+
+	RoutineOptimizer::Task *RoutineOptimizer::completed()
+	{
+		Task *task = nullptr;
+
+		mutex.lock();
+		if(!completedTasks.empty())
+		{
+			task = completedTasks.front();
+			completedTasks.pop_front();
+			atomicDecrement(&completedCount);
+		}
+		mutex.unlock();
+
+		return task;
+	}
+
+	void RoutineOptimizer::threadFunction(void *parameters)
+	{
+		RoutineOptimizer *optimizer = static_cast<RoutineOptimizer*>(parameters);
+
+		if(Tracer::isEnabled())
+		{
+			Tracer::setThreadName("Routine optimizer");
+		}
+
+		optimizer->threadLoop();
+	}
+
+	void RoutineOptimizer::threadLoop()
+	{
+		while(true)
+		{
+			mutex.lock();
+
+			if(exit)
+			{
+				mutex.unlock();
+				return;
+			}
+
+			if(pendingTasks.empty())
+			{
+				mutex.unlock();
+				queued->wait();
+				continue;
+			}
+
+			Task *task = pendingTasks.front();
+			pendingTasks.pop_front();
+			mutex.unlock();
+
+			{
+				TraceScope trace("Optimize routine");
+				task->routine = task->generate();
+			}
+
+			mutex.lock();
+			completedTasks.push_back(task);
+			atomicIncrement(&completedCount);
+			mutex.unlock();
+		}
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_RoutineOptimizer_hpp
+#define sw_RoutineOptimizer_hpp
+
+#include "Common/MutexLock.hpp"
+#include "Common/Thread.hpp"
+
+#include <list>
+
+namespace sw
+{
+	class Routine;
+
+	// Recompiles frequently used baseline routines at full optimization on a background thread
+	class RoutineOptimizer
+	{
+	public:
+		class Task
+		{
+		public:
+			Task();
+
+			virtual ~Task();   // Deletes the routine if it was not taken
+
+			virtual Routine *generate() = 0;   // Called on the optimizer thread
+
+			Routine *routine;
+		};
+
+		RoutineOptimizer();
+
+		~RoutineOptimizer();   // Waits for the task in progress and discards the others
+
+		void queue(Task *task);
+		bool hasCompleted() const { return completedCount != 0; }   // Lock-free check before completed()
+		Task *completed();   // Returns the next task with an optimized routine, or null
+
+	private:
+		static void threadFunction(void *parameters);
+		void threadLoop();
+
+		std::list<Task*> pendingTasks;
+		std::list<Task*> completedTasks;
+		volatile int completedCount;
+		MutexLock mutex;
+		Thread *thread;
+		Event *queued;
+		bool exit;
+	};
+}
+
+#endif   // sw_RoutineOptimizer_hpp
@@ -62,6 +62,7 @@ namespace sw
 		gather = false;
 		highPrecisionFiltering = false;
 		border = 0;
+		tiledLayout = false;
 
 		swizzleR = SWIZZLE_RED;
 		swizzleG = SWIZZLE_GREEN;
@@ -103,6 +104,7 @@ namespace sw
 			state.swizzleA = swizzleA;
 			state.highPrecisionFiltering = highPrecisionFiltering;
 			state.compare = getCompareFunc();
+			state.tiledLayout = tiledLayout;
 
 			#if PERF_PROFILE
 				state.compressedFormat = Surface::isCompressed(externalTextureFormat);
@@ -112,6 +114,35 @@ namespace sw
 		return state;
 	}
 
+	void Sampler::specialize(State &state) const
+	{
+		const Mipmap &mipmap = texture.mipmap[0];
+		int width = mipmap.width[0];
+		int height = mipmap.height[0];
+
+		if(state.textureType != TEXTURE_2D || state.mipmapFilter != MIPMAP_NONE || border != 0)
+		{
+			return;
+		}
+
+		if(!isPow2(width) || !isPow2(height) || mipmap.pitchP[0] != width)
+		{
+			return;
+		}
+
+		if(state.textureFormat == FORMAT_YV12_BT601 ||
+		   state.textureFormat == FORMAT_YV12_BT709 ||
+		   state.textureFormat == FORMAT_YV12_JFIF)
+		{
+			return;   // Chroma planes have their own dimensions
+		}
+
+		state.powerOfTwo = true;
+		state.log2Width = log2(width);
+		state.log2Height = log2(height);
+		state.noLodBias = (texture.widthHeightLOD[0] == width && texture.widthHeightLOD[2] == height);
+	}
+
 	void Sampler::setTextureLevel(int face, int level, Surface *surface, TextureType type)
 	{
 		if(surface)
@@ -119,18 +150,28 @@ namespace sw
 			Mipmap &mipmap = texture.mipmap[level];
 
 			border = surface->getBorder();
-			mipmap.buffer[face] = surface->lockInternal(-border, -border, 0, LOCK_UNLOCKED, PRIVATE);
+			bool tiled = (type == TEXTURE_2D) && surface->isTileable();
+
+			if(tiled)
+			{
+				mipmap.buffer[face] = surface->lockTiled();
+			}
+			else
+			{
+				mipmap.buffer[face] = surface->lockInternal(-border, -border, 0, LOCK_UNLOCKED, PRIVATE);
+			}
 
 			if(face == 0)
 			{
 				externalTextureFormat = surface->getExternalFormat();
 				internalTextureFormat = surface->getInternalFormat();
+				tiledLayout = tiled;
 
 				int width = surface->getWidth();
 				int height = surface->getHeight();
 				int depth = surface->getDepth();
-				int pitchP = surface->getInternalPitchP();
-				int sliceP = surface->getInternalSliceP();
+				int pitchP = tiled ? surface->getTiledPitchP() : surface->getInternalPitchP();
+				int sliceP = tiled ? surface->getTiledSliceP() : surface->getInternalSliceP();
 
 				if(level == 0)
 				{
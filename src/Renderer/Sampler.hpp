@@ -160,6 +160,13 @@ namespace sw
 			SwizzleType swizzleA           : BITS(SWIZZLE_LAST);
 			bool highPrecisionFiltering    : 1;
 			CompareFunc compare            : BITS(COMPARE_LAST);
+			bool tiledLayout               : 1;   // Texels are stored in Morton ordered 64x64 tiles
+
+			// Traits of the bound texture, only set for routines specialized on them (see specialize())
+			bool powerOfTwo                : 1;   // Single level 2D texture with power-of-two dimensions, a packed pitch and no border
+			unsigned int log2Width         : 4;
+			unsigned int log2Height        : 4;
+			bool noLodBias                 : 1;
 
 			#if PERF_PROFILE
 			bool compressedFormat          : 1;
@@ -171,6 +178,7 @@ namespace sw
 		~Sampler();
 
 		State samplerState() const;
+		void specialize(State &state) const;   // Adds the traits which let the sampling code fold the texture's dimensions
 
 		void setTextureLevel(int face, int level, Surface *surface, TextureType type);
 
@@ -230,6 +238,7 @@ namespace sw
 		bool highPrecisionFiltering;
 		bool syncRequired;
 		int border;
+		bool tiledLayout;
 
 		SwizzleType swizzleR;
 		SwizzleType swizzleG;
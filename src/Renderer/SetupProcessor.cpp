@@ -20,6 +20,9 @@
 #include "Renderer.hpp"
 #include "Shader/SetupRoutine.hpp"
 #include "Shader/Constants.hpp"
+#include "Common/Math.hpp"
+#include "Common/Timer.hpp"
+#include "Common/Tracer.hpp"
 #include "Common/Debug.hpp"
 
 namespace sw
@@ -31,15 +34,9 @@ namespace sw
 
 	unsigned int SetupProcessor::States::computeHash()
 	{
-		unsigned int *state = (unsigned int*)this;
-		unsigned int hash = 0;
+		uint64_t hash = FNV_1a(reinterpret_cast<const unsigned char*>(this), sizeof(States));
 
-		for(unsigned int i = 0; i < sizeof(States) / 4; i++)
-		{
-			hash ^= state[i];
-		}
-
-		return hash;
+		return static_cast<unsigned int>(hash ^ (hash >> 32));
 	}
 
 	SetupProcessor::State::State(int i)
@@ -69,9 +66,17 @@ namespace sw
 		routineCache = 0;
 	}
 
-	SetupProcessor::State SetupProcessor::update() const
+	void SetupProcessor::update(State &state) const
 	{
-		State state;
+		// Without both shaders the fixed-function paths also depend on vertex inputs and samplers
+		const unsigned int groups = (context->vertexShader && context->pixelShader) ? (STATE_RENDER | STATE_TARGETS | STATE_SHADERS) : STATE_ALL;
+
+		if(!(context->dirtyState & groups))
+		{
+			return;
+		}
+
+		state = State();
 
 		bool vPosZW = (context->pixelShader && context->pixelShader->isVPosDeclared() && fullPixelPositionRegister);
 
@@ -219,8 +224,6 @@ namespace sw
 		}
 
 		state.hash = state.computeHash();
-
-		return state;
 	}
 
 	Routine *SetupProcessor::routine(const State &state)
@@ -229,12 +232,23 @@ namespace sw
 
 		if(!routine)
 		{
+			double compileStart = Timer::seconds();
+			TraceScope trace("Compile SetupRoutine");
 			SetupRoutine *generator = new SetupRoutine(state);
 			generator->generate();
 			routine = generator->getRoutine();
 			delete generator;
 
 			routineCache->add(state, routine);
+
+			if(pipelineCounters)
+			{
+				profiler.countCompile(Timer::seconds() - compileStart);
+			}
+		}
+		else if(pipelineCounters)
+		{
+			profiler.count(COUNTER_ROUTINE_CACHE_HITS, 1);
 		}
 
 		return routine;
@@ -90,7 +90,7 @@ namespace sw
 		~SetupProcessor();
 
 	protected:
-		State update() const;
+		void update(State &state) const;   // Rederives the state when its context state is dirty
 		Routine *routine(const State &state);
 
 		void setRoutineCacheSize(int cacheSize);
@@ -37,6 +37,8 @@ namespace sw
 {
 	extern bool quadLayoutEnabled;
 	extern bool complementaryDepthBuffer;
+	extern bool compressedTextureSampling;
+	extern bool tiledTextureLayout;
 	extern TranscendentalPrecision logPrecision;
 
 	unsigned int *Surface::palette = 0;
@@ -1137,7 +1139,7 @@ namespace sw
 		case LOCK_WRITEONLY:
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
-			dirty = true;
+			markDirty(0, 0, 0, width, height, depth);   // Extent of the access is unknown
 			break;
 		default:
 			ASSERT(false);
@@ -1218,11 +1220,63 @@ namespace sw
 		return nullptr;
 	}
 
+	void *Surface::Buffer::lockRect(int x, int y, int z, int width, int height, int depth, Lock lock)
+	{
+		void *data = lockRect(x, y, z, LOCK_UPDATE);
+
+		this->lock = lock;
+
+		switch(lock)
+		{
+		case LOCK_UNLOCKED:
+		case LOCK_READONLY:
+		case LOCK_UPDATE:
+			break;
+		case LOCK_WRITEONLY:
+		case LOCK_READWRITE:
+		case LOCK_DISCARD:
+			markDirty(x, y, z, x + width, y + height, z + depth);
+			break;
+		default:
+			ASSERT(false);
+		}
+
+		return data;
+	}
+
 	void Surface::Buffer::unlockRect()
 	{
 		lock = LOCK_UNLOCKED;
 	}
 
+	void Surface::Buffer::markDirty(int x0, int y0, int z0, int x1, int y1, int z1)
+	{
+		if(x0 >= x1 || y0 >= y1 || z0 >= z1)
+		{
+			return;
+		}
+
+		if(!dirty)
+		{
+			dirtyX0 = x0;
+			dirtyY0 = y0;
+			dirtyZ0 = z0;
+			dirtyX1 = x1;
+			dirtyY1 = y1;
+			dirtyZ1 = z1;
+			dirty = true;
+		}
+		else
+		{
+			dirtyX0 = min(dirtyX0, x0);
+			dirtyY0 = min(dirtyY0, y0);
+			dirtyZ0 = min(dirtyZ0, z0);
+			dirtyX1 = max(dirtyX1, x1);
+			dirtyY1 = max(dirtyY1, y1);
+			dirtyZ1 = max(dirtyZ1, z1);
+		}
+	}
+
 	class SurfaceImplementation : public Surface
 	{
 	public:
@@ -1273,20 +1327,21 @@ namespace sw
 		external.sliceP = external.bytes ? slice / external.bytes : 0;
 		external.border = 0;
 		external.lock = LOCK_UNLOCKED;
-		external.dirty = true;
+		external.dirty = false;
+		external.markDirty(0, 0, 0, width, height, depth);
 
 		internal.buffer = nullptr;
 		internal.width = width;
 		internal.height = height;
 		internal.depth = depth;
 		internal.samples = 1;
+		internal.border = 0;
 		internal.format = selectInternalFormat(format);
 		internal.bytes = bytes(internal.format);
 		internal.pitchB = pitchB(internal.width, 0, internal.format, false);
 		internal.pitchP = pitchP(internal.width, 0, internal.format, false);
 		internal.sliceB = sliceB(internal.width, internal.height, 0, internal.format, false);
 		internal.sliceP = sliceP(internal.width, internal.height, 0, internal.format, false);
-		internal.border = 0;
 		internal.lock = LOCK_UNLOCKED;
 		internal.dirty = false;
 
@@ -1307,6 +1362,9 @@ namespace sw
 
 		dirtyContents = true;
 		paletteUsed = 0;
+
+		tiledBuffer = nullptr;
+		tiledDirty = true;
 	}
 
 	Surface::Surface(Resource *texture, int width, int height, int depth, int border, int samples, Format format, bool lockable, bool renderTarget, int pitchPprovided) : lockable(lockable), renderTarget(renderTarget)
@@ -1337,13 +1395,13 @@ namespace sw
 		internal.height = height;
 		internal.depth = depth;
 		internal.samples = (short)samples;
+		internal.border = (short)border;
 		internal.format = selectInternalFormat(format);
 		internal.bytes = bytes(internal.format);
 		internal.pitchB = !pitchPprovided ? pitchB(internal.width, border, internal.format, renderTarget) : pitchPprovided * internal.bytes;
 		internal.pitchP = !pitchPprovided ? pitchP(internal.width, border, internal.format, renderTarget) : pitchPprovided;
 		internal.sliceB = sliceB(internal.width, internal.height, border, internal.format, renderTarget);
 		internal.sliceP = sliceP(internal.width, internal.height, border, internal.format, renderTarget);
-		internal.border = (short)border;
 		internal.lock = LOCK_UNLOCKED;
 		internal.dirty = false;
 
@@ -1364,6 +1422,9 @@ namespace sw
 
 		dirtyContents = true;
 		paletteUsed = 0;
+
+		tiledBuffer = nullptr;
+		tiledDirty = true;
 	}
 
 	Surface::~Surface()
@@ -1388,13 +1449,29 @@ namespace sw
 		}
 
 		deallocate(stencil.buffer);
+		deallocate(tiledBuffer);
 
 		external.buffer = 0;
 		internal.buffer = 0;
 		stencil.buffer = 0;
+		tiledBuffer = nullptr;
 	}
 
 	void *Surface::lockExternal(int x, int y, int z, Lock lock, Accessor client)
+	{
+		prepareExternal(lock, client);
+
+		return external.lockRect(x, y, z, lock);
+	}
+
+	void *Surface::lockExternal(int x, int y, int z, int width, int height, int depth, Lock lock, Accessor client)
+	{
+		prepareExternal(lock, client);
+
+		return external.lockRect(x, y, z, width, height, depth, lock);
+	}
+
+	void Surface::prepareExternal(Lock lock, Accessor client)
 	{
 		resource->lock(client);
 
@@ -1432,8 +1509,6 @@ namespace sw
 		default:
 			ASSERT(false);
 		}
-
-		return external.lockRect(x, y, z, lock);
 	}
 
 	void Surface::unlockExternal()
@@ -1487,7 +1562,13 @@ namespace sw
 			}
 		}
 
-		if(external.dirty || (isPalette(external.format) && paletteUsed != Surface::paletteID))
+		if(isPalette(external.format) && paletteUsed != Surface::paletteID)
+		{
+			// All elements need decoding with the new palette
+			external.markDirty(0, 0, 0, external.width, external.height, external.depth);
+		}
+
+		if(external.dirty)
 		{
 			if(lock != LOCK_DISCARD)
 			{
@@ -1496,6 +1577,7 @@ namespace sw
 
 			external.dirty = false;
 			paletteUsed = Surface::paletteID;
+			tiledDirty = true;
 		}
 
 		switch(lock)
@@ -1507,6 +1589,7 @@ namespace sw
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
 			dirtyContents = true;
+			tiledDirty = true;
 			break;
 		default:
 			ASSERT(false);
@@ -1520,6 +1603,124 @@ namespace sw
 		return internal.lockRect(x, y, z, lock);
 	}
 
+	void *Surface::lockInternal(int x, int y, int z, const Rect &written, Lock lock, Accessor client)
+	{
+		bool dirty = internal.dirty;
+		int dirtyX0 = internal.dirtyX0, dirtyY0 = internal.dirtyY0, dirtyZ0 = internal.dirtyZ0;
+		int dirtyX1 = internal.dirtyX1, dirtyY1 = internal.dirtyY1, dirtyZ1 = internal.dirtyZ1;
+
+		void *data = lockInternal(x, y, z, lock, client);
+
+		if(lock == LOCK_WRITEONLY || lock == LOCK_READWRITE || lock == LOCK_DISCARD)
+		{
+			// Replace the whole buffer dirtied by the write lock with the rectangle actually written
+			internal.dirty = dirty;
+			internal.dirtyX0 = dirtyX0;
+			internal.dirtyY0 = dirtyY0;
+			internal.dirtyZ0 = dirtyZ0;
+			internal.dirtyX1 = dirtyX1;
+			internal.dirtyY1 = dirtyY1;
+			internal.dirtyZ1 = dirtyZ1;
+
+			int x0 = max(written.x0, 0);
+			int y0 = max(written.y0, 0);
+			int x1 = min(written.x1, internal.width);
+			int y1 = min(written.y1, internal.height);
+
+			internal.markDirty(x0, y0, z, x1, y1, z + 1);
+		}
+
+		return data;
+	}
+
+	bool Surface::isTileable() const
+	{
+		if(!tiledTextureLayout || internal.depth != 1 || internal.border != 0 || internal.samples > 1 || internal.bytes <= 0)
+		{
+			return false;
+		}
+
+		switch(internal.format)
+		{
+		case FORMAT_YV12_BT601:
+		case FORMAT_YV12_BT709:
+		case FORMAT_YV12_JFIF:
+			return false;
+		default:
+			return !isCompressed(internal.format) && !hasQuadLayout(internal.format);
+		}
+	}
+
+	int Surface::tiledColumn(int x)
+	{
+		// Spreads the low six bits of x into the even bits of the Morton index
+		int m = x & 63;
+		m = (m | (m << 4)) & 0x30F;
+		m = (m | (m << 2)) & 0x333;
+		m = (m | (m << 1)) & 0x555;
+
+		return ((x & ~63) << 6) | m;
+	}
+
+	int Surface::tiledRow(int y, int pitchP)
+	{
+		return (y & ~63) * pitchP + (tiledColumn(y & 63) << 1);
+	}
+
+	void *Surface::lockTiled()
+	{
+		ASSERT(isTileable());
+
+		lockInternal(0, 0, 0, LOCK_UNLOCKED, PRIVATE);   // Brings the internal buffer up to date
+
+		if(!tiledBuffer)
+		{
+			tiledBuffer = allocate(getTiledSliceP() * internal.bytes, 64);
+			memset(tiledBuffer, 0, getTiledSliceP() * internal.bytes);
+			tiledDirty = true;
+		}
+
+		if(tiledDirty)
+		{
+			// Writes which dirty the copy have already waited for the draws sampling it,
+			// so this only has to wait for the writes themselves.
+			resource->lock(PRIVATE);
+
+			const unsigned char *source = (const unsigned char*)internal.lockRect(0, 0, 0, LOCK_READONLY);
+			unsigned char *tiles = (unsigned char*)tiledBuffer;
+			int tiledPitchP = getTiledPitchP();
+			int bytes = internal.bytes;
+
+			for(int y = 0; y < internal.height; y++)
+			{
+				const unsigned char *row = source + y * internal.pitchB;
+				unsigned char *tileRow = tiles + tiledRow(y, tiledPitchP) * bytes;
+
+				if(bytes == 4)
+				{
+					for(int x = 0; x < internal.width; x++)
+					{
+						((unsigned int*)tileRow)[tiledColumn(x)] = ((const unsigned int*)row)[x];
+					}
+				}
+				else
+				{
+					for(int x = 0; x < internal.width; x++)
+					{
+						memcpy(tileRow + tiledColumn(x) * bytes, row + x * bytes, bytes);
+					}
+				}
+			}
+
+			internal.unlockRect();
+			resource->unlock();
+
+			tiledDirty = false;
+		}
+
+		return tiledBuffer;
+	}
+
 	void Surface::unlockInternal()
 	{
 		internal.unlockRect();
@@ -1885,6 +2086,11 @@ namespace sw
 		{
 			ASSERT(source.dirty && !destination.dirty);
 
+			// Only convert the region which doesn't match, within the common extent
+			source.dirtyX1 = min(source.dirtyX1, min(destination.width, source.width));
+			source.dirtyY1 = min(source.dirtyY1, min(destination.height, source.height));
+			source.dirtyZ1 = min(source.dirtyZ1, min(destination.depth, source.depth));
+
 			switch(source.format)
 			{
 			case FORMAT_R8G8B8:		decodeR8G8B8(destination, source);		break;   // FIXME: Check destination format
@@ -1944,12 +2150,15 @@ namespace sw
 
 	void Surface::genericUpdate(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
-
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
+
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 		int rowBytes = width * source.bytes;
 
 		for(int z = 0; z < depth; z++)
@@ -1992,12 +2201,15 @@ namespace sw
 
 	void Surface::decodeR8G8B8(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 
 		for(int z = 0; z < depth; z++)
 		{
@@ -2035,12 +2247,15 @@ namespace sw
 
 	void Surface::decodeX1R5G5B5(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 
 		for(int z = 0; z < depth; z++)
 		{
@@ -2080,12 +2295,15 @@ namespace sw
 
 	void Surface::decodeA1R5G5B5(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 
 		for(int z = 0; z < depth; z++)
 		{
@@ -2126,12 +2344,15 @@ namespace sw
 
 	void Surface::decodeX4R4G4B4(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 
 		for(int z = 0; z < depth; z++)
 		{
@@ -2171,12 +2392,15 @@ namespace sw
 
 	void Surface::decodeA4R4G4B4(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 
 		for(int z = 0; z < depth; z++)
 		{
@@ -2217,12 +2441,15 @@ namespace sw
 
 	void Surface::decodeP8(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		int x0 = source.dirtyX0;
+		int y0 = source.dirtyY0;
+		int z0 = source.dirtyZ0;
+		int width = source.dirtyX1 - x0;
+		int height = source.dirtyY1 - y0;
+		int depth = source.dirtyZ1 - z0;
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(x0, y0, z0, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(x0, y0, z0, sw::LOCK_UPDATE);
 
 		for(int z = 0; z < depth; z++)
 		{
@@ -2848,6 +3075,22 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
 		case FORMAT_R32I:
 		case FORMAT_R32UI:
 		case FORMAT_G32R32I:
@@ -2937,6 +3180,20 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_RG11_EAC:
 			return true;
 		case FORMAT_A8B8G8R8I:
 		case FORMAT_A16B16G16R16I:
@@ -2951,6 +3208,7 @@ namespace sw
 		case FORMAT_R16I:
 		case FORMAT_R32I:
 		case FORMAT_R8_SNORM:
+		case FORMAT_SIGNED_R11_EAC:
 			return component >= 1;
 		case FORMAT_V8U8:
 		case FORMAT_X8L8V8U8:
@@ -2960,6 +3218,7 @@ namespace sw
 		case FORMAT_G16R16I:
 		case FORMAT_G32R32I:
 		case FORMAT_G8R8_SNORM:
+		case FORMAT_SIGNED_RG11_EAC:
 			return component >= 2;
 		case FORMAT_A16W16V16U16:
 		case FORMAT_B32G32R32F:
@@ -3030,6 +3289,9 @@ namespace sw
 		{
 		case FORMAT_SRGB8_X8:
 		case FORMAT_SRGB8_A8:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
 			return true;
 		default:
 			return false;
@@ -3218,6 +3480,22 @@ namespace sw
 		case FORMAT_YV12_BT601:     return 3;
 		case FORMAT_YV12_BT709:     return 3;
 		case FORMAT_YV12_JFIF:      return 3;
+		case FORMAT_DXT1:           return 4;
+		case FORMAT_DXT3:           return 4;
+		case FORMAT_DXT5:           return 4;
+		case FORMAT_ATI1:           return 1;
+		case FORMAT_ATI2:           return 2;
+		case FORMAT_ETC1:           return 3;
+		case FORMAT_RGB8_ETC2:      return 3;
+		case FORMAT_SRGB8_ETC2:     return 3;
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2: return 4;
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: return 4;
+		case FORMAT_RGBA8_ETC2_EAC: return 4;
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC: return 4;
+		case FORMAT_R11_EAC:        return 1;
+		case FORMAT_SIGNED_R11_EAC: return 1;
+		case FORMAT_RG11_EAC:       return 2;
+		case FORMAT_SIGNED_RG11_EAC: return 2;
 		default:
 			ASSERT(false);
 		}
@@ -3537,7 +3815,7 @@ namespace sw
 		}
 		else
 		{
-			row = (unsigned char*)lockExternal(x0, y0, 0, LOCK_WRITEONLY, PUBLIC);
+			row = (unsigned char*)lockExternal(x0, y0, 0, width, height, 1, LOCK_WRITEONLY, PUBLIC);
 			buffer = &external;
 		}
 
@@ -3862,10 +4140,20 @@ namespace sw
 		case FORMAT_DXT1:
 		case FORMAT_DXT3:
 		case FORMAT_DXT5:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return format;   // Sampled directly from the compressed blocks
+			}
+			return FORMAT_A8R8G8B8;
 		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
 		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
 		case FORMAT_RGBA8_ETC2_EAC:
 		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return format;
+			}
+			return FORMAT_A8R8G8B8;
 		case FORMAT_SRGB8_ALPHA8_ASTC_4x4_KHR:
 		case FORMAT_SRGB8_ALPHA8_ASTC_5x4_KHR:
 		case FORMAT_SRGB8_ALPHA8_ASTC_5x5_KHR:
@@ -3898,18 +4186,38 @@ namespace sw
 			// ASTC supports HDR, so a floating point format is required to represent it properly
 			return FORMAT_A32B32G32R32F; // FIXME: 16FP is probably sufficient, but it's currently unsupported
 		case FORMAT_ATI1:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return FORMAT_ATI1;
+			}
 			return FORMAT_R8;
 		case FORMAT_R11_EAC:
 		case FORMAT_SIGNED_R11_EAC:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return format;
+			}
 			return FORMAT_R32F; // FIXME: Signed 8bit format would be sufficient
 		case FORMAT_ATI2:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return FORMAT_ATI2;
+			}
 			return FORMAT_G8R8;
 		case FORMAT_RG11_EAC:
 		case FORMAT_SIGNED_RG11_EAC:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return format;
+			}
 			return FORMAT_G32R32F; // FIXME: Signed 8bit format would be sufficient
 		case FORMAT_ETC1:
 		case FORMAT_RGB8_ETC2:
 		case FORMAT_SRGB8_ETC2:
+			if(compressedTextureSampling && internal.border == 0)
+			{
+				return format;
+			}
 			return FORMAT_X8R8G8B8;
 		// Bumpmap formats
 		case FORMAT_V8U8:			return FORMAT_V8U8;
@@ -255,8 +255,11 @@ namespace sw
 			Color<float> sample(float x, float y, int layer) const;
 
 			void *lockRect(int x, int y, int z, Lock lock);
+			void *lockRect(int x, int y, int z, int width, int height, int depth, Lock lock);
 			void unlockRect();
 
+			void markDirty(int x0, int y0, int z0, int x1, int y1, int z1);
+
 			void *buffer;
 			int width;
 			int height;
@@ -274,6 +277,8 @@ namespace sw
 			AtomicInt lock;
 
 			bool dirty;   // Sibling internal/external buffer doesn't match.
+			int dirtyX0, dirtyY0, dirtyZ0;   // Inclusive bounds of the region which doesn't match, when dirty.
+			int dirtyX1, dirtyY1, dirtyZ1;   // Exclusive bounds of the region which doesn't match, when dirty.
 		};
 
 	protected:
@@ -299,6 +304,7 @@ namespace sw
 		inline int getSliceP(bool internal = false) const;
 
 		void *lockExternal(int x, int y, int z, Lock lock, Accessor client);
+		void *lockExternal(int x, int y, int z, int width, int height, int depth, Lock lock, Accessor client);   // Writes only dirty the given box
 		void unlockExternal();
 		inline Format getExternalFormat() const;
 		inline int getExternalPitchB() const;
@@ -307,6 +313,7 @@ namespace sw
 		inline int getExternalSliceP() const;
 
 		virtual void *lockInternal(int x, int y, int z, Lock lock, Accessor client) = 0;
+		void *lockInternal(int x, int y, int z, const Rect &written, Lock lock, Accessor client);   // Writes only dirty the given rectangle of slice z
 		virtual void unlockInternal() = 0;
 		inline Format getInternalFormat() const;
 		inline int getInternalPitchB() const;
@@ -314,6 +321,14 @@ namespace sw
 		inline int getInternalSliceB() const;
 		inline int getInternalSliceP() const;
 
+		virtual bool isTileable() const;
+		void *lockTiled();   // Internal contents in 64x64 texel macro-tiles of Morton ordered texels, for sampling
+		inline int getTiledPitchP() const;
+		inline int getTiledSliceP() const;
+		inline bool isTiledDirty() const;
+		static int tiledColumn(int x);   // The tiled index of texel (x, y) is tiledRow(y, pitchP) + tiledColumn(x)
+		static int tiledRow(int y, int pitchP);
+
 		void *lockStencil(int x, int y, int front, Accessor client);
 		void unlockStencil();
 		inline Format getStencilFormat() const;
@@ -486,6 +501,7 @@ namespace sw
 		static void *allocateBuffer(int width, int height, int depth, int border, int samples, Format format);
 		static void memfill4(void *buffer, int pattern, int bytes);
 
+		void prepareExternal(Lock lock, Accessor client);
 		bool identicalBuffers() const;
 		Format selectInternalFormat(Format format) const;
 
@@ -506,6 +522,9 @@ namespace sw
 
 		bool hasParent;
 		bool ownExternal;
+
+		void *tiledBuffer;
+		bool tiledDirty;   // The tiled copy doesn't match the internal buffer.
 	};
 }
 
@@ -660,6 +679,21 @@ namespace sw
 	{
 		return external.buffer && external.buffer != internal.buffer && external.dirty;
 	}
+
+	int Surface::getTiledPitchP() const
+	{
+		return align<64>(internal.width);
+	}
+
+	int Surface::getTiledSliceP() const
+	{
+		return getTiledPitchP() * align<64>(internal.height);
+	}
+
+	bool Surface::isTiledDirty() const
+	{
+		return tiledBuffer && (tiledDirty || external.dirty);
+	}
 }
 
 #endif   // sw_Surface_hpp
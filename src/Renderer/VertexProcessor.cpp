@@ -20,13 +20,20 @@
 #include "Shader/PixelShader.hpp"
 #include "Shader/Constants.hpp"
 #include "Common/Math.hpp"
+#include "Common/Timer.hpp"
+#include "Common/Tracer.hpp"
 #include "Common/Debug.hpp"
 
 #include <string.h>
 
 namespace sw
 {
+	extern bool tieredCompilation;
+	extern bool specializeUniforms;
+	extern bool specializeSamplers;
+
 	bool precacheVertex = false;
+	bool shadeUniqueVertices = false;   // Shade the index range of a draw once, instead of per primitive batch
 
 	void VertexCache::clear()
 	{
@@ -36,22 +43,74 @@ namespace sw
 		}
 	}
 
-	unsigned int VertexProcessor::States::computeHash()
+	// The samplers and input sections span their arrays, the uniforms section the trailing
+	// uniform condition values, and the main section the rest
+	static const int samplersBegin = OFFSET(VertexProcessor::States, sampler);
+	static const int inputBegin = OFFSET(VertexProcessor::States, input);
+	static const int outputBegin = OFFSET(VertexProcessor::States, output);
+	static const int uniformsBegin = OFFSET(VertexProcessor::States, specializedUniforms);
+
+	VertexProcessor::State::State()
 	{
-		unsigned int *state = (unsigned int*)this;
-		unsigned int hash = 0;
+		memset(this, 0, sizeof(State));
+	}
 
-		for(unsigned int i = 0; i < sizeof(States) / 4; i++)
+	void VertexProcessor::State::clear(StateSection section)
+	{
+		unsigned char *states = reinterpret_cast<unsigned char*>(static_cast<States*>(this));
+
+		switch(section)
 		{
-			hash ^= state[i];
+		case SECTION_MAIN:
+			memset(states, 0, samplersBegin);
+			memset(states + outputBegin, 0, uniformsBegin - outputBegin);
+			break;
+		case SECTION_SAMPLERS:
+			memset(states + samplersBegin, 0, inputBegin - samplersBegin);
+			break;
+		case SECTION_INPUT:
+			memset(states + inputBegin, 0, outputBegin - inputBegin);
+			break;
+		case SECTION_UNIFORMS:
+			memset(states + uniformsBegin, 0, sizeof(States) - uniformsBegin);
+			break;
+		default:
+			ASSERT(false);
 		}
+	}
 
-		return hash;
+	void VertexProcessor::State::computeHash(StateSection section)
+	{
+		const unsigned char *states = reinterpret_cast<const unsigned char*>(static_cast<States*>(this));
+
+		switch(section)
+		{
+		case SECTION_MAIN:
+			sectionHash[SECTION_MAIN] = FNV_1a(states + outputBegin, uniformsBegin - outputBegin, FNV_1a(states, samplersBegin));
+			break;
+		case SECTION_SAMPLERS:
+			sectionHash[SECTION_SAMPLERS] = FNV_1a(states + samplersBegin, inputBegin - samplersBegin);
+			break;
+		case SECTION_INPUT:
+			sectionHash[SECTION_INPUT] = FNV_1a(states + inputBegin, outputBegin - inputBegin);
+			break;
+		case SECTION_UNIFORMS:
+			sectionHash[SECTION_UNIFORMS] = FNV_1a(states + uniformsBegin, sizeof(States) - uniformsBegin);
+			break;
+		default:
+			ASSERT(false);
+		}
+
+		uint64_t combined = FNV_1a(reinterpret_cast<const unsigned char*>(sectionHash), sizeof(sectionHash));
+		hash = static_cast<unsigned int>(combined ^ (combined >> 32));
 	}
 
-	VertexProcessor::State::State()
+	void VertexProcessor::State::computeHash()
 	{
-		memset(this, 0, sizeof(State));
+		computeHash(SECTION_MAIN);
+		computeHash(SECTION_SAMPLERS);
+		computeHash(SECTION_INPUT);
+		computeHash(SECTION_UNIFORMS);
 	}
 
 	bool VertexProcessor::State::operator==(const State &state) const
@@ -130,6 +189,13 @@ namespace sw
 
 	void VertexProcessor::setInputStream(int index, const Stream &stream)
 	{
+		const Stream &input = context->input[index];
+
+		if(input.type != stream.type || input.count != stream.count || input.normalized != stream.normalized)
+		{
+			context->dirtyState |= STATE_INPUT;
+		}
+
 		context->input[index] = stream;
 	}
 
@@ -137,10 +203,14 @@ namespace sw
 	{
 		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 		{
-			context->input[i].defaults();
+			setInputStream(i, Stream().defaults());
 		}
 
-		context->preTransformed = preTransformed;
+		if(context->preTransformed != preTransformed)
+		{
+			context->preTransformed = preTransformed;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setFloatConstant(unsigned int index, const float value[4])
@@ -246,7 +316,13 @@ namespace sw
 	void VertexProcessor::setProjectionMatrix(const Matrix &P)
 	{
 		this->P = P;
-		context->wBasedFog = (P[3][0] != 0.0f) || (P[3][1] != 0.0f) || (P[3][2] != 0.0f) || (P[3][3] != 1.0f);
+		bool wBasedFog = (P[3][0] != 0.0f) || (P[3][1] != 0.0f) || (P[3][2] != 0.0f) || (P[3][3] != 1.0f);
+
+		if(context->wBasedFog != wBasedFog)
+		{
+			context->wBasedFog = wBasedFog;
+			context->dirtyState |= STATE_RENDER;
+		}
 
 		updateMatrix = true;
 		updateProjectionMatrix = true;
@@ -346,12 +422,20 @@ namespace sw
 
 	void VertexProcessor::setFogEnable(bool fogEnable)
 	{
-		context->fogEnable = fogEnable;
+		if(context->fogEnable != fogEnable)
+		{
+			context->fogEnable = fogEnable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setVertexFogMode(FogMode fogMode)
 	{
-		context->vertexFogMode = fogMode;
+		if(context->vertexFogMode != fogMode)
+		{
+			context->vertexFogMode = fogMode;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setInstanceID(int instanceID)
@@ -443,19 +527,31 @@ namespace sw
 
 	void VertexProcessor::setRangeFogEnable(bool enable)
 	{
-		context->rangeFogEnable = enable;
+		if(context->rangeFogEnable != enable)
+		{
+			context->rangeFogEnable = enable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setIndexedVertexBlendEnable(bool indexedVertexBlendEnable)
 	{
-		context->indexedVertexBlendEnable = indexedVertexBlendEnable;
+		if(context->indexedVertexBlendEnable != indexedVertexBlendEnable)
+		{
+			context->indexedVertexBlendEnable = indexedVertexBlendEnable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setVertexBlendMatrixCount(unsigned int vertexBlendMatrixCount)
 	{
 		if(vertexBlendMatrixCount <= 4)
 		{
-			context->vertexBlendMatrixCount = vertexBlendMatrixCount;
+			if(context->vertexBlendMatrixCount != (int)vertexBlendMatrixCount)
+			{
+				context->vertexBlendMatrixCount = vertexBlendMatrixCount;
+				context->dirtyState |= STATE_RENDER;
+			}
 		}
 		else ASSERT(false);
 	}
@@ -464,7 +560,11 @@ namespace sw
 	{
 		if(stage < TEXTURE_IMAGE_UNITS)
 		{
-			context->textureWrap[stage] = mask;
+			if(context->textureWrap[stage] != mask)
+			{
+				context->textureWrap[stage] = mask;
+				context->dirtyState |= STATE_RENDER;
+			}
 		}
 		else ASSERT(false);
 
@@ -480,19 +580,31 @@ namespace sw
 	{
 		if(stage < 8)
 		{
-			context->texGen[stage] = texGen;
+			if(context->texGen[stage] != texGen)
+			{
+				context->texGen[stage] = texGen;
+				context->dirtyState |= STATE_RENDER;
+			}
 		}
 		else ASSERT(false);
 	}
 
 	void VertexProcessor::setLocalViewer(bool localViewer)
 	{
-		context->localViewer = localViewer;
+		if(context->localViewer != localViewer)
+		{
+			context->localViewer = localViewer;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setNormalizeNormals(bool normalizeNormals)
 	{
-		context->normalizeNormals = normalizeNormals;
+		if(context->normalizeNormals != normalizeNormals)
+		{
+			context->normalizeNormals = normalizeNormals;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setTextureMatrix(int stage, const Matrix &T)
@@ -508,8 +620,12 @@ namespace sw
 
 	void VertexProcessor::setTextureTransform(int stage, int count, bool project)
 	{
-		context->textureTransformCount[stage] = count;
-		context->textureTransformProject[stage] = project;
+		if(context->textureTransformCount[stage] != count || context->textureTransformProject[stage] != project)
+		{
+			context->textureTransformCount[stage] = count;
+			context->textureTransformProject[stage] = project;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::setTextureFilter(unsigned int sampler, FilterType textureFilter)
@@ -517,6 +633,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setTextureFilter(textureFilter);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -526,6 +643,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setMipmapFilter(mipmapFilter);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -535,6 +653,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setGatherEnable(enable);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -544,6 +663,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setAddressingModeU(addressMode);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -553,6 +673,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setAddressingModeV(addressMode);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -562,6 +683,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setAddressingModeW(addressMode);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -571,6 +693,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setReadSRGB(sRGB);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -598,6 +721,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setMaxAnisotropy(maxAnisotropy);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -607,6 +731,7 @@ namespace sw
 		if(sampler < TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[sampler].setHighPrecisionFiltering(highPrecisionFiltering);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -616,6 +741,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setSwizzleR(swizzleR);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -625,6 +751,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setSwizzleG(swizzleG);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -634,6 +761,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setSwizzleB(swizzleB);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -643,6 +771,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setSwizzleA(swizzleA);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -652,6 +781,7 @@ namespace sw
 		if(sampler < VERTEX_TEXTURE_IMAGE_UNITS)
 		{
 			context->sampler[TEXTURE_IMAGE_UNITS + sampler].setCompareFunc(compFunc);
+			context->dirtyState |= STATE_SAMPLERS;
 		}
 		else ASSERT(false);
 	}
@@ -733,12 +863,20 @@ namespace sw
 
 	void VertexProcessor::setTransformFeedbackQueryEnabled(bool enable)
 	{
-		context->transformFeedbackQueryEnabled = enable;
+		if(context->transformFeedbackQueryEnabled != enable)
+		{
+			context->transformFeedbackQueryEnabled = enable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	void VertexProcessor::enableTransformFeedback(uint64_t enable)
 	{
-		context->transformFeedbackEnabled = enable;
+		if(context->transformFeedbackEnabled != enable)
+		{
+			context->transformFeedbackEnabled = enable;
+			context->dirtyState |= STATE_RENDER;
+		}
 	}
 
 	const Matrix &VertexProcessor::getModelTransform(int i)
@@ -902,7 +1040,7 @@ namespace sw
 		routineCache = new RoutineCache<State>(clamp(cacheSize, 1, 65536), precacheVertex ? "sw-vertex" : 0);
 	}
 
-	const VertexProcessor::State VertexProcessor::update(DrawType drawType)
+	void VertexProcessor::update(State &state, DrawType drawType)
 	{
 		if(isFixedFunction())
 		{
@@ -923,8 +1061,43 @@ namespace sw
 			}
 		}
 
-		State state;
+		// Without both shaders the fixed-function paths also depend on vertex inputs and samplers
+		const unsigned int mainGroups = (context->vertexShader && context->pixelShader) ? (STATE_RENDER | STATE_TARGETS | STATE_SHADERS) : STATE_ALL;
+		const unsigned int samplerGroups = STATE_SAMPLERS | STATE_SHADERS;
+		const unsigned int inputGroups = STATE_INPUT | STATE_SHADERS;
+		const unsigned int uniformGroups = STATE_UNIFORMS | STATE_SHADERS;
 
+		if(context->dirtyState & mainGroups)
+		{
+			state.clear(SECTION_MAIN);
+			updateMain(state, drawType);
+			state.computeHash(SECTION_MAIN);
+		}
+
+		if(context->dirtyState & samplerGroups)
+		{
+			state.clear(SECTION_SAMPLERS);
+			updateSamplers(state);
+			state.computeHash(SECTION_SAMPLERS);
+		}
+
+		if(context->dirtyState & inputGroups)
+		{
+			state.clear(SECTION_INPUT);
+			updateInput(state);
+			state.computeHash(SECTION_INPUT);
+		}
+
+		if(context->dirtyState & uniformGroups)
+		{
+			state.clear(SECTION_UNIFORMS);
+			updateUniforms(state);
+			state.computeHash(SECTION_UNIFORMS);
+		}
+	}
+
+	void VertexProcessor::updateMain(State &state, DrawType drawType) const
+	{
 		if(context->vertexShader)
 		{
 			state.shaderID = context->vertexShader->getSerialID();
@@ -973,6 +1146,7 @@ namespace sw
 		state.multiSampling = context->getMultiSampleCount() > 1;
 
 		state.transformFeedbackQueryEnabled = context->transformFeedbackQueryEnabled;
+		state.pipelineCounters = pipelineCounters;
 		state.transformFeedbackEnabled = context->transformFeedbackEnabled;
 
 		// Note: Quads aren't handled for verticesPerPrimitive, but verticesPerPrimitive is used for transform feedback,
@@ -980,14 +1154,6 @@ namespace sw
 		DrawType type = static_cast<DrawType>(static_cast<unsigned int>(drawType) & 0xF);
 		state.verticesPerPrimitive = 1 + (type >= DRAW_LINELIST) + (type >= DRAW_TRIANGLELIST);
 
-		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
-		{
-			state.input[i].type = context->input[i].type;
-			state.input[i].count = context->input[i].count;
-			state.input[i].normalized = context->input[i].normalized;
-			state.input[i].attribType = context->vertexShader ? context->vertexShader->getAttribType(i) : VertexShader::ATTRIBTYPE_FLOAT;
-		}
-
 		if(!context->vertexShader)
 		{
 			for(int i = 0; i < 8; i++)
@@ -998,16 +1164,6 @@ namespace sw
 				state.textureState[i].texCoordIndexActive = context->texCoordIndexActive(i);
 			}
 		}
-		else
-		{
-			for(unsigned int i = 0; i < VERTEX_TEXTURE_IMAGE_UNITS; i++)
-			{
-				if(context->vertexShader->usesSampler(i))
-				{
-					state.sampler[i] = context->sampler[TEXTURE_IMAGE_UNITS + i].samplerState();
-				}
-			}
-		}
 
 		if(context->vertexShader)   // FIXME: Also when pre-transformed?
 		{
@@ -1083,34 +1239,179 @@ namespace sw
 			state.output[C1].clamp = 0xF;
 			state.output[Fog].xClamp = true;
 		}
+	}
 
-		state.hash = state.computeHash();
+	void VertexProcessor::updateSamplers(State &state) const
+	{
+		const VertexShader *shader = context->vertexShader;
 
-		return state;
+		if(shader)
+		{
+			bool specialize = specializeSamplers && shader->getSamplerSpecializationCount() < MAX_SAMPLER_SPECIALIZATIONS;
+
+			for(unsigned int i = 0; i < VERTEX_TEXTURE_IMAGE_UNITS; i++)
+			{
+				if(shader->usesSampler(i))
+				{
+					state.sampler[i] = context->sampler[TEXTURE_IMAGE_UNITS + i].samplerState();
+
+					if(specialize)
+					{
+						context->sampler[TEXTURE_IMAGE_UNITS + i].specialize(state.sampler[i]);
+					}
+				}
+			}
+		}
+	}
+
+	void VertexProcessor::updateInput(State &state) const
+	{
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			state.input[i].type = context->input[i].type;
+			state.input[i].count = context->input[i].count;
+			state.input[i].normalized = context->input[i].normalized;
+			state.input[i].attribType = context->vertexShader ? context->vertexShader->getAttribType(i) : VertexShader::ATTRIBTYPE_FLOAT;
+		}
 	}
 
+	void VertexProcessor::updateUniforms(State &state) const
+	{
+		const VertexShader *shader = context->vertexShader;
+
+		if(!specializeUniforms || !shader || shader->getSpecializationCount() >= MAX_UNIFORM_SPECIALIZATIONS)
+		{
+			return;
+		}
+
+		int count = shader->getUniformConditionCount();
+
+		for(int index = 0; index < count; index++)
+		{
+			const Shader::UniformCondition &condition = shader->getUniformCondition(index);
+			int *value = state.uniformCondition[index];
+
+			switch(condition.type)
+			{
+			case Shader::PARAMETER_CONST:
+				if(condition.index >= VERTEX_UNIFORM_VECTORS)
+				{
+					state.clear(SECTION_UNIFORMS);
+					return;
+				}
+
+				value[0] = ((const int&)c[condition.index][condition.component] < 0);   // Sign bit, as tested by IF
+				break;
+			case Shader::PARAMETER_CONSTINT:
+				value[0] = i[condition.index][0];
+				value[1] = i[condition.index][1];
+				value[2] = i[condition.index][2];
+				break;
+			case Shader::PARAMETER_CONSTBOOL:
+				value[0] = b[condition.index];
+				break;
+			default:
+				ASSERT(false);
+			}
+		}
+
+		state.specializedUniforms = count;
+	}
+
+	static Routine *generateRoutine(const VertexProcessor::State &state, const VertexShader *vertexShader, bool runOptimizations)
+	{
+		VertexRoutine *generator = nullptr;
+
+		if(state.fixedFunction)
+		{
+			generator = new VertexPipeline(state);
+		}
+		else
+		{
+			generator = new VertexProgram(state, vertexShader);
+		}
+
+		generator->generate();
+		Routine *routine = generator->compile(runOptimizations, L"VertexRoutine_%0.8X_%0.8X", state.shaderID, state.hash);
+		delete generator;
+
+		return routine;
+	}
+
+	class VertexRoutineOptimization : public RoutineCache<VertexProcessor::State>::Optimization
+	{
+	public:
+		VertexRoutineOptimization(const VertexProcessor::State &state, const VertexShader *vertexShader) : Optimization(state)
+		{
+			// The application may delete its shader before the optimizer gets to it
+			this->vertexShader = (vertexShader && !state.fixedFunction) ? new VertexShader(vertexShader) : nullptr;
+		}
+
+		~VertexRoutineOptimization() override
+		{
+			delete vertexShader;
+		}
+
+		Routine *generate() override
+		{
+			return generateRoutine(state, vertexShader, true);
+		}
+
+	private:
+		const VertexShader *vertexShader;
+	};
+
 	Routine *VertexProcessor::routine(const State &state)
 	{
+		routineCache->update();
+
 		Routine *routine = routineCache->query(state);
 
 		if(!routine)   // Create one
 		{
-			VertexRoutine *generator = nullptr;
+			double compileStart = Timer::seconds();
+			TraceScope trace("Compile VertexRoutine");
+
+			routine = generateRoutine(state, context->vertexShader, !tieredCompilation);
+			routineCache->add(state, routine);
+
+			if(state.specializedUniforms)
+			{
+				context->vertexShader->countSpecialization();
+			}
 
-			if(state.fixedFunction)
+			for(int i = 0; i < VERTEX_TEXTURE_IMAGE_UNITS; i++)
 			{
-				generator = new VertexPipeline(state);
+				if(state.sampler[i].powerOfTwo)
+				{
+					context->vertexShader->countSamplerSpecialization();
+					break;
+				}
 			}
-			else
+
+			if(pipelineCounters)
 			{
-				generator = new VertexProgram(state, context->vertexShader);
+				profiler.countCompile(Timer::seconds() - compileStart);
 			}
+		}
+		else if(pipelineCounters)
+		{
+			profiler.count(COUNTER_ROUTINE_CACHE_HITS, 1);
+		}
 
-			generator->generate();
-			routine = (*generator)(L"VertexRoutine_%0.8X", state.shaderID);
-			delete generator;
+		return routine;
+	}
 
-			routineCache->add(state, routine);
+	Routine *VertexProcessor::tierUp(const State &state, Routine *routine)
+	{
+		if(routineCache->update())
+		{
+			routine = this->routine(state);   // The bound routine may have been replaced
+		}
+
+		if(routineCache->isHot(routine))
+		{
+			routineCache->optimize(new VertexRoutineOptimization(state, context->vertexShader));
 		}
 
 		return routine;
@@ -38,16 +38,25 @@ namespace sw
 	{
 		unsigned int vertexCount;
 		unsigned int primitiveStart;
+		unsigned int cacheMisses;   // Written when pipeline counters are enabled
 		VertexCache vertexCache;
 	};
 
 	class VertexProcessor
 	{
 	public:
-		struct States
+		enum StateSection
 		{
-			unsigned int computeHash();
+			SECTION_MAIN,       // Everything but the sampler and input states
+			SECTION_SAMPLERS,   // Vertex texture sampler states
+			SECTION_INPUT,      // Vertex input stream formats
+			SECTION_UNIFORMS,   // Values of the shader's uniform conditions
+
+			SECTION_COUNT
+		};
 
+		struct States
+		{
 			uint64_t shaderID;
 
 			bool fixedFunction             : 1;   // TODO: Eliminate by querying shader.
@@ -75,6 +84,7 @@ namespace sw
 			bool pointSizeActive                              : 1;
 			bool pointScaleActive                             : 1;
 			bool transformFeedbackQueryEnabled                : 1;
+			bool pipelineCounters                             : 1;
 			uint64_t transformFeedbackEnabled                 : 64;
 			unsigned char verticesPerPrimitive                : 2; // 1 (points), 2 (lines) or 3 (triangles)
 
@@ -137,6 +147,9 @@ namespace sw
 
 			Input input[MAX_VERTEX_INPUTS];
 			Output output[MAX_VERTEX_OUTPUTS];
+
+			unsigned char specializedUniforms;   // Number of uniform conditions the routine assumes the values of
+			int uniformCondition[MAX_UNIFORM_CONDITIONS][3];
 		};
 
 		struct State : States
@@ -145,7 +158,12 @@ namespace sw
 
 			bool operator==(const State &state) const;
 
+			void clear(StateSection section);         // Resets the section's fields
+			void computeHash(StateSection section);   // Rehashes the section and recombines the hash
+			void computeHash();
+
 			unsigned int hash;
+			uint64_t sectionHash[SECTION_COUNT];
 		};
 
 		struct FixedFunction
@@ -284,8 +302,9 @@ namespace sw
 		const Matrix &getModelTransform(int i);
 		const Matrix &getViewTransform();
 
-		const State update(DrawType drawType);
+		void update(State &state, DrawType drawType);   // Rederives the sections whose context state is dirty
 		Routine *routine(const State &state);
+		Routine *tierUp(const State &state, Routine *routine);   // Counts a draw, returns the optimized routine once available
 
 		bool isFixedFunction();
 		void setRoutineCacheSize(int cacheSize);
@@ -322,6 +341,10 @@ namespace sw
 		TransformFeedbackInfo transformFeedbackInfo[MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS];
 
 		void updateTransform();
+		void updateMain(State &state, DrawType drawType) const;
+		void updateSamplers(State &state) const;
+		void updateInput(State &state) const;
+		void updateUniforms(State &state) const;
 		void setTransform(const Matrix &M, int i);
 		void setCameraTransform(const Matrix &M, int i);
 		void setNormalTransform(const Matrix &M, int i);
@@ -283,6 +283,51 @@ namespace sw
 			sRGBtoLinear12_16[i] = (unsigned short)(clamp(sw::sRGBtoLinear((float)i / 0x0FFF) * 0xFFFF + 0.5f, 0.0f, (float)0xFFFF));
 		}
 
+		static const int intensity[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+		static const int distance[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+		for(int i = 0; i < 8; i++)
+		{
+			const int a = intensity[i][0];
+			const int b = intensity[i][1];
+			const int d = distance[i];
+
+			const int modifiers[4][4] =
+			{
+				{a, b, -a, -b},   // Individual and differential modes
+				{0, b, 0, -b},    // Non-opaque punch-through
+				{0, d, 0, -d},    // T mode, index 0 selects the first color
+				{d, -d, d, -d},   // H mode
+			};
+
+			for(int j = 0; j < 4; j++)
+			{
+				memcpy(&etc2Modifiers[j * 8 + i], modifiers[j], sizeof(modifiers[j]));
+			}
+		}
+
+		static const int eacModifiers[16][8] =
+		{
+			{-3, -6, -9, -15, 2, 5, 8, 14},
+			{-3, -7, -10, -13, 2, 6, 9, 12},
+			{-2, -5, -8, -13, 1, 4, 7, 12},
+			{-2, -4, -6, -13, 1, 3, 5, 12},
+			{-3, -6, -8, -12, 2, 5, 7, 11},
+			{-3, -7, -9, -11, 2, 6, 8, 10},
+			{-4, -7, -8, -11, 3, 6, 7, 10},
+			{-3, -5, -8, -11, 2, 4, 7, 10},
+			{-2, -6, -8, -10, 1, 5, 7, 9},
+			{-2, -5, -8, -10, 1, 4, 7, 9},
+			{-2, -4, -8, -10, 1, 3, 7, 9},
+			{-2, -5, -7, -10, 1, 4, 6, 9},
+			{-3, -4, -7, -10, 2, 3, 6, 9},
+			{-1, -2, -3, -10, 0, 1, 2, 9},
+			{-4, -6, -8, -9, 3, 5, 7, 8},
+			{-3, -5, -7, -9, 2, 4, 6, 8}
+		};
+
+		memcpy(&this->eacModifiers, &eacModifiers, sizeof(eacModifiers));
+
 		for(int q = 0; q < 4; q++)
 		{
 			for(int c = 0; c < 16; c++)
@@ -325,6 +370,7 @@ namespace sw
 		const dword minY[16] = {0x00000000, 0x00000010, 0x00001000, 0x00001010, 0x00100000, 0x00100010, 0x00101000, 0x00101010, 0x10000000, 0x10000010, 0x10001000, 0x10001010, 0x10100000, 0x10100010, 0x10101000, 0x10101010};
 		const dword minZ[16] = {0x00000000, 0x00000020, 0x00002000, 0x00002020, 0x00200000, 0x00200020, 0x00202000, 0x00202020, 0x20000000, 0x20000020, 0x20002000, 0x20002020, 0x20200000, 0x20200020, 0x20202000, 0x20202020};
 		const dword fini[16] = {0x00000000, 0x00000080, 0x00008000, 0x00008080, 0x00800000, 0x00800080, 0x00808000, 0x00808080, 0x80000000, 0x80000080, 0x80008000, 0x80008080, 0x80800000, 0x80800080, 0x80808000, 0x80808080};
+		const dword band[16] = {0x00000000, 0x00000040, 0x00004000, 0x00004040, 0x00400000, 0x00400040, 0x00404000, 0x00404040, 0x40000000, 0x40000040, 0x40004000, 0x40004040, 0x40400000, 0x40400040, 0x40404000, 0x40404040};
 
 		memcpy(&this->maxX, &maxX, sizeof(maxX));
 		memcpy(&this->maxY, &maxY, sizeof(maxY));
@@ -333,6 +379,7 @@ namespace sw
 		memcpy(&this->minY, &minY, sizeof(minY));
 		memcpy(&this->minZ, &minZ, sizeof(minZ));
 		memcpy(&this->fini, &fini, sizeof(fini));
+		memcpy(&this->band, &band, sizeof(band));
 
 		static const dword4 maxPos = {0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFE};
 
@@ -74,6 +74,11 @@ namespace sw
 		unsigned short linearToSRGB12_16[4096];
 		unsigned short sRGBtoLinear12_16[4096];
 
+		// ETC2 modifiers per 2-bit texel index, for the individual and differential
+		// intensity tables, their non-opaque punch-through variant, and T and H modes
+		int etc2Modifiers[32][4];
+		int eacModifiers[16][8];
+
 		// Centroid parameters
 		float4 sampleX[4][16];
 		float4 sampleY[4][16];
@@ -93,6 +98,7 @@ namespace sw
 		dword minY[16];
 		dword minZ[16];
 		dword fini[16];
+		dword band[16];
 
 		dword4 maxPos;
 
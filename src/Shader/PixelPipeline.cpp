@@ -1254,6 +1254,11 @@ namespace sw
 			c = SamplerCore(constants, state.sampler[stage]).sampleTexture(texture, u_q, v_q, w_q, q, q, dsx, dsy);
 		}
 
+		if(state.pipelineCounters)
+		{
+			textureSamples += UInt(4);
+		}
+
 		#if PERF_PROFILE
 			cycles[PERF_TEX] += Ticks() - texTime;
 		#endif
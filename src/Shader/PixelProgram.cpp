@@ -754,6 +754,11 @@ namespace sw
 		Pointer<Byte> texture = data + OFFSET(DrawData, mipmap) + samplerIndex * sizeof(Texture);
 		Vector4f c = SamplerCore(constants, state.sampler[samplerIndex]).sampleTexture(texture, uvwq.x, uvwq.y, uvwq.z, uvwq.w, bias, dsx, dsy, offset, function);
 
+		if(state.pipelineCounters)
+		{
+			textureSamples += UInt(4);
+		}
+
 		#if PERF_PROFILE
 			cycles[PERF_TEX] += Ticks() - texTime;
 		#endif
@@ -1089,6 +1094,18 @@ namespace sw
 		return c;
 	}
 
+	const int *PixelProgram::uniformCondition(const Src &src) const
+	{
+		int index = shader->findUniformCondition(src);
+
+		if(index < 0 || index >= state.specializedUniforms)
+		{
+			return nullptr;
+		}
+
+		return state.uniformCondition[index];
+	}
+
 	Int PixelProgram::relativeAddress(const Shader::Relative &rel, int bufferIndex)
 	{
 		ASSERT(!rel.dynamic);
@@ -1429,13 +1446,6 @@ namespace sw
 
 	void PixelProgram::CALLNZb(int labelIndex, int callSiteIndex, const Src &boolRegister)
 	{
-		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData, ps.b[boolRegister.index])) != Byte(0));   // FIXME
-
-		if(boolRegister.modifier == Shader::MODIFIER_NOT)
-		{
-			condition = !condition;
-		}
-
 		if(!labelBlock[labelIndex])
 		{
 			labelBlock[labelIndex] = Nucleus::createBasicBlock();
@@ -1448,7 +1458,24 @@ namespace sw
 
 		Int4 restoreLeave = enableLeave;
 
-		branch(condition, labelBlock[labelIndex], callRetBlock[labelIndex][callSiteIndex]);
+		if(const int *value = uniformCondition(boolRegister))   // Only one of the blocks is reachable
+		{
+			bool condition = (value[0] != 0) != (boolRegister.modifier == Shader::MODIFIER_NOT);
+
+			Nucleus::createBr(condition ? labelBlock[labelIndex] : callRetBlock[labelIndex][callSiteIndex]);
+		}
+		else
+		{
+			Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData, ps.b[boolRegister.index])) != Byte(0));   // FIXME
+
+			if(boolRegister.modifier == Shader::MODIFIER_NOT)
+			{
+				condition = !condition;
+			}
+
+			branch(condition, labelBlock[labelIndex], callRetBlock[labelIndex][callSiteIndex]);
+		}
+
 		Nucleus::setInsertBlock(callRetBlock[labelIndex][callSiteIndex]);
 
 		enableLeave = restoreLeave;
@@ -1585,7 +1612,7 @@ namespace sw
 
 	void PixelProgram::IF(const Src &src)
 	{
-		if(src.type == Shader::PARAMETER_CONSTBOOL)
+		if(src.type == Shader::PARAMETER_CONSTBOOL || uniformCondition(src))
 		{
 			IFb(src);
 		}
@@ -1604,17 +1631,27 @@ namespace sw
 	{
 		ASSERT(ifDepth < 24 + 4);
 
-		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData, ps.b[boolRegister.index])) != Byte(0));   // FIXME
+		BasicBlock *trueBlock = Nucleus::createBasicBlock();
+		BasicBlock *falseBlock = Nucleus::createBasicBlock();
 
-		if(boolRegister.modifier == Shader::MODIFIER_NOT)
+		if(const int *value = uniformCondition(boolRegister))   // Only one of the blocks is reachable
 		{
-			condition = !condition;
+			bool condition = (value[0] != 0) != (boolRegister.modifier == Shader::MODIFIER_NOT);
+
+			Nucleus::createBr(condition ? trueBlock : falseBlock);
+			Nucleus::setInsertBlock(trueBlock);
 		}
+		else
+		{
+			Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData, ps.b[boolRegister.index])) != Byte(0));   // FIXME
 
-		BasicBlock *trueBlock = Nucleus::createBasicBlock();
-		BasicBlock *falseBlock = Nucleus::createBasicBlock();
+			if(boolRegister.modifier == Shader::MODIFIER_NOT)
+			{
+				condition = !condition;
+			}
 
-		branch(condition, trueBlock, falseBlock);
+			branch(condition, trueBlock, falseBlock);
+		}
 
 		isConditionalIf[ifDepth] = false;
 		ifFalseBlock[ifDepth] = falseBlock;
@@ -1688,9 +1725,18 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][0]));
-		aL[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][1]));
-		increment[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][2]));
+		if(const int *value = uniformCondition(integerRegister))
+		{
+			iteration[loopDepth] = Int(value[0]);
+			aL[loopDepth] = Int(value[1]);
+			increment[loopDepth] = Int(value[2]);
+		}
+		else
+		{
+			iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][0]));
+			aL[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][1]));
+			increment[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][2]));
+		}
 
 		//	If(increment[loopDepth] == 0)
 		//	{
@@ -1720,7 +1766,15 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][0]));
+		if(const int *value = uniformCondition(integerRegister))
+		{
+			iteration[loopDepth] = Int(value[0]);
+		}
+		else
+		{
+			iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][0]));
+		}
+
 		aL[loopDepth] = aL[loopDepth - 1];
 
 		BasicBlock *loopBlock = Nucleus::createBasicBlock();
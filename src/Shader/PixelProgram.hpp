@@ -24,7 +24,7 @@ namespace sw
 	{
 	public:
 		PixelProgram(const PixelProcessor::State &state, const PixelShader *shader) :
-			PixelRoutine(state, shader), r(shader->indirectAddressableTemporaries),
+			PixelRoutine(state, shader), r(shader->getTemporaryCount(), shader->indirectAddressableTemporaries),
 			loopDepth(-1), ifDepth(0), loopRepDepth(0), currentLabel(-1), whileTest(false)
 		{
 			for(int i = 0; i < 2048; ++i)
@@ -55,7 +55,7 @@ namespace sw
 
 	private:
 		// Temporary registers
-		RegisterArray<NUM_TEMPORARY_REGISTERS> r;
+		RegisterFile r;
 
 		// Color outputs
 		Vector4f c[RENDERTARGETS];
@@ -92,6 +92,7 @@ namespace sw
 
 		Vector4f fetchRegister(const Src &src, unsigned int offset = 0);
 		Vector4f readConstant(const Src &src, unsigned int offset = 0);
+		const int *uniformCondition(const Src &src) const;   // Value the routine is specialized on, or null
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index);
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index, Int& offset);
 		Int relativeAddress(const Shader::Relative &rel, int bufferIndex = -1);
@@ -98,6 +98,14 @@ namespace sw
 			{
 				depthPass = depthPass || depthTest(zBuffer, q, x, z[q], sMask[q], zMask[q], cMask[q]);
 			}
+
+			if(state.pipelineCounters)
+			{
+				If(!depthPass)
+				{
+					quadsDepthKilled++;
+				}
+			}
 		}
 
 		If(depthPass || Bool(!earlyDepthTest))
@@ -202,6 +210,11 @@ namespace sw
 					Long shaderTime = Ticks();
 				#endif
 
+				if(state.pipelineCounters)
+				{
+					quadsShaded++;
+				}
+
 				applyShader(cMask);
 
 				#if PERF_PROFILE
@@ -228,6 +241,14 @@ namespace sw
 					{
 						depthPass = depthPass || depthTest(zBuffer, q, x, z[q], sMask[q], zMask[q], cMask[q]);
 					}
+
+					if(state.pipelineCounters)
+					{
+						If(!depthPass)
+						{
+							quadsDepthKilled++;
+						}
+					}
 				}
 
 				#if PERF_PROFILE
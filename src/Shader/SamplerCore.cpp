@@ -52,10 +52,15 @@ namespace sw
 {
 	extern bool colorsDefaultToZero;
 
-	SamplerCore::SamplerCore(Pointer<Byte> &constants, const Sampler::State &state) : constants(constants), state(state)
+	SamplerCore::SamplerCore(Pointer<Byte> &constants, const Sampler::State &state) : constants(constants), state(state), blockCache(nullptr), blockCacheValid(false)
 	{
 	}
 
+	SamplerCore::~SamplerCore()
+	{
+		delete blockCache;
+	}
+
 	Vector4s SamplerCore::sampleTexture(Pointer<Byte> &texture, Float4 &u, Float4 &v, Float4 &w, Float4 &q, Float4 &bias, Vector4f &dsx, Vector4f &dsy)
 	{
 		return sampleTexture(texture, u, v, w, q, q, dsx, dsy, (dsx), Implicit, true);
@@ -212,6 +217,22 @@ namespace sw
 					case FORMAT_YV12_BT601:
 					case FORMAT_YV12_BT709:
 					case FORMAT_YV12_JFIF:
+					case FORMAT_DXT1:
+					case FORMAT_DXT3:
+					case FORMAT_DXT5:
+					case FORMAT_ATI1:
+					case FORMAT_ATI2:
+					case FORMAT_ETC1:
+					case FORMAT_RGB8_ETC2:
+					case FORMAT_SRGB8_ETC2:
+					case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+					case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+					case FORMAT_RGBA8_ETC2_EAC:
+					case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+					case FORMAT_R11_EAC:
+					case FORMAT_SIGNED_R11_EAC:
+					case FORMAT_RG11_EAC:
+					case FORMAT_SIGNED_RG11_EAC:
 						if(componentCount < 2) c.y = Short4(defaultColorValue);
 						if(componentCount < 3) c.z = Short4(defaultColorValue);
 						if(componentCount < 4) c.w = Short4(0x1000);
@@ -296,8 +317,8 @@ namespace sw
 		}
 		else
 		{
-			// FIXME: YUV is not supported by the floating point path
-			bool forceFloatFiltering = state.highPrecisionFiltering && !hasYuvFormat() && (state.textureFilter != FILTER_POINT);
+			// FIXME: YUV and compressed formats are not supported by the floating point path
+			bool forceFloatFiltering = state.highPrecisionFiltering && !hasYuvFormat() && !hasCompressedFormat() && (state.textureFilter != FILTER_POINT);
 			bool seamlessCube = (state.addressingModeU == ADDRESSING_SEAMLESS);
 			bool rectangleTexture = (state.textureType == TEXTURE_RECTANGLE);
 			if(hasFloatTexture() || hasUnnormalizedIntegerTexture() || forceFloatFiltering || seamlessCube || rectangleTexture)   // FIXME: Mostly identical to integer sampling
@@ -442,6 +463,22 @@ namespace sw
 				case FORMAT_YV12_BT601:
 				case FORMAT_YV12_BT709:
 				case FORMAT_YV12_JFIF:
+				case FORMAT_DXT1:
+				case FORMAT_DXT3:
+				case FORMAT_DXT5:
+				case FORMAT_ATI1:
+				case FORMAT_ATI2:
+				case FORMAT_ETC1:
+				case FORMAT_RGB8_ETC2:
+				case FORMAT_SRGB8_ETC2:
+				case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+				case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+				case FORMAT_RGBA8_ETC2_EAC:
+				case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+				case FORMAT_R11_EAC:
+				case FORMAT_SIGNED_R11_EAC:
+				case FORMAT_RG11_EAC:
+				case FORMAT_SIGNED_RG11_EAC:
 					if(componentCount < 2) c.y = Float4(defaultColorValue);
 					if(componentCount < 3) c.z = Float4(defaultColorValue);
 					if(componentCount < 4) c.w = Float4(1.0f);
@@ -777,8 +814,8 @@ namespace sw
 			if(!gather)   // Blend
 			{
 				// Fractions
-				UShort4 f0u = As<UShort4>(uuuu0) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,width));
-				UShort4 f0v = As<UShort4>(vvvv0) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,height));
+				UShort4 f0u = As<UShort4>(uuuu0) * mipmapSize(mipmap, OFFSET(Mipmap,width));
+				UShort4 f0v = As<UShort4>(vvvv0) * mipmapSize(mipmap, OFFSET(Mipmap,height));
 
 				UShort4 f1u = ~f0u;
 				UShort4 f1v = ~f0v;
@@ -1229,8 +1266,30 @@ namespace sw
 		address(v, y0, y1, fv, mipmap, offset.y, filter, OFFSET(Mipmap, height), state.addressingModeV, function);
 		address(w, z0, z0, fv, mipmap, offset.z, filter, OFFSET(Mipmap, depth), state.addressingModeW, function);
 
-		Int4 pitchP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, pitchP), 16);
-		y0 *= pitchP;
+		Int4 pitchP;
+
+		if(state.powerOfTwo)
+		{
+			pitchP = Int4(1 << state.log2Width);   // The pitch is the width
+		}
+		else
+		{
+			pitchP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, pitchP), 16);
+		}
+
+		if(state.tiledLayout)
+		{
+			x0 = tiledColumn(x0);
+			x1 = tiledColumn(x1);
+			y0 = tiledRow(y0, pitchP);
+			y1 = tiledRow(y1, pitchP);
+		}
+		else
+		{
+			y0 *= pitchP;
+			y1 *= pitchP;
+		}
+
 		if(hasThirdCoordinate())
 		{
 			Int4 sliceP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, sliceP), 16);
@@ -1243,7 +1302,6 @@ namespace sw
 		}
 		else
 		{
-			y1 *= pitchP;
 
 			Vector4f c0 = sampleTexel(x0, y0, z0, q, mipmap, buffer, function);
 			Vector4f c1 = sampleTexel(x1, y0, z0, q, mipmap, buffer, function);
@@ -1384,6 +1442,11 @@ namespace sw
 
 	void SamplerCore::computeLod(Pointer<Byte> &texture, Float &lod, Float &anisotropy, Float4 &uDelta, Float4 &vDelta, Float4 &uuuu, Float4 &vvvv, const Float &lodBias, Vector4f &dsx, Vector4f &dsy, SamplerFunction function)
 	{
+		if(!requiresLod())
+		{
+			return;   // Unused
+		}
+
 		if(function != Lod && function != Fetch)
 		{
 			Float4 duvdxy;
@@ -1401,7 +1464,18 @@ namespace sw
 			}
 
 			// Scale by texture dimensions and global LOD.
-			Float4 dUVdxy = duvdxy * *Pointer<Float4>(texture + OFFSET(Texture,widthHeightLOD));
+			Float4 dUVdxy;
+
+			if(state.noLodBias)
+			{
+				float width = (float)(1 << state.log2Width);
+				float height = (float)(1 << state.log2Height);
+				dUVdxy = duvdxy * Float4(width, width, height, height);
+			}
+			else
+			{
+				dUVdxy = duvdxy * *Pointer<Float4>(texture + OFFSET(Texture,widthHeightLOD));
+			}
 
 			Float4 dUV2dxy = dUVdxy * dUVdxy;
 			Float4 dUV2 = dUV2dxy.xy + dUV2dxy.zw;
@@ -1455,6 +1529,11 @@ namespace sw
 
 	void SamplerCore::computeLodCube(Pointer<Byte> &texture, Float &lod, Float4 &u, Float4 &v, Float4 &w, const Float &lodBias, Vector4f &dsx, Vector4f &dsy, Float4 &M, SamplerFunction function)
 	{
+		if(!requiresLod())
+		{
+			return;   // Unused
+		}
+
 		if(function != Lod && function != Fetch)
 		{
 			Float4 dudxy, dvdxy, dsdxy;
@@ -1521,6 +1600,11 @@ namespace sw
 
 	void SamplerCore::computeLod3D(Pointer<Byte> &texture, Float &lod, Float4 &uuuu, Float4 &vvvv, Float4 &wwww, const Float &lodBias, Vector4f &dsx, Vector4f &dsy, SamplerFunction function)
 	{
+		if(!requiresLod())
+		{
+			return;   // Unused
+		}
+
 		if(function != Lod && function != Fetch)
 		{
 			Float4 dudxy, dvdxy, dsdxy;
@@ -1637,7 +1721,14 @@ namespace sw
 		switch(mode)
 		{
 		case AddressingMode::ADDRESSING_WRAP:
-			tmp = (tmp + whd * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % whd;
+			if(state.powerOfTwo)
+			{
+				tmp = tmp & (whd - Int4(1));
+			}
+			else
+			{
+				tmp = (tmp + whd * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % whd;
+			}
 			break;
 		case AddressingMode::ADDRESSING_CLAMP:
 		case AddressingMode::ADDRESSING_MIRROR:
@@ -1663,54 +1754,89 @@ namespace sw
 
 		if(!texelFetch)
 		{
-			uuuu = MulHigh(As<UShort4>(uuuu), *Pointer<UShort4>(mipmap + OFFSET(Mipmap, width)));
-			vvvv = MulHigh(As<UShort4>(vvvv), *Pointer<UShort4>(mipmap + OFFSET(Mipmap, height)));
+			uuuu = MulHigh(As<UShort4>(uuuu), mipmapSize(mipmap, OFFSET(Mipmap, width)));
+			vvvv = MulHigh(As<UShort4>(vvvv), mipmapSize(mipmap, OFFSET(Mipmap, height)));
 		}
 
 		if(hasOffset)
 		{
-			UShort4 w = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, width));
+			UShort4 w = mipmapSize(mipmap, OFFSET(Mipmap, width));
 			uuuu = applyOffset(uuuu, offset.x, Int4(w), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeU);
-			UShort4 h = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, height));
+			UShort4 h = mipmapSize(mipmap, OFFSET(Mipmap, height));
 			vvvv = applyOffset(vvvv, offset.y, Int4(h), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeV);
 		}
 
-		Short4 uuu2 = uuuu;
-		uuuu = As<Short4>(UnpackLow(uuuu, vvvv));
-		uuu2 = As<Short4>(UnpackHigh(uuu2, vvvv));
-		uuuu = As<Short4>(MulAdd(uuuu, *Pointer<Short4>(mipmap + OFFSET(Mipmap,onePitchP))));
-		uuu2 = As<Short4>(MulAdd(uuu2, *Pointer<Short4>(mipmap + OFFSET(Mipmap,onePitchP))));
-
-		if(hasThirdCoordinate())
+		if(state.tiledLayout)
 		{
-			if(state.textureType != TEXTURE_2D_ARRAY)
-			{
-				if(!texelFetch)
-				{
-					wwww = MulHigh(As<UShort4>(wwww), *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth)));
-				}
+			// Tiled indices don't fit in 16 bits
+			Int4 pitchP;
 
-				if(hasOffset)
-				{
-					UShort4 d = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth));
-					wwww = applyOffset(wwww, offset.z, Int4(d), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeW);
-				}
+			if(state.powerOfTwo)
+			{
+				pitchP = Int4(1 << state.log2Width);
+			}
+			else
+			{
+				pitchP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, pitchP), 16);
 			}
 
-			UInt4 uv(As<UInt2>(uuuu), As<UInt2>(uuu2));
-			uv += As<UInt4>(Int4(As<UShort4>(wwww))) * *Pointer<UInt4>(mipmap + OFFSET(Mipmap, sliceP));
+			Int4 uv = tiledColumn(Int4(As<UShort4>(uuuu))) + tiledRow(Int4(As<UShort4>(vvvv)), pitchP);
 
-			index[0] = Extract(As<Int4>(uv), 0);
-			index[1] = Extract(As<Int4>(uv), 1);
-			index[2] = Extract(As<Int4>(uv), 2);
-			index[3] = Extract(As<Int4>(uv), 3);
+			index[0] = Extract(uv, 0);
+			index[1] = Extract(uv, 1);
+			index[2] = Extract(uv, 2);
+			index[3] = Extract(uv, 3);
 		}
 		else
 		{
-			index[0] = Extract(As<Int2>(uuuu), 0);
-			index[1] = Extract(As<Int2>(uuuu), 1);
-			index[2] = Extract(As<Int2>(uuu2), 0);
-			index[3] = Extract(As<Int2>(uuu2), 1);
+			Short4 onePitchP;
+
+			if(state.powerOfTwo)
+			{
+				onePitchP = Short4(1, 1 << state.log2Width, 1, 1 << state.log2Width);   // The pitch is the width
+			}
+			else
+			{
+				onePitchP = *Pointer<Short4>(mipmap + OFFSET(Mipmap,onePitchP));
+			}
+
+			Short4 uuu2 = uuuu;
+			uuuu = As<Short4>(UnpackLow(uuuu, vvvv));
+			uuu2 = As<Short4>(UnpackHigh(uuu2, vvvv));
+			uuuu = As<Short4>(MulAdd(uuuu, onePitchP));
+			uuu2 = As<Short4>(MulAdd(uuu2, onePitchP));
+
+			if(hasThirdCoordinate())
+			{
+				if(state.textureType != TEXTURE_2D_ARRAY)
+				{
+					if(!texelFetch)
+					{
+						wwww = MulHigh(As<UShort4>(wwww), *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth)));
+					}
+
+					if(hasOffset)
+					{
+						UShort4 d = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth));
+						wwww = applyOffset(wwww, offset.z, Int4(d), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeW);
+					}
+				}
+
+				UInt4 uv(As<UInt2>(uuuu), As<UInt2>(uuu2));
+				uv += As<UInt4>(Int4(As<UShort4>(wwww))) * *Pointer<UInt4>(mipmap + OFFSET(Mipmap, sliceP));
+
+				index[0] = Extract(As<Int4>(uv), 0);
+				index[1] = Extract(As<Int4>(uv), 1);
+				index[2] = Extract(As<Int4>(uv), 2);
+				index[3] = Extract(As<Int4>(uv), 3);
+			}
+			else
+			{
+				index[0] = Extract(As<Int2>(uuuu), 0);
+				index[1] = Extract(As<Int2>(uuuu), 1);
+				index[2] = Extract(As<Int2>(uuu2), 0);
+				index[3] = Extract(As<Int2>(uuu2), 1);
+			}
 		}
 
 		if(texelFetch)
@@ -1745,6 +1871,21 @@ namespace sw
 		}
 	}
 
+	Int4 SamplerCore::tiledColumn(Int4 x)
+	{
+		Int4 m = x & Int4(63);
+		m = (m | (m << 4)) & Int4(0x30F);
+		m = (m | (m << 2)) & Int4(0x333);
+		m = (m | (m << 1)) & Int4(0x555);
+
+		return ((x & Int4(~63)) << 6) | m;
+	}
+
+	Int4 SamplerCore::tiledRow(Int4 y, Int4 pitchP)
+	{
+		return (y & Int4(~63)) * pitchP + (tiledColumn(y & Int4(63)) << 1);
+	}
+
 	Vector4s SamplerCore::sampleTexel(UInt index[4], Pointer<Byte> buffer[4])
 	{
 		Vector4s c;
@@ -2010,6 +2151,11 @@ namespace sw
 	{
 		Vector4s c;
 
+		if(hasCompressedFormat())
+		{
+			return sampleCompressedTexel(uuuu, vvvv, wwww, offset, mipmap, buffer, function);
+		}
+
 		UInt index[4];
 		computeIndices(index, uuuu, vvvv, wwww, offset, mipmap, function);
 
@@ -2115,6 +2261,608 @@ namespace sw
 		return c;
 	}
 
+	Vector4s SamplerCore::sampleCompressedTexel(Short4 &uuuu, Short4 &vvvv, Short4 &wwww, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function)
+	{
+		// Decodes the addressed texels straight from their 4x4 blocks, so the
+		// texture never needs an uncompressed copy.
+		Vector4s c;
+
+		bool texelFetch = (function == Fetch);
+		bool hasOffset = (function.option == Offset);
+
+		Short4 uuu = uuuu;
+		Short4 vvv = vvvv;
+		UShort4 w = mipmapSize(mipmap, OFFSET(Mipmap, width));
+		UShort4 h = mipmapSize(mipmap, OFFSET(Mipmap, height));
+
+		if(!texelFetch)
+		{
+			uuu = MulHigh(As<UShort4>(uuu), w);
+			vvv = MulHigh(As<UShort4>(vvv), h);
+		}
+
+		if(hasOffset)
+		{
+			uuu = applyOffset(uuu, offset.x, Int4(w), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeU);
+			vvv = applyOffset(vvv, offset.y, Int4(h), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeV);
+		}
+
+		Int4 width = Int4(w);
+		Int4 x = Int4(As<UShort4>(uuu));
+		Int4 y = Int4(As<UShort4>(vvv));
+
+		if(texelFetch)
+		{
+			x = Min(x, width - Int4(1));
+			y = Min(y, Int4(h) - Int4(1));
+		}
+
+		Int4 blockIndex = (y >> 2) * ((width + Int4(3)) >> 2) + (x >> 2);
+
+		if(hasThirdCoordinate())
+		{
+			Short4 www = wwww;
+			UShort4 d = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth));
+
+			if(state.textureType != TEXTURE_2D_ARRAY)
+			{
+				if(!texelFetch)
+				{
+					www = MulHigh(As<UShort4>(www), d);
+				}
+
+				if(hasOffset)
+				{
+					www = applyOffset(www, offset.z, Int4(d), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeW);
+				}
+			}
+
+			Int4 z = Int4(As<UShort4>(www));
+
+			if(texelFetch)
+			{
+				z = Min(z, Int4(d) - Int4(1));
+			}
+
+			// Slices of 4x4 blocks hold one block per 4 pixels
+			blockIndex += z * (*Pointer<Int4>(mipmap + OFFSET(Mipmap, sliceP)) >> 2);
+		}
+
+		bool smallBlocks = (Surface::bytes(state.textureFormat) == 2);   // 64-bit blocks
+		Int4 blockOffset = blockIndex << (smallBlocks ? 3 : 4);
+		Int4 texel = ((y & Int4(3)) << 2) | (x & Int4(3));
+
+		int f[4];
+		f[0] = 0;
+		f[1] = state.textureType == TEXTURE_CUBE ? 1 : 0;
+		f[2] = state.textureType == TEXTURE_CUBE ? 2 : 0;
+		f[3] = state.textureType == TEXTURE_CUBE ? 3 : 0;
+
+		Pointer<Byte> block[4];
+
+		for(int i = 0; i < 4; i++)
+		{
+			block[i] = buffer[f[i]] + Extract(blockOffset, i);
+		}
+
+		if(hasETCFormat())
+		{
+			// ETC blocks store their texels column by column
+			Int4 etcTexel = ((x & Int4(3)) << 2) | (y & Int4(3));
+
+			sampleETCTexel(c, block, blockOffset, etcTexel);
+		}
+		else switch(state.textureFormat)
+		{
+		case FORMAT_DXT1:
+			decodeColorBlock(c, block, 0, texel, true);
+			break;
+		case FORMAT_DXT3:
+			{
+				decodeColorBlock(c, block, 8, texel, false);
+
+				// 4-bit explicit alpha, 16 texels in two 32-bit words
+				Int4 wordOffset = (texel >> 3) << 2;
+				Int4 bits;
+
+				for(int i = 0; i < 4; i++)
+				{
+					bits = Insert(bits, *Pointer<Int>(block[i] + Extract(wordOffset, i)), i);
+				}
+
+				Int4 a = (bits >> ((texel & Int4(7)) << 2)) & Int4(0xF);
+				a = (a << 4) | a;
+				c.w = Short4((a << 8) | a);
+			}
+			break;
+		case FORMAT_DXT5:
+			{
+				decodeColorBlock(c, block, 8, texel, false);
+
+				Int4 a = decodeAlphaBlock(block, 0, texel);
+				c.w = Short4((a << 8) | a);
+			}
+			break;
+		case FORMAT_ATI1:
+			{
+				Int4 r = decodeAlphaBlock(block, 0, texel);
+				c.x = Short4((r << 8) | r);
+			}
+			break;
+		case FORMAT_ATI2:
+			{
+				Int4 g = decodeAlphaBlock(block, 0, texel);
+				Int4 r = decodeAlphaBlock(block, 8, texel);
+				c.x = Short4((r << 8) | r);
+				c.y = Short4((g << 8) | g);
+			}
+			break;
+		default:
+			ASSERT(false);
+		}
+
+		if(state.sRGB)
+		{
+			for(int i = 0; i < textureComponentCount(); i++)
+			{
+				if(isRGBComponent(i))
+				{
+					sRGBtoLinear16_8_16(c[i]);
+				}
+			}
+		}
+
+		return c;
+	}
+
+	void SamplerCore::decodeColorBlock(Vector4s &c, Pointer<Byte> block[4], int blockOffset, Int4 &texel, bool punchThrough)
+	{
+		Int4 endpoints;
+		Int4 indices;
+
+		for(int i = 0; i < 4; i++)
+		{
+			endpoints = Insert(endpoints, *Pointer<Int>(block[i] + blockOffset), i);
+			indices = Insert(indices, *Pointer<Int>(block[i] + blockOffset + 4), i);
+		}
+
+		Int4 c0 = endpoints & Int4(0xFFFF);
+		Int4 c1 = (endpoints >> 16) & Int4(0xFFFF);
+		Int4 code = (indices >> (texel << 1)) & Int4(3);
+
+		// DXT1 blocks with c0 <= c1 have a single interpolant and a transparent black entry
+		Int4 opaque = Int4(-1);
+
+		if(punchThrough)
+		{
+			opaque = CmpNLE(c0, c1);
+		}
+
+		Int4 select0 = CmpEQ(code, Int4(0));
+		Int4 select1 = CmpEQ(code, Int4(1));
+		Int4 select2 = CmpEQ(code, Int4(2));
+		Int4 select3 = CmpEQ(code, Int4(3));
+
+		const int shift[3] = {11, 5, 0};
+		const int bits[3] = {5, 6, 5};
+
+		for(int i = 0; i < 3; i++)
+		{
+			Int4 mask = Int4((1 << bits[i]) - 1);
+			Int4 e0 = (c0 >> shift[i]) & mask;
+			Int4 e1 = (c1 >> shift[i]) & mask;
+			e0 = (e0 << (8 - bits[i])) | (e0 >> (2 * bits[i] - 8));
+			e1 = (e1 << (8 - bits[i])) | (e1 >> (2 * bits[i] - 8));
+
+			// Divide by 3 as a multiply and shift, exact for the numerators in range
+			Int4 third0 = ((e0 + e0 + e1 + Int4(1)) * Int4(0x5556)) >> 16;
+			Int4 third1 = ((e0 + e1 + e1 + Int4(1)) * Int4(0x5556)) >> 16;
+			Int4 half = (e0 + e1) >> 1;
+
+			Int4 e2 = (opaque & third0) | (~opaque & half);
+			Int4 e3 = opaque & third1;
+
+			Int4 e = (select0 & e0) | (select1 & e1) | (select2 & e2) | (select3 & e3);
+			c[i] = Short4((e << 8) | e);
+		}
+
+		c.w = Short4(~(select3 & ~opaque));
+	}
+
+	Int4 SamplerCore::decodeAlphaBlock(Pointer<Byte> block[4], int blockOffset, Int4 &texel)
+	{
+		// The 3-bit codes follow the two endpoints. Fetch the 16 bits holding a
+		// texel's code without reading beyond the 8-byte block.
+		Int4 bitOffset = (texel << 1) + texel;
+		Int4 bit = bitOffset & Int4(7);
+		Int4 straddle = CmpNLT(bit, Int4(6));
+		Int4 byteOffset = Int4(blockOffset + 1) + (bitOffset >> 3) - straddle;
+		Int4 shift = bit + Int4(8) - (straddle & Int4(8));
+
+		Int4 endpoints;
+		Int4 bits;
+
+		for(int i = 0; i < 4; i++)
+		{
+			endpoints = Insert(endpoints, Int(*Pointer<UShort>(block[i] + blockOffset)), i);
+			bits = Insert(bits, Int(*Pointer<UShort>(block[i] + Extract(byteOffset, i))), i);
+		}
+
+		Int4 a0 = endpoints & Int4(0xFF);
+		Int4 a1 = (endpoints >> 8) & Int4(0xFF);
+		Int4 code = (bits >> shift) & Int4(7);
+
+		// Eight interpolated values when a0 > a1, otherwise six plus 0 and 255
+		Int4 eight = CmpNLE(a0, a1);
+		Int4 w1 = code - Int4(1);
+		Int4 w0 = ((eight & Int4(7)) | (~eight & Int4(5))) - w1;
+		Int4 sum = w0 * a0 + w1 * a1;
+		Int4 seventh = ((sum + Int4(3)) * Int4(9363)) >> 16;
+		Int4 fifth = ((sum + Int4(2)) * Int4(13108)) >> 16;
+		Int4 a = (eight & seventh) | (~eight & fifth);
+
+		Int4 select0 = CmpEQ(code, Int4(0));
+		Int4 select1 = CmpEQ(code, Int4(1));
+		Int4 extreme = ~eight & CmpNLT(code, Int4(6));
+		Int4 select7 = CmpEQ(code, Int4(7));
+
+		a = (select0 & a0) | (select1 & a1) | (~(select0 | select1 | extreme) & a);
+		a |= extreme & select7 & Int4(0xFF);
+
+		return a;
+	}
+
+	void SamplerCore::sampleETCTexel(Vector4s &c, Pointer<Byte> block[4], Int4 &blockOffset, Int4 &texel)
+	{
+		if(!blockCache)
+		{
+			blockCache = new BlockCache;
+		}
+
+		if(blockCacheValid)
+		{
+			If(SignMask(CmpNEQ(blockOffset, blockCache->offset)) != 0)
+			{
+				decodeETCHeaders(block, blockOffset);
+			}
+		}
+		else
+		{
+			decodeETCHeaders(block, blockOffset);
+			blockCacheValid = true;
+		}
+
+		switch(state.textureFormat)
+		{
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+			decodeETC2Texel(c, texel, false);
+			break;
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+			decodeETC2Texel(c, texel, true);
+			break;
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+			{
+				decodeETC2Texel(c, texel, false);
+
+				Int4 a = decodeEACTexel(0, texel, false, false);
+				c.w = Short4((a << 8) | a);
+			}
+			break;
+		case FORMAT_R11_EAC:
+			c.x = Short4(decodeEACTexel(0, texel, true, false));
+			break;
+		case FORMAT_SIGNED_R11_EAC:
+			c.x = Short4(decodeEACTexel(0, texel, true, true));
+			break;
+		case FORMAT_RG11_EAC:
+			c.x = Short4(decodeEACTexel(0, texel, true, false));
+			c.y = Short4(decodeEACTexel(1, texel, true, false));
+			break;
+		case FORMAT_SIGNED_RG11_EAC:
+			c.x = Short4(decodeEACTexel(0, texel, true, true));
+			c.y = Short4(decodeEACTexel(1, texel, true, true));
+			break;
+		default:
+			ASSERT(false);
+		}
+	}
+
+	void SamplerCore::decodeETCHeaders(Pointer<Byte> block[4], Int4 &blockOffset)
+	{
+		switch(state.textureFormat)
+		{
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+			decodeETC2Header(block, 0, false);
+			break;
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+			decodeETC2Header(block, 0, true);
+			break;
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+			decodeEACHeader(block, 0, 0, false, false);
+			decodeETC2Header(block, 8, false);
+			break;
+		case FORMAT_R11_EAC:
+			decodeEACHeader(block, 0, 0, true, false);
+			break;
+		case FORMAT_SIGNED_R11_EAC:
+			decodeEACHeader(block, 0, 0, true, true);
+			break;
+		case FORMAT_RG11_EAC:
+			decodeEACHeader(block, 0, 0, true, false);
+			decodeEACHeader(block, 8, 1, true, false);
+			break;
+		case FORMAT_SIGNED_RG11_EAC:
+			decodeEACHeader(block, 0, 0, true, true);
+			decodeEACHeader(block, 8, 1, true, true);
+			break;
+		default:
+			ASSERT(false);
+		}
+
+		blockCache->offset = blockOffset;
+	}
+
+	void SamplerCore::decodeETC2Header(Pointer<Byte> block[4], int blockOffset, bool punchThrough)
+	{
+		// See ETC_Decoder.cpp for the bit fields of each mode
+		BlockCache &cache = *blockCache;
+
+		Int4 high = loadBlockWord(block, blockOffset);
+		Int4 low = loadBlockWord(block, blockOffset + 4);
+
+		// Punch-through blocks always use the differential mode bits, which hold the opaque bit instead
+		Int4 opaque = CmpNEQ(high & Int4(2), Int4(0));
+		Int4 differential = punchThrough ? Int4(-1) : opaque;
+		Int4 overflow[3];
+		Int4 c1[3];
+		Int4 c2[3];
+
+		for(int i = 0; i < 3; i++)
+		{
+			Int4 base = (high >> (27 - 8 * i)) & Int4(0x1F);
+			Int4 delta = (high << (5 + 8 * i)) >> 29;
+			Int4 sum = base + delta;
+			overflow[i] = CmpNEQ(sum & Int4(~0x1F), Int4(0));
+
+			Int4 individual1 = (high >> (28 - 8 * i)) & Int4(0xF);
+			Int4 individual2 = (high >> (24 - 8 * i)) & Int4(0xF);
+			individual1 = (individual1 << 4) | individual1;
+			individual2 = (individual2 << 4) | individual2;
+			base = (base << 3) | (base >> 2);
+			sum = (sum << 3) | ((sum >> 2) & Int4(7));
+
+			c1[i] = (differential & base) | (~differential & individual1);
+			c2[i] = (differential & sum) | (~differential & individual2);
+		}
+
+		Int4 modeT = differential & overflow[0];
+		Int4 modeH = differential & ~overflow[0] & overflow[1];
+		Int4 modeP = differential & ~overflow[0] & ~overflow[1] & overflow[2];
+		Int4 modeTH = modeT | modeH;
+
+		Int4 t1[3];
+		Int4 t2[3];
+		Int4 h1[3];
+		Int4 h2[3];
+
+		t1[0] = ((high >> 25) & Int4(0xC)) | ((high >> 24) & Int4(0x3));
+		t1[1] = (high >> 20) & Int4(0xF);
+		t1[2] = (high >> 16) & Int4(0xF);
+		t2[0] = (high >> 12) & Int4(0xF);
+		t2[1] = (high >> 8) & Int4(0xF);
+		t2[2] = (high >> 4) & Int4(0xF);
+		h1[0] = (high >> 27) & Int4(0xF);
+		h1[1] = ((high >> 23) & Int4(0xE)) | ((high >> 20) & Int4(0x1));
+		h1[2] = ((high >> 16) & Int4(0x8)) | ((high >> 15) & Int4(0x7));
+		h2[0] = (high >> 11) & Int4(0xF);
+		h2[1] = (high >> 7) & Int4(0xF);
+		h2[2] = (high >> 3) & Int4(0xF);
+
+		for(int i = 0; i < 3; i++)
+		{
+			t1[i] = (t1[i] << 4) | t1[i];
+			t2[i] = (t2[i] << 4) | t2[i];
+			h1[i] = (h1[i] << 4) | h1[i];
+			h2[i] = (h2[i] << 4) | h2[i];
+		}
+
+		// The H mode distance's lowest bit is implied by the order of its colors
+		Int4 hOrder = CmpNLT((h1[0] << 16) | (h1[1] << 8) | h1[2], (h2[0] << 16) | (h2[1] << 8) | h2[2]);
+		Int4 tDistance = ((high >> 1) & Int4(6)) | (high & Int4(1));
+		Int4 hDistance = (high & Int4(4)) | ((high & Int4(1)) << 1) | (hOrder & Int4(1));
+
+		Int4 o[3];
+		Int4 h[3];
+		Int4 v[3];
+
+		o[0] = (high >> 25) & Int4(0x3F);
+		o[1] = ((high >> 18) & Int4(0x40)) | ((high >> 17) & Int4(0x3F));
+		o[2] = ((high >> 11) & Int4(0x20)) | ((high >> 8) & Int4(0x18)) | ((high >> 7) & Int4(0x7));
+		h[0] = ((high >> 1) & Int4(0x3E)) | (high & Int4(0x1));
+		h[1] = (low >> 25) & Int4(0x7F);
+		h[2] = (low >> 19) & Int4(0x3F);
+		v[0] = (low >> 13) & Int4(0x3F);
+		v[1] = (low >> 6) & Int4(0x7F);
+		v[2] = low & Int4(0x3F);
+
+		for(int i = 0; i < 3; i++)
+		{
+			int bits = (i == 1) ? 7 : 6;
+
+			o[i] = (o[i] << (8 - bits)) | (o[i] >> (2 * bits - 8));
+			h[i] = (h[i] << (8 - bits)) | (h[i] >> (2 * bits - 8));
+			v[i] = (v[i] << (8 - bits)) | (v[i] >> (2 * bits - 8));
+
+			c1[i] = (modeT & t1[i]) | (modeH & h1[i]) | (~modeTH & c1[i]);
+			c2[i] = (modeT & t2[i]) | (modeH & h2[i]) | (~modeTH & c2[i]);
+
+			cache.c1[i] = (modeP & o[i]) | (~modeP & c1[i]);
+			cache.c2[i] = (modeP & (h[i] - o[i])) | (~modeP & c2[i]);
+			cache.v[i] = v[i] - o[i];
+		}
+
+		Int4 nonOpaque = Int4(0);
+
+		if(punchThrough)
+		{
+			nonOpaque = ~opaque;
+		}
+
+		// Rows of Constants::etc2Modifiers, as byte offsets
+		Int4 intensityRow = nonOpaque & Int4(8 * 16);
+		Int4 row1 = intensityRow + (((high >> 5) & Int4(7)) << 4);
+		Int4 row2 = intensityRow + (((high >> 2) & Int4(7)) << 4);
+		Int4 rowT = Int4(16 * 16) + (tDistance << 4);
+		Int4 rowH = Int4(24 * 16) + (hDistance << 4);
+
+		cache.row[0] = (modeT & rowT) | (modeH & rowH) | (~modeTH & row1);
+		cache.row[1] = (modeT & rowT) | (modeH & rowH) | (~modeTH & row2);
+
+		// T mode uses c1 for index 0 only, H mode for indices 0 and 1
+		cache.secondBase = (modeT & Int4(0xEE)) | (modeH & Int4(0xCC)) | (~modeTH & Int4(0xF0));
+
+		cache.indices = low;
+		cache.flip = CmpNEQ(high & Int4(1), Int4(0));
+		cache.planar = modeP;
+		cache.nonOpaque = nonOpaque & ~modeP;
+	}
+
+	void SamplerCore::decodeEACHeader(Pointer<Byte> block[4], int blockOffset, int channel, bool eac11, bool isSigned)
+	{
+		BlockCache &cache = *blockCache;
+
+		Int4 high = loadBlockWord(block, blockOffset);
+		Int4 low = loadBlockWord(block, blockOffset + 4);
+
+		Int4 base = isSigned ? (high >> 24) : ((high >> 24) & Int4(0xFF));
+		Int4 multiplier = (high >> 20) & Int4(0xF);
+
+		if(eac11)
+		{
+			// 11-bit values, where a zero multiplier steps by one
+			base = (base << 3) + Int4(4);
+			multiplier = (multiplier << 3) | (CmpEQ(multiplier, Int4(0)) & Int4(1));
+		}
+
+		cache.eacBase[channel] = base;
+		cache.eacMultiplier[channel] = multiplier;
+		cache.eacRow[channel] = ((high >> 16) & Int4(0xF)) << 5;
+
+		// The 48 index bits, as their upper and lower 32 bits
+		cache.eacIndices[channel][0] = (high << 16) | ((low >> 16) & Int4(0xFFFF));
+		cache.eacIndices[channel][1] = low;
+	}
+
+	void SamplerCore::decodeETC2Texel(Vector4s &c, Int4 &texel, bool punchThrough)
+	{
+		BlockCache &cache = *blockCache;
+
+		Int4 index = ((cache.indices >> (texel + Int4(15))) & Int4(2)) | ((cache.indices >> texel) & Int4(1));
+
+		// Sub-blocks are 2x4, or 4x2 when flipped
+		Int4 subBlock = (cache.flip & (texel >> 1)) | (~cache.flip & (texel >> 3));
+		subBlock &= Int4(1);
+
+		Int4 second = -subBlock;
+		Int4 row = (second & cache.row[1]) | (~second & cache.row[0]);
+		Int4 modifierOffset = row + (index << 2);
+		Int4 modifier;
+
+		for(int i = 0; i < 4; i++)
+		{
+			modifier = Insert(modifier, *Pointer<Int>(constants + OFFSET(Constants,etc2Modifiers) + Extract(modifierOffset, i)), i);
+		}
+
+		Int4 useC2 = -((cache.secondBase >> ((subBlock << 2) | index)) & Int4(1));
+		Int4 x = texel >> 2;
+		Int4 y = texel & Int4(3);
+
+		for(int i = 0; i < 3; i++)
+		{
+			Int4 e = ((useC2 & cache.c2[i]) | (~useC2 & cache.c1[i])) + modifier;
+			Int4 p = ((x * cache.c2[i] + y * cache.v[i] + Int4(2)) >> 2) + cache.c1[i];
+
+			e = (cache.planar & p) | (~cache.planar & e);
+			e = Min(Max(e, Int4(0)), Int4(0xFF));
+
+			if(punchThrough)
+			{
+				e &= ~(cache.nonOpaque & CmpEQ(index, Int4(2)));
+			}
+
+			c[i] = Short4((e << 8) | e);
+		}
+
+		if(punchThrough)
+		{
+			c.w = Short4(~(cache.nonOpaque & CmpEQ(index, Int4(2))));
+		}
+	}
+
+	Int4 SamplerCore::decodeEACTexel(int channel, Int4 &texel, bool eac11, bool isSigned)
+	{
+		BlockCache &cache = *blockCache;
+
+		// Texel k's 3-bit index starts at bit 45 - 3k of the 48 index bits
+		Int4 position = Int4(45) - ((texel << 1) + texel);
+		Int4 upper = CmpNLT(position, Int4(16));
+		Int4 bits = (upper & (cache.eacIndices[channel][0] >> ((position - Int4(16)) & Int4(31)))) |
+		            (~upper & (cache.eacIndices[channel][1] >> (position & Int4(31))));
+		Int4 index = bits & Int4(7);
+
+		Int4 modifierOffset = cache.eacRow[channel] + (index << 2);
+		Int4 modifier;
+
+		for(int i = 0; i < 4; i++)
+		{
+			modifier = Insert(modifier, *Pointer<Int>(constants + OFFSET(Constants,eacModifiers) + Extract(modifierOffset, i)), i);
+		}
+
+		Int4 value = cache.eacBase[channel] + modifier * cache.eacMultiplier[channel];
+
+		if(!eac11)
+		{
+			return Min(Max(value, Int4(0)), Int4(0xFF));
+		}
+
+		if(isSigned)
+		{
+			// Scale [-1023, 1023] to [-32767, 32767]
+			value = Min(Max(value, Int4(-1023)), Int4(1023));
+			Int4 magnitude = Abs(value);
+			magnitude = (magnitude << 5) | (magnitude >> 5);
+			Int4 negative = value >> 31;
+
+			return (magnitude ^ negative) - negative;
+		}
+
+		// Scale [0, 2047] to [0, 65535]
+		value = Min(Max(value, Int4(0)), Int4(2047));
+
+		return (value << 5) | (value >> 6);
+	}
+
+	Int4 SamplerCore::loadBlockWord(Pointer<Byte> block[4], int offset)
+	{
+		Int4 word;
+
+		for(int i = 0; i < 4; i++)
+		{
+			word = Insert(word, *Pointer<Int>(block[i] + offset), i);
+		}
+
+		// ETC blocks are stored most significant byte first
+		return ((word & Int4(0xFF)) << 24) | ((word & Int4(0xFF00)) << 8) | ((word >> 8) & Int4(0xFF00)) | ((word >> 24) & Int4(0xFF));
+	}
+
 	Vector4f SamplerCore::sampleTexel(Int4 &uuuu, Int4 &vvvv, Int4 &wwww, Float4 &z, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function)
 	{
 		Vector4f c;
@@ -2199,7 +2947,7 @@ namespace sw
 		}
 		else
 		{
-			ASSERT(!hasYuvFormat());
+			ASSERT(!hasYuvFormat() && !hasCompressedFormat());
 
 			Vector4s cs = sampleTexel(index, buffer);
 
@@ -2237,6 +2985,8 @@ namespace sw
 
 	void SamplerCore::selectMipmap(Pointer<Byte> &texture, Pointer<Byte> buffer[4], Pointer<Byte> &mipmap, Float &lod, Int face[4], bool secondLOD)
 	{
+		blockCacheValid = false;
+
 		if(state.mipmapFilter == MIPMAP_NONE)
 		{
 			mipmap = texture + OFFSET(Texture,mipmap[0]);
@@ -2296,6 +3046,16 @@ namespace sw
 		return filter;
 	}
 
+	UShort4 SamplerCore::mipmapSize(const Pointer<Byte> &mipmap, int whd)
+	{
+		if(state.powerOfTwo && whd != OFFSET(Mipmap, depth))
+		{
+			return UShort4(1 << ((whd == OFFSET(Mipmap, width)) ? state.log2Width : state.log2Height));
+		}
+
+		return *Pointer<UShort4>(mipmap + whd);
+	}
+
 	Short4 SamplerCore::address(Float4 &uw, AddressingMode addressingMode, Pointer<Byte> &mipmap)
 	{
 		if(addressingMode == ADDRESSING_LAYER && state.textureType != TEXTURE_2D_ARRAY)
@@ -2345,7 +3105,17 @@ namespace sw
 			return;   // Unused
 		}
 
-		Int4 dim = Int4(*Pointer<Short4>(mipmap + whd, 16));
+		Int4 dim;
+
+		if(state.powerOfTwo)
+		{
+			dim = Int4(1 << ((whd == OFFSET(Mipmap, width)) ? state.log2Width : state.log2Height));
+		}
+		else
+		{
+			dim = Int4(*Pointer<Short4>(mipmap + whd, 16));
+		}
+
 		Int4 maxXYZ = dim - Int4(1);
 
 		if(function == Fetch)
@@ -2466,8 +3236,16 @@ namespace sw
 					xyz1 = Min(Max(xyz1, Int4(0)), maxXYZ);
 					break;
 				default:   // Wrap
-					xyz0 = (xyz0 + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % dim;
-					xyz1 = (xyz1 + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % dim;
+					if(state.powerOfTwo)
+					{
+						xyz0 &= maxXYZ;
+						xyz1 &= maxXYZ;
+					}
+					else
+					{
+						xyz0 = (xyz0 + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % dim;
+						xyz1 = (xyz1 + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % dim;
+					}
 					break;
 				}
 			}
@@ -2485,6 +3263,12 @@ namespace sw
 					xyz1 = Min(xyz1, maxXYZ);
 					break;
 				default:   // Wrap
+					if(state.powerOfTwo)
+					{
+						xyz0 &= maxXYZ;   // Coordinates are at most one texel outside
+						xyz1 &= maxXYZ;
+					}
+					else
 					{
 						Int4 under = CmpLT(xyz0, Int4(0));
 						xyz0 = (under & maxXYZ) | (~under & xyz0);   // xyz < 0 ? dim - 1 : xyz   // FIXME: IfThenElse()
@@ -2663,6 +3447,22 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
 			return false;
 		default:
 			ASSERT(false);
@@ -2701,6 +3501,18 @@ namespace sw
 		case FORMAT_X8B8G8R8UI:
 		case FORMAT_A8B8G8R8I:
 		case FORMAT_A8B8G8R8UI:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
 			return true;
 		case FORMAT_R5G6B5:
 		case FORMAT_R32F:
@@ -2739,6 +3551,10 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
 			return false;
 		default:
 			ASSERT(false);
@@ -2800,6 +3616,18 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
 			return false;
 		case FORMAT_L16:
 		case FORMAT_G16R16:
@@ -2815,6 +3643,10 @@ namespace sw
 		case FORMAT_V16U16:
 		case FORMAT_A16W16V16U16:
 		case FORMAT_Q16W16V16U16:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
 			return true;
 		default:
 			ASSERT(false);
@@ -2882,6 +3714,22 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
 			return false;
 		case FORMAT_R32I:
 		case FORMAT_R32UI:
@@ -2907,6 +3755,22 @@ namespace sw
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
 			return true;
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
 		case FORMAT_R5G6B5:
 		case FORMAT_R8_SNORM:
 		case FORMAT_G8R8_SNORM:
@@ -2975,6 +3839,53 @@ namespace sw
 		return false;
 	}
 
+	bool SamplerCore::hasCompressedFormat() const
+	{
+		switch(state.textureFormat)
+		{
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ATI1:
+		case FORMAT_ATI2:
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool SamplerCore::hasETCFormat() const
+	{
+		switch(state.textureFormat)
+		{
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:
+		case FORMAT_SRGB8_ETC2:
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case FORMAT_RGBA8_ETC2_EAC:
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:
+		case FORMAT_R11_EAC:
+		case FORMAT_SIGNED_R11_EAC:
+		case FORMAT_RG11_EAC:
+		case FORMAT_SIGNED_RG11_EAC:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	bool SamplerCore::isRGBComponent(int component) const
 	{
 		switch(state.textureFormat)
@@ -3042,10 +3953,35 @@ namespace sw
 		case FORMAT_YV12_BT601:     return component < 3;
 		case FORMAT_YV12_BT709:     return component < 3;
 		case FORMAT_YV12_JFIF:      return component < 3;
+		case FORMAT_DXT1:           return component < 3;
+		case FORMAT_DXT3:           return component < 3;
+		case FORMAT_DXT5:           return component < 3;
+		case FORMAT_ATI1:           return component < 1;
+		case FORMAT_ATI2:           return component < 2;
+		case FORMAT_ETC1:           return component < 3;
+		case FORMAT_RGB8_ETC2:      return component < 3;
+		case FORMAT_SRGB8_ETC2:     return component < 3;
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2: return component < 3;
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: return component < 3;
+		case FORMAT_RGBA8_ETC2_EAC: return component < 3;
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC: return component < 3;
+		case FORMAT_R11_EAC:        return component < 1;
+		case FORMAT_SIGNED_R11_EAC: return component < 1;
+		case FORMAT_RG11_EAC:       return component < 2;
+		case FORMAT_SIGNED_RG11_EAC: return component < 2;
 		default:
 			ASSERT(false);
 		}
 
 		return false;
 	}
+
+	bool SamplerCore::requiresLod() const
+	{
+		// A single level is sampled with a single filter, unless minification and magnification differ
+		return state.mipmapFilter != MIPMAP_NONE ||
+		       state.textureFilter == FILTER_MIN_POINT_MAG_LINEAR ||
+		       state.textureFilter == FILTER_MIN_LINEAR_MAG_POINT ||
+		       state.textureFilter == FILTER_ANISOTROPIC;
+	}
 }
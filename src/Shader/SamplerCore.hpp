@@ -49,6 +49,7 @@ namespace sw
 	{
 	public:
 		SamplerCore(Pointer<Byte> &constants, const Sampler::State &state);
+		~SamplerCore();
 
 		Vector4s sampleTexture(Pointer<Byte> &texture, Float4 &u, Float4 &v, Float4 &w, Float4 &q, Float4 &bias, Vector4f &dsx, Vector4f &dsy);
 		Vector4f sampleTexture(Pointer<Byte> &texture, Float4 &u, Float4 &v, Float4 &w, Float4 &q, Float4 &bias, Vector4f &dsx, Vector4f &dsy, Vector4f &offset, SamplerFunction function);
@@ -79,13 +80,26 @@ namespace sw
 		Short4 applyOffset(Short4 &uvw, Float4 &offset, const Int4 &whd, AddressingMode mode);
 		void computeIndices(UInt index[4], Short4 uuuu, Short4 vvvv, Short4 wwww, Vector4f &offset, const Pointer<Byte> &mipmap, SamplerFunction function);
 		void computeIndices(UInt index[4], Int4& uuuu, Int4& vvvv, Int4& wwww, const Pointer<Byte> &mipmap, SamplerFunction function);
+		Int4 tiledColumn(Int4 x);   // See Surface::tiledColumn()
+		Int4 tiledRow(Int4 y, Int4 pitchP);
 		Vector4s sampleTexel(Short4 &u, Short4 &v, Short4 &s, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function);
 		Vector4s sampleTexel(UInt index[4], Pointer<Byte> buffer[4]);
 		Vector4f sampleTexel(Int4 &u, Int4 &v, Int4 &s, Float4 &z, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function);
+		Vector4s sampleCompressedTexel(Short4 &u, Short4 &v, Short4 &s, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function);
+		void decodeColorBlock(Vector4s &c, Pointer<Byte> block[4], int blockOffset, Int4 &texel, bool punchThrough);
+		Int4 decodeAlphaBlock(Pointer<Byte> block[4], int blockOffset, Int4 &texel);
+		void sampleETCTexel(Vector4s &c, Pointer<Byte> block[4], Int4 &blockOffset, Int4 &texel);
+		void decodeETCHeaders(Pointer<Byte> block[4], Int4 &blockOffset);
+		void decodeETC2Header(Pointer<Byte> block[4], int blockOffset, bool punchThrough);
+		void decodeEACHeader(Pointer<Byte> block[4], int blockOffset, int channel, bool eac11, bool isSigned);
+		void decodeETC2Texel(Vector4s &c, Int4 &texel, bool punchThrough);
+		Int4 decodeEACTexel(int channel, Int4 &texel, bool eac11, bool isSigned);
+		Int4 loadBlockWord(Pointer<Byte> block[4], int offset);
 		void selectMipmap(Pointer<Byte> &texture, Pointer<Byte> buffer[4], Pointer<Byte> &mipmap, Float &lod, Int face[4], bool secondLOD);
 		Short4 address(Float4 &uw, AddressingMode addressingMode, Pointer<Byte>& mipmap);
 		void address(Float4 &uw, Int4& xyz0, Int4& xyz1, Float4& f, Pointer<Byte>& mipmap, Float4 &texOffset, Int4 &filter, int whd, AddressingMode addressingMode, SamplerFunction function);
 		Int4 computeFilterOffset(Float &lod);
+		UShort4 mipmapSize(const Pointer<Byte> &mipmap, int whd);
 
 		void convertFixed12(Short4 &ci, Float4 &cf);
 		void convertFixed12(Vector4s &cs, Vector4f &cf);
@@ -106,10 +120,38 @@ namespace sw
 		bool has16bitTextureComponents() const;
 		bool has32bitIntegerTextureComponents() const;
 		bool hasYuvFormat() const;
+		bool hasCompressedFormat() const;
+		bool hasETCFormat() const;
 		bool isRGBComponent(int component) const;
+		bool requiresLod() const;
 
 		Pointer<Byte> &constants;
 		const Sampler::State &state;
+
+		// Decoded headers of the ETC2 and EAC blocks last fetched by each lane.
+		// Filter taps mostly stay within the blocks of the previous tap.
+		struct BlockCache
+		{
+			Int4 offset;
+
+			Int4 indices;
+			Int4 flip;
+			Int4 secondBase;   // Bit per sub-block and index, selecting c2 over c1
+			Int4 row[2];       // Modifier table row per sub-block
+			Int4 c1[3];        // Planar mode origin
+			Int4 c2[3];        // Planar mode horizontal gradient
+			Int4 v[3];         // Planar mode vertical gradient
+			Int4 planar;
+			Int4 nonOpaque;
+
+			Int4 eacBase[2];
+			Int4 eacMultiplier[2];
+			Int4 eacRow[2];
+			Int4 eacIndices[2][2];
+		};
+
+		BlockCache *blockCache;
+		bool blockCacheValid;   // Cleared when a new mipmap level is selected
 	};
 }
 
@@ -197,82 +197,79 @@ namespace sw
 			yMin = Max(yMin, *Pointer<Int>(data + OFFSET(DrawData,scissorY0)));
 			yMax = Min(yMax, *Pointer<Int>(data + OFFSET(DrawData,scissorY1)));
 
-			For(Int q = 0, q < state.multiSample, q++)
-			{
-				Array<Int> Xq(16);
-				Array<Int> Yq(16);
+			X[n] = X[0];
+			Y[n] = Y[0];
 
-				Int i = 0;
+			if(state.multiSample == 1)
+			{
+				Pointer<Byte> leftEdge = primitive + OFFSET(Primitive,outline->left);
+				Pointer<Byte> rightEdge = primitive + OFFSET(Primitive,outline->right);
 
-				Do
+				// Rasterize
 				{
-					Xq[i] = X[i];
-					Yq[i] = Y[i];
+					Int i = 0;
 
-					if(state.multiSample > 1)
+					Do
 					{
-						Xq[i] = Xq[i] + *Pointer<Int>(constants + OFFSET(Constants,Xf) + q * sizeof(int));
-						Yq[i] = Yq[i] + *Pointer<Int>(constants + OFFSET(Constants,Yf) + q * sizeof(int));
+						edge(primitive, data, X[i + 1 - d], Y[i + 1 - d], X[i + d], Y[i + d]);
+
+						i++;
 					}
+					Until(i >= n)
+				}
 
-					i++;
+				For(, yMin < yMax && *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + yMin * sizeof(Primitive::Span)), yMin++)
+				{
+					// Increments yMin
 				}
-				Until(i >= n)
 
-				Pointer<Byte> leftEdge = Pointer<Byte>(primitive + OFFSET(Primitive,outline->left)) + q * sizeof(Primitive);
-				Pointer<Byte> rightEdge = Pointer<Byte>(primitive + OFFSET(Primitive,outline->right)) + q * sizeof(Primitive);
+				For(, yMax > yMin && *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + (yMax - 1) * sizeof(Primitive::Span)), yMax--)
+				{
+					// Decrements yMax
+				}
+
+				If(yMin == yMax)
+				{
+					Return(false);
+				}
+
+				*Pointer<Short>(leftEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
+				*Pointer<Short>(rightEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
+				*Pointer<Short>(leftEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
+				*Pointer<Short>(rightEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
+			}
+			else
+			{
+				// Rows hold the left edges of all samples, followed by their right edges
+				Pointer<Byte> outline = primitive + OFFSET(Primitive,outline);
+				const int pitch = state.multiSample * sizeof(Primitive::Span);
+
+				Int xMin = *Pointer<Int>(data + OFFSET(DrawData,scissorX0));
+				Int xMax = *Pointer<Int>(data + OFFSET(DrawData,scissorX1));
+				Short4 x = Short4(Clamp((X[0] + 0xF) >> 4, xMin, xMax));
 
-				if(state.multiSample > 1)
+				For(Int y = yMin - 1, y < yMax + 1, y++)
 				{
-					Int xMin = *Pointer<Int>(data + OFFSET(DrawData, scissorX0));
-					Int xMax = *Pointer<Int>(data + OFFSET(DrawData, scissorX1));
-					Short x = Short(Clamp((X[0] + 0xF) >> 4, xMin, xMax));
+					*Pointer<Short4>(outline + y * pitch) = x;
 
-					For(Int y = yMin - 1, y < yMax + 1, y++)
+					if(state.multiSample == 4)
 					{
-						*Pointer<Short>(leftEdge + y * sizeof(Primitive::Span)) = x;
-						*Pointer<Short>(rightEdge + y * sizeof(Primitive::Span)) = x;
+						*Pointer<Short4>(outline + y * pitch + 8) = x;
 					}
 				}
 
-				Xq[n] = Xq[0];
-				Yq[n] = Yq[0];
-
 				// Rasterize
 				{
 					Int i = 0;
 
 					Do
 					{
-						edge(primitive, data, Xq[i + 1 - d], Yq[i + 1 - d], Xq[i + d], Yq[i + d], q);
+						multisampleEdge(primitive, data, constants, X[i + 1 - d], Y[i + 1 - d], X[i + d], Y[i + d]);
 
 						i++;
 					}
 					Until(i >= n)
 				}
-
-				if(state.multiSample == 1)
-				{
-					For(, yMin < yMax && *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + yMin * sizeof(Primitive::Span)), yMin++)
-					{
-						// Increments yMin
-					}
-
-					For(, yMax > yMin && *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + (yMax - 1) * sizeof(Primitive::Span)), yMax--)
-					{
-						// Decrements yMax
-					}
-
-					If(yMin == yMax)
-					{
-						Return(false);
-					}
-
-					*Pointer<Short>(leftEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
-					*Pointer<Short>(rightEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
-					*Pointer<Short>(leftEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
-					*Pointer<Short>(rightEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
-				}
 			}
 
 			*Pointer<Int>(primitive + OFFSET(Primitive,yMin)) = yMin;
@@ -476,7 +473,7 @@ namespace sw
 			Return(true);
 		}
 
-		routine = function(L"SetupRoutine");
+		routine = function(L"SetupRoutine_%0.8X", state.hash);
 	}
 
 	void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool sprite, bool perspective, bool wrap, int component)
@@ -557,7 +554,7 @@ namespace sw
 		}
 	}
 
-	void SetupRoutine::edge(Pointer<Byte> &primitive, Pointer<Byte> &data, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb, Int &q)
+	void SetupRoutine::edge(Pointer<Byte> &primitive, Pointer<Byte> &data, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb)
 	{
 		If(Ya != Yb)
 		{
@@ -576,8 +573,8 @@ namespace sw
 				Int xMin = *Pointer<Int>(data + OFFSET(DrawData,scissorX0));
 				Int xMax = *Pointer<Int>(data + OFFSET(DrawData,scissorX1));
 
-				Pointer<Byte> leftEdge = primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left);
-				Pointer<Byte> rightEdge = primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right);
+				Pointer<Byte> leftEdge = primitive + OFFSET(Primitive,outline->left);
+				Pointer<Byte> rightEdge = primitive + OFFSET(Primitive,outline->right);
 				Pointer<Byte> edge = IfThenElse(swap, rightEdge, leftEdge);
 
 				// Deltas
@@ -622,6 +619,92 @@ namespace sw
 		}
 	}
 
+	void SetupRoutine::multisampleEdge(Pointer<Byte> &primitive, Pointer<Byte> &data, Pointer<Byte> &constants, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb)
+	{
+		If(Ya != Yb)
+		{
+			Bool swap = Yb < Ya;
+
+			Int X1 = IfThenElse(swap, Xb, Xa);
+			Int X2 = IfThenElse(swap, Xa, Xb);
+			Int Y1 = IfThenElse(swap, Yb, Ya);
+			Int Y2 = IfThenElse(swap, Ya, Yb);
+
+			// Each lane walks the edge as seen from one sample position
+			Int4 X1q = Int4(X1) + *Pointer<Int4>(constants + OFFSET(Constants,Xf));
+			Int4 Y1q = Int4(Y1) + *Pointer<Int4>(constants + OFFSET(Constants,Yf));
+			Int4 Y2q = Int4(Y2) + *Pointer<Int4>(constants + OFFSET(Constants,Yf));
+
+			Int4 y1 = Max((Y1q + Int4(0x0000000F)) >> 4, Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorY0))));
+			Int4 y2 = Min((Y2q + Int4(0x0000000F)) >> 4, Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorY1))));
+
+			Int yFirst = Extract(y1, 0);
+			Int yLast = Extract(y2, 0);
+
+			for(int q = 1; q < state.multiSample; q++)
+			{
+				yFirst = Min(yFirst, Extract(y1, q));
+				yLast = Max(yLast, Extract(y2, q));
+			}
+
+			If(yFirst < yLast)
+			{
+				Int4 xMin = Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorX0)));
+				Int4 xMax = Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorX1)));
+
+				const int pitch = state.multiSample * sizeof(Primitive::Span);
+				Pointer<Byte> leftEdge = primitive + OFFSET(Primitive,outline);
+				Pointer<Byte> rightEdge = primitive + OFFSET(Primitive,outline) + state.multiSample * sizeof(unsigned short);
+				Pointer<Byte> edge = IfThenElse(swap, rightEdge, leftEdge);
+
+				// Deltas
+				Int DX12 = X2 - X1;
+				Int DY12 = Y2 - Y1;
+
+				Int FDX12 = DX12 << 4;
+				Int FDY12 = DY12 << 4;
+
+				Int4 X = Int4(DX12) * (Int4(yFirst << 4) - Y1q) + (X1q & Int4(0x0000000F)) * Int4(DY12);
+				Int4 x = (X1q >> 4) + X / Int4(FDY12);   // Edge
+				Int4 d = X % Int4(FDY12);                // Error-term
+				Int4 ceil = -d >> 31;                    // Ceiling division: remainder <= 0
+				x -= ceil;
+				d -= ceil & Int4(FDY12);
+
+				Int Q = FDX12 / FDY12;   // Edge-step
+				Int R = FDX12 % FDY12;   // Error-step
+				Int floor = R >> 31;     // Flooring division: remainder >= 0
+				Q += floor;
+				R += floor & FDY12;
+
+				Int D = FDY12;   // Error-overflow
+				Int y = yFirst;
+
+				Int4 samples = (state.multiSample == 4) ? Int4(-1, -1, -1, -1) : Int4(-1, -1, 0, 0);
+
+				Do
+				{
+					// Only lanes whose sample crosses this row are written
+					Short4 mask = Short4(CmpNLT(Int4(y), y1) & CmpLT(Int4(y), y2) & samples);
+					Short4 span = *Pointer<Short4>(edge + y * pitch);
+
+					*Pointer<Short4>(edge + y * pitch) = (Short4(Min(Max(x, xMin), xMax)) & mask) | (span & ~mask);
+
+					x += Int4(Q);
+					d += Int4(R);
+
+					Int4 overflow = -d >> 31;
+
+					d -= Int4(D) & overflow;
+					x -= overflow;
+
+					y++;
+				}
+				Until(y >= yLast)
+			}
+		}
+	}
+
 	void SetupRoutine::conditionalRotate1(Bool condition, Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2)
 	{
 		#if 0   // Rely on LLVM optimization
@@ -19,6 +19,7 @@
 #include "Common/Math.hpp"
 #include "Common/Debug.hpp"
 
+#include <algorithm>
 #include <set>
 #include <fstream>
 #include <sstream>
@@ -28,6 +29,104 @@ namespace sw
 {
 	volatile int Shader::serialCounter = 1;
 
+	namespace
+	{
+		struct TemporaryReads
+		{
+			TemporaryReads() : count(0), mask(0)
+			{
+			}
+
+			int count;
+			unsigned char mask;
+		};
+
+		bool isRelativeTemporary(const Shader::Parameter &parameter)
+		{
+			// Literals and labels share storage with the relative addressing fields
+			return parameter.type != Shader::PARAMETER_FLOAT4LITERAL &&
+			       parameter.type != Shader::PARAMETER_LABEL &&
+			       parameter.rel.type == Shader::PARAMETER_TEMP;
+		}
+
+		void markRead(std::vector<TemporaryReads> &reads, unsigned int index, unsigned char mask)
+		{
+			if(index >= reads.size())
+			{
+				reads.resize(index + 1);
+			}
+
+			reads[index].count++;
+			reads[index].mask |= mask;
+		}
+
+		std::vector<TemporaryReads> gatherTemporaryReads(const std::vector<Shader::Instruction*> &instruction)
+		{
+			std::vector<TemporaryReads> reads;
+
+			for(const auto &inst : instruction)
+			{
+				if(inst->opcode == Shader::OPCODE_NULL)
+				{
+					continue;
+				}
+
+				if(isRelativeTemporary(inst->dst))
+				{
+					markRead(reads, inst->dst.rel.index, 0xF);
+				}
+
+				if(inst->dst.type == Shader::PARAMETER_TEMP && !inst->isPure())
+				{
+					markRead(reads, inst->dst.index, 0xF);   // E.g. texkill takes its destination as input
+				}
+
+				for(int i = 0; i < 5; i++)
+				{
+					const Shader::SourceParameter &src = inst->src[i];
+
+					if(isRelativeTemporary(src))
+					{
+						markRead(reads, src.rel.index, 0xF);
+					}
+
+					if(src.type == Shader::PARAMETER_TEMP)
+					{
+						if(i == 1 && inst->isMatrix())   // Reads consecutive rows
+						{
+							for(unsigned int row = 0; row < 4; row++)
+							{
+								markRead(reads, src.index + row, 0xF);
+							}
+						}
+						else
+						{
+							markRead(reads, src.index, inst->sourceMask(i));
+						}
+					}
+				}
+			}
+
+			return reads;
+		}
+
+		void markLiveRange(std::vector<int> &first, std::vector<int> &last, unsigned int index, int position)
+		{
+			if(index >= first.size())
+			{
+				first.resize(index + 1, -1);
+				last.resize(index + 1, -1);
+			}
+
+			if(first[index] == -1)
+			{
+				first[index] = position;
+			}
+
+			last[index] = position;
+		}
+	}
+
 	Shader::Opcode Shader::OPCODE_DP(int i)
 	{
 		switch(i)
@@ -1120,6 +1219,11 @@ namespace sw
 		return opcode == OPCODE_ENDLOOP || opcode == OPCODE_ENDREP || opcode == OPCODE_ENDWHILE;
 	}
 
+	bool Shader::Instruction::isMatrix() const
+	{
+		return opcode == OPCODE_M3X2 || opcode == OPCODE_M3X3 || opcode == OPCODE_M3X4 || opcode == OPCODE_M4X3 || opcode == OPCODE_M4X4;
+	}
+
 	bool Shader::Instruction::isPredicated() const
 	{
 		return predicate ||
@@ -1129,9 +1233,210 @@ namespace sw
 		       analysisLeave;
 	}
 
+	// Each component of the result only depends on the same component of the sources
+	bool Shader::Instruction::isComponentwise() const
+	{
+		switch(opcode)
+		{
+		case OPCODE_MOV:
+		case OPCODE_NEG:
+		case OPCODE_INEG:
+		case OPCODE_ABS:
+		case OPCODE_IABS:
+		case OPCODE_SGN:
+		case OPCODE_ISGN:
+		case OPCODE_ADD:
+		case OPCODE_IADD:
+		case OPCODE_SUB:
+		case OPCODE_ISUB:
+		case OPCODE_MUL:
+		case OPCODE_IMUL:
+		case OPCODE_MAD:
+		case OPCODE_IMAD:
+		case OPCODE_DIV:
+		case OPCODE_IDIV:
+		case OPCODE_UDIV:
+		case OPCODE_MOD:
+		case OPCODE_IMOD:
+		case OPCODE_UMOD:
+		case OPCODE_MIN:
+		case OPCODE_IMIN:
+		case OPCODE_UMIN:
+		case OPCODE_MAX:
+		case OPCODE_IMAX:
+		case OPCODE_UMAX:
+		case OPCODE_SHL:
+		case OPCODE_ISHR:
+		case OPCODE_USHR:
+		case OPCODE_NOT:
+		case OPCODE_OR:
+		case OPCODE_XOR:
+		case OPCODE_AND:
+		case OPCODE_F2B:
+		case OPCODE_B2F:
+		case OPCODE_F2I:
+		case OPCODE_I2F:
+		case OPCODE_F2U:
+		case OPCODE_U2F:
+		case OPCODE_I2B:
+		case OPCODE_B2I:
+		case OPCODE_FLOATBITSTOINT:
+		case OPCODE_FLOATBITSTOUINT:
+		case OPCODE_INTBITSTOFLOAT:
+		case OPCODE_UINTBITSTOFLOAT:
+		case OPCODE_FRC:
+		case OPCODE_TRUNC:
+		case OPCODE_FLOOR:
+		case OPCODE_ROUND:
+		case OPCODE_ROUNDEVEN:
+		case OPCODE_CEIL:
+		case OPCODE_SQRT:
+		case OPCODE_RSQ:
+		case OPCODE_EXP2:
+		case OPCODE_LOG2:
+		case OPCODE_EXP:
+		case OPCODE_LOG:
+		case OPCODE_POW:
+		case OPCODE_SIN:
+		case OPCODE_COS:
+		case OPCODE_TAN:
+		case OPCODE_ASIN:
+		case OPCODE_ACOS:
+		case OPCODE_ATAN:
+		case OPCODE_ATAN2:
+		case OPCODE_SINH:
+		case OPCODE_COSH:
+		case OPCODE_TANH:
+		case OPCODE_ASINH:
+		case OPCODE_ACOSH:
+		case OPCODE_ATANH:
+		case OPCODE_STEP:
+		case OPCODE_SMOOTH:
+		case OPCODE_LRP:
+		case OPCODE_CMP:
+		case OPCODE_ICMP:
+		case OPCODE_UCMP:
+		case OPCODE_SELECT:
+		case OPCODE_ISNAN:
+		case OPCODE_ISINF:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Has no effect other than writing the destination register
+	bool Shader::Instruction::isPure() const
+	{
+		if(isComponentwise() || isMatrix())
+		{
+			return true;
+		}
+
+		switch(opcode)
+		{
+		case OPCODE_SLT:
+		case OPCODE_SGE:
+		case OPCODE_RCPX:
+		case OPCODE_RSQX:
+		case OPCODE_EXP2X:
+		case OPCODE_LOG2X:
+		case OPCODE_POWX:
+		case OPCODE_EXPP:
+		case OPCODE_LOGP:
+		case OPCODE_LIT:
+		case OPCODE_CRS:
+		case OPCODE_DP1:
+		case OPCODE_DP2:
+		case OPCODE_DP3:
+		case OPCODE_DP4:
+		case OPCODE_DET2:
+		case OPCODE_DET3:
+		case OPCODE_DET4:
+		case OPCODE_NRM2:
+		case OPCODE_NRM3:
+		case OPCODE_NRM4:
+		case OPCODE_LEN2:
+		case OPCODE_LEN3:
+		case OPCODE_LEN4:
+		case OPCODE_DIST1:
+		case OPCODE_DIST2:
+		case OPCODE_DIST3:
+		case OPCODE_DIST4:
+		case OPCODE_FORWARD1:
+		case OPCODE_FORWARD2:
+		case OPCODE_FORWARD3:
+		case OPCODE_FORWARD4:
+		case OPCODE_REFLECT1:
+		case OPCODE_REFLECT2:
+		case OPCODE_REFLECT3:
+		case OPCODE_REFLECT4:
+		case OPCODE_REFRACT1:
+		case OPCODE_REFRACT2:
+		case OPCODE_REFRACT3:
+		case OPCODE_REFRACT4:
+		case OPCODE_ALL:
+		case OPCODE_ANY:
+		case OPCODE_EQ:
+		case OPCODE_NE:
+		case OPCODE_EXTRACT:
+		case OPCODE_INSERT:
+		case OPCODE_PACKSNORM2x16:
+		case OPCODE_PACKUNORM2x16:
+		case OPCODE_PACKHALF2x16:
+		case OPCODE_UNPACKSNORM2x16:
+		case OPCODE_UNPACKUNORM2x16:
+		case OPCODE_UNPACKHALF2x16:
+		case OPCODE_DFDX:
+		case OPCODE_DFDY:
+		case OPCODE_FWIDTH:
+		case OPCODE_TEX:
+		case OPCODE_TEXLDD:
+		case OPCODE_TEXLDL:
+		case OPCODE_TEXBIAS:
+		case OPCODE_TEXLOD:
+		case OPCODE_TEXOFFSET:
+		case OPCODE_TEXOFFSETBIAS:
+		case OPCODE_TEXLODOFFSET:
+		case OPCODE_TEXELFETCH:
+		case OPCODE_TEXELFETCHOFFSET:
+		case OPCODE_TEXGRAD:
+		case OPCODE_TEXGRADOFFSET:
+		case OPCODE_TEXSIZE:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Components of source register i which can affect the result
+	unsigned char Shader::Instruction::sourceMask(int i) const
+	{
+		if(!isPure())
+		{
+			return 0xF;
+		}
+
+		int components = isComponentwise() ? dst.mask : 0xF;
+		unsigned char mask = 0;
+
+		for(int c = 0; c < 4; c++)
+		{
+			if(components & (1 << c))
+			{
+				mask |= 1 << ((src[i].swizzle >> (2 * c)) & 0x3);
+			}
+		}
+
+		return mask;
+	}
+
 	Shader::Shader() : serialID(serialCounter++)
 	{
 		usedSamplers = 0;
+		temporaryCount = NUM_TEMPORARY_REGISTERS;
+		specializations = 0;
+		samplerSpecializations = 0;
 	}
 
 	Shader::~Shader()
@@ -1393,6 +1698,11 @@ namespace sw
 		return false;
 	}
 
+	unsigned int Shader::getTemporaryCount() const
+	{
+		return temporaryCount;
+	}
+
 	bool Shader::containsDynamicBranching() const
 	{
 		return dynamicBranching;
@@ -1418,6 +1728,58 @@ namespace sw
 		return containsDefine;
 	}
 
+	int Shader::getUniformConditionCount() const
+	{
+		return (int)uniformConditions.size();
+	}
+
+	const Shader::UniformCondition &Shader::getUniformCondition(int i) const
+	{
+		return uniformConditions[i];
+	}
+
+	int Shader::findUniformCondition(const SourceParameter &src) const
+	{
+		if(src.rel.type != PARAMETER_VOID || src.bufferIndex != -1 || (src.type == PARAMETER_CONST && src.modifier != MODIFIER_NONE))
+		{
+			return -1;
+		}
+
+		unsigned int component = (src.type == PARAMETER_CONST) ? (src.swizzle & 0x3) : 0;
+
+		for(size_t i = 0; i < uniformConditions.size(); i++)
+		{
+			const UniformCondition &condition = uniformConditions[i];
+
+			if(condition.type == src.type && condition.index == src.index && condition.component == component)
+			{
+				return (int)i;
+			}
+		}
+
+		return -1;
+	}
+
+	int Shader::getSpecializationCount() const
+	{
+		return specializations;
+	}
+
+	void Shader::countSpecialization() const
+	{
+		specializations++;
+	}
+
+	int Shader::getSamplerSpecializationCount() const
+	{
+		return samplerSpecializations;
+	}
+
+	void Shader::countSamplerSpecialization() const
+	{
+		samplerSpecializations++;
+	}
+
 	bool Shader::usesSampler(int index) const
 	{
 		return (usedSamplers & (1 << index)) != 0;
@@ -1491,7 +1853,21 @@ namespace sw
 	{
 		optimizeLeave();
 		optimizeCall();
+
+		if(optimizableTemporaries())
+		{
+			do
+			{
+				propagateCopies();
+			}
+			while(foldConstants());
+
+			forwardResults();
+			removeDeadCode();
+		}
+
 		removeNull();
+		renumberTemporaries();
 	}
 
 	void Shader::optimizeLeave()
@@ -1591,6 +1967,503 @@ namespace sw
 		instruction.resize(size);
 	}
 
+	bool Shader::optimizableTemporaries() const
+	{
+		// Shader model 1.x uses temporaries as outputs, and relative addressing makes any temporary a potential operand
+		if(shaderModel < 0x0300)
+		{
+			return false;
+		}
+
+		for(const auto &inst : instruction)
+		{
+			if(inst->dst.type == PARAMETER_TEMP && inst->dst.rel.type != PARAMETER_VOID)
+			{
+				return false;
+			}
+
+			for(int i = 0; i < 5; i++)
+			{
+				if(inst->src[i].type == PARAMETER_TEMP && inst->src[i].rel.type != PARAMETER_VOID)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool Shader::foldConstants()
+	{
+		// Evaluate arithmetic on literal operands, leaving a move of the result
+		bool progress = false;
+
+		for(auto &inst : instruction)
+		{
+			const DestinationParameter &dst = inst->dst;
+
+			if(inst->predicate || dst.saturate || dst.shift != 0)
+			{
+				continue;
+			}
+
+			if(dst.type != PARAMETER_TEMP && dst.type != PARAMETER_OUTPUT && dst.type != PARAMETER_COLOROUT)
+			{
+				continue;
+			}
+
+			int sources = 0;
+			bool integer = false;
+
+			switch(inst->opcode)
+			{
+			case OPCODE_MOV:
+			case OPCODE_NEG:
+			case OPCODE_ABS:  sources = 1;                 break;
+			case OPCODE_ADD:
+			case OPCODE_SUB:
+			case OPCODE_MUL:  sources = 2;                 break;
+			case OPCODE_MAD:  sources = 3;                 break;
+			case OPCODE_INEG:
+			case OPCODE_NOT:  sources = 1; integer = true; break;
+			case OPCODE_IADD:
+			case OPCODE_ISUB:
+			case OPCODE_IMUL:
+			case OPCODE_AND:
+			case OPCODE_OR:
+			case OPCODE_XOR:  sources = 2; integer = true; break;
+			default:
+				continue;
+			}
+
+			if(inst->opcode == OPCODE_MOV && inst->src[0].swizzle == 0xE4 && inst->src[0].modifier == MODIFIER_NONE)
+			{
+				continue;   // Already folded
+			}
+
+			union
+			{
+				float f[4];
+				unsigned int u[4];
+			} operand[3] = {};
+
+			bool literal = true;
+
+			for(int i = 0; i < sources; i++)
+			{
+				const SourceParameter &src = inst->src[i];
+				Modifier modifier = src.modifier;
+
+				if(src.type != PARAMETER_FLOAT4LITERAL ||
+				   (integer && modifier != MODIFIER_NONE) ||
+				   (!integer && modifier != MODIFIER_NONE && modifier != MODIFIER_NEGATE && modifier != MODIFIER_ABS && modifier != MODIFIER_ABS_NEGATE))
+				{
+					literal = false;
+					break;
+				}
+
+				for(int c = 0; c < 4; c++)
+				{
+					operand[i].f[c] = src.value[(src.swizzle >> (2 * c)) & 0x3];
+
+					if(modifier == MODIFIER_ABS || modifier == MODIFIER_ABS_NEGATE) operand[i].f[c] = fabsf(operand[i].f[c]);
+					if(modifier == MODIFIER_NEGATE || modifier == MODIFIER_ABS_NEGATE) operand[i].f[c] = -operand[i].f[c];
+				}
+			}
+
+			if(!literal)
+			{
+				continue;
+			}
+
+			SourceParameter result;
+			result.type = PARAMETER_FLOAT4LITERAL;
+
+			for(int c = 0; c < 4; c++)
+			{
+				const float a = operand[0].f[c], b = operand[1].f[c], d = operand[2].f[c];
+				const unsigned int x = operand[0].u[c], y = operand[1].u[c];
+				float product;
+
+				switch(inst->opcode)
+				{
+				case OPCODE_MOV:  result.value[c] = a;                                   break;
+				case OPCODE_NEG:  result.value[c] = -a;                                  break;
+				case OPCODE_ABS:  result.value[c] = fabsf(a);                            break;
+				case OPCODE_ADD:  result.value[c] = a + b;                               break;
+				case OPCODE_SUB:  result.value[c] = a - b;                               break;
+				case OPCODE_MUL:  result.value[c] = a * b;                               break;
+				case OPCODE_MAD:  product = a * b; result.value[c] = product + d;        break;   // Not fused
+				case OPCODE_INEG: result.integer[c] = (int)(0u - x);                     break;
+				case OPCODE_NOT:  result.integer[c] = (int)~x;                           break;
+				case OPCODE_IADD: result.integer[c] = (int)(x + y);                      break;
+				case OPCODE_ISUB: result.integer[c] = (int)(x - y);                      break;
+				case OPCODE_IMUL: result.integer[c] = (int)(x * y);                      break;
+				case OPCODE_AND:  result.integer[c] = (int)(x & y);                      break;
+				case OPCODE_OR:   result.integer[c] = (int)(x | y);                      break;
+				case OPCODE_XOR:  result.integer[c] = (int)(x ^ y);                      break;
+				default:
+					ASSERT(false);
+				}
+			}
+
+			inst->opcode = OPCODE_MOV;
+			inst->src[0] = result;
+			inst->src[1] = SourceParameter();
+			inst->src[2] = SourceParameter();
+
+			progress = true;
+		}
+
+		return progress;
+	}
+
+	void Shader::propagateCopies()
+	{
+		// Within a basic block, replace reads of a moved temporary with the move's source
+		struct Copy
+		{
+			unsigned int index;
+			unsigned char mask;
+			SourceParameter source;
+		};
+
+		std::vector<Copy> copies;
+
+		for(auto &inst : instruction)
+		{
+			if(inst->opcode == OPCODE_NULL)
+			{
+				continue;
+			}
+
+			if(!inst->isPure())
+			{
+				copies.clear();   // Control flow or side effects
+				continue;
+			}
+
+			// Texture sampling and derivatives depend on neighboring pixels, which may have been masked out of the move
+			bool rewritable = inst->isComponentwise() || !(inst->isMatrix() || inst->src[1].type == PARAMETER_SAMPLER ||
+			                  inst->opcode == OPCODE_DFDX || inst->opcode == OPCODE_DFDY || inst->opcode == OPCODE_FWIDTH);
+
+			for(int i = 0; i < 5 && rewritable; i++)
+			{
+				SourceParameter &src = inst->src[i];
+
+				if(src.type != PARAMETER_TEMP)
+				{
+					continue;
+				}
+
+				for(const auto &copy : copies)
+				{
+					if(copy.index == src.index)
+					{
+						if((inst->sourceMask(i) & ~copy.mask) == 0)
+						{
+							unsigned int swizzle = 0;
+
+							for(int c = 0; c < 4; c++)
+							{
+								int component = (src.swizzle >> (2 * c)) & 0x3;
+								swizzle |= ((copy.source.swizzle >> (2 * component)) & 0x3) << (2 * c);
+							}
+
+							Modifier modifier = src.modifier;
+							src = copy.source;
+							src.swizzle = swizzle;
+							src.modifier = modifier;
+						}
+
+						break;
+					}
+				}
+			}
+
+			const DestinationParameter &dst = inst->dst;
+
+			if(dst.type == PARAMETER_TEMP)
+			{
+				for(size_t i = 0; i < copies.size(); )
+				{
+					if(copies[i].index == dst.index || (copies[i].source.type == PARAMETER_TEMP && copies[i].source.index == dst.index))
+					{
+						copies.erase(copies.begin() + i);
+					}
+					else
+					{
+						i++;
+					}
+				}
+
+				const SourceParameter &src = inst->src[0];
+
+				if(inst->opcode == OPCODE_MOV && !inst->predicate && !dst.saturate && dst.shift == 0 && src.modifier == MODIFIER_NONE)
+				{
+					if(src.type == PARAMETER_FLOAT4LITERAL ||
+					   (src.type == PARAMETER_TEMP && src.index != dst.index) ||
+					   ((src.type == PARAMETER_INPUT || src.type == PARAMETER_CONST) && src.rel.type == PARAMETER_VOID))
+					{
+						Copy copy = {dst.index, dst.mask, src};
+						copies.push_back(copy);
+					}
+				}
+			}
+		}
+	}
+
+	void Shader::forwardResults()
+	{
+		// Let an instruction write directly to the destination of a move which is the sole reader of its result
+		std::vector<TemporaryReads> reads = gatherTemporaryReads(instruction);
+
+		for(size_t i = 0; i < instruction.size(); )
+		{
+			Instruction *inst = instruction[i];
+			const DestinationParameter &dst = inst->dst;
+
+			size_t next = i + 1;
+
+			while(next < instruction.size() && instruction[next]->opcode == OPCODE_NULL)
+			{
+				next++;
+			}
+
+			if(next == instruction.size())
+			{
+				break;
+			}
+
+			Instruction *move = instruction[next];
+			const SourceParameter &src = move->src[0];
+
+			bool forward = inst->opcode != OPCODE_NULL && inst->isPure() && !inst->predicate &&
+			               dst.type == PARAMETER_TEMP && !dst.saturate && dst.shift == 0 &&
+			               move->opcode == OPCODE_MOV && !move->predicate && !move->dst.saturate && move->dst.shift == 0 &&
+			               (move->dst.type == PARAMETER_TEMP || move->dst.type == PARAMETER_OUTPUT || move->dst.type == PARAMETER_COLOROUT) &&
+			               move->dst.rel.type == PARAMETER_VOID && move->dst.mask == dst.mask &&
+			               src.type == PARAMETER_TEMP && src.index == dst.index && src.modifier == MODIFIER_NONE &&
+			               reads[src.index].count == 1;
+
+			for(int c = 0; c < 4 && forward; c++)
+			{
+				if((dst.mask & (1 << c)) && ((src.swizzle >> (2 * c)) & 0x3) != c)
+				{
+					forward = false;
+				}
+			}
+
+			if(forward)
+			{
+				bool partialPrecision = dst.partialPrecision;
+				inst->dst = move->dst;
+				inst->dst.partialPrecision = partialPrecision;
+				move->opcode = OPCODE_NULL;
+
+				// The forwarded result may again be moved by the next instruction
+			}
+			else
+			{
+				i = next;
+			}
+		}
+	}
+
+	void Shader::removeDeadCode()
+	{
+		// Remove writes to temporary register components which are never read
+		bool progress = true;
+
+		while(progress)
+		{
+			progress = false;
+
+			std::vector<TemporaryReads> reads = gatherTemporaryReads(instruction);
+
+			for(auto &inst : instruction)
+			{
+				DestinationParameter &dst = inst->dst;
+
+				if(inst->opcode == OPCODE_NULL || !inst->isPure() || dst.type != PARAMETER_TEMP)
+				{
+					continue;
+				}
+
+				unsigned char live = (dst.index < reads.size()) ? reads[dst.index].mask : 0;
+
+				if(dst.mask & ~live)
+				{
+					dst.mask &= live;
+
+					if(dst.mask == 0)
+					{
+						inst->opcode = OPCODE_NULL;
+					}
+
+					progress = true;
+				}
+			}
+		}
+	}
+
+	void Shader::renumberTemporaries()
+	{
+		// Assign temporaries with disjoint live ranges to the same register, to shrink the register file
+		if(!optimizableTemporaries())
+		{
+			return;
+		}
+
+		bool calls = false;
+
+		for(const auto &inst : instruction)
+		{
+			if(inst->isMatrix() && inst->src[1].type == PARAMETER_TEMP)
+			{
+				return;   // Rows must remain consecutive
+			}
+
+			calls = calls || inst->isCall();
+		}
+
+		std::vector<int> first;
+		std::vector<int> last;
+		std::vector<std::pair<int, int>> loops;
+		std::vector<int> loopStart;
+
+		for(size_t i = 0; i < instruction.size(); i++)
+		{
+			const Instruction *inst = instruction[i];
+
+			if(inst->isLoop())
+			{
+				loopStart.push_back((int)i);
+			}
+			else if(inst->isEndLoop() && !loopStart.empty())
+			{
+				loops.push_back(std::make_pair(loopStart.back(), (int)i));
+				loopStart.pop_back();
+			}
+
+			if(inst->dst.type == PARAMETER_TEMP)
+			{
+				markLiveRange(first, last, inst->dst.index, (int)i);
+			}
+
+			if(isRelativeTemporary(inst->dst))
+			{
+				markLiveRange(first, last, inst->dst.rel.index, (int)i);
+			}
+
+			for(int j = 0; j < 5; j++)
+			{
+				if(inst->src[j].type == PARAMETER_TEMP)
+				{
+					markLiveRange(first, last, inst->src[j].index, (int)i);
+				}
+
+				if(isRelativeTemporary(inst->src[j]))
+				{
+					markLiveRange(first, last, inst->src[j].rel.index, (int)i);
+				}
+			}
+		}
+
+		// Values can be carried to the next iteration, so anything live within a loop is live throughout it
+		bool extended = true;
+
+		while(extended)
+		{
+			extended = false;
+
+			for(size_t t = 0; t < first.size(); t++)
+			{
+				for(const auto &loop : loops)
+				{
+					if(first[t] != -1 && first[t] <= loop.second && last[t] >= loop.first &&
+					   (first[t] > loop.first || last[t] < loop.second))
+					{
+						first[t] = std::min(first[t], loop.first);
+						last[t] = std::max(last[t], loop.second);
+						extended = true;
+					}
+				}
+			}
+		}
+
+		std::vector<std::pair<int, int>> order;   // First use, register
+
+		for(size_t t = 0; t < first.size(); t++)
+		{
+			if(first[t] != -1)
+			{
+				order.push_back(std::make_pair(first[t], (int)t));
+			}
+		}
+
+		std::sort(order.begin(), order.end());
+
+		// Without calls the live ranges are exact, otherwise only compact the register indices
+		std::vector<unsigned int> remap(first.size(), 0);
+		std::vector<int> busyUntil;
+
+		for(const auto &range : order)
+		{
+			int t = range.second;
+			size_t r = busyUntil.size();
+
+			if(!calls)
+			{
+				for(r = 0; r < busyUntil.size(); r++)
+				{
+					if(busyUntil[r] < first[t])
+					{
+						break;
+					}
+				}
+			}
+
+			if(r == busyUntil.size())
+			{
+				busyUntil.push_back(last[t]);
+			}
+			else
+			{
+				busyUntil[r] = last[t];
+			}
+
+			remap[t] = (unsigned int)r;
+		}
+
+		for(auto &inst : instruction)
+		{
+			if(inst->dst.type == PARAMETER_TEMP)
+			{
+				inst->dst.index = remap[inst->dst.index];
+			}
+
+			if(isRelativeTemporary(inst->dst))
+			{
+				inst->dst.rel.index = remap[inst->dst.rel.index];
+			}
+
+			for(int j = 0; j < 5; j++)
+			{
+				if(inst->src[j].type == PARAMETER_TEMP)
+				{
+					inst->src[j].index = remap[inst->src[j].index];
+				}
+
+				if(isRelativeTemporary(inst->src[j]))
+				{
+					inst->src[j].rel.index = remap[inst->src[j].rel.index];
+				}
+			}
+		}
+	}
+
 	void Shader::analyzeDirtyConstants()
 	{
 		dirtyConstantsF = 0;
@@ -1625,6 +2498,50 @@ namespace sw
 		}
 	}
 
+	void Shader::analyzeUniformCondition(const Instruction &inst)
+	{
+		const SourceParameter *src = nullptr;
+
+		switch(inst.opcode)
+		{
+		case OPCODE_IF:
+		case OPCODE_CALLNZ:
+		case OPCODE_REP:
+			src = &inst.src[0];
+			break;
+		case OPCODE_LOOP:
+			src = &inst.src[1];
+			break;
+		default:
+			return;
+		}
+
+		switch(src->type)
+		{
+		case PARAMETER_CONSTBOOL:
+		case PARAMETER_CONSTINT:
+			break;
+		case PARAMETER_CONST:   // Boolean uniforms of GLSL shaders, when tested directly
+			if(inst.opcode != OPCODE_IF || src->rel.type != PARAMETER_VOID || src->bufferIndex != -1 || src->modifier != MODIFIER_NONE)
+			{
+				return;
+			}
+			break;
+		default:
+			return;
+		}
+
+		if(findUniformCondition(*src) == -1 && uniformConditions.size() < MAX_UNIFORM_CONDITIONS)
+		{
+			UniformCondition condition;
+			condition.type = src->type;
+			condition.index = src->index;
+			condition.component = (src->type == PARAMETER_CONST) ? (src->swizzle & 0x3) : 0;
+
+			uniformConditions.push_back(condition);
+		}
+	}
+
 	void Shader::analyzeDynamicBranching()
 	{
 		dynamicBranching = false;
@@ -1632,10 +2549,13 @@ namespace sw
 		containsBreak = false;
 		containsContinue = false;
 		containsDefine = false;
+		uniformConditions.clear();
 
 		// Determine global presence of branching instructions
 		for(const auto &inst : instruction)
 		{
+			analyzeUniformCondition(*inst);
+
 			switch(inst->opcode)
 			{
 			case OPCODE_CALLNZ:
@@ -1924,4 +2844,44 @@ namespace sw
 			}
 		}
 	}
+
+	void Shader::analyzeTemporaries()
+	{
+		// Number of temporary registers the program must allocate
+		if(indirectAddressableTemporaries)
+		{
+			temporaryCount = NUM_TEMPORARY_REGISTERS;
+			return;
+		}
+
+		temporaryCount = 1;   // Register 0 serves as a dummy operand
+
+		for(const auto &inst : instruction)
+		{
+			if(inst->dst.type == PARAMETER_TEMP)
+			{
+				temporaryCount = max(temporaryCount, inst->dst.index + 1);
+			}
+
+			if(isRelativeTemporary(inst->dst))
+			{
+				temporaryCount = max(temporaryCount, inst->dst.rel.index + 1);
+			}
+
+			for(int i = 0; i < 5; i++)
+			{
+				const SourceParameter &src = inst->src[i];
+
+				if(src.type == PARAMETER_TEMP)
+				{
+					temporaryCount = max(temporaryCount, src.index + ((i == 1 && inst->isMatrix()) ? 4 : 1));
+				}
+
+				if(isRelativeTemporary(src))
+				{
+					temporaryCount = max(temporaryCount, src.rel.index + 1);
+				}
+			}
+		}
+	}
 }
@@ -510,8 +510,12 @@ namespace sw
 			bool isBreak() const;
 			bool isLoop() const;
 			bool isEndLoop() const;
+			bool isMatrix() const;
 
 			bool isPredicated() const;
+			bool isComponentwise() const;
+			bool isPure() const;
+			unsigned char sourceMask(int i) const;
 
 			Opcode opcode;
 
@@ -583,6 +587,22 @@ namespace sw
 		bool containsDefineInstruction() const;
 		bool usesSampler(int i) const;
 
+		struct UniformCondition   // Uniform register which alone decides a branch or loop count
+		{
+			ParameterType type;      // PARAMETER_CONST, PARAMETER_CONSTINT or PARAMETER_CONSTBOOL
+			unsigned int index;
+			unsigned int component;   // Tested component of a float constant
+		};
+
+		int getUniformConditionCount() const;
+		const UniformCondition &getUniformCondition(int i) const;
+		int findUniformCondition(const SourceParameter &src) const;   // Returns -1 for conditions which aren't uniform
+
+		int getSpecializationCount() const;
+		void countSpecialization() const;
+		int getSamplerSpecializationCount() const;
+		void countSamplerSpecialization() const;
+
 		struct Semantic
 		{
 			Semantic(unsigned char usage = 0xFF, unsigned char index = 0xFF, bool flat = false) : usage(usage), index(index), centroid(false), flat(flat)
@@ -607,6 +627,8 @@ namespace sw
 
 		void optimize();
 
+		unsigned int getTemporaryCount() const;
+
 		// FIXME: Private
 		unsigned int dirtyConstantsF;
 		unsigned int dirtyConstantsI;
@@ -623,11 +645,20 @@ namespace sw
 		void optimizeCall();
 		void removeNull();
 
+		bool optimizableTemporaries() const;
+		bool foldConstants();
+		void propagateCopies();
+		void forwardResults();
+		void removeDeadCode();
+		void renumberTemporaries();
+
 		void analyzeDirtyConstants();
 		void analyzeDynamicBranching();
+		void analyzeUniformCondition(const Instruction &instruction);
 		void analyzeSamplers();
 		void analyzeCallSites();
 		void analyzeIndirectAddressing();
+		void analyzeTemporaries();
 		void markFunctionAnalysis(unsigned int functionLabel, Analysis flag);
 
 		ShaderType shaderType;
@@ -646,6 +677,7 @@ namespace sw
 		std::vector<Instruction*> instruction;
 
 		unsigned short usedSamplers;   // Bit flags
+		unsigned int temporaryCount;
 
 	private:
 		const int serialID;
@@ -656,6 +688,10 @@ namespace sw
 		bool containsContinue;
 		bool containsLeave;
 		bool containsDefine;
+
+		std::vector<UniformCondition> uniformConditions;
+		mutable int specializations;   // Routines compiled for particular values of the uniform conditions
+		mutable int samplerSpecializations;   // Routines compiled for particular texture traits
 	};
 }
 
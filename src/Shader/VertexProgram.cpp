@@ -24,7 +24,7 @@
 namespace sw
 {
 	VertexProgram::VertexProgram(const VertexProcessor::State &state, const VertexShader *shader)
-		: VertexRoutine(state, shader), shader(shader), r(shader->indirectAddressableTemporaries)
+		: VertexRoutine(state, shader), shader(shader), r(shader->getTemporaryCount(), shader->indirectAddressableTemporaries)
 	{
 		ifDepth = 0;
 		loopRepDepth = 0;
@@ -922,6 +922,18 @@ namespace sw
 		return c;
 	}
 
+	const int *VertexProgram::uniformCondition(const Src &src) const
+	{
+		int index = shader->findUniformCondition(src);
+
+		if(index < 0 || index >= state.specializedUniforms)
+		{
+			return nullptr;
+		}
+
+		return state.uniformCondition[index];
+	}
+
 	Int VertexProgram::relativeAddress(const Shader::Relative &rel, int bufferIndex)
 	{
 		ASSERT(!rel.dynamic);
@@ -1146,13 +1158,6 @@ namespace sw
 
 	void VertexProgram::CALLNZb(int labelIndex, int callSiteIndex, const Src &boolRegister)
 	{
-		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData,vs.b[boolRegister.index])) != Byte(0));   // FIXME
-
-		if(boolRegister.modifier == Shader::MODIFIER_NOT)
-		{
-			condition = !condition;
-		}
-
 		if(!labelBlock[labelIndex])
 		{
 			labelBlock[labelIndex] = Nucleus::createBasicBlock();
@@ -1165,7 +1170,24 @@ namespace sw
 
 		Int4 restoreLeave = enableLeave;
 
-		branch(condition, labelBlock[labelIndex], callRetBlock[labelIndex][callSiteIndex]);
+		if(const int *value = uniformCondition(boolRegister))   // Only one of the blocks is reachable
+		{
+			bool condition = (value[0] != 0) != (boolRegister.modifier == Shader::MODIFIER_NOT);
+
+			Nucleus::createBr(condition ? labelBlock[labelIndex] : callRetBlock[labelIndex][callSiteIndex]);
+		}
+		else
+		{
+			Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData,vs.b[boolRegister.index])) != Byte(0));   // FIXME
+
+			if(boolRegister.modifier == Shader::MODIFIER_NOT)
+			{
+				condition = !condition;
+			}
+
+			branch(condition, labelBlock[labelIndex], callRetBlock[labelIndex][callSiteIndex]);
+		}
+
 		Nucleus::setInsertBlock(callRetBlock[labelIndex][callSiteIndex]);
 
 		enableLeave = restoreLeave;
@@ -1302,7 +1324,7 @@ namespace sw
 
 	void VertexProgram::IF(const Src &src)
 	{
-		if(src.type == Shader::PARAMETER_CONSTBOOL)
+		if(src.type == Shader::PARAMETER_CONSTBOOL || uniformCondition(src))
 		{
 			IFb(src);
 		}
@@ -1321,17 +1343,27 @@ namespace sw
 	{
 		ASSERT(ifDepth < 24 + 4);
 
-		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData,vs.b[boolRegister.index])) != Byte(0));   // FIXME
+		BasicBlock *trueBlock = Nucleus::createBasicBlock();
+		BasicBlock *falseBlock = Nucleus::createBasicBlock();
 
-		if(boolRegister.modifier == Shader::MODIFIER_NOT)
+		if(const int *value = uniformCondition(boolRegister))   // Only one of the blocks is reachable
 		{
-			condition = !condition;
+			bool condition = (value[0] != 0) != (boolRegister.modifier == Shader::MODIFIER_NOT);
+
+			Nucleus::createBr(condition ? trueBlock : falseBlock);
+			Nucleus::setInsertBlock(trueBlock);
 		}
+		else
+		{
+			Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData,vs.b[boolRegister.index])) != Byte(0));   // FIXME
 
-		BasicBlock *trueBlock = Nucleus::createBasicBlock();
-		BasicBlock *falseBlock = Nucleus::createBasicBlock();
+			if(boolRegister.modifier == Shader::MODIFIER_NOT)
+			{
+				condition = !condition;
+			}
 
-		branch(condition, trueBlock, falseBlock);
+			branch(condition, trueBlock, falseBlock);
+		}
 
 		isConditionalIf[ifDepth] = false;
 		ifFalseBlock[ifDepth] = falseBlock;
@@ -1405,9 +1437,18 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][0]));
-		aL[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][1]));
-		increment[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][2]));
+		if(const int *value = uniformCondition(integerRegister))
+		{
+			iteration[loopDepth] = Int(value[0]);
+			aL[loopDepth] = Int(value[1]);
+			increment[loopDepth] = Int(value[2]);
+		}
+		else
+		{
+			iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][0]));
+			aL[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][1]));
+			increment[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][2]));
+		}
 
 		// FIXME: Compiles to two instructions?
 		If(increment[loopDepth] == 0)
@@ -1438,7 +1479,15 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][0]));
+		if(const int *value = uniformCondition(integerRegister))
+		{
+			iteration[loopDepth] = Int(value[0]);
+		}
+		else
+		{
+			iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][0]));
+		}
+
 		aL[loopDepth] = aL[loopDepth - 1];
 
 		BasicBlock *loopBlock = Nucleus::createBasicBlock();
@@ -37,7 +37,7 @@ namespace sw
 	private:
 		const VertexShader *const shader;
 
-		RegisterArray<NUM_TEMPORARY_REGISTERS> r;   // Temporary registers
+		RegisterFile r;   // Temporary registers
 		Vector4f a0;
 		Array<Int, 4> aL;
 		Vector4f p0;
@@ -69,6 +69,7 @@ namespace sw
 
 		Vector4f fetchRegister(const Src &src, unsigned int offset = 0);
 		Vector4f readConstant(const Src &src, unsigned int offset = 0);
+		const int *uniformCondition(const Src &src) const;   // Value the routine is specialized on, or null
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index);
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index, Int &offset);
 		Int relativeAddress(const Shader::Relative &rel, int bufferIndex = -1);
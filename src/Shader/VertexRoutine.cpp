@@ -48,6 +48,7 @@ namespace sw
 		UInt vertexCount = *Pointer<UInt>(task + OFFSET(VertexTask,vertexCount));
 		UInt primitiveNumber = *Pointer<UInt>(task + OFFSET(VertexTask, primitiveStart));
 		UInt indexInPrimitive = 0;
+		UInt cacheMisses = 0;
 
 		constants = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,constants));
 
@@ -68,6 +69,11 @@ namespace sw
 
 				Pointer<Byte> cacheLine0 = vertexCache + tagIndex * UInt((int)sizeof(Vertex));
 				writeCache(cacheLine0);
+
+				if(state.pipelineCounters)
+				{
+					cacheMisses++;
+				}
 			}
 
 			UInt cacheIndex = index & 0x0000003F;
@@ -92,6 +98,11 @@ namespace sw
 		}
 		Until(vertexCount == 0)
 
+		if(state.pipelineCounters)
+		{
+			*Pointer<UInt>(task + OFFSET(VertexTask,cacheMisses)) = cacheMisses;
+		}
+
 		Return();
 	}
 
@@ -131,6 +142,10 @@ namespace sw
 		Int4 finiteXYZ = finiteX & finiteY & finiteZ;
 		clipFlags |= *Pointer<Int>(constants + OFFSET(Constants,fini) + SignMask(finiteXYZ) * 4);
 
+		Int4 bandX = CmpNLE(Abs(o[pos].x), o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandX)));
+		Int4 bandY = CmpNLE(Abs(o[pos].y), o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandY)));
+		clipFlags |= *Pointer<Int>(constants + OFFSET(Constants,band) + SignMask(bandX | bandY) * 4);
+
 		if(state.preTransformed)
 		{
 			clipFlags &= 0xFBFBFBFB;   // Don't clip against far clip plane
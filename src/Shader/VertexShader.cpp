@@ -38,6 +38,8 @@ namespace sw
 
 		if(vs)   // Make a copy
 		{
+			shaderModel = vs->shaderModel;
+
 			for(size_t i = 0; i < vs->getLength(); i++)
 			{
 				append(new sw::Shader::Instruction(*vs->getInstruction(i)));
@@ -198,6 +200,77 @@ namespace sw
 		return output[outputIdx][component];
 	}
 
+	void VertexShader::removeUnusedOutputs()
+	{
+		// Once linked, writes to outputs without a semantic can't be observed
+		if(shaderModel < 0x0300 || indirectAddressableOutput)
+		{
+			return;
+		}
+
+		bool outputRead[MAX_VERTEX_OUTPUTS] = {};
+
+		for(const auto &inst : instruction)
+		{
+			for(int i = 0; i < 5; i++)
+			{
+				const SourceParameter &src = inst->src[i];
+
+				if(src.type == PARAMETER_OUTPUT)
+				{
+					if(src.rel.type != PARAMETER_VOID || src.index >= MAX_VERTEX_OUTPUTS)
+					{
+						return;
+					}
+
+					outputRead[src.index] = true;
+				}
+			}
+		}
+
+		bool changed = false;
+
+		for(auto &inst : instruction)
+		{
+			DestinationParameter &dst = inst->dst;
+
+			if(!inst->isPure() || dst.type != PARAMETER_OUTPUT || dst.index >= MAX_VERTEX_OUTPUTS || outputRead[dst.index] ||
+			   (int)dst.index == positionRegister || (int)dst.index == pointSizeRegister)
+			{
+				continue;
+			}
+
+			for(int c = 0; c < 4; c++)
+			{
+				if((dst.mask & (1 << c)) && !output[dst.index][c].active())
+				{
+					dst.mask &= ~(1 << c);
+					changed = true;
+				}
+			}
+
+			if(dst.mask == 0)
+			{
+				inst->opcode = OPCODE_NULL;
+			}
+		}
+
+		if(changed)
+		{
+			if(optimizableTemporaries())
+			{
+				removeDeadCode();
+			}
+
+			removeNull();
+			renumberTemporaries();
+
+			analyzeTextureSampling();
+			analyzeDirtyConstants();
+			analyzeTemporaries();
+		}
+	}
+
 	void VertexShader::analyze()
 	{
 		analyzeInput();
@@ -208,6 +281,7 @@ namespace sw
 		analyzeSamplers();
 		analyzeCallSites();
 		analyzeIndirectAddressing();
+		analyzeTemporaries();
 	}
 
 	void VertexShader::analyzeInput()
@@ -55,6 +55,8 @@ namespace sw
 		bool isInstanceIdDeclared() const { return instanceIdDeclared; }
 		bool isVertexIdDeclared() const { return vertexIdDeclared; }
 
+		void removeUnusedOutputs();
+
 	private:
 		void analyze();
 		void analyzeInput();
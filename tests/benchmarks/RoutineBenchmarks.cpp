@@ -0,0 +1,761 @@
+// Copyright 2017 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reactor code generation benchmarks. JIT-compiles a fixed corpus of Reactor
+// kernels, pixel, vertex and blitter routines with the Reactor backend this
+// binary was built with (see REACTOR_BACKEND), and records the compile time,
+// code size and execution time of each routine.
+//
+// Usage: routine_benchmarks [--filter=<substring>] [--csv] [--unoptimized]
+//                           [--baseline=<csv file>]
+//                           [--compile-threshold=<percent>]
+//                           [--code-threshold=<percent>]
+//                           [--execute-threshold=<percent>]
+//
+// The --csv output can be saved and passed back as --baseline, in which case
+// any routine which got slower to compile, larger, or slower to execute by
+// more than the given thresholds is reported and the exit code is non-zero.
+// --unoptimized compiles the Reactor kernels, pixel and vertex routines at the
+// baseline tier used for rarely executed routines. Subzero has no baseline
+// tier, so there it makes no difference.
+
+#include "Reactor/Reactor.hpp"
+#include "Renderer/Blitter.hpp"
+#include "Renderer/PixelProcessor.hpp"
+#include "Renderer/Primitive.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Surface.hpp"
+#include "Renderer/VertexProcessor.hpp"
+#include "Shader/Constants.hpp"
+#include "Shader/PixelPipeline.hpp"
+#include "Shader/VertexPipeline.hpp"
+#include "Common/Memory.hpp"
+#include "Common/Timer.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace sw;
+
+namespace
+{
+	struct Measurement
+	{
+		double compileTime;   // Milliseconds
+		int codeSize;         // Bytes, or -1 when unknown
+		double executeTime;   // Microseconds per call
+	};
+
+	class RoutineBenchmark
+	{
+	public:
+		explicit RoutineBenchmark(const char *name) : name(name) {}
+		virtual ~RoutineBenchmark() {}
+
+		virtual Measurement measure()
+		{
+			setUp();
+
+			double compileStart = Timer::seconds();
+			Routine *routine = compile();
+			const void *entry = routine->getEntry();
+			double compileTime = Timer::seconds() - compileStart;
+
+			Measurement measurement;
+			measurement.compileTime = compileTime * 1.0e3;
+			measurement.codeSize = routine->getCodeSize();
+			measurement.executeTime = fastest(entry) * 1.0e6;
+
+			delete routine;
+			tearDown();
+
+			return measurement;
+		}
+
+		const char *const name;
+
+	protected:
+		virtual void setUp() {}
+		virtual Routine *compile() = 0;
+		virtual void execute(const void *entry) = 0;
+		virtual void tearDown() {}
+
+		// Fastest of several batches, to reduce the effect of interference by other processes
+		double fastest(const void *entry)
+		{
+			execute(entry);   // Warm up caches
+
+			double best = 1.0e9;
+
+			for(int batch = 0; batch < batches; batch++)
+			{
+				double start = Timer::seconds();
+
+				for(int i = 0; i < iterations; i++)
+				{
+					execute(entry);
+				}
+
+				best = std::min(best, (Timer::seconds() - start) / iterations);
+			}
+
+			return best;
+		}
+
+		static const int batches = 5;
+		static const int iterations = 20;
+	};
+
+	const int elementCount = 16384;
+	bool runOptimizations = true;   // False measures the baseline compilation tier
+
+	// Integer arithmetic and control flow
+	class IntegerLoopBenchmark : public RoutineBenchmark
+	{
+	public:
+		IntegerLoopBenchmark() : RoutineBenchmark("Reactor/IntegerLoop") {}
+
+	protected:
+		void setUp() override
+		{
+			input.resize(elementCount);
+			output.resize(elementCount);
+
+			for(int i = 0; i < elementCount; i++)
+			{
+				input[i] = i * 7919;
+			}
+		}
+
+		Routine *compile() override
+		{
+			Function<Void(Pointer<Int>, Pointer<Int>, Int)> function;
+			{
+				Pointer<Int> output = function.Arg<0>();
+				Pointer<Int> input = function.Arg<1>();
+				Int count = function.Arg<2>();
+
+				For(Int i = 0, i < count, i++)
+				{
+					Int x = input[i];
+					Int y = (x * 3 + (x >> 2)) ^ i;
+
+					If(y < 0)
+					{
+						y = -y;
+					}
+
+					output[i] = y % 1021 + Min(x, i);
+				}
+
+				Return();
+			}
+
+			return function.compile(runOptimizations, L"IntegerLoop");
+		}
+
+		void execute(const void *entry) override
+		{
+			((void(*)(int*, const int*, int))entry)(output.data(), input.data(), elementCount);
+		}
+
+	private:
+		std::vector<int> input;
+		std::vector<int> output;
+	};
+
+	// Vector floating-point math, as used by shaders
+	class Float4MathBenchmark : public RoutineBenchmark
+	{
+	public:
+		Float4MathBenchmark() : RoutineBenchmark("Reactor/Float4Math") {}
+
+	protected:
+		void setUp() override
+		{
+			data = (float*)allocate(elementCount * sizeof(float));
+
+			for(int i = 0; i < elementCount; i++)
+			{
+				data[i] = i / (float)elementCount;
+			}
+		}
+
+		Routine *compile() override
+		{
+			Function<Void(Pointer<Float4>, Int)> function;
+			{
+				Pointer<Float4> data = function.Arg<0>();
+				Int count = function.Arg<1>();
+
+				For(Int i = 0, i < count, i++)
+				{
+					Float4 x = data[i];
+					Float4 p = ((Float4(0.5f) * x + Float4(-1.25f)) * x + Float4(2.0f)) * x + Float4(0.1f);
+					Float4 n = Sqrt(Max(p, Float4(0.0f))) * Rcp_pp(x + Float4(1.0f));
+
+					data[i] = Min(n, Float4(1.0f));
+				}
+
+				Return();
+			}
+
+			return function.compile(runOptimizations, L"Float4Math");
+		}
+
+		void execute(const void *entry) override
+		{
+			((void(*)(float*, int))entry)(data, elementCount / 4);
+		}
+
+		void tearDown() override
+		{
+			deallocate(data);
+		}
+
+	private:
+		float *data = nullptr;
+	};
+
+	// Unpacking, scaling and repacking of 8-bit color components
+	class ColorConversionBenchmark : public RoutineBenchmark
+	{
+	public:
+		ColorConversionBenchmark() : RoutineBenchmark("Reactor/ColorConversion") {}
+
+	protected:
+		void setUp() override
+		{
+			pixels.resize(elementCount);
+
+			for(int i = 0; i < elementCount; i++)
+			{
+				pixels[i] = i * 2654435761u;
+			}
+		}
+
+		Routine *compile() override
+		{
+			Function<Void(Pointer<Byte>, Int)> function;
+			{
+				Pointer<Byte> pixels = function.Arg<0>();
+				Int count = function.Arg<1>();
+
+				For(Int i = 0, i < count, i++)
+				{
+					Float4 color = Float4(*Pointer<Byte4>(pixels + 4 * i)) * Float4(1.0f / 255.0f);
+					color = color * Float4(0.75f, 0.5f, 0.25f, 1.0f) + Float4(0.1f);
+
+					Short4 scaled = Short4(RoundInt(color * Float4(255.0f)));
+					*Pointer<Byte4>(pixels + 4 * i) = Byte4(PackUnsigned(scaled, scaled));
+				}
+
+				Return();
+			}
+
+			return function.compile(runOptimizations, L"ColorConversion");
+		}
+
+		void execute(const void *entry) override
+		{
+			((void(*)(unsigned int*, int))entry)(pixels.data(), elementCount);
+		}
+
+	private:
+		std::vector<unsigned int> pixels;
+	};
+
+	// Fixed-function pixel routine, rasterizing a square primitive
+	class PixelRoutineBenchmark : public RoutineBenchmark
+	{
+	public:
+		PixelRoutineBenchmark(const char *name, const PixelProcessor::State &state) : RoutineBenchmark(name), state(state)
+		{
+			this->state.computeHash();
+		}
+
+	protected:
+		void setUp() override
+		{
+			primitive = (Primitive*)allocate(sizeof(Primitive));
+			memset(primitive, 0, sizeof(Primitive));
+
+			primitive->yMin = 0;
+			primitive->yMax = size;
+
+			for(int y = 0; y < size; y++)
+			{
+				primitive->outline[y].left = 0;
+				primitive->outline[y].right = size;
+			}
+
+			// Shade a horizontal gradient with a varying depth
+			primitive->z.A = replicate(0.5f / size);
+			primitive->z.C = replicate(0.25f);
+			primitive->w.C = replicate(1.0f);
+			primitive->V[0][0].A = replicate(1.0f / size);
+			primitive->V[0][1].B = replicate(1.0f / size);
+			primitive->V[0][2].C = replicate(0.5f);
+			primitive->V[0][3].C = replicate(0.75f);
+
+			data = (DrawData*)allocate(sizeof(DrawData));
+			memset(static_cast<void*>(data), 0, sizeof(DrawData));
+			data->constants = &constants;
+
+			int colorPitchB = size * Surface::bytes(state.targetFormat[0]);
+			colorBuffer = allocate(colorPitchB * size);
+			memset(colorBuffer, 0, colorPitchB * size);
+			data->colorBuffer[0] = (unsigned int*)colorBuffer;
+			data->colorPitchB[0] = colorPitchB;
+
+			depthBuffer = (float*)allocate(size * size * sizeof(float));
+
+			for(int i = 0; i < size * size; i++)
+			{
+				depthBuffer[i] = 1.0f;
+			}
+
+			data->depthBuffer = depthBuffer;
+			data->depthPitchB = size * sizeof(float);
+		}
+
+		Routine *compile() override
+		{
+			PixelPipeline *generator = new PixelPipeline(state, nullptr);
+			generator->generate();
+			Routine *routine = generator->compile(runOptimizations, L"PixelRoutine_%0.8X", state.hash);
+			delete generator;
+
+			return routine;
+		}
+
+		void execute(const void *entry) override
+		{
+			((PixelProcessor::RoutinePointer)entry)(primitive, 1, 0, data);
+		}
+
+		void tearDown() override
+		{
+			deallocate(depthBuffer);
+			deallocate(colorBuffer);
+			deallocate(data);
+			deallocate(primitive);
+		}
+
+	private:
+		static const int size = 256;
+
+		PixelProcessor::State state;
+		Primitive *primitive = nullptr;
+		DrawData *data = nullptr;
+		void *colorBuffer = nullptr;
+		float *depthBuffer = nullptr;
+	};
+
+	// Fixed-function vertex routine, processing a batch of unique vertices
+	class VertexRoutineBenchmark : public RoutineBenchmark
+	{
+	public:
+		VertexRoutineBenchmark(const char *name, const VertexProcessor::State &state) : RoutineBenchmark(name), state(state)
+		{
+			this->state.computeHash();
+		}
+
+	protected:
+		void setUp() override
+		{
+			// Every attribute stream holds up to four floats per vertex, with room for reading whole quads past the end
+			attributes = (float*)allocate((vertexCount + 4) * 4 * sizeof(float));
+
+			for(unsigned int i = 0; i < (vertexCount + 4) * 4; i++)
+			{
+				attributes[i] = (i % 7) * 0.25f - 0.5f;
+			}
+
+			data = (DrawData*)allocate(sizeof(DrawData));
+			memset(static_cast<void*>(data), 0, sizeof(DrawData));
+			data->constants = &constants;
+
+			for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+			{
+				data->input[i] = attributes;
+				data->stride[i] = 4 * sizeof(float);
+			}
+
+			for(int i = 0; i < 4; i++)
+			{
+				data->ff.transformT[0][i][i] = 1.0f;
+				data->ff.cameraTransformT[0][i][i] = 1.0f;
+				data->ff.normalTransformT[0][i][i] = 1.0f;
+				data->Wx16[i] = 16.0f * size;
+				data->Hx16[i] = 16.0f * size;
+				data->guardBandX[i] = 2.0f;
+				data->guardBandY[i] = 2.0f;
+			}
+
+			task = (VertexTask*)allocate(sizeof(VertexTask));
+			memset(task, 0, sizeof(VertexTask));
+
+			output = (Vertex*)allocate(vertexCount * sizeof(Vertex));
+
+			for(unsigned int i = 0; i < vertexCount; i++)
+			{
+				batch[i] = i;
+			}
+		}
+
+		Routine *compile() override
+		{
+			VertexPipeline *generator = new VertexPipeline(state);
+			generator->generate();
+			Routine *routine = generator->compile(runOptimizations, L"VertexRoutine_%0.8X", state.hash);
+			delete generator;
+
+			return routine;
+		}
+
+		void execute(const void *entry) override
+		{
+			task->vertexCount = vertexCount;
+			task->vertexCache.clear();
+
+			((VertexProcessor::RoutinePointer)entry)(output, batch, task, data);
+		}
+
+		void tearDown() override
+		{
+			deallocate(output);
+			deallocate(task);
+			deallocate(data);
+			deallocate(attributes);
+		}
+
+	private:
+		static const unsigned int vertexCount = 128;   // Largest batch processed by the renderer
+		static const int size = 256;
+
+		VertexProcessor::State state;
+		float *attributes = nullptr;
+		DrawData *data = nullptr;
+		VertexTask *task = nullptr;
+		Vertex *output = nullptr;
+		unsigned int batch[vertexCount];
+	};
+
+	// Blitter routines are compiled by the first blit which needs them, so the
+	// compile time is estimated from the first blit's time minus a later one's.
+	class BlitRoutineBenchmark : public RoutineBenchmark
+	{
+	public:
+		BlitRoutineBenchmark(const char *name, Format sourceFormat, Format destFormat, int destSize, bool filter)
+			: RoutineBenchmark(name), sourceFormat(sourceFormat), destFormat(destFormat), destSize(destSize), filter(filter)
+		{
+		}
+
+		Measurement measure() override
+		{
+			std::vector<unsigned char> sourcePixels(sourceSize * sourceSize * Surface::bytes(sourceFormat));
+			std::vector<unsigned char> destPixels(destSize * destSize * Surface::bytes(destFormat));
+
+			for(size_t i = 0; i < sourcePixels.size(); i++)
+			{
+				sourcePixels[i] = (unsigned char)(i * 31);
+			}
+
+			source = Surface::create(sourceSize, sourceSize, 1, sourceFormat, sourcePixels.data(), sourceSize * Surface::bytes(sourceFormat), 0);
+			dest = Surface::create(destSize, destSize, 1, destFormat, destPixels.data(), destSize * Surface::bytes(destFormat), 0);
+			blitter = new Blitter();
+
+			double compileStart = Timer::seconds();
+			execute(nullptr);
+			double firstBlit = Timer::seconds() - compileStart;
+
+			Routine *routine = blitter->getRoutine(source, sourceRect(), dest, {filter, false, false});
+
+			Measurement measurement;
+			measurement.executeTime = fastest(nullptr) * 1.0e6;
+			measurement.compileTime = std::max(firstBlit * 1.0e3 - measurement.executeTime * 1.0e-3, 0.0);
+			measurement.codeSize = routine ? routine->getCodeSize() : -1;
+
+			delete blitter;
+			delete dest;
+			delete source;
+
+			return measurement;
+		}
+
+	protected:
+		Routine *compile() override
+		{
+			return nullptr;
+		}
+
+		void execute(const void *) override
+		{
+			blitter->blit(source, sourceRect(), dest, SliceRect(0, 0, destSize, destSize, 0), {filter, false, false});
+		}
+
+	private:
+		static SliceRectF sourceRect()
+		{
+			return SliceRectF(0.0f, 0.0f, (float)sourceSize, (float)sourceSize, 0);
+		}
+
+		static const int sourceSize = 256;
+
+		const Format sourceFormat;
+		const Format destFormat;
+		const int destSize;
+		const bool filter;
+
+		Surface *source = nullptr;
+		Surface *dest = nullptr;
+		Blitter *blitter = nullptr;
+	};
+
+	PixelProcessor::State pixelState(Format format)
+	{
+		PixelProcessor::State state;
+
+		state.alphaCompareMode = ALPHA_ALWAYS;
+		state.depthCompareMode = DEPTH_ALWAYS;
+		state.logicalOperation = LOGICALOP_COPY;
+		state.colorWriteMask = 0xF;
+		state.targetFormat[0] = format;
+		state.multiSample = 1;
+		state.multiSampleMask = 0xF;
+		state.perspective = true;
+		state.color[0].component = 0xF;
+
+		return state;
+	}
+
+	VertexProcessor::State vertexState()
+	{
+		VertexProcessor::State state;
+
+		state.fixedFunction = true;
+		state.positionRegister = Pos;
+		state.pointSizeRegister = Pts;
+		state.verticesPerPrimitive = 3;
+		state.input[Position].type = STREAMTYPE_FLOAT;
+		state.input[Position].count = 3;
+		state.output[Pos].write = 0xF;
+
+		return state;
+	}
+
+	typedef std::map<std::string, Measurement> Baseline;
+
+	bool readBaseline(const char *fileName, Baseline &baseline)
+	{
+		FILE *file = fopen(fileName, "r");
+
+		if(!file)
+		{
+			return false;
+		}
+
+		char line[256];
+
+		while(fgets(line, sizeof(line), file))
+		{
+			char name[128];
+			Measurement measurement;
+
+			if(sscanf(line, "%127[^,],%lf,%d,%lf", name, &measurement.compileTime, &measurement.codeSize, &measurement.executeTime) == 4)
+			{
+				baseline[name] = measurement;
+			}
+		}
+
+		fclose(file);
+
+		return true;
+	}
+
+	bool regressed(const char *name, const char *metric, double value, double base, double threshold)
+	{
+		if(base > 0 && value > base * (1.0 + threshold / 100.0))
+		{
+			fprintf(stderr, "REGRESSION %s %s: %.3f -> %.3f (+%.1f%%, threshold %.1f%%)\n", name, metric, base, value, (value / base - 1.0) * 100.0, threshold);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool parseOption(const char *argument, const char *option, const char **value)
+	{
+		size_t length = strlen(option);
+
+		if(strncmp(argument, option, length) == 0 && argument[length] == '=')
+		{
+			*value = argument + length + 1;
+			return true;
+		}
+
+		return false;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = "";
+	const char *baselineFile = nullptr;
+	double compileThreshold = 25.0;   // Compile times are noisy
+	double codeThreshold = 5.0;
+	double executeThreshold = 10.0;
+	bool csv = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *value = nullptr;
+
+		if(parseOption(argv[i], "--filter", &value))
+		{
+			filter = value;
+		}
+		else if(parseOption(argv[i], "--baseline", &value))
+		{
+			baselineFile = value;
+		}
+		else if(parseOption(argv[i], "--compile-threshold", &value))
+		{
+			compileThreshold = atof(value);
+		}
+		else if(parseOption(argv[i], "--code-threshold", &value))
+		{
+			codeThreshold = atof(value);
+		}
+		else if(parseOption(argv[i], "--execute-threshold", &value))
+		{
+			executeThreshold = atof(value);
+		}
+		else if(strcmp(argv[i], "--csv") == 0)
+		{
+			csv = true;
+		}
+		else if(strcmp(argv[i], "--unoptimized") == 0)
+		{
+			runOptimizations = false;
+		}
+		else
+		{
+			printf("Usage: %s [--filter=<substring>] [--csv] [--unoptimized] [--baseline=<csv file>] [--compile-threshold=<percent>] [--code-threshold=<percent>] [--execute-threshold=<percent>]\n", argv[0]);
+			return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	Baseline baseline;
+
+	if(baselineFile && !readBaseline(baselineFile, baseline))
+	{
+		fprintf(stderr, "Failed to read baseline %s\n", baselineFile);
+		return EXIT_FAILURE;
+	}
+
+	PixelProcessor::State depthState = pixelState(FORMAT_A8R8G8B8);
+	depthState.depthTestActive = true;
+	depthState.depthCompareMode = DEPTH_LESSEQUAL;
+	depthState.depthWriteEnable = true;
+
+	PixelProcessor::State blendState = pixelState(FORMAT_A8R8G8B8);
+	blendState.alphaBlendActive = true;
+	blendState.sourceBlendFactor = BLEND_SOURCEALPHA;
+	blendState.destBlendFactor = BLEND_INVSOURCEALPHA;
+	blendState.blendOperation = BLENDOP_ADD;
+	blendState.sourceBlendFactorAlpha = BLEND_ONE;
+	blendState.destBlendFactorAlpha = BLEND_INVSOURCEALPHA;
+	blendState.blendOperationAlpha = BLENDOP_ADD;
+
+	VertexProcessor::State lightingState = vertexState();
+	lightingState.vertexNormalActive = true;
+	lightingState.normalizeNormals = true;
+	lightingState.vertexLightingActive = true;
+	lightingState.vertexLightActive = 0x3;
+	lightingState.diffuseActive = true;
+	lightingState.input[Normal].type = STREAMTYPE_FLOAT;
+	lightingState.input[Normal].count = 3;
+	lightingState.output[C0].write = 0xF;
+
+	VertexProcessor::State texturedState = vertexState();
+	texturedState.input[TexCoord0].type = STREAMTYPE_FLOAT;
+	texturedState.input[TexCoord0].count = 2;
+	texturedState.textureState[0].texGenActive = TEXGEN_PASSTHRU;
+	texturedState.textureState[0].texCoordIndexActive = 0;
+	texturedState.output[T0].write = 0x3;
+
+	IntegerLoopBenchmark integerLoop;
+	Float4MathBenchmark float4Math;
+	ColorConversionBenchmark colorConversion;
+	PixelRoutineBenchmark pixelFlat("Pixel/Flat", pixelState(FORMAT_A8R8G8B8));
+	PixelRoutineBenchmark pixelDepth("Pixel/DepthTest", depthState);
+	PixelRoutineBenchmark pixelBlend("Pixel/Blend", blendState);
+	PixelRoutineBenchmark pixelFloat("Pixel/FloatTarget", pixelState(FORMAT_A32B32G32R32F));
+	VertexRoutineBenchmark vertexTransform("Vertex/Transform", vertexState());
+	VertexRoutineBenchmark vertexLighting("Vertex/Lighting", lightingState);
+	VertexRoutineBenchmark vertexTextured("Vertex/Textured", texturedState);
+	BlitRoutineBenchmark blitCopy("Blit/Copy", FORMAT_A8B8G8R8, FORMAT_A8R8G8B8, 256, false);
+	BlitRoutineBenchmark blitScale("Blit/ScaleLinear", FORMAT_A8B8G8R8, FORMAT_A8B8G8R8, 512, true);
+	BlitRoutineBenchmark blitFloat("Blit/ToFloat", FORMAT_R5G6B5, FORMAT_A32B32G32R32F, 256, false);
+
+	RoutineBenchmark *benchmarks[] =
+	{
+		&integerLoop, &float4Math, &colorConversion,
+		&pixelFlat, &pixelDepth, &pixelBlend, &pixelFloat,
+		&vertexTransform, &vertexLighting, &vertexTextured,
+		&blitCopy, &blitScale, &blitFloat,
+	};
+
+	if(csv)
+	{
+		printf("routine,compile_ms,code_bytes,execute_us\n");
+	}
+	else
+	{
+		printf("%-24s %12s %12s %12s\n", "Routine", "Compile ms", "Code bytes", "Execute us");
+	}
+
+	int regressions = 0;
+
+	for(RoutineBenchmark *benchmark : benchmarks)
+	{
+		if(!strstr(benchmark->name, filter))
+		{
+			continue;
+		}
+
+		Measurement measurement = benchmark->measure();
+
+		const char *format = csv ? "%s,%.3f,%d,%.3f\n" : "%-24s %12.3f %12d %12.3f\n";
+		printf(format, benchmark->name, measurement.compileTime, measurement.codeSize, measurement.executeTime);
+		fflush(stdout);
+
+		Baseline::const_iterator base = baseline.find(benchmark->name);
+
+		if(base != baseline.end())
+		{
+			regressions += regressed(benchmark->name, "compile ms", measurement.compileTime, base->second.compileTime, compileThreshold);
+			regressions += regressed(benchmark->name, "code bytes", measurement.codeSize, base->second.codeSize, codeThreshold);
+			regressions += regressed(benchmark->name, "execute us", measurement.executeTime, base->second.executeTime, executeThreshold);
+		}
+	}
+
+	return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
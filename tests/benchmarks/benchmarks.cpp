@@ -0,0 +1,1335 @@
+// Copyright 2017 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Headless OpenGL ES rendering benchmarks. Each scene renders a fixed,
+// deterministic workload into an EGL pbuffer and reports the time taken by
+// its first frame (which includes routine compilation), the steady state
+// frame rate, and how frame time splits between issuing commands and waiting
+// for rendering to finish. A checksum of the final image makes it possible to
+// check that different builds rendered the same thing.
+//
+// Usage: benchmarks [--filter=<substring>] [--frames=<count>]
+//                   [--width=<pixels>] [--height=<pixels>] [--csv]
+//
+// Finer grained per-stage timings are available by running with
+// SWIFTSHADER_TRACE=<file>, and pipeline counters by enabling
+// PipelineCounters in SwiftShader.ini.
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+namespace
+{
+	int width = 1024;
+	int height = 768;
+
+	double now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void fail(const char *message, const char *detail = "")
+	{
+		fprintf(stderr, "%s%s\n", message, detail);
+		exit(EXIT_FAILURE);
+	}
+
+	void checkGLError(const char *where)
+	{
+		GLenum error = glGetError();
+
+		if(error != GL_NO_ERROR)
+		{
+			fprintf(stderr, "GL error 0x%04X in %s\n", error, where);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// Deterministic pseudo-random numbers, so every run renders the same scene
+	class Random
+	{
+	public:
+		explicit Random(uint32_t seed) : state(seed) {}
+
+		float next()
+		{
+			state = state * 1664525u + 1013904223u;
+			return (state >> 8) * (1.0f / 16777216.0f);
+		}
+
+	private:
+		uint32_t state;
+	};
+
+	GLuint compileShader(GLenum type, const char *source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+
+		if(!compiled)
+		{
+			char log[1024] = {0};
+			glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+			fail("Shader compilation failed: ", log);
+		}
+
+		return shader;
+	}
+
+	GLuint createProgram(const char *vertexSource, const char *fragmentSource)
+	{
+		GLuint program = glCreateProgram();
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glBindAttribLocation(program, 0, "position");
+		glLinkProgram(program);
+
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+		if(!linked)
+		{
+			char log[1024] = {0};
+			glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+			fail("Program linking failed: ", log);
+		}
+
+		return program;
+	}
+
+	const char *const quadVertexShader =
+		"attribute vec2 position;\n"
+		"uniform vec4 transform;\n"   // xy: scale, zw: offset
+		"uniform float depth;\n"
+		"varying vec2 texCoord;\n"
+		"void main()\n"
+		"{\n"
+		"    texCoord = position * 0.5 + 0.5;\n"
+		"    gl_Position = vec4(position * transform.xy + transform.zw, depth, 1.0);\n"
+		"}\n";
+
+	const char *const colorFragmentShader =
+		"precision mediump float;\n"
+		"uniform vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"    gl_FragColor = color;\n"
+		"}\n";
+
+	class Benchmark
+	{
+	public:
+		explicit Benchmark(const char *name) : name(name) {}
+		virtual ~Benchmark() {}
+
+		virtual void setUp() = 0;
+		virtual void frame() = 0;   // Issues one frame of rendering commands
+		virtual void tearDown() = 0;
+
+		const char *const name;
+
+	protected:
+		// Full screen quad, drawn as a triangle strip from attribute 0
+		void createQuad()
+		{
+			static const GLfloat vertices[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+
+			glGenBuffers(1, &quadBuffer);
+			glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(0);
+		}
+
+		void deleteQuad()
+		{
+			glDisableVertexAttribArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glDeleteBuffers(1, &quadBuffer);
+		}
+
+		void drawQuad(GLuint program, float scaleX, float scaleY, float offsetX, float offsetY, float depth = 0.0f)
+		{
+			glUniform4f(glGetUniformLocation(program, "transform"), scaleX, scaleY, offsetX, offsetY);
+			glUniform1f(glGetUniformLocation(program, "depth"), depth);
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+
+		GLuint quadBuffer = 0;
+	};
+
+	// Opaque full screen quads without blending or depth testing
+	class FillRateBenchmark : public Benchmark
+	{
+	public:
+		FillRateBenchmark() : Benchmark("FillRate") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(quadVertexShader, colorFragmentShader);
+		}
+
+		void frame() override
+		{
+			glUseProgram(program);
+
+			for(int i = 0; i < layers; i++)
+			{
+				glUniform4f(glGetUniformLocation(program, "color"), i / (float)layers, 0.5f, 1.0f - i / (float)layers, 1.0f);
+				drawQuad(program, 1.0f, 1.0f, 0.0f, 0.0f);
+			}
+		}
+
+		void tearDown() override
+		{
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int layers = 8;
+		GLuint program = 0;
+	};
+
+	// Depth tested, alpha blended layers drawn back to front
+	class OverdrawBenchmark : public Benchmark
+	{
+	public:
+		OverdrawBenchmark() : Benchmark("Overdraw") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(quadVertexShader, colorFragmentShader);
+
+			glEnable(GL_DEPTH_TEST);
+			glDepthFunc(GL_LEQUAL);
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+
+		void frame() override
+		{
+			glClear(GL_DEPTH_BUFFER_BIT);
+			glUseProgram(program);
+
+			Random random(1);
+
+			for(int i = 0; i < layers; i++)
+			{
+				float scale = 0.6f + 0.4f * random.next();
+				glUniform4f(glGetUniformLocation(program, "color"), random.next(), random.next(), random.next(), 0.25f);
+				drawQuad(program, scale, scale, random.next() - 0.5f, random.next() - 0.5f, 1.0f - 2.0f * i / layers);
+			}
+		}
+
+		void tearDown() override
+		{
+			glDisable(GL_BLEND);
+			glDisable(GL_DEPTH_TEST);
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int layers = 16;
+		GLuint program = 0;
+	};
+
+	// Trilinear filtered sampling of several mipmapped textures per fragment
+	class TextureBenchmark : public Benchmark
+	{
+	public:
+		TextureBenchmark() : Benchmark("Texture") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(quadVertexShader,
+				"precision mediump float;\n"
+				"uniform sampler2D texture0;\n"
+				"uniform sampler2D texture1;\n"
+				"uniform sampler2D texture2;\n"
+				"uniform sampler2D texture3;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    gl_FragColor = texture2D(texture0, texCoord) * 0.25 +\n"
+				"                   texture2D(texture1, texCoord * 3.7) * 0.25 +\n"
+				"                   texture2D(texture2, texCoord * vec2(0.3, 5.0)) * 0.25 +\n"
+				"                   texture2D(texture3, texCoord.yx * 11.0) * 0.25;\n"
+				"}\n");
+
+			glGenTextures(textureCount, textures);
+			std::vector<GLubyte> texels(textureSize * textureSize * 4);
+			Random random(2);
+
+			for(int t = 0; t < textureCount; t++)
+			{
+				for(size_t i = 0; i < texels.size(); i++)
+				{
+					texels[i] = (GLubyte)(random.next() * 255.0f);
+				}
+
+				glActiveTexture(GL_TEXTURE0 + t);
+				glBindTexture(GL_TEXTURE_2D, textures[t]);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureSize, textureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+				glGenerateMipmap(GL_TEXTURE_2D);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+				char sampler[] = "texture0";
+				sampler[7] = '0' + t;
+				glUseProgram(program);
+				glUniform1i(glGetUniformLocation(program, sampler), t);
+			}
+		}
+
+		void frame() override
+		{
+			glUseProgram(program);
+			drawQuad(program, 1.0f, 1.0f, 0.0f, 0.0f);
+			drawQuad(program, -1.0f, 1.0f, 0.0f, 0.0f);
+		}
+
+		void tearDown() override
+		{
+			glDeleteTextures(textureCount, textures);
+			glActiveTexture(GL_TEXTURE0);
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int textureCount = 4;
+		static const int textureSize = 256;
+		GLuint textures[textureCount];
+		GLuint program = 0;
+	};
+
+	// Bilinear sampling of a large, minified texture mapped onto the screen at
+	// an angle. Rotation changes how many texel rows each quad of fragments
+	// touches, which makes it sensitive to the texture's memory layout.
+	class RotatedTextureBenchmark : public Benchmark
+	{
+	public:
+		RotatedTextureBenchmark(const char *name, float degrees) : Benchmark(name), degrees(degrees) {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(
+				"attribute vec2 position;\n"
+				"uniform mat2 rotation;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    texCoord = rotation * position * 0.5 + 0.5;\n"
+				"    gl_Position = vec4(position, 0.0, 1.0);\n"
+				"}\n",
+				"precision mediump float;\n"
+				"uniform sampler2D texture;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    gl_FragColor = texture2D(texture, texCoord);\n"
+				"}\n");
+
+			std::vector<GLubyte> texels(textureSize * textureSize * 4);
+			Random random(6);
+
+			for(size_t i = 0; i < texels.size(); i++)
+			{
+				texels[i] = (GLubyte)(random.next() * 255.0f);
+			}
+
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureSize, textureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+			float radians = degrees * 3.14159265f / 180.0f;
+			const GLfloat rotation[] = {cosf(radians), sinf(radians), -sinf(radians), cosf(radians)};
+
+			glUseProgram(program);
+			glUniformMatrix2fv(glGetUniformLocation(program, "rotation"), 1, GL_FALSE, rotation);
+			glUniform1i(glGetUniformLocation(program, "texture"), 0);
+		}
+
+		void frame() override
+		{
+			glUseProgram(program);
+
+			for(int i = 0; i < layers; i++)
+			{
+				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			}
+		}
+
+		void tearDown() override
+		{
+			glDeleteTextures(1, &texture);
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int textureSize = 2048;
+		static const int layers = 4;
+		const float degrees;
+		GLuint texture = 0;
+		GLuint program = 0;
+	};
+
+	// Full screen layers drawn with one shader whose features are toggled by
+	// boolean uniforms, each layer enabling a different combination of them
+	class UberShaderBenchmark : public Benchmark
+	{
+	public:
+		UberShaderBenchmark() : Benchmark("UberShader") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(quadVertexShader,
+				"precision mediump float;\n"
+				"uniform vec4 color;\n"
+				"uniform bool tint;\n"
+				"uniform bool stripes;\n"
+				"uniform bool vignette;\n"
+				"uniform bool gamma;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    vec3 c = color.rgb;\n"
+				"    if(tint)\n"
+				"    {\n"
+				"        c = mix(c, vec3(texCoord, 0.5), 0.5);\n"
+				"    }\n"
+				"    if(stripes)\n"
+				"    {\n"
+				"        c *= 0.75 + 0.25 * sin(texCoord.x * 40.0 + texCoord.y * 17.0);\n"
+				"    }\n"
+				"    if(vignette)\n"
+				"    {\n"
+				"        vec2 d = texCoord - 0.5;\n"
+				"        c *= 1.0 - dot(d, d) * 1.5;\n"
+				"    }\n"
+				"    if(gamma)\n"
+				"    {\n"
+				"        c = pow(max(c, 0.0), vec3(1.0 / 2.2));\n"
+				"    }\n"
+				"    gl_FragColor = vec4(c, 1.0);\n"
+				"}\n");
+		}
+
+		void frame() override
+		{
+			static const int features[] = {0x3, 0x5, 0xE, 0x9};
+
+			glUseProgram(program);
+
+			for(int i = 0; i < layers; i++)
+			{
+				int enabled = features[i % 4];
+
+				glUniform4f(glGetUniformLocation(program, "color"), i / (float)layers, 0.5f, 1.0f - i / (float)layers, 1.0f);
+				glUniform1i(glGetUniformLocation(program, "tint"), (enabled >> 0) & 1);
+				glUniform1i(glGetUniformLocation(program, "stripes"), (enabled >> 1) & 1);
+				glUniform1i(glGetUniformLocation(program, "vignette"), (enabled >> 2) & 1);
+				glUniform1i(glGetUniformLocation(program, "gamma"), (enabled >> 3) & 1);
+				drawQuad(program, 1.0f, 1.0f, 0.0f, 0.0f);
+			}
+		}
+
+		void tearDown() override
+		{
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int layers = 8;
+		GLuint program = 0;
+	};
+
+	// Full screen layers drawn with a set of fragment shaders written the way
+	// applications tend to write them: loops carrying values between
+	// iterations, constant expressions, swizzle chains and branches. Shader
+	// compiler output for these has many moves and temporaries, so this scene
+	// tracks how well the shader optimizer cleans them up.
+	class ShaderCorpusBenchmark : public Benchmark
+	{
+	public:
+		ShaderCorpusBenchmark() : Benchmark("ShaderCorpus") {}
+
+		void setUp() override
+		{
+			static const char *const fragmentShaders[programCount] =
+			{
+				// Constant arithmetic
+				"precision mediump float;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    float a = 2.0 * 3.0 + 1.0;\n"
+				"    vec3 b = vec3(a, a * 0.5, -a) * 0.1;\n"
+				"    gl_FragColor = vec4(b + vec3(texCoord, 0.0), 1.0);\n"
+				"}\n",
+
+				// Values swapped between loop iterations
+				"precision mediump float;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    float s = 0.0;\n"
+				"    vec2 q = texCoord;\n"
+				"    for(int i = 0; i < 8; i++)\n"
+				"    {\n"
+				"        s += q.x * q.y;\n"
+				"        q = q.yx + vec2(0.1, 0.05);\n"
+				"    }\n"
+				"    gl_FragColor = vec4(fract(s), q, 1.0);\n"
+				"}\n",
+
+				"precision mediump float;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    vec2 a = texCoord;\n"
+				"    vec2 b = vec2(0.0);\n"
+				"    for(int i = 0; i < 5; i++)\n"
+				"    {\n"
+				"        vec2 t = a;\n"
+				"        a = b + vec2(0.1);\n"
+				"        b = t * 0.9;\n"
+				"    }\n"
+				"    gl_FragColor = vec4(a, b);\n"
+				"}\n",
+
+				// Branches writing a shared result
+				"precision mediump float;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    vec4 r;\n"
+				"    float t = texCoord.x * 2.0;\n"
+				"    if(texCoord.x > 0.5)\n"
+				"    {\n"
+				"        r = vec4(t, 0.2, 0.3, 1.0);\n"
+				"    }\n"
+				"    else\n"
+				"    {\n"
+				"        float u = t * t;\n"
+				"        r = vec4(0.1, u, t, 1.0);\n"
+				"    }\n"
+				"    gl_FragColor = r;\n"
+				"}\n",
+
+				// Swizzle chains
+				"precision mediump float;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    vec4 a = vec4(texCoord, texCoord.yx);\n"
+				"    vec4 b = a.wzyx;\n"
+				"    vec4 d = -b.yxwz;\n"
+				"    vec4 e = abs(d.xxyy) + d;\n"
+				"    gl_FragColor = e * 0.5 + 0.5;\n"
+				"}\n",
+
+				// Arithmetic heavy loop
+				"precision mediump float;\n"
+				"uniform vec4 color;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    vec4 acc = vec4(0.0);\n"
+				"    vec2 p = texCoord;\n"
+				"    for(int i = 0; i < 8; i++)\n"
+				"    {\n"
+				"        vec4 t = vec4(p, p.yx) * color + vec4(float(i) * 0.01);\n"
+				"        vec4 u = t * t - t.yzwx;\n"
+				"        acc += sin(u) * 0.1;\n"
+				"        p = p * 0.97 + acc.xy * 0.01;\n"
+				"    }\n"
+				"    gl_FragColor = fract(acc);\n"
+				"}\n",
+			};
+
+			createQuad();
+
+			for(int i = 0; i < programCount; i++)
+			{
+				programs[i] = createProgram(quadVertexShader, fragmentShaders[i]);
+			}
+		}
+
+		void frame() override
+		{
+			for(int i = 0; i < programCount; i++)
+			{
+				glUseProgram(programs[i]);
+				glUniform4f(glGetUniformLocation(programs[i], "color"), 1.1f, 0.9f, 1.3f, 0.7f);
+				drawQuad(programs[i], 1.0f, 1.0f, 0.0f, 0.0f);
+			}
+		}
+
+		void tearDown() override
+		{
+			for(int i = 0; i < programCount; i++)
+			{
+				glDeleteProgram(programs[i]);
+			}
+
+			deleteQuad();
+		}
+
+	private:
+		static const int programCount = 6;
+		GLuint programs[programCount];
+	};
+
+	// A densely tessellated, lit mesh covering the screen
+	class VertexBenchmark : public Benchmark
+	{
+	public:
+		VertexBenchmark() : Benchmark("Vertex") {}
+
+		void setUp() override
+		{
+			program = createProgram(
+				"attribute vec2 position;\n"
+				"uniform float time;\n"
+				"varying vec3 color;\n"
+				"void main()\n"
+				"{\n"
+				"    float height = sin(position.x * 20.0 + time) * cos(position.y * 17.0 - time) * 0.1;\n"
+				"    vec3 normal = normalize(vec3(-cos(position.x * 20.0 + time), sin(position.y * 17.0 - time), 1.0));\n"
+				"    float diffuse = max(dot(normal, normalize(vec3(0.3, 0.5, 0.8))), 0.0);\n"
+				"    color = vec3(0.2) + vec3(0.8, 0.7, 0.5) * diffuse;\n"
+				"    gl_Position = vec4(position * 0.95, height, 1.0);\n"
+				"}\n",
+				"precision mediump float;\n"
+				"varying vec3 color;\n"
+				"void main()\n"
+				"{\n"
+				"    gl_FragColor = vec4(color, 1.0);\n"
+				"}\n");
+
+			std::vector<GLfloat> vertices;
+			vertices.reserve((gridSize + 1) * (gridSize + 1) * 2);
+
+			for(int y = 0; y <= gridSize; y++)
+			{
+				for(int x = 0; x <= gridSize; x++)
+				{
+					vertices.push_back(2.0f * x / gridSize - 1.0f);
+					vertices.push_back(2.0f * y / gridSize - 1.0f);
+				}
+			}
+
+			std::vector<GLuint> indices;
+			indices.reserve(gridSize * gridSize * 6);
+
+			for(int y = 0; y < gridSize; y++)
+			{
+				for(int x = 0; x < gridSize; x++)
+				{
+					GLuint i = y * (gridSize + 1) + x;
+
+					indices.push_back(i);
+					indices.push_back(i + 1);
+					indices.push_back(i + gridSize + 1);
+					indices.push_back(i + 1);
+					indices.push_back(i + gridSize + 2);
+					indices.push_back(i + gridSize + 1);
+				}
+			}
+
+			indexCount = (GLsizei)indices.size();
+
+			glGenBuffers(2, buffers);
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(0);
+
+			time = 0.0f;
+		}
+
+		void frame() override
+		{
+			glUseProgram(program);
+			glUniform1f(glGetUniformLocation(program, "time"), time);
+			glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+
+			time += 0.1f;
+		}
+
+		void tearDown() override
+		{
+			glDisableVertexAttribArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			glDeleteBuffers(2, buffers);
+			glDeleteProgram(program);
+		}
+
+	private:
+		static const int gridSize = 256;
+		GLuint buffers[2];
+		GLsizei indexCount = 0;
+		GLuint program = 0;
+		float time = 0.0f;
+	};
+
+	// Many draw calls of a few pixels each, with a uniform change in between
+	class SmallDrawsBenchmark : public Benchmark
+	{
+	public:
+		SmallDrawsBenchmark() : Benchmark("SmallDraws") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(quadVertexShader, colorFragmentShader);
+		}
+
+		void frame() override
+		{
+			glUseProgram(program);
+
+			GLint colorLocation = glGetUniformLocation(program, "color");
+			GLint transformLocation = glGetUniformLocation(program, "transform");
+			Random random(3);
+
+			for(int i = 0; i < drawCount; i++)
+			{
+				glUniform4f(colorLocation, random.next(), random.next(), random.next(), 1.0f);
+				glUniform4f(transformLocation, 8.0f / width, 8.0f / height, 2.0f * random.next() - 1.0f, 2.0f * random.next() - 1.0f);
+				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			}
+		}
+
+		void tearDown() override
+		{
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int drawCount = 4096;
+		GLuint program = 0;
+	};
+
+	// Small triangles straddling the screen edges, which stay within the guard band,
+	// and long ones reaching far outside it, which have to be clipped
+	class ClippingBenchmark : public Benchmark
+	{
+	public:
+		ClippingBenchmark() : Benchmark("Clipping") {}
+
+		void setUp() override
+		{
+			program = createProgram(quadVertexShader, colorFragmentShader);
+
+			std::vector<GLfloat> vertices;
+			vertices.reserve((edgeTriangles + sliverTriangles) * 3 * 2);
+			Random random(7);
+
+			// Slivers across the screen, so clipping rather than filling dominates their cost
+			for(int i = 0; i < sliverTriangles; i++)
+			{
+				float left = 2.0f * random.next() - 1.0f;
+				float right = 2.0f * random.next() - 1.0f;
+
+				vertices.push_back(-200.0f);
+				vertices.push_back(left);
+				vertices.push_back(200.0f);
+				vertices.push_back(right);
+				vertices.push_back(200.0f);
+				vertices.push_back(right + 0.01f);
+			}
+
+			float sizeX = 32.0f / width;
+			float sizeY = 32.0f / height;
+
+			for(int i = 0; i < edgeTriangles; i++)
+			{
+				float along = 2.0f * random.next() - 1.0f;
+				float side = (i & 2) ? 1.0f : -1.0f;
+				float centerX = (i & 1) ? side : along;
+				float centerY = (i & 1) ? along : side;
+
+				for(int v = 0; v < 3; v++)
+				{
+					vertices.push_back(centerX + sizeX * (random.next() - 0.5f));
+					vertices.push_back(centerY + sizeY * (random.next() - 0.5f));
+				}
+			}
+
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_ARRAY_BUFFER, buffer);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(0);
+		}
+
+		void frame() override
+		{
+			glUseProgram(program);
+			glUniform4f(glGetUniformLocation(program, "transform"), 1.0f, 1.0f, 0.0f, 0.0f);
+			glUniform1f(glGetUniformLocation(program, "depth"), 0.0f);
+
+			GLint colorLocation = glGetUniformLocation(program, "color");
+			glUniform4f(colorLocation, 0.2f, 0.3f, 0.6f, 1.0f);
+			glDrawArrays(GL_TRIANGLES, 0, sliverTriangles * 3);
+			glUniform4f(colorLocation, 0.9f, 0.6f, 0.1f, 1.0f);
+			glDrawArrays(GL_TRIANGLES, sliverTriangles * 3, edgeTriangles * 3);
+		}
+
+		void tearDown() override
+		{
+			glDisableVertexAttribArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glDeleteBuffers(1, &buffer);
+			glDeleteProgram(program);
+		}
+
+	private:
+		static const int edgeTriangles = 24576;
+		static const int sliverTriangles = 64;
+		GLuint buffer = 0;
+		GLuint program = 0;
+	};
+
+	// Rendering into a 4x multisampled renderbuffer, resolved into the pbuffer
+	class MultisampleBenchmark : public Benchmark
+	{
+	public:
+		MultisampleBenchmark() : Benchmark("Multisample") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(
+				"attribute vec2 position;\n"
+				"uniform mat2 rotation;\n"
+				"uniform vec4 transform;\n"   // xy: scale, zw: offset
+				"uniform float depth;\n"
+				"void main()\n"
+				"{\n"
+				"    gl_Position = vec4(rotation * (position * transform.xy) + transform.zw, depth, 1.0);\n"
+				"}\n",
+				colorFragmentShader);
+
+			glGenRenderbuffers(2, renderbuffers);
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+			glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGBA8, width, height);
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+			glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH_COMPONENT24, width, height);
+
+			glGenFramebuffers(1, &framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+			if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				fail("Incomplete multisample framebuffer");
+			}
+
+			glEnable(GL_DEPTH_TEST);
+		}
+
+		void frame() override
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glUseProgram(program);
+
+			Random random(4);
+
+			for(int i = 0; i < layers; i++)
+			{
+				// Rotated quads produce plenty of partially covered edge pixels
+				float angle = random.next() * 6.2831853f;
+				float scale = 0.3f + 0.3f * random.next();
+				const GLfloat rotation[] = {cosf(angle), sinf(angle), -sinf(angle), cosf(angle)};
+				glUniformMatrix2fv(glGetUniformLocation(program, "rotation"), 1, GL_FALSE, rotation);
+				glUniform4f(glGetUniformLocation(program, "color"), random.next(), random.next(), random.next(), 1.0f);
+				drawQuad(program, scale, 0.5f * scale, random.next() - 0.5f, random.next() - 0.5f, random.next() - 0.5f);
+			}
+
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+			glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		}
+
+		void tearDown() override
+		{
+			glDisable(GL_DEPTH_TEST);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glDeleteFramebuffers(1, &framebuffer);
+			glDeleteRenderbuffers(2, renderbuffers);
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		static const int layers = 32;
+		GLuint renderbuffers[2];
+		GLuint framebuffer = 0;
+		GLuint program = 0;
+	};
+
+	// Scaled framebuffer blits followed by a full readback
+	class BlitBenchmark : public Benchmark
+	{
+	public:
+		BlitBenchmark() : Benchmark("BlitReadback") {}
+
+		void setUp() override
+		{
+			createQuad();
+			program = createProgram(quadVertexShader, colorFragmentShader);
+
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width / 2, height / 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+			glGenFramebuffers(1, &framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			pixels.resize(width * height * 4);
+		}
+
+		void frame() override
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glViewport(0, 0, width / 2, height / 2);
+			glUseProgram(program);
+			glUniform4f(glGetUniformLocation(program, "color"), 0.9f, 0.4f, 0.1f, 1.0f);
+			drawQuad(program, 0.5f, 0.5f, 0.0f, 0.0f);
+
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+			glViewport(0, 0, width, height);
+			glBlitFramebuffer(0, 0, width / 2, height / 2, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+			glBlitFramebuffer(0, 0, width / 2, height / 2, width / 4, height / 4, width / 2, height / 2, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		}
+
+		void tearDown() override
+		{
+			glDeleteFramebuffers(1, &framebuffer);
+			glDeleteTextures(1, &texture);
+			glDeleteProgram(program);
+			deleteQuad();
+		}
+
+	private:
+		GLuint texture = 0;
+		GLuint framebuffer = 0;
+		GLuint program = 0;
+		std::vector<GLubyte> pixels;
+	};
+
+	// Every frame links a program which hasn't been seen before, so each one
+	// misses the routine caches and pays for shader and routine compilation.
+	class ShaderCompileBenchmark : public Benchmark
+	{
+	public:
+		ShaderCompileBenchmark() : Benchmark("ShaderCompile") {}
+
+		void setUp() override
+		{
+			createQuad();
+			variant = 0;
+		}
+
+		void frame() override
+		{
+			char fragmentShader[512];
+			snprintf(fragmentShader, sizeof(fragmentShader),
+				"precision mediump float;\n"
+				"varying vec2 texCoord;\n"
+				"void main()\n"
+				"{\n"
+				"    vec2 p = texCoord * %d.0;\n"
+				"    gl_FragColor = vec4(fract(p), sin(p.x * p.y), 1.0);\n"
+				"}\n", ++variant);
+
+			GLuint program = createProgram(quadVertexShader, fragmentShader);
+			glUseProgram(program);
+			drawQuad(program, 0.1f, 0.1f, 0.0f, 0.0f);
+			glDeleteProgram(program);
+		}
+
+		void tearDown() override
+		{
+			deleteQuad();
+		}
+
+	private:
+		int variant = 0;
+	};
+
+	// Binds and queries objects drawn at random from a large set of live
+	// textures and buffers, which exercises object name lookup on the API
+	// thread. Nothing is drawn.
+	class ObjectBindingBenchmark : public Benchmark
+	{
+	public:
+		ObjectBindingBenchmark() : Benchmark("ObjectBinding") {}
+
+		void setUp() override
+		{
+			textures.resize(objectCount);
+			buffers.resize(objectCount);
+			glGenTextures(objectCount, textures.data());
+			glGenBuffers(objectCount, buffers.data());
+
+			for(int i = 0; i < objectCount; i++)   // Binding creates the objects
+			{
+				glBindTexture(GL_TEXTURE_2D, textures[i]);
+				glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+			}
+		}
+
+		void frame() override
+		{
+			Random random(5);
+			GLboolean live = GL_TRUE;
+
+			for(int i = 0; i < bindCount; i++)
+			{
+				int index = (int)(random.next() * objectCount);
+
+				glBindTexture(GL_TEXTURE_2D, textures[index]);
+				glBindBuffer(GL_ARRAY_BUFFER, buffers[index]);
+				live &= glIsTexture(textures[objectCount - 1 - index]);
+			}
+
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			if(!live)
+			{
+				fail("ObjectBinding: texture name lookup failed");
+			}
+		}
+
+		void tearDown() override
+		{
+			glDeleteTextures(objectCount, textures.data());
+			glDeleteBuffers(objectCount, buffers.data());
+		}
+
+	private:
+		static const int objectCount = 16384;
+		static const int bindCount = 65536;
+		std::vector<GLuint> textures;
+		std::vector<GLuint> buffers;
+	};
+
+	struct Result
+	{
+		double firstFrame;   // Seconds, including routine compilation
+		double submit;       // Seconds per frame spent issuing commands
+		double finish;       // Seconds per frame spent waiting for rendering
+		double median;       // Median frame time in seconds
+		double total;        // Seconds for all measured frames
+		uint32_t checksum;
+	};
+
+	uint32_t framebufferChecksum()
+	{
+		std::vector<GLubyte> pixels(width * height * 4);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+		uint32_t hash = 2166136261u;   // FNV-1a
+
+		for(GLubyte pixel : pixels)
+		{
+			hash = (hash ^ pixel) * 16777619u;
+		}
+
+		return hash;
+	}
+
+	Result run(Benchmark &benchmark, int frames)
+	{
+		Result result = {};
+
+		glViewport(0, 0, width, height);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		benchmark.setUp();
+		glFinish();
+		checkGLError(benchmark.name);
+
+		double start = now();
+		benchmark.frame();
+		glFinish();
+		result.firstFrame = now() - start;
+
+		std::vector<double> frameTimes(frames);
+
+		for(int i = 0; i < frames; i++)
+		{
+			double frameStart = now();
+			benchmark.frame();
+			double submitted = now();
+			glFinish();
+			double finished = now();
+
+			result.submit += submitted - frameStart;
+			result.finish += finished - submitted;
+			frameTimes[i] = finished - frameStart;
+		}
+
+		checkGLError(benchmark.name);
+
+		for(double time : frameTimes)
+		{
+			result.total += time;
+		}
+
+		result.submit /= frames;
+		result.finish /= frames;
+
+		std::sort(frameTimes.begin(), frameTimes.end());
+		result.median = frameTimes[frames / 2];
+
+		result.checksum = framebufferChecksum();
+		benchmark.tearDown();
+		checkGLError(benchmark.name);
+
+		return result;
+	}
+
+	class PbufferContext
+	{
+	public:
+		PbufferContext()
+		{
+			#if defined(_WIN32)
+				// Make sure SwiftShader's libraries are used, from the same directory as the executable
+				LoadLibraryA("libEGL.dll");
+				LoadLibraryA("libGLESv2.dll");
+			#endif
+
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+			if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+			{
+				fail("Failed to initialize EGL");
+			}
+
+			eglBindAPI(EGL_OPENGL_ES_API);
+
+			const EGLint configAttributes[] =
+			{
+				EGL_SURFACE_TYPE,		EGL_PBUFFER_BIT,
+				EGL_RENDERABLE_TYPE,	EGL_OPENGL_ES2_BIT,
+				EGL_RED_SIZE,			8,
+				EGL_GREEN_SIZE,			8,
+				EGL_BLUE_SIZE,			8,
+				EGL_ALPHA_SIZE,			8,
+				EGL_DEPTH_SIZE,			24,
+				EGL_NONE
+			};
+
+			EGLConfig config;
+			EGLint configCount = 0;
+
+			if(!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount != 1)
+			{
+				fail("No suitable EGL config");
+			}
+
+			const EGLint surfaceAttributes[] =
+			{
+				EGL_WIDTH, width,
+				EGL_HEIGHT, height,
+				EGL_NONE
+			};
+
+			surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+			const EGLint contextAttributes[] =
+			{
+				EGL_CONTEXT_CLIENT_VERSION, 3,
+				EGL_NONE
+			};
+
+			context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+			if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+			{
+				fail("Failed to create the EGL pbuffer context");
+			}
+		}
+
+		~PbufferContext()
+		{
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext(display, context);
+			eglDestroySurface(display, surface);
+			eglTerminate(display);
+		}
+
+	private:
+		EGLDisplay display;
+		EGLSurface surface;
+		EGLContext context;
+	};
+
+	bool parseOption(const char *argument, const char *option, const char **value)
+	{
+		size_t length = strlen(option);
+
+		if(strncmp(argument, option, length) == 0 && argument[length] == '=')
+		{
+			*value = argument + length + 1;
+			return true;
+		}
+
+		return false;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = "";
+	int frames = 50;
+	bool csv = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *value = nullptr;
+
+		if(parseOption(argv[i], "--filter", &value))
+		{
+			filter = value;
+		}
+		else if(parseOption(argv[i], "--frames", &value))
+		{
+			frames = std::max(atoi(value), 1);
+		}
+		else if(parseOption(argv[i], "--width", &value))
+		{
+			width = std::max(atoi(value), 16);
+		}
+		else if(parseOption(argv[i], "--height", &value))
+		{
+			height = std::max(atoi(value), 16);
+		}
+		else if(strcmp(argv[i], "--csv") == 0)
+		{
+			csv = true;
+		}
+		else
+		{
+			printf("Usage: %s [--filter=<substring>] [--frames=<count>] [--width=<pixels>] [--height=<pixels>] [--csv]\n", argv[0]);
+			return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	PbufferContext context;
+
+	FillRateBenchmark fillRate;
+	OverdrawBenchmark overdraw;
+	TextureBenchmark texture;
+	RotatedTextureBenchmark rotated0("Rotated0", 0.0f);
+	RotatedTextureBenchmark rotated45("Rotated45", 45.0f);
+	RotatedTextureBenchmark rotated90("Rotated90", 90.0f);
+	UberShaderBenchmark uberShader;
+	ShaderCorpusBenchmark shaderCorpus;
+	VertexBenchmark vertex;
+	SmallDrawsBenchmark smallDraws;
+	ClippingBenchmark clipping;
+	MultisampleBenchmark multisample;
+	BlitBenchmark blit;
+	ShaderCompileBenchmark shaderCompile;
+	ObjectBindingBenchmark objectBinding;
+
+	Benchmark *benchmarks[] = {&fillRate, &overdraw, &texture, &vertex, &smallDraws, &multisample, &blit, &shaderCompile, &objectBinding, &rotated0, &rotated45, &rotated90, &uberShader, &clipping, &shaderCorpus};
+
+	if(csv)
+	{
+		printf("benchmark,fps,median_ms,submit_ms,finish_ms,first_frame_ms,jit_ms,checksum\n");
+	}
+	else
+	{
+		printf("%dx%d, %d frames\n", width, height, frames);
+		printf("%-14s %10s %10s %10s %10s %12s %10s %10s\n", "Benchmark", "FPS", "Median ms", "Submit ms", "Finish ms", "First ms", "JIT ms", "Checksum");
+	}
+
+	for(Benchmark *benchmark : benchmarks)
+	{
+		if(!strstr(benchmark->name, filter))
+		{
+			continue;
+		}
+
+		Result result = run(*benchmark, frames);
+
+		double fps = frames / result.total;
+		double jit = std::max(result.firstFrame - result.median, 0.0);   // First frame overhead, mostly routine compilation
+		const char *format = csv ? "%s,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%08X\n" : "%-14s %10.2f %10.3f %10.3f %10.3f %12.3f %10.3f   %08X\n";
+
+		printf(format, benchmark->name, fps, result.median * 1e3, result.submit * 1e3, result.finish * 1e3, result.firstFrame * 1e3, jit * 1e3, result.checksum);
+		fflush(stdout);
+	}
+
+	return EXIT_SUCCESS;
+}
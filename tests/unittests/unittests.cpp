@@ -29,8 +29,12 @@
 #include <Windows.h>
 #endif
 
+#include <math.h>
+#include <stdio.h>
 #include <string.h>
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #define EXPECT_GLENUM_EQ(expected, actual) EXPECT_EQ(static_cast<GLenum>(expected), static_cast<GLenum>(actual))
 
@@ -312,6 +316,43 @@ protected:
 		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
 	}
 
+	// Renders into a 32-bit floating-point color buffer, so shader results can be compared exactly
+	void bindFloatFramebuffer(GLsizei width, GLsizei height)
+	{
+		GLuint texture = 0;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, width, height);
+
+		GLuint framebuffer = 0;
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+		EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+
+		glViewport(0, 0, width, height);
+	}
+
+	// Options are read from SwiftShader.ini in the working directory when a context is created
+	void setOptions(const char *section, const char *options)
+	{
+		FILE *ini = fopen("SwiftShader.ini", "w");
+		ASSERT_NE(nullptr, ini);
+		fprintf(ini, "[%s]\n%s\n", section, options);
+		fclose(ini);
+	}
+
+	void setTestingOptions(const char *options)
+	{
+		setOptions("Testing", options);
+	}
+
+	void resetOptions()
+	{
+		remove("SwiftShader.ini");
+	}
+
 	EGLDisplay getDisplay() const { return display; }
 	EGLConfig getConfig() const { return config; }
 	EGLSurface getSurface() const { return surface; }
@@ -626,6 +667,937 @@ TEST_F(SwiftShaderTest, ReadHalfFloat)
 	Uninitialize();
 }
 
+// Tests that partial uploads and scissored rendering, which only convert the
+// affected region between the internal and external buffers, read back correctly.
+TEST_F(SwiftShaderTest, PartialUploadAndReadback)
+{
+	Initialize(3, false);
+
+	const float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+	const float green[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+	const float blue[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	std::vector<float> texels(64 * 64 * 4);
+	for(size_t i = 0; i < texels.size(); i += 4)
+	{
+		memcpy(&texels[i], red, sizeof(red));
+	}
+
+	GLuint tex = 1;
+	glBindTexture(GL_TEXTURE_2D, tex);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, 64, 64, 0, GL_RGBA, GL_FLOAT, texels.data());
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	GLuint fbo = 1;
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+	EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+
+	expectFramebufferColor(red, 20, 20);
+
+	std::vector<float> block(4 * 4 * 4);
+	for(size_t i = 0; i < block.size(); i += 4)
+	{
+		memcpy(&block[i], green, sizeof(green));
+	}
+
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 8, 12, 4, 4, GL_RGBA, GL_FLOAT, block.data());
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	const std::string vs =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+		"}\n";
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(0.0, 0.0, 1.0, 1.0);\n"
+		"}\n";
+
+	const ProgramHandles ph = createProgram(vs, fs);
+
+	glViewport(0, 0, 64, 64);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(32, 40, 16, 8);
+	drawQuad(ph.program);
+	glDisable(GL_SCISSOR_TEST);
+
+	deleteProgram(ph);
+
+	expectFramebufferColor(green, 8, 12);
+	expectFramebufferColor(green, 11, 15);
+	expectFramebufferColor(red, 12, 12);
+	expectFramebufferColor(blue, 32, 40);
+	expectFramebufferColor(blue, 47, 47);
+	expectFramebufferColor(red, 31, 40);
+	expectFramebufferColor(red, 48, 47);
+	expectFramebufferColor(red, 32, 48);
+	expectFramebufferColor(red, 63, 63);
+
+	// Upload into the rendered region, then read back the whole level
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 40, 42, 2, 2, GL_RGBA, GL_FLOAT, block.data());
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	std::vector<float> pixels(64 * 64 * 4);
+	glReadPixels(0, 0, 64, 64, GL_RGBA, GL_FLOAT, pixels.data());
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	for(int y = 0; y < 64; y++)
+	{
+		for(int x = 0; x < 64; x++)
+		{
+			const float *expected = red;
+
+			if(x >= 8 && x < 12 && y >= 12 && y < 16)
+			{
+				expected = green;
+			}
+			else if(x >= 40 && x < 42 && y >= 42 && y < 44)
+			{
+				expected = green;
+			}
+			else if(x >= 32 && x < 48 && y >= 40 && y < 48)
+			{
+				expected = blue;
+			}
+
+			EXPECT_EQ(0, memcmp(&pixels[(y * 64 + x) * 4], expected, sizeof(red))) << "at " << x << ", " << y;
+		}
+	}
+
+	Uninitialize();
+}
+
+// Tests that asynchronous readbacks into pixel pack buffers see the contents at the time of
+// the glReadPixels call, even when the source is written to again before they complete.
+TEST_F(SwiftShaderTest, PixelPackBufferReadbackOrdering)
+{
+	Initialize(3, false);
+
+	GLuint tex = 1;
+	glBindTexture(GL_TEXTURE_2D, tex);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	GLuint fbo = 1;
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+	EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+
+	std::vector<unsigned char> block(16 * 16 * 4, 0x80);
+
+	const int frames = 8;
+	GLuint buffers[frames];
+	glGenBuffers(frames, buffers);
+
+	for(int i = 0; i < frames; i++)
+	{
+		glClearColor(i / 255.0f, 0.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[i]);
+		glBufferData(GL_PIXEL_PACK_BUFFER, 64 * 64 * 4, nullptr, GL_STREAM_READ);
+		glReadPixels(0, 0, 64, 64, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		// Overwrite part of the source before the readback is known to have completed
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 8, 8, 16, 16, GL_RGBA, GL_UNSIGNED_BYTE, block.data());
+	}
+
+	for(int i = 0; i < frames; i++)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[i]);
+		const unsigned char *pixels = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 64 * 64 * 4, GL_MAP_READ_BIT));
+		ASSERT_NE(nullptr, pixels);
+
+		for(int offset : { 0, (10 * 64 + 10) * 4, (63 * 64 + 63) * 4 })
+		{
+			EXPECT_EQ(i, pixels[offset + 0]);
+			EXPECT_EQ(0, pixels[offset + 1]);
+			EXPECT_EQ(255, pixels[offset + 2]);
+			EXPECT_EQ(255, pixels[offset + 3]);
+		}
+
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glDeleteBuffers(frames, buffers);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	Uninitialize();
+}
+
+// Tests that sampling textures stored in Morton ordered macro-tiles gives the same results as
+// the linear layout, for sizes which aren't a multiple of the tile size and for small mipmap levels.
+TEST_F(SwiftShaderTest, TiledTextureLayout)
+{
+	const int width = 100;
+	const int height = 70;
+
+	std::vector<unsigned char> texels8(width * height * 4);
+	std::vector<float> texels16f(width * height * 4);
+
+	for(int i = 0; i < width * height * 4; i++)
+	{
+		texels8[i] = (unsigned char)((i * 37 + (i / (width * 4)) * 101) & 0xFF);
+		texels16f[i] = (float)((i * 3 + (i / (width * 4)) * 5) % 17) / 16.0f;
+	}
+
+	const std::string vs =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+		"}\n";
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D texture8;\n"
+		"uniform sampler2D texture16f;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 uv = mat2(0.8, 0.6, -0.6, 0.8) * gl_FragCoord.xy / 45.0;\n"
+		"	ivec2 xy = ivec2(gl_FragCoord.xy) % ivec2(100, 70);\n"
+		"	fragColor = vec4(texture(texture8, uv).rg, texture(texture16f, uv).b, texelFetch(texture8, xy, 0).a);\n"
+		"}\n";
+
+	std::vector<unsigned char> pixels[2];
+
+	for(int tiled = 0; tiled < 2; tiled++)
+	{
+		if(tiled)
+		{
+			setTestingOptions("TiledTextureLayout=1");
+		}
+
+		Initialize(3, false);
+
+		GLuint textures[2];
+		glGenTextures(2, textures);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, textures[0]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels8.data());
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, textures[1]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, texels16f.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		const ProgramHandles ph = createProgram(vs, fs);
+
+		glUseProgram(ph.program);
+		glUniform1i(glGetUniformLocation(ph.program, "texture8"), 0);
+		glUniform1i(glGetUniformLocation(ph.program, "texture16f"), 1);
+
+		glViewport(0, 0, 256, 256);
+		drawQuad(ph.program);
+
+		pixels[tiled].resize(256 * 256 * 4);
+		glReadPixels(0, 0, 256, 256, GL_RGBA, GL_UNSIGNED_BYTE, pixels[tiled].data());
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		deleteProgram(ph);
+		glDeleteTextures(2, textures);
+
+		Uninitialize();
+
+		if(tiled)
+		{
+			resetOptions();
+		}
+	}
+
+	for(int y = 0; y < 256; y++)
+	{
+		for(int x = 0; x < 256; x++)
+		{
+			int i = (y * 256 + x) * 4;
+			EXPECT_EQ(texels8[((y % height) * width + (x % width)) * 4 + 3], pixels[1][i + 3]) << "at " << x << ", " << y;
+			EXPECT_EQ(0, memcmp(&pixels[0][i], &pixels[1][i], 4)) << "at " << x << ", " << y;
+		}
+	}
+}
+
+const std::string quadVertexShader =
+	"#version 300 es\n"
+	"in vec4 position;\n"
+	"void main()\n"
+	"{\n"
+	"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+	"}\n";
+
+// Tests constant folding, copy propagation and result forwarding around dynamic branches and loops
+TEST_F(SwiftShaderTest, OptimizerBranchesAndLoops)
+{
+	Initialize(3, false);
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform int count;\n"
+		"uniform float scale;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	float k = scale * 0.5;\n"
+		"	float a = 0.25;\n"
+		"	float b = a * 2.0;\n"
+		"	vec4 c = vec4(b, 0.0, 0.0, 1.0);\n"
+		"	vec4 d = c;\n"
+		"	if(gl_FragCoord.x < 32.0)\n"
+		"	{\n"
+		"		d.g = d.r;\n"
+		"		c = d;\n"
+		"	}\n"
+		"	else\n"
+		"	{\n"
+		"		c.b = b;\n"
+		"	}\n"
+		"	for(int i = 0; i < count; i++)\n"
+		"	{\n"
+		"		float t = c.r + 0.125;\n"
+		"		c.r = t;\n"
+		"	}\n"
+		"	float sum = 0.0;\n"
+		"	for(int i = 0; i < count; i++)\n"
+		"	{\n"
+		"		sum += k;\n"   // k is last read here, but must stay live for the next iteration
+		"		float u = sum * 3.0 + float(i);\n"
+		"		sum = u - sum * 2.0 - float(i);\n"
+		"	}\n"
+		"	fragColor = vec4(c.rgb, sum);\n"
+		"}\n";
+
+	const ProgramHandles ph = createProgram(quadVertexShader, fs);
+
+	glUseProgram(ph.program);
+	glUniform1i(glGetUniformLocation(ph.program, "count"), 3);
+	glUniform1f(glGetUniformLocation(ph.program, "scale"), 0.25f);
+
+	bindFloatFramebuffer(64, 64);
+	drawQuad(ph.program);
+
+	const float left[4] = { 0.875f, 0.5f, 0.0f, 0.375f };
+	const float right[4] = { 0.875f, 0.0f, 0.5f, 0.375f };
+	expectFramebufferColor(left, 8, 8);
+	expectFramebufferColor(right, 40, 8);
+
+	deleteProgram(ph);
+
+	Uninitialize();
+}
+
+// Tests shaders with relative addressing of temporaries, and of uniforms indexed by temporaries
+TEST_F(SwiftShaderTest, OptimizerRelativeAddressing)
+{
+	Initialize(3, false);
+
+	const float constants[16] =
+	{
+		0.0f, 0.0f, 0.0f,  0.0f,
+		0.0f, 0.0f, 0.25f, 0.0f,
+		0.0f, 0.0f, 0.5f,  0.0f,
+		0.0f, 0.0f, 0.75f, 0.0f,
+	};
+
+	const std::string arrayShader =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform int index;\n"
+		"uniform vec4 constants[4];\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 a[4];\n"
+		"	for(int i = 0; i < 4; i++)\n"
+		"	{\n"
+		"		a[i] = vec4(float(i) * 0.25);\n"
+		"	}\n"
+		"	int j = int(gl_FragCoord.x) / 32;\n"
+		"	a[j + index].x = 0.125;\n"
+		"	vec4 v = a[index];\n"
+		"	vec4 u = constants[j + 1];\n"
+		"	fragColor = vec4(v.x, v.y, u.z, a[3].x);\n"
+		"}\n";
+
+	const std::string uniformShader =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform int index;\n"
+		"uniform vec4 constants[4];\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	int j = int(gl_FragCoord.x) / 32 + index - 1;\n"
+		"	float f = gl_FragCoord.y * 0.5 + 1.0;\n"   // Mustn't take the register of j
+		"	vec4 u = constants[j] * floor(f / 32.0 + 1.0);\n"
+		"	vec4 w = constants[j + 1];\n"
+		"	int k = j;\n"
+		"	fragColor = vec4(u.z, w.z, constants[k].z * 2.0, 1.0);\n"
+		"}\n";
+
+	bindFloatFramebuffer(64, 64);
+
+	const ProgramHandles array = createProgram(quadVertexShader, arrayShader);
+	glUseProgram(array.program);
+	glUniform1i(glGetUniformLocation(array.program, "index"), 2);
+	glUniform4fv(glGetUniformLocation(array.program, "constants"), 4, constants);
+	drawQuad(array.program);
+
+	const float arrayLeft[4] = { 0.125f, 0.5f, 0.25f, 0.75f };
+	const float arrayRight[4] = { 0.5f, 0.5f, 0.5f, 0.125f };
+	expectFramebufferColor(arrayLeft, 8, 8);
+	expectFramebufferColor(arrayRight, 40, 8);
+
+	const ProgramHandles uniform = createProgram(quadVertexShader, uniformShader);
+	glUseProgram(uniform.program);
+	glUniform1i(glGetUniformLocation(uniform.program, "index"), 2);
+	glUniform4fv(glGetUniformLocation(uniform.program, "constants"), 4, constants);
+	drawQuad(uniform.program);
+
+	const float uniformLeft[4] = { 0.25f, 0.5f, 0.5f, 1.0f };
+	const float uniformRight[4] = { 0.5f, 0.75f, 1.0f, 1.0f };
+	expectFramebufferColor(uniformLeft, 8, 8);
+	expectFramebufferColor(uniformRight, 40, 8);
+
+	deleteProgram(array);
+	deleteProgram(uniform);
+
+	Uninitialize();
+}
+
+// Tests copy propagation and dead code removal with partial write masks and swizzles
+TEST_F(SwiftShaderTest, OptimizerWriteMasksAndSwizzles)
+{
+	Initialize(3, false);
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 color;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 a = color;\n"
+		"	vec4 b;\n"
+		"	b.xz = a.yx;\n"
+		"	b.yw = a.wz;\n"
+		"	vec3 c = b.zyx * 2.0;\n"
+		"	vec2 d = -a.wx;\n"
+		"	a.y = c.z;\n"
+		"	fragColor = vec4(c.x + d.y, a.y + b.w, c.z - a.x, b.y);\n"
+		"}\n";
+
+	const ProgramHandles ph = createProgram(quadVertexShader, fs);
+
+	glUseProgram(ph.program);
+	glUniform4f(glGetUniformLocation(ph.program, "color"), 0.125f, 0.25f, 0.5f, 1.0f);
+
+	bindFloatFramebuffer(64, 64);
+	drawQuad(ph.program);
+
+	const float expected[4] = { 0.125f, 1.0f, 0.375f, 1.0f };
+	expectFramebufferColor(expected, 8, 8);
+
+	deleteProgram(ph);
+
+	Uninitialize();
+}
+
+// Tests that dead code removal keeps the values discard depends on
+TEST_F(SwiftShaderTest, OptimizerDeadCodeAndDiscard)
+{
+	Initialize(3, false);
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform float threshold;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	float unused = gl_FragCoord.y * 3.0;\n"
+		"	float x = gl_FragCoord.x - threshold;\n"
+		"	fragColor = vec4(0.0, 1.0, 0.0, 1.0);\n"
+		"	if(x < 0.0)\n"
+		"	{\n"
+		"		fragColor = vec4(unused);\n"
+		"		discard;\n"
+		"	}\n"
+		"	vec4 dead = vec4(unused, x, 0.0, 1.0);\n"
+		"}\n";
+
+	const ProgramHandles ph = createProgram(quadVertexShader, fs);
+
+	glUseProgram(ph.program);
+	glUniform1f(glGetUniformLocation(ph.program, "threshold"), 32.0f);
+
+	bindFloatFramebuffer(64, 64);
+	glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	drawQuad(ph.program);
+
+	const float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+	const float green[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+	expectFramebufferColor(red, 8, 8);
+	expectFramebufferColor(red, 31, 60);
+	expectFramebufferColor(green, 32, 8);
+	expectFramebufferColor(green, 63, 60);
+
+	deleteProgram(ph);
+
+	Uninitialize();
+}
+
+// Tests that compressed textures sampled directly from their blocks match their decompressed equivalents,
+// at dimensions which aren't a multiple of the block size and down to the mipmap tail
+TEST_F(SwiftShaderTest, CompressedTextureSampling)
+{
+	const struct
+	{
+		GLenum format;
+		int blockSize;
+	}
+	formats[] =
+	{
+		{ GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 8 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT3_ANGLE, 16 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT5_ANGLE, 16 },
+		{ GL_ETC1_RGB8_OES, 8 },
+		{ GL_COMPRESSED_RGB8_ETC2, 8 },
+		{ GL_COMPRESSED_SRGB8_ETC2, 8 },
+		{ GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 8 },
+		{ GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, 8 },
+		{ GL_COMPRESSED_RGBA8_ETC2_EAC, 16 },
+		{ GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, 16 },
+		{ GL_COMPRESSED_R11_EAC, 8 },
+		{ GL_COMPRESSED_SIGNED_R11_EAC, 8 },
+		{ GL_COMPRESSED_RG11_EAC, 16 },
+		{ GL_COMPRESSED_SIGNED_RG11_EAC, 16 },
+	};
+
+	const int formatCount = sizeof(formats) / sizeof(formats[0]);
+	const int width = 13;
+	const int height = 10;
+	const int levels = 4;   // 13x10, 6x5, 3x2, 1x1
+
+	// Random block contents exercise every block mode
+	std::vector<unsigned char> blocks(((width + 3) / 4) * ((height + 3) / 4) * 16);
+	unsigned int seed = 0x2545F491;
+
+	for(size_t i = 0; i < blocks.size(); i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		blocks[i] = (unsigned char)(seed >> 16);
+	}
+
+	// The bottom rows fetch texels from each level, the top rows filter at lods in between levels
+	const std::string fs =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform sampler2D tex;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	int band = int(gl_FragCoord.y) / 8;\n"
+		"	if(band < 4)\n"
+		"	{\n"
+		"		ivec2 xy = ivec2(gl_FragCoord.xy) % textureSize(tex, band);\n"
+		"		fragColor = texelFetch(tex, xy, band);\n"
+		"	}\n"
+		"	else\n"
+		"	{\n"
+		"		vec2 uv = mat2(0.8, 0.6, -0.6, 0.8) * gl_FragCoord.xy / 23.0;\n"
+		"		fragColor = textureLod(tex, uv, float(band - 4) * 0.9);\n"
+		"	}\n"
+		"}\n";
+
+	std::vector<float> pixels[2];
+
+	for(int direct = 0; direct < 2; direct++)
+	{
+		if(direct)
+		{
+			setTestingOptions("CompressedTextureSampling=1");
+		}
+
+		Initialize(3, false);
+
+		const ProgramHandles ph = createProgram(quadVertexShader, fs);
+
+		glUseProgram(ph.program);
+		glUniform1i(glGetUniformLocation(ph.program, "tex"), 0);
+
+		bindFloatFramebuffer(64, 64);
+		pixels[direct].resize(formatCount * 64 * 64 * 4);
+
+		for(int f = 0; f < formatCount; f++)
+		{
+			GLuint texture = 0;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+
+			for(int level = 0; level < levels; level++)
+			{
+				int w = std::max(width >> level, 1);
+				int h = std::max(height >> level, 1);
+				int size = ((w + 3) / 4) * ((h + 3) / 4) * formats[f].blockSize;
+
+				glCompressedTexImage2D(GL_TEXTURE_2D, level, formats[f].format, w, h, 0, size, blocks.data());
+			}
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			EXPECT_GLENUM_EQ(GL_NONE, glGetError()) << "format " << f;
+
+			drawQuad(ph.program);
+			glReadPixels(0, 0, 64, 64, GL_RGBA, GL_FLOAT, &pixels[direct][f * 64 * 64 * 4]);
+			EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+			glDeleteTextures(1, &texture);
+		}
+
+		deleteProgram(ph);
+
+		Uninitialize();
+
+		if(direct)
+		{
+			resetOptions();
+		}
+	}
+
+	for(int f = 0; f < formatCount; f++)
+	{
+		for(int i = 0; i < 64 * 64 * 4; i++)
+		{
+			float expected = pixels[0][f * 64 * 64 * 4 + i];
+			float actual = pixels[1][f * 64 * 64 * 4 + i];
+
+			// Filtering the decoded texels is done at 16-bit precision
+			EXPECT_NEAR(expected, actual, 1.0f / 256.0f) << "format " << f << " at " << (i / 4) % 64 << ", " << i / 4 / 64 << " component " << i % 4;
+		}
+	}
+}
+
+// Tests that routines specialized on the dimensions of single level power-of-two textures sample like
+// the generic ones, and that mixed minification and magnification filters still select by level of detail
+TEST_F(SwiftShaderTest, SpecializeSamplers)
+{
+	const struct
+	{
+		int width;
+		int height;
+	}
+	sizes[] =
+	{
+		{ 16, 8 },
+		{ 1, 16 },
+		{ 16, 1 },
+		{ 12, 10 },   // Not specialized
+	};
+
+	// 8-bit textures are sampled in fixed-point, half-float ones in floating-point
+	const GLenum formats[] = { GL_RGBA8, GL_RGBA16F };
+
+	const GLenum wrapModes[] = { GL_REPEAT, GL_CLAMP_TO_EDGE, GL_MIRRORED_REPEAT };
+
+	const GLenum filters[][2] =   // Minification and magnification
+	{
+		{ GL_NEAREST, GL_NEAREST },
+		{ GL_LINEAR, GL_LINEAR },
+		{ GL_LINEAR, GL_NEAREST },
+		{ GL_NEAREST, GL_LINEAR },
+	};
+
+	const float scales[] = { 1.0f, 8.0f };   // Magnified and minified
+
+	const int sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+	const int drawCount = 2 * sizeCount * 3 * 4 * 2;
+	const int drawSize = 64 * 64 * 4;
+
+	std::vector<unsigned char> texels8(16 * 16 * 4);
+	std::vector<float> texels16f(16 * 16 * 4);
+
+	for(size_t i = 0; i < texels8.size(); i++)
+	{
+		texels8[i] = (unsigned char)((i * 73 + (i >> 4) * 29) & 0xFF);
+		texels16f[i] = (float)texels8[i] / 255.0f;
+	}
+
+	// Bands of quads sample with implicit lod, with an offset, with texelFetch, and with a bias
+	const std::string fs =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform sampler2D tex;\n"
+		"uniform float scale;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 uv = mat2(0.8, 0.6, -0.6, 0.8) * (gl_FragCoord.xy - 20.0) * scale / 23.0;\n"
+		"	int band = int(gl_FragCoord.y) / 16;\n"
+		"	if(band == 0)\n"
+		"	{\n"
+		"		fragColor = texture(tex, uv);\n"
+		"	}\n"
+		"	else if(band == 1)\n"
+		"	{\n"
+		"		fragColor = textureOffset(tex, uv, ivec2(-3, 2));\n"
+		"	}\n"
+		"	else if(band == 2)\n"
+		"	{\n"
+		"		fragColor = texelFetch(tex, ivec2(gl_FragCoord.xy) % textureSize(tex, 0), 0);\n"
+		"	}\n"
+		"	else\n"
+		"	{\n"
+		"		fragColor = texture(tex, uv, -0.5);\n"
+		"	}\n"
+		"}\n";
+
+	std::vector<float> pixels[2];
+
+	for(int specialize = 0; specialize < 2; specialize++)
+	{
+		if(specialize)
+		{
+			setOptions("Optimization", "SpecializeSamplers=1");
+		}
+
+		Initialize(3, false);
+
+		bindFloatFramebuffer(64, 64);
+		pixels[specialize].resize(drawCount * drawSize);
+
+		GLuint texture = 0;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+
+		int draw = 0;
+
+		for(int t = 0; t < 2 * sizeCount; t++)
+		{
+			const int s = t % sizeCount;
+
+			// Each texture gets its own program, to stay below the cap on specialized routines per shader
+			const ProgramHandles ph = createProgram(quadVertexShader, fs);
+
+			glUseProgram(ph.program);
+			glUniform1i(glGetUniformLocation(ph.program, "tex"), 0);
+
+			if(formats[t / sizeCount] == GL_RGBA8)
+			{
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, sizes[s].width, sizes[s].height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels8.data());
+			}
+			else
+			{
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, sizes[s].width, sizes[s].height, 0, GL_RGBA, GL_FLOAT, texels16f.data());
+			}
+
+			for(int w = 0; w < 3; w++)
+			{
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapModes[w]);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapModes[(w + 1) % 3]);
+
+				for(int f = 0; f < 4; f++)
+				{
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filters[f][0]);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filters[f][1]);
+
+					for(int k = 0; k < 2; k++)
+					{
+						glUniform1f(glGetUniformLocation(ph.program, "scale"), scales[k]);
+
+						drawQuad(ph.program);
+						glReadPixels(0, 0, 64, 64, GL_RGBA, GL_FLOAT, &pixels[specialize][draw * drawSize]);
+						EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+						draw++;
+					}
+				}
+			}
+
+			deleteProgram(ph);
+		}
+
+		glDeleteTextures(1, &texture);
+
+		Uninitialize();
+
+		if(specialize)
+		{
+			resetOptions();
+		}
+	}
+
+	for(int draw = 0; draw < drawCount; draw++)
+	{
+		const float *expected = &pixels[0][draw * drawSize];
+		const float *actual = &pixels[1][draw * drawSize];
+
+		EXPECT_EQ(0, memcmp(expected, actual, drawSize * sizeof(float))) << "texture " << draw / 24 << " wrap " << (draw / 8) % 3 << " filter " << (draw / 2) % 4 << " scale " << draw % 2;
+	}
+
+	// A magnified texture is sampled with the magnification filter only, a minified one with the minification filter only.
+	// Mixed filters take the bilinear path with the neighbor offsets masked off, so point sampling isn't bit-exact.
+	const struct
+	{
+		int mixed;   // Draw index within a group of filters and scales
+		int pure;
+		const char *name;
+	}
+	pairs[] =
+	{
+		{ 4, 0, "MIN_LINEAR_MAG_POINT magnified" },
+		{ 5, 3, "MIN_LINEAR_MAG_POINT minified" },
+		{ 6, 2, "MIN_POINT_MAG_LINEAR magnified" },
+		{ 7, 1, "MIN_POINT_MAG_LINEAR minified" },
+	};
+
+	for(int specialize = 0; specialize < 2; specialize++)
+	{
+		for(int draw = 0; draw < drawCount; draw += 8)
+		{
+			for(int p = 0; p < 4; p++)
+			{
+				const float *mixed = &pixels[specialize][(draw + pairs[p].mixed) * drawSize];
+				const float *pure = &pixels[specialize][(draw + pairs[p].pure) * drawSize];
+				float maxDifference = 0.0f;
+
+				for(int i = 0; i < drawSize; i++)
+				{
+					maxDifference = std::max(maxDifference, fabsf(mixed[i] - pure[i]));
+				}
+
+				EXPECT_LT(maxDifference, 1.0f / 1024.0f) << pairs[p].name << ", texture " << draw / 24 << " wrap " << (draw / 8) % 3 << " specialize " << specialize;
+			}
+		}
+	}
+}
+
+// Tests that routines specialized on bool uniforms follow the uniforms when they're toggled between draws,
+// also after the shader has more specialized routines than the cap and falls back to generic ones
+TEST_F(SwiftShaderTest, SpecializeUniforms)
+{
+	setOptions("Optimization", "SpecializeUniforms=1");
+
+	Initialize(3, false);
+
+	const std::string branches =
+		"uniform bool b0;\n"
+		"uniform bool b1;\n"
+		"uniform bool b2;\n"
+		"uniform bool b3;\n"
+		"uniform bool b4;\n"
+		"float branchBits()\n"
+		"{\n"
+		"	float bits = 0.0;\n"
+		"	if(b0) bits += 1.0;\n"
+		"	if(b1) bits += 2.0;\n"
+		"	if(b2) bits += 4.0;\n"
+		"	if(b3) bits += 8.0;\n"
+		"	if(b4) bits += 16.0;\n"
+		"	return bits;\n"
+		"}\n";
+
+	const std::string vs =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"out float vertexBits;\n" +
+		branches +
+		"void main()\n"
+		"{\n"
+		"	vertexBits = branchBits();\n"
+		"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+		"}\n";
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"in float vertexBits;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(vertexBits, 0.0, 0.0, 1.0);\n"
+		"}\n";
+
+	const std::string branchingFS =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"out vec4 fragColor;\n" +
+		branches +
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(branchBits(), 0.0, 0.0, 1.0);\n"
+		"}\n";
+
+	bindFloatFramebuffer(16, 16);
+
+	// Only one stage branches, so each stage's constant updates have to invalidate its own routine
+	for(int stage = 0; stage < 2; stage++)
+	{
+		const ProgramHandles ph = (stage == 0) ? createProgram(quadVertexShader, branchingFS) : createProgram(vs, fs);
+
+		glUseProgram(ph.program);
+
+		GLint locations[5];
+
+		for(int b = 0; b < 5; b++)
+		{
+			char name[] = "b0";
+			name[1] = (char)('0' + b);
+			locations[b] = glGetUniformLocation(ph.program, name);
+			EXPECT_NE(-1, locations[b]);
+		}
+
+		// Twice the 32 combinations, each followed by a draw which only toggles b1. Only the first
+		// MAX_UNIFORM_SPECIALIZATIONS combinations get specialized routines.
+		for(int i = 0; i < 2 * 32; i++)
+		{
+			for(int toggle = 0; toggle < 2; toggle++)
+			{
+				int bits = ((i * 11) % 32) ^ (toggle << 1);
+
+				for(int b = 0; b < 5; b++)
+				{
+					glUniform1i(locations[b], (bits >> b) & 1);
+				}
+
+				glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+				drawQuad(ph.program);
+
+				const float expected[4] = { (float)bits, 0.0f, 0.0f, 1.0f };
+				expectFramebufferColor(expected, 8, 8);
+			}
+		}
+
+		deleteProgram(ph);
+	}
+
+	Uninitialize();
+
+	resetOptions();
+}
+
 // Tests construction of a structure containing a single matrix
 TEST_F(SwiftShaderTest, MatrixInStruct)
 {